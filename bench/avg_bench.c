@@ -0,0 +1,68 @@
+/**
+ * @file avg_bench.c
+ * @brief Compare the per-sample cost of a moving average computed with
+ * push() + sum_line() against the running sum in push_avg().
+ *
+ * The running sum should stay flat as the window grows, while
+ * sum_line() grows linearly with the window.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "lib/filter.h"
+
+#define BLOCK 1024
+#define REPEAT 32
+#define TRIALS 5
+
+static float x[BLOCK];
+
+static double run_sum_line(size_t len) {
+    delay_line_t line;
+    float acc = 0;
+    create_line(&line, len);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        for (size_t k = 0; k < BLOCK; k++) {
+            push(&line, x[k]);
+            acc += sum_line(&line) / len;
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_sink_f = acc;
+    destroy_line(&line);
+    return (double)elapsed / (REPEAT * BLOCK);
+}
+
+static double run_avg_line(size_t len) {
+    avg_line_t line;
+    float acc = 0;
+    create_avg_line(&line, len);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        for (size_t k = 0; k < BLOCK; k++) {
+            push_avg(&line, x[k]);
+            acc += avg_line_sum(&line) / len;
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_sink_f = acc;
+    destroy_avg_line(&line);
+    return (double)elapsed / (REPEAT * BLOCK);
+}
+
+int main(void) {
+    srand(1);
+    for (size_t i = 0; i < BLOCK; i++) {
+        x[i] = (float)rand() / RAND_MAX;
+    }
+
+    printf("%6s %14s %14s %8s\n", "window", "sum_line ns", "push_avg ns", "speedup");
+    for (size_t len = 4; len <= 1024; len *= 4) {
+        double t_sum = BENCH_BEST_OF(TRIALS, run_sum_line(len));
+        double t_avg = BENCH_BEST_OF(TRIALS, run_avg_line(len));
+        printf("%6zu %14.2f %14.2f %7.2fx\n", len, t_sum, t_avg, t_sum / t_avg);
+    }
+    return 0;
+}
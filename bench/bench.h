@@ -0,0 +1,45 @@
+/**
+ * @file bench.h
+ * @brief Timing helpers for Linux-native benchmarks of the lib/ kernels.
+ *
+ * These benchmarks run on the development host, not on the nRF52.
+ * Absolute numbers are not representative of the Cortex-M4F, but the
+ * ratios between implementations of the same kernel are.
+ */
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @brief Return a monotonic timestamp in nanoseconds.
+ */
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Sink that keeps the compiler from discarding benchmarked results.
+ */
+static volatile float bench_sink_f;
+
+/**
+ * @brief Evaluate trial, an expression that runs one trial and gives its
+ * time, trials times, and give the least time, which is the one least
+ * disturbed by the scheduler. Since trial is an expression rather than a
+ * function, it can pass whatever the trial takes. This uses a GNU C
+ * statement expression, which GCC and Clang both accept.
+ */
+#define BENCH_BEST_OF(trials, trial) ({ \
+    double _bench_best = (trial); \
+    for (int _bench_t = 1; _bench_t < (trials); _bench_t++) { \
+        double _bench_time = (trial); \
+        if (_bench_time < _bench_best) _bench_best = _bench_time; \
+    } \
+    _bench_best; \
+})
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * @file biquad_bench.c
+ * @brief Compare the per-sample cost of a fourth order IIR low-pass,
+ * run as a biquad cascade, against an FIR with the same response.
+ *
+ * The FIR taps are the IIR impulse response truncated to FIR_TAPS
+ * samples, which is roughly what a low-pass this sharp costs as an FIR.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "lib/filter.h"
+
+#define BLOCK 1024
+#define REPEAT 64
+#define TRIALS 5
+#define FIR_TAPS 64
+
+static float x[BLOCK];
+static float y[BLOCK];
+static float coeffs[10];
+static float taps[FIR_TAPS];
+
+// Second order low-pass section by the bilinear transform (RBJ cookbook).
+static void lowpass_section(double fc, double q, float *c) {
+    double w0 = 2 * M_PI * fc;
+    double alpha = sin(w0) / (2 * q);
+    double a0 = 1 + alpha;
+    c[0] = (1 - cos(w0)) / 2 / a0;
+    c[1] = (1 - cos(w0)) / a0;
+    c[2] = (1 - cos(w0)) / 2 / a0;
+    c[3] = -2 * cos(w0) / a0;
+    c[4] = (1 - alpha) / a0;
+}
+
+static double run_biquad(void) {
+    biquad_t bq;
+    create_biquad(&bq, coeffs, 2);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        for (size_t k = 0; k < BLOCK; k++) {
+            y[k] = biquad_filter(&bq, x[k]);
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    destroy_biquad(&bq);
+    return (double)elapsed / (REPEAT * BLOCK);
+}
+
+static double run_biquad_block(void) {
+    biquad_t bq;
+    create_biquad(&bq, coeffs, 2);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        biquad_filter_block(&bq, x, y, BLOCK);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    destroy_biquad(&bq);
+    return (double)elapsed / (REPEAT * BLOCK);
+}
+
+static double run_fir_block(void) {
+    mirror_line_t line;
+    create_mirror_line(&line, FIR_TAPS);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        fir_filter_block(&line, taps, FIR_TAPS, x, y, BLOCK);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    destroy_mirror_line(&line);
+    return (double)elapsed / (REPEAT * BLOCK);
+}
+
+int main(void) {
+    biquad_t bq;
+    // Fourth order Butterworth at 5% of the sample rate.
+    lowpass_section(0.05, 0.54119610, coeffs);
+    lowpass_section(0.05, 1.30656296, coeffs + 5);
+
+    // Truncated impulse response, and how much of it is lost.
+    double kept = 0, lost = 0;
+    create_biquad(&bq, coeffs, 2);
+    for (int n = 0; n < 4 * FIR_TAPS; n++) {
+        float h = biquad_filter(&bq, n == 0 ? 1.0f : 0.0f);
+        if (n < FIR_TAPS) {
+            taps[n] = h;
+            kept += h * h;
+        } else {
+            lost += h * h;
+        }
+    }
+    destroy_biquad(&bq);
+
+    srand(1);
+    for (size_t i = 0; i < BLOCK; i++) {
+        x[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+
+    printf("%-22s %10s %12s\n", "filter", "ns/sample", "state bytes");
+    printf("%-22s %10.2f %12zu\n", "biquad x2 per sample",
+           BENCH_BEST_OF(TRIALS, run_biquad()), 4 * sizeof(float));
+    printf("%-22s %10.2f %12zu\n", "biquad x2 block",
+           BENCH_BEST_OF(TRIALS, run_biquad_block()), 4 * sizeof(float));
+    printf("%-22s %10.2f %12zu\n", "fir 64 taps block",
+           BENCH_BEST_OF(TRIALS, run_fir_block()), 2 * FIR_TAPS * sizeof(float));
+    printf("FIR truncation loses %.2e of the impulse response energy\n", lost / (kept + lost));
+    bench_sink_f = y[BLOCK - 1];
+    return 0;
+}
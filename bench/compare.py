@@ -0,0 +1,51 @@
+"""Compare two micro_bench result files and flag regressions.
+
+Usage: python3 compare.py [--threshold RATIO] BASELINE.csv RESULTS.csv
+
+A benchmark regresses when its time exceeds the baseline time by more than
+the threshold ratio (default 1.25, that is, 25% slower). Exits with status 1
+if any benchmark regresses, so it can gate a change.
+"""
+import argparse
+import csv
+import sys
+
+
+def load(path):
+    with open(path, newline="") as f:
+        return {(row["benchmark"], int(row["size"])): float(row["ns_per_op"])
+                for row in csv.DictReader(f)}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare micro_bench results against a baseline")
+    parser.add_argument("baseline")
+    parser.add_argument("results")
+    parser.add_argument("--threshold", type=float, default=1.25,
+                        help="Slowdown ratio counted as a regression. Default: 1.25")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    results = load(args.results)
+
+    regressions = 0
+    print(f"{'benchmark':<28} {'size':>6} {'base ns':>10} {'new ns':>10} {'ratio':>7}")
+    for key, ns in results.items():
+        name, size = key
+        if key not in baseline:
+            print(f"{name:<28} {size:>6} {'-':>10} {ns:>10.2f} {'new':>7}")
+            continue
+        ratio = ns / baseline[key]
+        flag = ""
+        if ratio > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{name:<28} {size:>6} {baseline[key]:>10.2f} {ns:>10.2f} {ratio:>6.2f}x{flag}")
+
+    if regressions:
+        print(f"{regressions} benchmark(s) slower than {args.threshold:.2f}x baseline")
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
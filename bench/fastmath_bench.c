@@ -0,0 +1,85 @@
+/**
+ * @file fastmath_bench.c
+ * @brief Compare the approximations in lib/fastmath.c against libm,
+ * one function at a time and in the computation of the Tilt reactor.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "lib/fastmath.h"
+
+#define N 1024
+#define REPEAT 200
+#define TRIALS 5
+
+static float a[N], b[N], c[N];
+
+#define TIMED_LOOP(expr) do { \
+    float acc = 0; \
+    uint64_t start = bench_now_ns(); \
+    for (int r = 0; r < REPEAT; r++) { \
+        for (int i = 0; i < N; i++) { \
+            acc += (expr); \
+        } \
+    } \
+    uint64_t elapsed = bench_now_ns() - start; \
+    bench_sink_f = acc; \
+    return (double)elapsed / (REPEAT * N); \
+} while (0)
+
+static double libm_atan2(void) { TIMED_LOOP(atan2f(a[i], b[i])); }
+static double fast_atan2(void) { TIMED_LOOP(fast_atan2f(a[i], b[i])); }
+static double libm_rsqrt(void) { TIMED_LOOP(1.0f / sqrtf(c[i])); }
+static double fast_rsqrt(void) { TIMED_LOOP(fast_rsqrtf(c[i])); }
+static double libm_cos(void) { TIMED_LOOP(cosf(a[i] * 3)); }
+static double fast_cos(void) { TIMED_LOOP(fast_cosf(a[i] * 3)); }
+static double libm_acos(void) { TIMED_LOOP(acosf(a[i])); }
+static double fast_acos(void) { TIMED_LOOP(fast_acosf(a[i])); }
+
+// The reaction of Tilt in src/lib/Tilt.lf, with zero bias and unit sensitivity.
+static float tilt_exact(float ax, float ay, float az) {
+    float pitch = 180 * atanf(-ax / sqrt(ay * ay + az * az)) / M_PI;
+    float roll = 180 * atanf(-ay / sqrt(ax * ax + az * az)) / M_PI;
+    return pitch + roll + 180 * acosf(cosf(pitch * M_PI / 180) * cosf(roll * M_PI / 180)) / M_PI;
+}
+
+static float tilt_fast(float ax, float ay, float az) {
+    float bx = ay * ay + az * az, by = ax * ax + az * az;
+    float degrees = 180.0f / (float)M_PI;
+    float pitch = degrees * fast_atan2f(-ax, bx * fast_rsqrtf(bx));
+    float roll = degrees * fast_atan2f(-ay, by * fast_rsqrtf(by));
+    return pitch + roll + degrees * fast_acosf(fast_cosf(pitch / degrees) * fast_cosf(roll / degrees));
+}
+
+static double libm_tilt(void) { TIMED_LOOP(tilt_exact(a[i], b[i], c[i])); }
+static double fast_tilt(void) { TIMED_LOOP(tilt_fast(a[i], b[i], c[i])); }
+
+int main(void) {
+    srand(1);
+    for (int i = 0; i < N; i++) {
+        a[i] = 2.0f * rand() / RAND_MAX - 1;
+        b[i] = 2.0f * rand() / RAND_MAX - 1;
+        c[i] = 2.0f * rand() / RAND_MAX;
+    }
+
+    struct {
+        const char *name;
+        double (*libm)(void);
+        double (*fast)(void);
+    } cases[] = {
+        {"atan2f", libm_atan2, fast_atan2},
+        {"rsqrtf", libm_rsqrt, fast_rsqrt},
+        {"cosf", libm_cos, fast_cos},
+        {"acosf", libm_acos, fast_acos},
+        {"Tilt", libm_tilt, fast_tilt},
+    };
+    printf("%-8s %10s %10s %8s\n", "kernel", "libm ns", "fast ns", "speedup");
+    for (size_t k = 0; k < sizeof(cases) / sizeof(cases[0]); k++) {
+        double t_libm = BENCH_BEST_OF(TRIALS, cases[k].libm());
+        double t_fast = BENCH_BEST_OF(TRIALS, cases[k].fast());
+        printf("%-8s %10.2f %10.2f %7.2fx\n", cases[k].name, t_libm, t_fast, t_libm / t_fast);
+    }
+    return 0;
+}
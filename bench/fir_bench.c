@@ -0,0 +1,108 @@
+/**
+ * @file fir_bench.c
+ * @brief Compare the per-sample cost of fir_filter() on a circular
+ * delay line against the mirrored delay line paths.
+ *
+ * For each filter length, the same input is run through
+ *   - push() + fir_filter()            (circular delay line, one get() per tap)
+ *   - push_mirror() + fir_filter_mirror() (mirrored delay line, per sample)
+ *   - fir_filter_block()               (mirrored delay line, whole block)
+ * and the outputs are checked against each other before timing.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "lib/filter.h"
+
+#define BLOCK 1024
+#define REPEAT 64
+#define TRIALS 5
+
+static float x[BLOCK];
+static float y_ref[BLOCK];
+static float y[BLOCK];
+
+static void fill(float *buf, size_t n) {
+    srand(1);
+    for (size_t i = 0; i < n; i++) {
+        buf[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+}
+
+static double run_circular(float *b, size_t taps) {
+    delay_line_t line;
+    create_line(&line, taps);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        for (size_t k = 0; k < BLOCK; k++) {
+            push(&line, x[k]);
+            y_ref[k] = fir_filter(&line, b, taps);
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    destroy_line(&line);
+    return (double)elapsed / (REPEAT * BLOCK);
+}
+
+static double run_mirror(float *b, size_t taps) {
+    mirror_line_t line;
+    create_mirror_line(&line, taps);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        for (size_t k = 0; k < BLOCK; k++) {
+            push_mirror(&line, x[k]);
+            y[k] = fir_filter_mirror(&line, b, taps);
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    destroy_mirror_line(&line);
+    return (double)elapsed / (REPEAT * BLOCK);
+}
+
+static double run_block(float *b, size_t taps) {
+    mirror_line_t line;
+    create_mirror_line(&line, taps);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        fir_filter_block(&line, b, taps, x, y, BLOCK);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    destroy_mirror_line(&line);
+    return (double)elapsed / (REPEAT * BLOCK);
+}
+
+// Outputs differ only by summation order, so compare with a tolerance.
+static int check(size_t taps) {
+    for (size_t k = 0; k < BLOCK; k++) {
+        if (fabsf(y[k] - y_ref[k]) > 1e-4f * (1.0f + fabsf(y_ref[k]))) {
+            fprintf(stderr, "ERROR: taps=%zu sample %zu: %f != %f\n",
+                    taps, k, y[k], y_ref[k]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main(void) {
+    static float b[256];
+    fill(x, BLOCK);
+    for (size_t i = 0; i < 256; i++) {
+        b[i] = 1.0f / (i + 1);
+    }
+
+    printf("%6s %14s %14s %14s %8s\n",
+           "taps", "circular ns", "mirror ns", "block ns", "speedup");
+    for (size_t taps = 4; taps <= 256; taps *= 2) {
+        double t_circ = BENCH_BEST_OF(TRIALS, run_circular(b, taps));
+        double t_mirror = BENCH_BEST_OF(TRIALS, run_mirror(b, taps));
+        if (check(taps)) return 1;
+        double t_block = BENCH_BEST_OF(TRIALS, run_block(b, taps));
+        if (check(taps)) return 1;
+        printf("%6zu %14.2f %14.2f %14.2f %7.2fx\n",
+               taps, t_circ, t_mirror, t_block, t_circ / t_block);
+        bench_sink_f = y[BLOCK - 1];
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file framer_bench.c
+ * @brief Throughput of the Kobuki packet framer in lib/romi_framer.c, in MB/s,
+ * on a stream of valid sensor packets mixed with garbage.
+ *
+ * The stream is fed in chunks of several sizes. For comparison, the same
+ * stream is run through a byte-at-a-time state machine like the one that
+ * romi.c used before the framer existed.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "lib/romi_framer.h"
+
+#define STREAM 65536
+#define REPEAT 32
+#define TRIALS 5
+
+static uint8_t stream[STREAM];
+static size_t stream_frames;
+static size_t frames;
+
+// Fill the stream with sensor-sized packets, each followed by
+// up to 32 bytes of garbage, some of which look like headers.
+static void make_stream(void) {
+    size_t n = 0;
+    while (n + 70 + 32 < STREAM) {
+        uint8_t *p = stream + n;
+        p[0] = 0xAA;
+        p[1] = 0x55;
+        p[2] = 66;
+        uint8_t cs = p[2];
+        for (int i = 0; i < 66; i++) {
+            p[3 + i] = (uint8_t)rand();
+            cs ^= p[3 + i];
+        }
+        p[69] = cs;
+        n += 70;
+        stream_frames++;
+        size_t garbage = rand() % 33;
+        for (size_t i = 0; i < garbage; i++) {
+            stream[n++] = (rand() % 8 == 0) ? 0xAA : (uint8_t)rand();
+        }
+    }
+    while (n < STREAM) {
+        stream[n++] = 0;
+    }
+}
+
+static void count_frame(const uint8_t *packet, size_t length, void *context) {
+    frames++;
+}
+
+static size_t chunk;
+
+// Each run gives nanoseconds per byte.
+static double run_framer(void) {
+    romi_framer_t framer;
+    romi_framer_init(&framer, count_frame, NULL);
+    frames = 0;
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        for (size_t n = 0; n < STREAM; n += chunk) {
+            romi_framer_feed(&framer, stream + n, chunk);
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    if (frames < REPEAT * stream_frames) {
+        fprintf(stderr, "ERROR: framer found %zu of %zu frames\n", frames, REPEAT * stream_frames);
+        exit(1);
+    }
+    return (double)elapsed / (REPEAT * STREAM);
+}
+
+// Byte-at-a-time state machine that drops the whole packet on a bad checksum.
+static double run_state_machine(void) {
+    enum { header, header_2, read_length, read_payload } state = header;
+    uint8_t packet[ROMI_FRAME_MAX];
+    size_t length = 0;
+    frames = 0;
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        for (size_t n = 0; n < STREAM; n++) {
+            uint8_t byte = stream[n];
+            switch (state) {
+            case header:
+                if (byte == 0xAA) state = header_2;
+                break;
+            case header_2:
+                state = (byte == 0x55) ? read_length : (byte == 0xAA) ? header_2 : header;
+                break;
+            case read_length:
+                packet[2] = byte;
+                length = 3;
+                state = read_payload;
+                break;
+            case read_payload:
+                packet[length++] = byte;
+                if (length == packet[2] + 4) {
+                    uint8_t cs = 0;
+                    for (size_t i = 2; i < length; i++) cs ^= packet[i];
+                    if (cs == 0) count_frame(packet, length, NULL);
+                    state = header;
+                }
+                break;
+            }
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    return (double)elapsed / (REPEAT * STREAM);
+}
+
+int main(void) {
+    srand(1);
+    make_stream();
+
+    printf("%-24s %10s %8s\n", "framer", "MB/s", "frames");
+    double t_sm = 1e3 / BENCH_BEST_OF(TRIALS, run_state_machine());
+    printf("%-24s %10.1f %8zu\n", "state machine", t_sm, frames / REPEAT);
+    for (chunk = 1; chunk <= 256; chunk *= 16) {
+        double t = 1e3 / BENCH_BEST_OF(TRIALS, run_framer());
+        char name[32];
+        snprintf(name, sizeof(name), "romi_framer, chunk %zu", chunk);
+        printf("%-24s %10.1f %8zu\n", name, t, frames / REPEAT);
+    }
+    printf("(%zu valid frames in the stream)\n", stream_frames);
+    return 0;
+}
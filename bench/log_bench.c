@@ -0,0 +1,108 @@
+/**
+ * @file log_bench.c
+ * @brief Cost of a log call with lib/binlog.h against formatting it with
+ * printf, for the two floats that TiltLog shows.
+ *
+ * On the board, printf formats the floats and then writes the text to
+ * RTT before returning. Here, fprintf to /dev/null with a flush after
+ * each call stands in for that, and snprintf alone gives the cost of the
+ * formatting. BINLOG() is timed by itself, and so is draining what it
+ * logged, which happens later, when the program has time to spare.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "lib/binlog.h"
+
+// Few enough that a batch fits in the ring with 64-bit pointers.
+#define CALLS 32
+#define REPEAT 2000
+#define TRIALS 5
+
+static float xz[CALLS], yz[CALLS];
+static FILE *null_file;
+static size_t drained;
+
+static bool count_bytes(const uint8_t *data, size_t length, void *context) {
+    drained += length;
+    return true;
+}
+
+static double run_printf(void) {
+    uint64_t elapsed = 0;
+    for (int r = 0; r < REPEAT; r++) {
+        uint64_t start = bench_now_ns();
+        for (int i = 0; i < CALLS; i++) {
+            fprintf(null_file, "xz:%.2f yz:%.2f\n", xz[i], yz[i]);
+            fflush(null_file);
+        }
+        elapsed += bench_now_ns() - start;
+    }
+    return (double)elapsed / (REPEAT * CALLS);
+}
+
+static double text_bytes;
+
+static double run_snprintf(void) {
+    char text[32];
+    uint64_t elapsed = 0;
+    size_t length = 0;
+    for (int r = 0; r < REPEAT; r++) {
+        uint64_t start = bench_now_ns();
+        for (int i = 0; i < CALLS; i++) {
+            length += snprintf(text, sizeof(text), "xz:%.2f yz:%.2f\n", xz[i], yz[i]);
+        }
+        elapsed += bench_now_ns() - start;
+        bench_sink_f = text[4];
+    }
+    text_bytes = (double)length / (REPEAT * CALLS);
+    return (double)elapsed / (REPEAT * CALLS);
+}
+
+static double drain_ns;
+
+// CALLS messages at a time, each batch drained outside the timed loop.
+static double run_binlog(void) {
+    uint64_t elapsed = 0, draining = 0;
+    for (int r = 0; r < REPEAT; r++) {
+        uint64_t start = bench_now_ns();
+        for (int i = 0; i < CALLS; i++) {
+            BINLOG("xz:%.2f yz:%.2f", xz[i], yz[i]);
+        }
+        uint64_t middle = bench_now_ns();
+        binlog_drain(count_bytes, NULL, 1 << 16);
+        draining += bench_now_ns() - middle;
+        elapsed += middle - start;
+    }
+    drain_ns = (double)draining / (REPEAT * CALLS);
+    return (double)elapsed / (REPEAT * CALLS);
+}
+
+int main(void) {
+    null_file = fopen("/dev/null", "w");
+    if (!null_file) {
+        perror("/dev/null");
+        return 1;
+    }
+    for (int i = 0; i < CALLS; i++) {
+        xz[i] = (rand() % 18000) / 100.0f - 90;
+        yz[i] = (rand() % 18000) / 100.0f - 90;
+    }
+    binlog_init();
+    binlog_reset();
+
+    double t_printf = BENCH_BEST_OF(TRIALS, run_printf());
+    double t_snprintf = BENCH_BEST_OF(TRIALS, run_snprintf());
+    double t_binlog = BENCH_BEST_OF(TRIALS, run_binlog());
+    binlog_stats_t stats;
+    binlog_stats(&stats);
+
+    printf("%-24s %10s %8s\n", "log call", "ns", "bytes");
+    printf("%-24s %10.1f %8.1f\n", "printf and write", t_printf, text_bytes);
+    printf("%-24s %10.1f %8.1f\n", "snprintf only", t_snprintf, text_bytes);
+    printf("%-24s %10.1f %8.1f\n", "BINLOG", t_binlog, (double)stats.bytes / stats.drained);
+    printf("%-24s %10.1f\n", "binlog_drain, per call", drain_ns);
+    printf("(%u messages dropped)\n", (unsigned)stats.dropped);
+    return 0;
+}
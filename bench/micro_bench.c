@@ -0,0 +1,234 @@
+/**
+ * @file micro_bench.c
+ * @brief Repeatable micro-benchmarks of the lib/ kernels with
+ * machine-readable output.
+ *
+ * Prints one CSV row per benchmark and input size:
+ *
+ *     benchmark,size,ns_per_op
+ *
+ * Compare two runs with compare.py, or use `make bench_baseline` before
+ * a change and `make bench_check` after it.
+ *
+ * romi.c is included directly so that its private framing and parsing
+ * functions can be timed; it is compiled against the stand-ins in
+ * platform/host.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "lib/filter.h"
+#include "lib/odometry.h"
+#include "lib/ahrs.h"
+#include "lib/romi.c"
+
+// Many short trials, keeping the fastest, are more robust to interference
+// from other processes than a few long ones.
+#define TRIALS 31
+#define OPS 50000
+
+static void report(const char *name, size_t size, double ns) {
+    printf("%s,%zu,%.3f\n", name, size, ns);
+}
+
+static float input[1024];
+
+static double run_push(size_t len) {
+    delay_line_t line;
+    create_line(&line, len);
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < OPS; i++) {
+        push(&line, input[i & 1023]);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_sink_f = *line.curr;
+    destroy_line(&line);
+    return (double)elapsed / OPS;
+}
+
+static double run_get(size_t len) {
+    delay_line_t line;
+    float x, acc = 0;
+    create_line(&line, len);
+    for (size_t i = 0; i < len; i++) push(&line, input[i]);
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < OPS; i++) {
+        get(&line, i % len, &x);
+        acc += x;
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_sink_f = acc;
+    destroy_line(&line);
+    return (double)elapsed / OPS;
+}
+
+static double run_sum_line(size_t len) {
+    delay_line_t line;
+    float acc = 0;
+    size_t ops = OPS / len + 1;
+    create_line(&line, len);
+    for (size_t i = 0; i < len; i++) push(&line, input[i]);
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < ops; i++) {
+        acc += sum_line(&line);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_sink_f = acc;
+    destroy_line(&line);
+    return (double)elapsed / ops;
+}
+
+static double run_fir_filter(size_t len) {
+    delay_line_t line;
+    float acc = 0;
+    size_t ops = OPS / len + 1;
+    create_line(&line, len);
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < ops; i++) {
+        push(&line, input[i & 1023]);
+        acc += fir_filter(&line, input, len);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_sink_f = acc;
+    destroy_line(&line);
+    return (double)elapsed / ops;
+}
+
+static uint8_t bytes[256];
+
+static double run_romi_checksum(size_t len) {
+    uint8_t acc = 0;
+    size_t ops = OPS * 8 / len + 1;
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < ops; i++) {
+        bytes[0] = (uint8_t)i; // defeat hoisting out of the loop
+        acc ^= _romi_checksum(bytes, len);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_sink_f = acc;
+    return (double)elapsed / ops;
+}
+
+/**
+ * Write a Kobuki sensor packet holding `count` basic sensor data
+ * sub-payloads (id 0x01) into `buf` and return its total length.
+ */
+static size_t make_sensor_packet(uint8_t *buf, size_t count) {
+    size_t n = 3;
+    buf[0] = 0xAA;
+    buf[1] = 0x55;
+    for (size_t k = 0; k < count; k++) {
+        buf[n++] = 0x01;
+        buf[n++] = 0x0F;
+        for (int j = 0; j < 0x0F; j++) {
+            buf[n++] = (uint8_t)(k * 31 + j);
+        }
+    }
+    buf[2] = (uint8_t)(n - 3);
+    buf[n] = _romi_checksum(buf, n);
+    return n + 1;
+}
+
+static uint8_t packet[256];
+
+static double run_romi_parse(size_t count) {
+    romi_sensors_ext_t sensors;
+    uint32_t acc = 0;
+    make_sensor_packet(packet, count);
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < OPS; i++) {
+        _romi_parse_sensor_packet(packet, &sensors);
+        acc += sensors.basic.encoders.left;
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_sink_f = acc;
+    return (double)elapsed / OPS;
+}
+
+// Drive commands issued while the UART is busy, as in a control loop
+// running faster than the commands go out. The size is unused.
+static double run_romi_drive_direct(size_t size) {
+    int32_t err = 0;
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < OPS; i++) {
+        err |= romi_drive_direct((int16_t)(i & 0xFF), 100);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_sink_f = err;
+    return (double)elapsed / OPS;
+}
+
+// Odometry updates on a trace that turns and rolls over. The size is unused.
+static double run_odometry_update(size_t size) {
+    odometry_t odom;
+    odometry_pose_t pose;
+    romi_encoder_t enc = {0, 0};
+    odometry_init(&odom, 0.0006108f, 0.141f);
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < OPS; i++) {
+        enc.left += 37 + (i & 7);
+        enc.right += 45 - (i & 3);
+        odometry_update(&odom, enc);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    odometry_get_pose(&odom, &pose);
+    bench_sink_f = pose.x;
+    return (double)elapsed / OPS;
+}
+
+// Orientation updates with all three sensors, turning slowly about
+// every axis. The size is unused.
+static double run_ahrs_update(size_t size) {
+    ahrs_t ahrs;
+    ahrs_init(&ahrs, 0.1f);
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < OPS; i++) {
+        float a = input[i & 1023];
+        ahrs_update(&ahrs, 0.1f * a, -0.2f * a, 0.3f,
+                    a - 0.5f, 0.1f, 1.0f, 20.0f, a, -40.0f, 0.01f);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_sink_f = ahrs.q.w;
+    return (double)elapsed / OPS;
+}
+
+int main(void) {
+    srand(1);
+    for (size_t i = 0; i < 1024; i++) {
+        input[i] = (float)rand() / RAND_MAX;
+    }
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = (uint8_t)rand();
+    }
+
+    printf("benchmark,size,ns_per_op\n");
+    // 16 and 64 take the power-of-two path, 10 and 100 the branching one.
+    size_t lens[] = {10, 16, 64, 100, 256};
+    for (size_t k = 0; k < sizeof(lens) / sizeof(lens[0]); k++) {
+        report("push", lens[k], BENCH_BEST_OF(TRIALS, run_push(lens[k])));
+    }
+    for (size_t k = 0; k < sizeof(lens) / sizeof(lens[0]); k++) {
+        report("get", lens[k], BENCH_BEST_OF(TRIALS, run_get(lens[k])));
+    }
+    for (size_t len = 16; len <= 1024; len *= 4) {
+        report("sum_line", len, BENCH_BEST_OF(TRIALS, run_sum_line(len)));
+    }
+    for (size_t len = 4; len <= 256; len *= 4) {
+        report("fir_filter", len, BENCH_BEST_OF(TRIALS, run_fir_filter(len)));
+    }
+    for (size_t len = 16; len <= 256; len *= 4) {
+        report("romi_checksum", len, BENCH_BEST_OF(TRIALS, run_romi_checksum(len)));
+    }
+    for (size_t count = 1; count <= 8; count *= 2) {
+        report("romi_parse_sensor_packet", count, BENCH_BEST_OF(TRIALS, run_romi_parse(count)));
+    }
+    report("odometry_update", 1, BENCH_BEST_OF(TRIALS, run_odometry_update(1)));
+    report("ahrs_update", 1, BENCH_BEST_OF(TRIALS, run_ahrs_update(1)));
+    // The stop command sent by romi_init() stays in progress,
+    // since the host UART only completes it when told to.
+    romi_init();
+    report("romi_drive_direct", 1, BENCH_BEST_OF(TRIALS, run_romi_drive_direct(1)));
+    return 0;
+}
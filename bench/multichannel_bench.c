@@ -0,0 +1,141 @@
+/**
+ * @file multichannel_bench.c
+ * @brief Compare filtering three axes with one single-channel filter per
+ * axis against one multi-channel filter over interleaved frames.
+ *
+ * This measures only the kernels. On the target, the multi-channel
+ * reactors also save two reaction invocations and four port writes
+ * per sample, which this benchmark does not capture.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "lib/filter.h"
+
+#define FRAMES 1024
+#define REPEAT 32
+#define TRIALS 5
+#define TAPS 16
+
+static float x[FRAMES][3];
+static float y[FRAMES][3];
+static float b[TAPS];
+static float coeffs[10] = {
+    // Two arbitrary stable low-pass sections.
+    0.02f, 0.04f, 0.02f, -1.56f, 0.64f,
+    0.02f, 0.04f, 0.02f, -1.70f, 0.78f,
+};
+
+static double run_fir_single(void) {
+    mirror_line_t line[3];
+    for (int k = 0; k < 3; k++) create_mirror_line(&line[k], TAPS);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        for (size_t n = 0; n < FRAMES; n++) {
+            for (int k = 0; k < 3; k++) {
+                fir_filter_block(&line[k], b, TAPS, &x[n][k], &y[n][k], 1);
+            }
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    for (int k = 0; k < 3; k++) destroy_mirror_line(&line[k]);
+    return (double)elapsed / (REPEAT * FRAMES);
+}
+
+static double run_fir_mc(void) {
+    mirror_line_mc_t line;
+    create_mirror_line_mc(&line, TAPS, 3);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        for (size_t n = 0; n < FRAMES; n++) {
+            fir_filter_mc(&line, b, TAPS, x[n], y[n]);
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    destroy_mirror_line_mc(&line);
+    return (double)elapsed / (REPEAT * FRAMES);
+}
+
+static double run_avg_single(void) {
+    avg_line_t line[3];
+    for (int k = 0; k < 3; k++) create_avg_line(&line[k], TAPS);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        for (size_t n = 0; n < FRAMES; n++) {
+            for (int k = 0; k < 3; k++) {
+                push_avg(&line[k], x[n][k]);
+                y[n][k] = avg_line_sum(&line[k]);
+            }
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    for (int k = 0; k < 3; k++) destroy_avg_line(&line[k]);
+    return (double)elapsed / (REPEAT * FRAMES);
+}
+
+static double run_avg_mc(void) {
+    avg_line_mc_t line;
+    create_avg_line_mc(&line, TAPS, 3);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        for (size_t n = 0; n < FRAMES; n++) {
+            push_avg_mc(&line, x[n], y[n]);
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    destroy_avg_line_mc(&line);
+    return (double)elapsed / (REPEAT * FRAMES);
+}
+
+static double run_biquad_single(void) {
+    biquad_t bq[3];
+    for (int k = 0; k < 3; k++) create_biquad(&bq[k], coeffs, 2);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        for (size_t n = 0; n < FRAMES; n++) {
+            for (int k = 0; k < 3; k++) {
+                y[n][k] = biquad_filter(&bq[k], x[n][k]);
+            }
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    for (int k = 0; k < 3; k++) destroy_biquad(&bq[k]);
+    return (double)elapsed / (REPEAT * FRAMES);
+}
+
+static double run_biquad_mc(void) {
+    biquad_mc_t bq;
+    create_biquad_mc(&bq, coeffs, 2, 3);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < REPEAT; r++) {
+        for (size_t n = 0; n < FRAMES; n++) {
+            biquad_filter_mc(&bq, x[n], y[n]);
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    destroy_biquad_mc(&bq);
+    return (double)elapsed / (REPEAT * FRAMES);
+}
+
+static void report(const char *name, double single, double mc) {
+    printf("%-14s %14.2f %14.2f %7.2fx\n", name, single, mc, single / mc);
+}
+
+int main(void) {
+    srand(1);
+    for (size_t n = 0; n < FRAMES; n++) {
+        for (int k = 0; k < 3; k++) {
+            x[n][k] = (float)rand() / RAND_MAX - 0.5f;
+        }
+    }
+    for (int i = 0; i < TAPS; i++) {
+        b[i] = 1.0f / TAPS;
+    }
+    printf("%-14s %14s %14s %8s\n", "ns per frame", "3 x single", "multi-channel", "speedup");
+    report("fir 16 taps", BENCH_BEST_OF(TRIALS, run_fir_single()), BENCH_BEST_OF(TRIALS, run_fir_mc()));
+    report("avg 16", BENCH_BEST_OF(TRIALS, run_avg_single()), BENCH_BEST_OF(TRIALS, run_avg_mc()));
+    report("biquad x2", BENCH_BEST_OF(TRIALS, run_biquad_single()), BENCH_BEST_OF(TRIALS, run_biquad_mc()));
+    bench_sink_f = y[FRAMES - 1][0];
+    return 0;
+}
@@ -37,6 +37,11 @@
 #define SPI1_ENABLED 1
 
 #define APP_SDCARD_ENABLED 1
+// SPI0 shares its peripheral with the TWI of the sensors, and the LCD
+// uses SPI1, so the SD card gets SPI2.
+#define APP_SDCARD_SPI_INSTANCE 2
+#define NRFX_SPI2_ENABLED 1
+#define SPI2_ENABLED 1
 
 #define NRF_CLOCK_ENABLED 1
 #define NRFX_CLOCK_ENABLED 1
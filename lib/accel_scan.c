@@ -0,0 +1,129 @@
+/**
+ * @file accel_scan.c
+ * @brief Implementation of continuous accelerometer sampling with the SAADC.
+ */
+
+#include "accel_scan.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "nrfx_ppi.h"
+#include "nrfx_timer.h"
+
+#define CHANNELS 3
+
+// Conversion time of the SAADC in microseconds, which follows the
+// acquisition time (product specification, SAADC electrical specification).
+#define CONVERSION_US 2
+
+// Acquisition times in microseconds, indexed by nrf_saadc_acqtime_t.
+static const uint8_t acquisition_us[] = {3, 5, 10, 15, 20, 40};
+
+static const nrfx_timer_t timer = NRFX_TIMER_INSTANCE(1);
+static nrf_ppi_channel_t ppi_channel;
+static bool initialized = false;
+
+static accel_scan_handler_t scan_handler;
+static void *scan_context;
+
+// The SAADC fills one while the other is handed out or waits.
+static nrf_saadc_value_t buffers[2][CHANNELS * ACCEL_SCAN_BATCH];
+
+static void saadc_done(nrfx_saadc_evt_t const *p_event) {
+    if (p_event->type != NRFX_SAADC_EVT_DONE) return;
+    // The SAADC has already moved on to the other buffer. Copy this one
+    // out and queue it again before that one fills.
+    accel_scan_batch_t batch;
+    memcpy(batch.samples, p_event->data.done.p_buffer, sizeof(batch.samples));
+    nrfx_saadc_buffer_convert(p_event->data.done.p_buffer, p_event->data.done.size);
+    scan_handler(&batch, scan_context);
+}
+
+static void timer_event(nrf_timer_event_t event_type, void *p_context) {
+    // The compare event only drives PPI; its interrupt is not enabled.
+}
+
+ret_code_t accel_scan_init(accel_scan_config_t const *config,
+                           accel_scan_handler_t handler, void *context) {
+    if (initialized) return NRF_ERROR_INVALID_STATE;
+
+    nrf_saadc_channel_config_t channel_config = NRFX_SAADC_DEFAULT_CHANNEL_CONFIG_SE(config->x_input);
+    channel_config.gain = NRF_SAADC_GAIN1_6;
+    channel_config.reference = NRF_SAADC_REFERENCE_INTERNAL;
+    if (config->oversample != NRF_SAADC_OVERSAMPLE_DISABLED) {
+        channel_config.burst = NRF_SAADC_BURST_ENABLED;
+    }
+
+    // Each scan has to finish before the next SAMPLE task, or the SAADC
+    // ignores it.
+    uint32_t scan_us = CHANNELS * (acquisition_us[channel_config.acq_time] + CONVERSION_US)
+            << config->oversample;
+    if (config->period_us <= scan_us) return NRF_ERROR_INVALID_PARAM;
+
+    scan_handler = handler;
+    scan_context = context;
+
+    // Low power mode starts the SAADC from the driver on each sample,
+    // which does not work when PPI triggers the samples.
+    nrfx_saadc_config_t saadc_config = NRFX_SAADC_DEFAULT_CONFIG;
+    saadc_config.resolution = NRF_SAADC_RESOLUTION_12BIT;
+    saadc_config.oversample = config->oversample;
+    saadc_config.low_power_mode = false;
+    ret_code_t error_code = nrfx_saadc_init(&saadc_config, saadc_done);
+    if (error_code != NRF_SUCCESS) return error_code;
+
+    // Scans go through the channels in order, so x, y, z end up
+    // interleaved in the buffers as accel_scan_sample_t.
+    const nrf_saadc_input_t inputs[CHANNELS] = {config->x_input, config->y_input, config->z_input};
+    for (uint8_t i = 0; i < CHANNELS; i++) {
+        channel_config.pin_p = inputs[i];
+        error_code = nrfx_saadc_channel_init(i, &channel_config);
+        if (error_code != NRF_SUCCESS) return error_code;
+    }
+
+    nrfx_timer_config_t timer_config = NRFX_TIMER_DEFAULT_CONFIG;
+    timer_config.bit_width = NRF_TIMER_BIT_WIDTH_32;
+    error_code = nrfx_timer_init(&timer, &timer_config, timer_event);
+    if (error_code != NRF_SUCCESS) return error_code;
+    nrfx_timer_extended_compare(&timer, NRF_TIMER_CC_CHANNEL0,
+            nrfx_timer_us_to_ticks(&timer, config->period_us),
+            NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK, false);
+
+    error_code = nrfx_ppi_channel_alloc(&ppi_channel);
+    if (error_code != NRF_SUCCESS) return error_code;
+    error_code = nrfx_ppi_channel_assign(ppi_channel,
+            nrfx_timer_compare_event_address_get(&timer, NRF_TIMER_CC_CHANNEL0),
+            nrfx_saadc_sample_task_get());
+    if (error_code != NRF_SUCCESS) return error_code;
+    error_code = nrfx_ppi_channel_enable(ppi_channel);
+    if (error_code != NRF_SUCCESS) return error_code;
+
+    initialized = true;
+    return NRF_SUCCESS;
+}
+
+void accel_scan_uninit(void) {
+    if (!initialized) return;
+    accel_scan_stop();
+    nrfx_ppi_channel_disable(ppi_channel);
+    nrfx_ppi_channel_free(ppi_channel);
+    nrfx_timer_uninit(&timer);
+    nrfx_saadc_uninit();
+    initialized = false;
+}
+
+ret_code_t accel_scan_start(void) {
+    if (!initialized) return NRF_ERROR_INVALID_STATE;
+    ret_code_t error_code = nrfx_saadc_buffer_convert(buffers[0], CHANNELS * ACCEL_SCAN_BATCH);
+    if (error_code != NRF_SUCCESS) return error_code;
+    error_code = nrfx_saadc_buffer_convert(buffers[1], CHANNELS * ACCEL_SCAN_BATCH);
+    if (error_code != NRF_SUCCESS) return error_code;
+    nrfx_timer_clear(&timer);
+    nrfx_timer_enable(&timer);
+    return NRF_SUCCESS;
+}
+
+void accel_scan_stop(void) {
+    nrfx_timer_disable(&timer);
+    nrfx_saadc_abort();
+}
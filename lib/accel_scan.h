@@ -0,0 +1,93 @@
+/**
+ * @file accel_scan.h
+ * @brief Continuous sampling of the three analog accelerometer channels
+ * of the Buckler board with the SAADC.
+ *
+ * A hardware timer triggers the SAADC's SAMPLE task through PPI at a
+ * fixed period, with no interrupt or code involved, and each SAMPLE task
+ * converts all three channels into memory by EasyDMA. Two buffers of
+ * ACCEL_SCAN_BATCH scans each take turns: while the SAADC fills one,
+ * the handler gets the other, so the CPU is interrupted once per batch
+ * rather than once per conversion, and the sampling times do not depend
+ * on what the CPU is doing.
+ *
+ * With oversampling, each channel is converted 2^oversample times in a
+ * burst on each SAMPLE task and the SAADC averages the results. The
+ * nRF52 only supports oversampling with several channels in burst mode.
+ */
+
+#ifndef ACCEL_SCAN_H
+#define ACCEL_SCAN_H
+
+#include <stdint.h>
+#include "nrfx_saadc.h" // Defines nrf_saadc_value_t, nrf_saadc_input_t, etc.
+
+// Scans per buffer, and so per call of the handler.
+#ifndef ACCEL_SCAN_BATCH
+#define ACCEL_SCAN_BATCH 16
+#endif
+
+/**
+ * @brief Raw conversions of the three channels from one scan, at 12 bits.
+ */
+typedef struct {
+    nrf_saadc_value_t x;
+    nrf_saadc_value_t y;
+    nrf_saadc_value_t z;
+} accel_scan_sample_t;
+
+/**
+ * @brief The scans from one buffer, oldest first, sampled period_us apart.
+ */
+typedef struct {
+    accel_scan_sample_t samples[ACCEL_SCAN_BATCH];
+} accel_scan_batch_t;
+
+/**
+ * @brief Sampling configuration.
+ */
+typedef struct {
+    nrf_saadc_input_t x_input;
+    nrf_saadc_input_t y_input;
+    nrf_saadc_input_t z_input;
+    uint32_t period_us;                // Time between scans.
+    nrf_saadc_oversample_t oversample; // Averaging of each conversion.
+} accel_scan_config_t;
+
+/**
+ * @brief Function called with each full batch, from the SAADC interrupt.
+ * @param batch The scans, valid only during the call.
+ * @param context The context given to accel_scan_init().
+ */
+typedef void (*accel_scan_handler_t)(accel_scan_batch_t const *batch, void *context);
+
+/**
+ * @brief Set up the SAADC, TIMER1, and a PPI channel for scanning.
+ * Sampling starts with accel_scan_start().
+ * @param config The channels, period, and oversampling.
+ * @param handler The function to call with each batch.
+ * @param context Passed to the handler.
+ * @return An error code that should be checked using the macro APP_ERROR_CHECK.
+ *  NRF_ERROR_INVALID_PARAM if the period is too short for the conversions of
+ *  one scan, and NRF_ERROR_INVALID_STATE if already initialized.
+ */
+ret_code_t accel_scan_init(accel_scan_config_t const *config,
+                           accel_scan_handler_t handler, void *context);
+
+/**
+ * @brief Release the SAADC, the timer, and the PPI channel.
+ */
+void accel_scan_uninit(void);
+
+/**
+ * @brief Queue both buffers and start the timer.
+ * @return An error code that should be checked using the macro APP_ERROR_CHECK.
+ */
+ret_code_t accel_scan_start(void);
+
+/**
+ * @brief Stop the timer, dropping the scans of the unfinished batch.
+ */
+void accel_scan_stop(void);
+
+#endif // ACCEL_SCAN_H
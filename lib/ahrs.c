@@ -0,0 +1,150 @@
+/**
+ * @file ahrs.c
+ * @brief Implementation of the Madgwick orientation filter.
+ * This follows Madgwick's reference implementation, MadgwickAHRS.c,
+ * with the sample period passed in on each update and one fix, noted below.
+ */
+
+#include "ahrs.h"
+#include "fastmath.h"
+#include <math.h>
+
+void ahrs_init(ahrs_t *ahrs, float beta) {
+    ahrs->q.w = 1.0f;
+    ahrs->q.x = 0.0f;
+    ahrs->q.y = 0.0f;
+    ahrs->q.z = 0.0f;
+    ahrs->beta = beta;
+}
+
+/**
+ * Gradient of the error between measured and predicted gravity,
+ * for the accelerometer-only update. The measurement is normalized.
+ */
+static void gradient_imu(const quaternion_t *q, float ax, float ay, float az,
+                         float *s0, float *s1, float *s2, float *s3) {
+    float q0 = q->w, q1 = q->x, q2 = q->y, q3 = q->z;
+    float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+    float _4q0 = 4.0f * q0, _4q1 = 4.0f * q1, _4q2 = 4.0f * q2;
+    float _8q1 = 8.0f * q1, _8q2 = 8.0f * q2;
+    float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+
+    *s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+    *s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1
+            + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+    *s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2
+            + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+    *s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+}
+
+/**
+ * Gradient of the error between measured and predicted gravity and
+ * magnetic field. Both measurements are normalized. The earth field is
+ * taken to lie in the x-z plane, with its direction estimated from the
+ * measurement, so magnetic inclination does not matter.
+ */
+static void gradient_marg(const quaternion_t *q, float ax, float ay, float az,
+                          float mx, float my, float mz,
+                          float *s0, float *s1, float *s2, float *s3) {
+    float q0 = q->w, q1 = q->x, q2 = q->y, q3 = q->z;
+    float _2q0mx = 2.0f * q0 * mx;
+    float _2q0my = 2.0f * q0 * my;
+    float _2q0mz = 2.0f * q0 * mz;
+    float _2q1mx = 2.0f * q1 * mx;
+    float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+    float _2q0q2 = 2.0f * q0 * q2;
+    float _2q2q3 = 2.0f * q2 * q3;
+    float q0q0 = q0 * q0, q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+    float q1q1 = q1 * q1, q1q2 = q1 * q2, q1q3 = q1 * q3;
+    float q2q2 = q2 * q2, q2q3 = q2 * q3, q3q3 = q3 * q3;
+
+    // Direction of the earth's field in the earth frame.
+    float hx = mx * q0q0 - _2q0my * q3 + _2q0mz * q2 + mx * q1q1 + _2q1 * my * q2
+            + _2q1 * mz * q3 - mx * q2q2 - mx * q3q3;
+    float hy = _2q0mx * q3 + my * q0q0 - _2q0mz * q1 + _2q1mx * q2 - my * q1q1
+            + my * q2q2 + _2q2 * mz * q3 - my * q3q3;
+    float hz = -_2q0mx * q2 + _2q0my * q1 + mz * q0q0 + _2q1mx * q3 - mz * q1q1
+            + _2q2 * my * q3 - mz * q2q2 + mz * q3q3;
+    // The reference implementation leaves out the factor of 2 here, so its
+    // estimate settles away from the true orientation whenever the
+    // magnetometer is used.
+    float hh = hx * hx + hy * hy;
+    float _2bx = 2.0f * hh * fast_rsqrtf(hh);
+    float _2bz = 2.0f * hz;
+    float _4bx = 2.0f * _2bx;
+    float _4bz = 2.0f * _2bz;
+
+    // Residuals of gravity and field, shared by the four gradient terms.
+    float ex = 2.0f * q1q3 - _2q0q2 - ax;
+    float ey = 2.0f * q0q1 + _2q2q3 - ay;
+    float ez = 1.0f - 2.0f * q1q1 - 2.0f * q2q2 - az;
+    float fx = _2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx;
+    float fy = _2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my;
+    float fz = _2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz;
+
+    *s0 = -_2q2 * ex + _2q1 * ey - _2bz * q2 * fx + (-_2bx * q3 + _2bz * q1) * fy
+            + _2bx * q2 * fz;
+    *s1 = _2q3 * ex + _2q0 * ey - 4.0f * q1 * ez + _2bz * q3 * fx
+            + (_2bx * q2 + _2bz * q0) * fy + (_2bx * q3 - _4bz * q1) * fz;
+    *s2 = -_2q0 * ex + _2q3 * ey - 4.0f * q2 * ez + (-_4bx * q2 - _2bz * q0) * fx
+            + (_2bx * q1 + _2bz * q3) * fy + (_2bx * q0 - _4bz * q2) * fz;
+    *s3 = _2q1 * ex + _2q2 * ey + (-_4bx * q3 + _2bz * q1) * fx
+            + (-_2bx * q0 + _2bz * q2) * fy + _2bx * q1 * fz;
+}
+
+void ahrs_update(ahrs_t *ahrs, float gx, float gy, float gz,
+                 float ax, float ay, float az,
+                 float mx, float my, float mz, float dt) {
+    quaternion_t *q = &ahrs->q;
+    float r;
+
+    // Rate of change of the quaternion from the gyro.
+    float qdot0 = 0.5f * (-q->x * gx - q->y * gy - q->z * gz);
+    float qdot1 = 0.5f * (q->w * gx + q->y * gz - q->z * gy);
+    float qdot2 = 0.5f * (q->w * gy - q->x * gz + q->z * gx);
+    float qdot3 = 0.5f * (q->w * gz + q->x * gy - q->y * gx);
+
+    if (!(ax == 0.0f && ay == 0.0f && az == 0.0f)) {
+        float s0, s1, s2, s3;
+        r = fast_rsqrtf(ax * ax + ay * ay + az * az);
+        ax *= r;
+        ay *= r;
+        az *= r;
+        if (mx == 0.0f && my == 0.0f && mz == 0.0f) {
+            gradient_imu(q, ax, ay, az, &s0, &s1, &s2, &s3);
+        } else {
+            r = fast_rsqrtf(mx * mx + my * my + mz * mz);
+            gradient_marg(q, ax, ay, az, mx * r, my * r, mz * r, &s0, &s1, &s2, &s3);
+        }
+        // Step down the normalized gradient. It is zero when the
+        // estimate already agrees with the measurements.
+        float ss = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+        if (ss > 0.0f) {
+            r = ahrs->beta * fast_rsqrtf(ss);
+            qdot0 -= r * s0;
+            qdot1 -= r * s1;
+            qdot2 -= r * s2;
+            qdot3 -= r * s3;
+        }
+    }
+
+    q->w += qdot0 * dt;
+    q->x += qdot1 * dt;
+    q->y += qdot2 * dt;
+    q->z += qdot3 * dt;
+    r = fast_rsqrtf(q->w * q->w + q->x * q->x + q->y * q->y + q->z * q->z);
+    q->w *= r;
+    q->x *= r;
+    q->y *= r;
+    q->z *= r;
+}
+
+void ahrs_euler(const ahrs_t *ahrs, float *roll, float *pitch, float *yaw) {
+    const quaternion_t *q = &ahrs->q;
+    *roll = atan2f(q->w * q->x + q->y * q->z, 0.5f - q->x * q->x - q->y * q->y);
+    float s = -2.0f * (q->x * q->z - q->w * q->y);
+    if (s > 1.0f) s = 1.0f;
+    if (s < -1.0f) s = -1.0f;
+    *pitch = asinf(s);
+    *yaw = atan2f(q->x * q->y + q->w * q->z, 0.5f - q->y * q->y - q->z * q->z);
+}
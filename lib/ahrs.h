@@ -0,0 +1,76 @@
+/**
+ * @file ahrs.h
+ * @brief Orientation estimation (attitude and heading reference system)
+ * from accelerometer, gyroscope, and magnetometer readings, using the
+ * gradient-descent filter of Madgwick (S. Madgwick, "An efficient
+ * orientation filter for inertial and inertial/magnetic sensor arrays",
+ * 2010). Everything is single precision.
+ *
+ * The gyro rates are integrated as a quaternion, so rotations about all
+ * axes are combined correctly, and each update nudges the result toward
+ * the orientation in which gravity and the magnetic field point where
+ * the accelerometer and magnetometer say they do, which removes drift.
+ *
+ * Cost per update: about 250 floating-point operations and five
+ * reciprocal square roots with the magnetometer, and about 100 and three
+ * without it. ahrs_update() has no divisions or calls to libm.
+ */
+
+#ifndef AHRS_H
+#define AHRS_H
+
+/**
+ * @brief Unit quaternion w + xi + yj + zk. It rotates vectors from the
+ * sensor frame to the earth frame, whose z axis points up.
+ */
+typedef struct {
+    float w;
+    float x;
+    float y;
+    float z;
+} quaternion_t;
+
+/**
+ * @brief Filter state.
+ */
+typedef struct {
+    quaternion_t q; // Current estimate.
+    float beta;     // Gain of the correction toward gravity and magnetic north.
+} ahrs_t;
+
+/**
+ * @brief Initialize the filter at the identity orientation.
+ * @param ahrs The filter.
+ * @param beta Correction gain in radians per second. Larger values
+ *  converge faster but follow accelerometer noise more. Madgwick
+ *  suggests sqrt(3/4) times the gyro noise; 0.1 is a common choice.
+ */
+void ahrs_init(ahrs_t *ahrs, float beta);
+
+/**
+ * @brief Update the estimate with one set of readings.
+ * Readings in any units can be used for the accelerometer and
+ * magnetometer, since only their directions matter. If the magnetometer
+ * reading is all zeros, it is ignored and heading is from the gyro alone.
+ * If the accelerometer reading is all zeros, both are ignored.
+ * @param ahrs The filter.
+ * @param gx, gy, gz Angular rate in radians per second.
+ * @param ax, ay, az Acceleration, which points up at rest.
+ * @param mx, my, mz Magnetic field, in the same frame as the other two.
+ * @param dt Time since the previous update in seconds.
+ */
+void ahrs_update(ahrs_t *ahrs, float gx, float gy, float gz,
+                 float ax, float ay, float az,
+                 float mx, float my, float mz, float dt);
+
+/**
+ * @brief Get the orientation as Euler angles in radians, in the order
+ * yaw (about z), then pitch (about the new y), then roll (about the new x).
+ * @param ahrs The filter.
+ * @param roll In (-pi, pi].
+ * @param pitch In [-pi/2, pi/2].
+ * @param yaw In (-pi, pi].
+ */
+void ahrs_euler(const ahrs_t *ahrs, float *roll, float *pitch, float *yaw);
+
+#endif // AHRS_H
@@ -0,0 +1,235 @@
+/**
+ * @file binlog.c
+ * @brief Implementation of deferred binary logging.
+ *
+ * The ring is an array of words with two running counts of words, head,
+ * claimed by writers, and tail, released by the drain. Each record starts
+ * with a word holding its size in words, which the writer stores last,
+ * followed by the format pointer, the timestamp, and the arguments. A
+ * record that would run past the end of the array is preceded by padding
+ * to the end, marked with PAD in its first word. The drain zeroes
+ * each record before releasing it, so a zero first word means that a
+ * claimed record has not been written yet.
+ *
+ * Writers and the drain share one core, so compiler barriers are enough
+ * to order their stores; the compare-and-swap on head is what lets an
+ * interrupt handler log in the middle of another writer's claim.
+ */
+
+#include "binlog.h"
+#include <stdatomic.h>
+#include "app_timer.h"      // Defines app_timer_cnt_get()
+#include "nrf_drv_clock.h"  // Defines nrf_drv_clock_init()
+
+#if (BINLOG_RING_WORDS & (BINLOG_RING_WORDS - 1)) != 0
+#error "BINLOG_RING_WORDS must be a power of two"
+#endif
+
+#define MASK (BINLOG_RING_WORDS - 1)
+#define PAD 0x80000000u
+#define POINTER_WORDS (sizeof(binlog_format_t *) / sizeof(uint32_t))
+// Words of a record before its arguments.
+#define RECORD_WORDS (1 + POINTER_WORDS + 1)
+
+// The app_timer counter is the RTC counter, 24 bits wide.
+#define CLOCK_BITS 24
+#define CLOCK_MASK ((1u << CLOCK_BITS) - 1)
+// Time without messages after which the drain sends a BINLOG_CLOCK, a
+// quarter of the counter's period.
+#define CLOCK_INTERVAL (1u << (CLOCK_BITS - 2))
+
+// Largest encoding of one ring record: a format and a message.
+#define ENCODED_MAX (4 + BINLOG_FORMAT_MAX + 8 + 4 * BINLOG_MAX_ARGS)
+
+static uint32_t ring[BINLOG_RING_WORDS];
+static atomic_uint_fast32_t head;
+static atomic_uint_fast32_t tail;
+static atomic_uint_fast32_t written;
+static atomic_uint_fast32_t dropped;
+
+// State of the drain.
+static bool header_sent;
+static uint32_t dropped_sent;   // Value of dropped when BINLOG_LOST was last sent.
+static uint32_t last_timestamp; // Of the last message or BINLOG_CLOCK sent.
+static binlog_stats_t stats;
+// Counts the streams, so that formats sent in an earlier stream, before
+// binlog_reset(), are sent again with new ids. Never 0.
+static uint16_t generation = 1;
+
+static size_t put16(uint8_t *out, uint16_t value) {
+    out[0] = value;
+    out[1] = value >> 8;
+    return 2;
+}
+
+static size_t put32(uint8_t *out, uint32_t value) {
+    out[0] = value;
+    out[1] = value >> 8;
+    out[2] = value >> 16;
+    out[3] = value >> 24;
+    return 4;
+}
+
+static bool send(binlog_sink_t sink, void *context, const uint8_t *data, size_t length) {
+    if (!sink(data, length, context)) return false;
+    stats.bytes += length;
+    return true;
+}
+
+ret_code_t binlog_init(void) {
+    ret_code_t error_code = nrf_drv_clock_init();
+    if (error_code != NRF_SUCCESS && error_code != NRF_ERROR_MODULE_ALREADY_INITIALIZED) {
+        return error_code;
+    }
+    nrf_drv_clock_lfclk_request(NULL);
+    error_code = app_timer_init();
+    if (error_code != NRF_SUCCESS && error_code != NRF_ERROR_MODULE_ALREADY_INITIALIZED) {
+        return error_code;
+    }
+    return NRF_SUCCESS;
+}
+
+void binlog_reset(void) {
+    memset(ring, 0, sizeof(ring));
+    atomic_store(&head, 0);
+    atomic_store(&tail, 0);
+    atomic_store(&written, 0);
+    atomic_store(&dropped, 0);
+    header_sent = false;
+    dropped_sent = 0;
+    last_timestamp = app_timer_cnt_get();
+    memset(&stats, 0, sizeof(stats));
+    if (++generation == 0) generation = 1;
+}
+
+bool binlog_write(binlog_format_t *format, const uint32_t *args) {
+    uint32_t timestamp = app_timer_cnt_get();
+    uint32_t size = RECORD_WORDS + format->args;
+
+    // Claim size words, with padding first if they would not fit before
+    // the end of the ring.
+    uint_fast32_t start = atomic_load_explicit(&head, memory_order_relaxed);
+    uint32_t offset, pad;
+    do {
+        offset = start & MASK;
+        pad = offset + size > BINLOG_RING_WORDS ? BINLOG_RING_WORDS - offset : 0;
+        if (start + pad + size - atomic_load_explicit(&tail, memory_order_relaxed) > BINLOG_RING_WORDS) {
+            atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&head, &start, start + pad + size,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    if (pad) {
+        ((volatile uint32_t *)ring)[offset] = PAD | pad;
+        offset = 0;
+    }
+
+    uint32_t *record = &ring[offset];
+    memcpy(record + 1, &format, sizeof(format));
+    record[1 + POINTER_WORDS] = timestamp;
+    for (uint32_t i = 0; i < format->args; i++) {
+        record[RECORD_WORDS + i] = args[i];
+    }
+    // Publish the record only once the rest of it is in place.
+    atomic_signal_fence(memory_order_release);
+    ((volatile uint32_t *)ring)[offset] = size;
+    atomic_fetch_add_explicit(&written, 1, memory_order_relaxed);
+    return true;
+}
+
+// Encode a message, preceded by its format if that has not been sent.
+static size_t encode(uint8_t *out, binlog_format_t const *format, bool sent, uint16_t id,
+                     uint32_t timestamp, const uint32_t *args) {
+    size_t length = 0;
+    if (!sent) {
+        size_t text_length = strlen(format->text);
+        if (text_length > BINLOG_FORMAT_MAX) text_length = BINLOG_FORMAT_MAX;
+        out[length++] = BINLOG_FORMAT;
+        length += put16(out + length, id);
+        out[length++] = text_length;
+        memcpy(out + length, format->text, text_length);
+        length += text_length;
+    }
+    out[length++] = BINLOG_MESSAGE;
+    length += put16(out + length, id);
+    length += put32(out + length, timestamp);
+    out[length++] = format->args;
+    for (uint32_t i = 0; i < format->args; i++) {
+        length += put32(out + length, args[i]);
+    }
+    return length;
+}
+
+size_t binlog_drain(binlog_sink_t sink, void *context, size_t budget) {
+    uint8_t out[ENCODED_MAX];
+    uint32_t start_bytes = stats.bytes;
+
+    if (!header_sent) {
+        memcpy(out, "LFBL", 4);
+        out[4] = BINLOG_VERSION;
+        out[5] = BINLOG_HEADER_SIZE;
+        out[6] = CLOCK_BITS;
+        out[7] = 0;
+        put32(out + 8, APP_TIMER_CLOCK_FREQ);
+        if (!send(sink, context, out, BINLOG_HEADER_SIZE)) return 0;
+        header_sent = true;
+    }
+
+    uint32_t lost = atomic_load_explicit(&dropped, memory_order_relaxed) - dropped_sent;
+    if (lost > 0) {
+        out[0] = BINLOG_LOST;
+        put32(out + 1, lost);
+        if (!send(sink, context, out, 5)) return stats.bytes - start_bytes;
+        dropped_sent += lost;
+    }
+
+    uint32_t used = atomic_load_explicit(&head, memory_order_relaxed)
+            - atomic_load_explicit(&tail, memory_order_relaxed);
+    if (used > stats.peak) stats.peak = used;
+
+    bool sent_message = false;
+    while (stats.bytes - start_bytes < budget) {
+        uint_fast32_t position = atomic_load_explicit(&tail, memory_order_relaxed);
+        uint32_t offset = position & MASK;
+        uint32_t first = ((volatile uint32_t *)ring)[offset];
+        if (first == 0) break; // Empty, or claimed but not written yet.
+        atomic_signal_fence(memory_order_acquire);
+
+        uint32_t size = first & ~PAD;
+        if (!(first & PAD)) {
+            binlog_format_t *format;
+            memcpy(&format, &ring[offset + 1], sizeof(format));
+            uint32_t timestamp = ring[offset + 1 + POINTER_WORDS];
+            bool sent = format->generation == generation;
+            uint16_t id = sent ? format->id : stats.formats + 1;
+            size_t length = encode(out, format, sent, id, timestamp,
+                                   &ring[offset + RECORD_WORDS]);
+            if (!send(sink, context, out, length)) break;
+            if (!sent) {
+                format->id = id;
+                format->generation = generation;
+                stats.formats++;
+            }
+            stats.drained++;
+            last_timestamp = timestamp;
+            sent_message = true;
+        }
+        memset(&ring[offset], 0, size * sizeof(uint32_t));
+        atomic_signal_fence(memory_order_release);
+        atomic_store_explicit(&tail, position + size, memory_order_relaxed);
+    }
+
+    uint32_t now = app_timer_cnt_get();
+    if (!sent_message && ((now - last_timestamp) & CLOCK_MASK) >= CLOCK_INTERVAL) {
+        out[0] = BINLOG_CLOCK;
+        put32(out + 1, now);
+        if (send(sink, context, out, 5)) last_timestamp = now;
+    }
+    return stats.bytes - start_bytes;
+}
+
+void binlog_stats(binlog_stats_t *result) {
+    *result = stats;
+    result->written = atomic_load(&written);
+    result->dropped = atomic_load(&dropped);
+}
@@ -0,0 +1,194 @@
+/**
+ * @file binlog.h
+ * @brief Deferred binary logging, for logging from reactions and
+ * interrupt handlers at the cost of a few stores rather than printf.
+ *
+ * BINLOG() works like printf(), but formats nothing. It puts a pointer to
+ * the format string, the app_timer counter, and the arguments as 32-bit
+ * words into a RAM ring, and returns. binlog_drain(), called when there
+ * is nothing more urgent to do, turns what is in the ring into a compact
+ * stream for a sink such as RTT, and scripts/binlog_decode.py turns the
+ * stream back into text on the host:
+ *
+ *     BINLOG("tilt xz:%.2f yz:%.2f", xz, yz);
+ *
+ * Arguments are integers of up to 32 bits, chars, or floats (doubles are
+ * logged as floats), at most BINLOG_MAX_ARGS of them. Strings and other
+ * pointers do not compile, since what they point to may be gone by the
+ * time the ring is drained; the format string itself must be a literal.
+ *
+ * Any number of writers, at any interrupt priority, can log at once
+ * without disabling interrupts: space in the ring is claimed with a
+ * compare-and-swap, and a record only becomes visible to the drain when
+ * its first word is written, after the rest. When the ring is full,
+ * messages are dropped and counted, and the stream reports how many.
+ * This relies on the writers and the drain running on one core, as on
+ * the nRF52 and in the single-threaded LF runtime.
+ *
+ * The stream is a 12-byte header followed by records. The header is the
+ * magic "LFBL", a version byte, the header size, the number of bits in
+ * the timestamps, a reserved byte, and the timestamp ticks per second as
+ * a little-endian uint32. Each record is a type byte and then, with
+ * multi-byte values little endian:
+ *
+ *  - BINLOG_FORMAT: a uint16 format id, a length byte, and the format
+ *    string, without a terminating zero. Each format is sent once,
+ *    before its first message.
+ *  - BINLOG_MESSAGE: the uint16 format id, the uint32 timestamp, the
+ *    number of arguments, and the arguments, each a 32-bit word.
+ *  - BINLOG_LOST: the uint32 number of messages dropped since the last
+ *    BINLOG_LOST.
+ *  - BINLOG_CLOCK: a uint32 timestamp, sent when there have been no
+ *    messages for a while, so that the decoder can follow the counter
+ *    as it wraps.
+ */
+
+#ifndef BINLOG_H
+#define BINLOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "sdk_errors.h"
+
+#define BINLOG_VERSION 1
+#define BINLOG_HEADER_SIZE 12
+#define BINLOG_MAX_ARGS 6
+// Longest format string sent; longer ones are cut short.
+#define BINLOG_FORMAT_MAX 255
+
+// Size of the ring in 32-bit words, a power of two. A message with n
+// arguments takes 3 + n words, or 4 + n with 64-bit pointers.
+#ifndef BINLOG_RING_WORDS
+#define BINLOG_RING_WORDS 256
+#endif
+
+/**
+ * @brief Record types, which are the first byte of each record.
+ */
+typedef enum {
+    BINLOG_FORMAT = 1,
+    BINLOG_MESSAGE = 2,
+    BINLOG_LOST = 3,
+    BINLOG_CLOCK = 4,
+} binlog_type_t;
+
+/**
+ * @brief A format string and what the drain knows about it. BINLOG()
+ * makes one of these for each call site.
+ */
+typedef struct {
+    const char *text;
+    uint8_t args; // Number of arguments.
+    uint16_t id;  // Assigned when first sent.
+    uint16_t generation; // Stream the id belongs to, 0 until first sent.
+} binlog_format_t;
+
+/**
+ * @brief Counters since the start of the program or binlog_reset().
+ */
+typedef struct {
+    uint32_t written;  // Messages put into the ring.
+    uint32_t dropped;  // Messages dropped because the ring was full.
+    uint32_t drained;  // Messages sent to the sink.
+    uint32_t bytes;    // Bytes sent to the sink.
+    uint32_t peak;     // Most words in use that binlog_drain() has found.
+    uint16_t formats;  // Format strings sent.
+} binlog_stats_t;
+
+/**
+ * @brief Function that stores or sends encoded bytes.
+ * @param data The bytes, which are only valid during the call.
+ * @param length The number of bytes.
+ * @param context The context given to binlog_drain().
+ * @return true if it took all the bytes, false if it took none of them,
+ *  in which case they are offered again on the next drain.
+ */
+typedef bool (*binlog_sink_t)(const uint8_t *data, size_t length, void *context);
+
+/**
+ * @brief Start the app_timer that gives the timestamps, unless that has
+ * been done already. The ring needs no setting up, so messages logged
+ * before this are kept, with a timestamp of 0.
+ * @return An error code that should be checked using the macro APP_ERROR_CHECK.
+ */
+ret_code_t binlog_init(void);
+
+/**
+ * @brief Empty the ring and reset the counters. A new stream, with its
+ * header and format strings, starts with the next binlog_drain().
+ * Nothing may log during the call.
+ */
+void binlog_reset(void);
+
+/**
+ * @brief Put a message into the ring. Use BINLOG() rather than calling this.
+ * @param format The format, with the number of arguments.
+ * @param args The arguments.
+ * @return false if the ring was full and the message was dropped.
+ */
+bool binlog_write(binlog_format_t *format, const uint32_t *args);
+
+/**
+ * @brief Encode messages from the ring and give them to the sink, oldest
+ * first, until the ring is empty, the sink refuses a record, or at least
+ * `budget` bytes have gone to the sink.
+ * @param sink The function that gets the encoded bytes, a record or two
+ *  at a time.
+ * @param context Passed to the sink.
+ * @param budget The number of bytes after which to stop.
+ * @return The number of bytes given to the sink.
+ */
+size_t binlog_drain(binlog_sink_t sink, void *context, size_t budget);
+
+/**
+ * @brief Get the counters since the start of the program or binlog_reset().
+ * @param stats The struct into which to write the counters.
+ */
+void binlog_stats(binlog_stats_t *stats);
+
+/**
+ * @brief The bits of a float, for logging it in a 32-bit word.
+ */
+static inline uint32_t binlog_float(float value) {
+    uint32_t word;
+    memcpy(&word, &value, sizeof(word));
+    return word;
+}
+
+/**
+ * @brief Log a message. See the description at the top of this file.
+ */
+#define BINLOG(...) BINLOG_CAT(BINLOG_, BINLOG_COUNT(__VA_ARGS__))(__VA_ARGS__)
+
+// Helpers for BINLOG(), which count the arguments after the format and
+// turn each into a word.
+#define BINLOG_COUNT(...) BINLOG_COUNT_(__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0, _)
+#define BINLOG_COUNT_(format, a1, a2, a3, a4, a5, a6, n, ...) n
+#define BINLOG_CAT(a, b) BINLOG_CAT_(a, b)
+#define BINLOG_CAT_(a, b) a##b
+#define BINLOG_WORD(x) _Generic((x), \
+    float: binlog_float((float)(x)), \
+    double: binlog_float((float)(x)), \
+    default: (uint32_t)(x))
+#define BINLOG_WRITE(format, count, ...) do { \
+    static binlog_format_t _binlog_format = {format, count, 0, 0}; \
+    const uint32_t _binlog_args[] = {__VA_ARGS__}; \
+    binlog_write(&_binlog_format, _binlog_args); \
+} while (0)
+#define BINLOG_0(format) BINLOG_WRITE(format, 0, 0)
+#define BINLOG_1(format, a) BINLOG_WRITE(format, 1, BINLOG_WORD(a))
+#define BINLOG_2(format, a, b) BINLOG_WRITE(format, 2, BINLOG_WORD(a), BINLOG_WORD(b))
+#define BINLOG_3(format, a, b, c) \
+    BINLOG_WRITE(format, 3, BINLOG_WORD(a), BINLOG_WORD(b), BINLOG_WORD(c))
+#define BINLOG_4(format, a, b, c, d) \
+    BINLOG_WRITE(format, 4, BINLOG_WORD(a), BINLOG_WORD(b), BINLOG_WORD(c), BINLOG_WORD(d))
+#define BINLOG_5(format, a, b, c, d, e) \
+    BINLOG_WRITE(format, 5, BINLOG_WORD(a), BINLOG_WORD(b), BINLOG_WORD(c), BINLOG_WORD(d), \
+                 BINLOG_WORD(e))
+#define BINLOG_6(format, a, b, c, d, e, f) \
+    BINLOG_WRITE(format, 6, BINLOG_WORD(a), BINLOG_WORD(b), BINLOG_WORD(c), BINLOG_WORD(d), \
+                 BINLOG_WORD(e), BINLOG_WORD(f))
+
+#endif // BINLOG_H
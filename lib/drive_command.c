@@ -0,0 +1,55 @@
+/**
+ * @file drive_command.c
+ * @brief Implementation of drive command decoding.
+ */
+
+#include "drive_command.h"
+
+int drive_command_decode(const uint8_t *data, size_t length) {
+    uint8_t keys;
+    if (length == 1) {
+        keys = data[0];
+        if (keys & ~(DRIVE_KEY_UP | DRIVE_KEY_DOWN | DRIVE_KEY_LEFT | DRIVE_KEY_RIGHT)) return -1;
+    } else if (length == 4) {
+        keys = 0;
+        for (int i = 0; i < 4; i++) {
+            if (data[i] > 1) return -1;
+            keys |= data[i] << i;
+        }
+    } else {
+        return -1;
+    }
+
+    if (keys & DRIVE_KEY_UP) return DRIVE_FORWARD;
+    if (keys & DRIVE_KEY_DOWN) return DRIVE_BACKWARD;
+    if (keys & DRIVE_KEY_LEFT) return DRIVE_LEFT;
+    if (keys & DRIVE_KEY_RIGHT) return DRIVE_RIGHT;
+    return DRIVE_STOP;
+}
+
+void drive_command_filter_init(drive_command_filter_t *filter) {
+    filter->command = DRIVE_STOP;
+    filter->writes = 0;
+    filter->changes = 0;
+    filter->invalid = 0;
+}
+
+bool drive_command_filter_write(drive_command_filter_t *filter, const uint8_t *data,
+                                size_t length, drive_command_t *command) {
+    filter->writes++;
+    int decoded = drive_command_decode(data, length);
+    if (decoded < 0) {
+        filter->invalid++;
+        return false;
+    }
+    if (!drive_command_filter_set(filter, decoded)) return false;
+    *command = decoded;
+    return true;
+}
+
+bool drive_command_filter_set(drive_command_filter_t *filter, drive_command_t command) {
+    if (command == filter->command) return false;
+    filter->command = command;
+    filter->changes++;
+    return true;
+}
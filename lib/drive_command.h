@@ -0,0 +1,91 @@
+/**
+ * @file drive_command.h
+ * @brief Decoding of drive commands written over BLE, keeping only the
+ * writes that change the command.
+ *
+ * A client writes the arrow keys it holds down as one byte of key bits
+ * (DRIVE_KEY_UP etc.). The older form, four bytes of booleans for up,
+ * down, left, and right, is also accepted. When several keys are down,
+ * the first of up, down, left, and right decides the command.
+ *
+ * Clients write on every key event, including key repeats, and most
+ * writes do not change the command. The filter lets a BLE write handler
+ * pass on only the changes, so that the reactors do nothing while the
+ * command stays the same. It touches no hardware, so it can be called
+ * from the SoftDevice's event handler and tested on the host alike.
+ */
+
+#ifndef DRIVE_COMMAND_H
+#define DRIVE_COMMAND_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Bits of the one-byte form.
+#define DRIVE_KEY_UP 0x01
+#define DRIVE_KEY_DOWN 0x02
+#define DRIVE_KEY_LEFT 0x04
+#define DRIVE_KEY_RIGHT 0x08
+
+/**
+ * @brief What the robot should do.
+ */
+typedef enum {
+    DRIVE_STOP = 0,
+    DRIVE_FORWARD,
+    DRIVE_BACKWARD,
+    DRIVE_LEFT,
+    DRIVE_RIGHT,
+} drive_command_t;
+
+/**
+ * @brief Filter state, set up by drive_command_filter_init(). The filter
+ * compares each write with command; the counts only describe the client.
+ */
+typedef struct {
+    drive_command_t command; // The last command passed on.
+
+    uint32_t writes;  // Writes seen, valid or not.
+    uint32_t changes; // Commands passed on.
+    uint32_t invalid; // Writes of neither form, which are ignored.
+} drive_command_filter_t;
+
+/**
+ * @brief Decode a write.
+ *
+ * @param data The bytes written.
+ * @param length The number of bytes.
+ * @return The command, or -1 if the write is of neither form.
+ */
+int drive_command_decode(const uint8_t *data, size_t length);
+
+/**
+ * @brief Initialize a filter, with DRIVE_STOP as the current command and
+ * zero counters.
+ */
+void drive_command_filter_init(drive_command_filter_t *filter);
+
+/**
+ * @brief Decode a write and check whether it changes the command.
+ *
+ * @param filter The filter.
+ * @param data The bytes written.
+ * @param length The number of bytes.
+ * @param command Set to the new command if it changed.
+ * @return true if the command changed and should be passed on.
+ */
+bool drive_command_filter_write(drive_command_filter_t *filter, const uint8_t *data,
+                                size_t length, drive_command_t *command);
+
+/**
+ * @brief Set the command without a write, for example to stop when the
+ * client disconnects.
+ *
+ * @param filter The filter.
+ * @param command The command.
+ * @return true if the command changed and should be passed on.
+ */
+bool drive_command_filter_set(drive_command_filter_t *filter, drive_command_t command);
+
+#endif // DRIVE_COMMAND_H
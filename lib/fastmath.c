@@ -0,0 +1,77 @@
+/**
+ * @file fastmath.c
+ * @brief Implementation of the fast math approximations.
+ */
+
+#include "fastmath.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#define PI_F 3.14159265f
+#define HALF_PI_F 1.57079633f
+#define TWO_PI_F 6.28318531f
+
+/**
+ * Arctangent of z for |z| <= 1, with a minimax polynomial in z^2.
+ */
+static float atan_unit(float z) {
+    float z2 = z * z;
+    return z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f
+            + z2 * (-0.11643287f + z2 * (0.05265332f + z2 * -0.01172120f)))));
+}
+
+float fast_atan2f(float y, float x) {
+    float ax = fabsf(x);
+    float ay = fabsf(y);
+    if (ax == 0 && ay == 0) return 0;
+    // Keep the polynomial argument in [-1, 1] using atan(z) = pi/2 - atan(1/z).
+    float a;
+    if (ay <= ax) {
+        a = atan_unit(ay / ax);
+    } else {
+        a = HALF_PI_F - atan_unit(ax / ay);
+    }
+    if (x < 0) a = PI_F - a;
+    return (y < 0) ? -a : a;
+}
+
+float fast_rsqrtf(float x) {
+    uint32_t i;
+    float half = 0.5f * x;
+    memcpy(&i, &x, sizeof(i));
+    i = 0x5F375A86 - (i >> 1);
+    float r;
+    memcpy(&r, &i, sizeof(r));
+    r = r * (1.5f - half * r * r);
+    r = r * (1.5f - half * r * r);
+    return r;
+}
+
+float fast_cosf(float x) {
+    // Reduce to [-pi, pi], then to [0, pi/2] using cos(pi - x) = -cos(x).
+    x = fabsf(x);
+    if (x > PI_F) {
+        x -= TWO_PI_F * floorf((x + PI_F) / TWO_PI_F);
+        x = fabsf(x);
+    }
+    float sign = 1.0f;
+    if (x > HALF_PI_F) {
+        x = PI_F - x;
+        sign = -1.0f;
+    }
+    // Taylor series to x^10, whose first omitted term is below 5e-8 at pi/2.
+    float x2 = x * x;
+    float c = 1.0f + x2 * (-1.0f / 2 + x2 * (1.0f / 24 + x2 * (-1.0f / 720
+            + x2 * (1.0f / 40320 + x2 * (-1.0f / 3628800)))));
+    return sign * c;
+}
+
+float fast_acosf(float x) {
+    if (x > 1.0f) x = 1.0f;
+    if (x < -1.0f) x = -1.0f;
+    float ax = fabsf(x);
+    float a = sqrtf(1.0f - ax) * (1.5707288f + ax * (-0.2121144f
+            + ax * (0.0742610f + ax * -0.0187293f)));
+    return (x < 0) ? PI_F - a : a;
+}
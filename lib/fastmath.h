@@ -0,0 +1,45 @@
+/**
+ * @file fastmath.h
+ * @brief Fast single-precision approximations of the math functions
+ * used to turn IMU readings into angles.
+ *
+ * Each function has a documented bound on its error, measured over its
+ * whole domain by test/host/fastmath_test.c. On the Cortex-M4F they avoid
+ * the libm argument reduction and, unlike sqrt() and friends called with
+ * float arguments, any double-precision arithmetic, which has no hardware
+ * support there.
+ */
+
+#ifndef FASTMATH_H
+#define FASTMATH_H
+
+/**
+ * @brief Four-quadrant arctangent of y/x in radians, in [-pi, pi].
+ * Maximum absolute error 2e-6 radians. Returns 0 if both arguments are 0.
+ */
+float fast_atan2f(float y, float x);
+
+/**
+ * @brief 1/sqrt(x) for x > 0, using the bit-level initial guess and two
+ * Newton steps. Maximum relative error 5e-6.
+ * Returns a large finite number, about 2e19, for x = 0,
+ * so that x * fast_rsqrtf(x) is 0.
+ */
+float fast_rsqrtf(float x);
+
+/**
+ * @brief Cosine of x in radians.
+ * Maximum absolute error 1e-6 for |x| <= 2 pi. Beyond that the error
+ * grows with |x| because the argument reduction is done in float,
+ * to about 2e-6 at 10 pi.
+ */
+float fast_cosf(float x);
+
+/**
+ * @brief Arccosine of x in radians, in [0, pi], for x in [-1, 1].
+ * Arguments outside that range are clamped to it.
+ * Maximum absolute error 7e-5 radians (Abramowitz and Stegun 4.4.45).
+ */
+float fast_acosf(float x);
+
+#endif // FASTMATH_H
@@ -10,51 +10,125 @@
        __typeof__ (b) _b = (b); \
      _a < _b ? _a : _b; })
 
+// Bytes of sample storage currently held by delay lines and filter state.
+static size_t filter_bytes_in_use = 0;
+
+#ifdef FILTER_STATIC_POOL
+// Storage handed out by line_alloc() instead of the heap.
+static float filter_pool[FILTER_POOL_LEN];
+static size_t filter_pool_next = 0;
+#endif
+
+/**
+ * Allocate zeroed storage for `n` samples, from the static pool if
+ * FILTER_STATIC_POOL is defined and from the heap otherwise.
+ * Return NULL if there is not enough memory.
+ */
+static float *line_alloc(size_t n) {
+    float *buf;
+#ifdef FILTER_STATIC_POOL
+    if (n > FILTER_POOL_LEN - filter_pool_next) return NULL;
+    // the pool is zero initialized and never reused
+    buf = filter_pool + filter_pool_next;
+    filter_pool_next += n;
+#else
+    buf = (float *) calloc(n, sizeof(float));
+    if (!buf) return NULL;
+#endif
+    filter_bytes_in_use += n * sizeof(float);
+    return buf;
+}
+
+/**
+ * Release storage for `n` samples obtained from line_alloc().
+ * Pool storage is not reclaimed, so it stays counted as in use.
+ */
+static void line_free(float *buf, size_t n) {
+    if (!buf) return;
+#ifndef FILTER_STATIC_POOL
+    free(buf);
+    filter_bytes_in_use -= n * sizeof(float);
+#endif
+}
+
+/**
+ * Return `len - 1` if `len` is a power of two greater than one, else 0.
+ */
+static size_t wrap_mask(size_t len) {
+    return (len > 1 && (len & (len - 1)) == 0) ? len - 1 : 0;
+}
+
 int create_line(delay_line_t *line, size_t len) {
-    if (!line) return -1;
+    if (!line || len == 0) return -1;
     // allocate buffer
-    line->head = (float *) calloc(len, sizeof(float));
+    line->head = line_alloc(len);
     if (!line->head) return -1;
     line->len = len;
+    line->mask = wrap_mask(len);
     // set curr pointer to start of buffer
     line->curr = line->head;
     return 0;
 }
 
+int init_line(delay_line_t *line, float *storage, size_t len) {
+    if (!line || !storage || len == 0) return -1;
+    // the line starts out holding zero samples, as with create_line()
+    for (size_t i = 0; i < len; i++) {
+        storage[i] = 0;
+    }
+    line->head = storage;
+    line->curr = storage;
+    line->len = len;
+    line->mask = wrap_mask(len);
+    filter_bytes_in_use += len * sizeof(float);
+    return 0;
+}
+
 int destroy_line(delay_line_t *line) {
     if (!line) return -1;
     // free buffer
-    free(line->head);
+    line_free(line->head, line->len);
     // set struct to empty
     line->head = NULL;
     line->curr = NULL;
     line->len = 0;
+    line->mask = 0;
     return 0;
 }
 
 int push(delay_line_t *line, float x) {
     float *tail;
     if (!line) return -1;
-    // set value
-    *line->curr = x;
-    // increment pointer
-    line->curr++;
-    tail = line->head + line->len - 1;
-    // wrap pointer if exceeds tail
-    if (line->curr > tail) {
-        line->curr = line->head;
+    if (line->mask) {
+        // power-of-two length, wrap without a branch
+        line->curr = line->head + ((line->curr - line->head + 1) & line->mask);
+    } else {
+        // increment pointer
+        line->curr++;
+        tail = line->head + line->len - 1;
+        // wrap pointer if exceeds tail
+        if (line->curr > tail) {
+            line->curr = line->head;
+        }
     }
+    // set value, so curr always refers to the n=0 sample
+    *line->curr = x;
     return 0;
 }
 
 int get(delay_line_t *line, size_t n, float *x) {
     float *ptr;
     if (n >= line->len) return -1;
-    // subtract offset from curr
-    ptr = line->curr - n;
-    // wrap if less than head
-    if (ptr < line->head) {
-        ptr = line->len + ptr;
+    if (line->mask) {
+        // power-of-two length, wrap without a branch
+        ptr = line->head + ((line->curr - line->head - n) & line->mask);
+    } else {
+        // subtract offset from curr
+        ptr = line->curr - n;
+        // wrap if less than head
+        if (ptr < line->head) {
+            ptr = line->len + ptr;
+        }
     }
     // set value
     *x = *(ptr);
@@ -71,16 +145,456 @@ float sum_line(delay_line_t *line) {
     return sum;
 }
 
+int create_avg_line(avg_line_t *line, size_t len) {
+    if (!line || len == 0) return -1;
+    if (create_line(&line->line, len)) return -1;
+    line->sum = 0;
+    line->comp = 0;
+    line->count = 0;
+    return 0;
+}
+
+int init_avg_line(avg_line_t *line, float *storage, size_t len) {
+    if (!line) return -1;
+    if (init_line(&line->line, storage, len)) return -1;
+    line->sum = 0;
+    line->comp = 0;
+    line->count = 0;
+    return 0;
+}
+
+int destroy_avg_line(avg_line_t *line) {
+    if (!line) return -1;
+    destroy_line(&line->line);
+    line->sum = 0;
+    line->comp = 0;
+    line->count = 0;
+    return 0;
+}
+
+/**
+ * Add `x` to `*sum` using Kahan summation with compensation term `*comp`.
+ * NOTE: This relies on strict IEEE float semantics;
+ * it must not be compiled with -ffast-math.
+ */
+static inline void kahan_add(float *sum, float *comp, float x) {
+    float y = x - *comp;
+    float t = *sum + y;
+    *comp = (t - *sum) - y;
+    *sum = t;
+}
+
+int push_avg(avg_line_t *line, float x) {
+    if (!line) return -1;
+    delay_line_t *dl = &line->line;
+    // the slot after curr holds the oldest sample, which x replaces
+    float evicted;
+    if (dl->mask) {
+        evicted = dl->head[(dl->curr - dl->head + 1) & dl->mask];
+    } else {
+        evicted = (dl->curr + 1 > dl->head + dl->len - 1) ? *dl->head : dl->curr[1];
+    }
+    push(dl, x);
+    if (++line->count >= AVG_LINE_RESYNC * dl->len) {
+        // recompute from scratch to discard accumulated rounding error
+        line->sum = 0;
+        line->comp = 0;
+        line->count = 0;
+        for (size_t i = 0; i < dl->len; i++) {
+            kahan_add(&line->sum, &line->comp, dl->head[i]);
+        }
+    } else {
+        kahan_add(&line->sum, &line->comp, x);
+        kahan_add(&line->sum, &line->comp, -evicted);
+    }
+    return 0;
+}
+
+float avg_line_sum(avg_line_t *line) {
+    return line->sum;
+}
+
 float fir_filter(delay_line_t *line, float *b, size_t b_size) {
     // perform convolution
     // zero pad h to fit size of x
-    float xi;
+    float xi = 0;
     size_t n = min(line->len, b_size);
     float sum = 0;
+    if (line->mask) {
+        // power-of-two length, index the buffer directly
+        size_t curr = line->curr - line->head;
+        for (size_t i = 0; i < n; i++) {
+            sum += b[i] * line->head[(curr - i) & line->mask];
+        }
+        return sum;
+    }
     for (size_t i = 0; i < n; i++) {
         // get the ith value before current
         get(line, i, &xi);
         sum += b[i] * xi;
     }
     return sum;
-}
\ No newline at end of file
+}
+
+int create_mirror_line(mirror_line_t *line, size_t len) {
+    if (!line || len == 0) return -1;
+    // allocate both copies of the buffer
+    line->head = line_alloc(2 * len);
+    if (!line->head) return -1;
+    line->len = len;
+    line->mask = wrap_mask(len);
+    line->newest = 0;
+    return 0;
+}
+
+int init_mirror_line(mirror_line_t *line, float *storage, size_t len) {
+    if (!line || !storage || len == 0) return -1;
+    for (size_t i = 0; i < 2 * len; i++) {
+        storage[i] = 0;
+    }
+    line->head = storage;
+    line->len = len;
+    line->mask = wrap_mask(len);
+    line->newest = 0;
+    filter_bytes_in_use += 2 * len * sizeof(float);
+    return 0;
+}
+
+int destroy_mirror_line(mirror_line_t *line) {
+    if (!line) return -1;
+    line_free(line->head, 2 * line->len);
+    line->head = NULL;
+    line->newest = 0;
+    line->len = 0;
+    line->mask = 0;
+    return 0;
+}
+
+/**
+ * Return the index of the slot before `newest` in a mirrored delay line,
+ * wrapping to the end of the first copy.
+ */
+static inline size_t mirror_step(const mirror_line_t *line, size_t newest) {
+    if (line->mask) return (newest - 1) & line->mask;
+    return (newest == 0) ? line->len - 1 : newest - 1;
+}
+
+int push_mirror(mirror_line_t *line, float x) {
+    if (!line) return -1;
+    // step back one slot
+    line->newest = mirror_step(line, line->newest);
+    // write both copies so [newest, newest + len) stays contiguous
+    line->head[line->newest] = x;
+    line->head[line->newest + line->len] = x;
+    return 0;
+}
+
+/**
+ * Dot product of two contiguous arrays.
+ * Four partial sums break the dependency chain on the accumulator,
+ * which lets the FPU pipeline consecutive multiply-accumulates.
+ */
+static inline float dot(const float *b, const float *x, size_t n) {
+    float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += b[i] * x[i];
+        s1 += b[i + 1] * x[i + 1];
+        s2 += b[i + 2] * x[i + 2];
+        s3 += b[i + 3] * x[i + 3];
+    }
+    for (; i < n; i++) {
+        s0 += b[i] * x[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+float fir_filter_mirror(mirror_line_t *line, const float *b, size_t b_size) {
+    // newest sample first, so taps line up with b directly
+    return dot(b, line->head + line->newest, min(line->len, b_size));
+}
+
+int fir_filter_block(mirror_line_t *line, const float *b, size_t b_size,
+                     const float *x, float *y, size_t n) {
+    if (!line || !b || !x || !y) return -1;
+    size_t len = line->len;
+    size_t taps = min(len, b_size);
+    float *head = line->head;
+    size_t newest = line->newest;
+    for (size_t k = 0; k < n; k++) {
+        newest = mirror_step(line, newest);
+        head[newest] = x[k];
+        head[newest + len] = x[k];
+        y[k] = dot(b, head + newest, taps);
+    }
+    line->newest = newest;
+    return 0;
+}
+
+int create_biquad(biquad_t *bq, const float *coeffs, size_t sections) {
+    if (!bq || !coeffs || sections == 0) return -1;
+    bq->state = line_alloc(2 * sections);
+    if (!bq->state) return -1;
+    bq->coeffs = coeffs;
+    bq->sections = sections;
+    return 0;
+}
+
+int init_biquad(biquad_t *bq, const float *coeffs, float *state, size_t sections) {
+    if (!bq || !coeffs || !state || sections == 0) return -1;
+    for (size_t i = 0; i < 2 * sections; i++) {
+        state[i] = 0;
+    }
+    bq->coeffs = coeffs;
+    bq->state = state;
+    bq->sections = sections;
+    filter_bytes_in_use += 2 * sections * sizeof(float);
+    return 0;
+}
+
+int destroy_biquad(biquad_t *bq) {
+    if (!bq) return -1;
+    line_free(bq->state, 2 * bq->sections);
+    bq->coeffs = NULL;
+    bq->state = NULL;
+    bq->sections = 0;
+    return 0;
+}
+
+float biquad_filter(biquad_t *bq, float x) {
+    const float *c = bq->coeffs;
+    float *s = bq->state;
+    for (size_t k = 0; k < bq->sections; k++, c += 5, s += 2) {
+        // transposed direct form II
+        float y = c[0] * x + s[0];
+        s[0] = c[1] * x - c[3] * y + s[1];
+        s[1] = c[2] * x - c[4] * y;
+        x = y;
+    }
+    return x;
+}
+
+int biquad_filter_block(biquad_t *bq, const float *x, float *y, size_t n) {
+    if (!bq || !x || !y) return -1;
+    const float *c = bq->coeffs;
+    float *s = bq->state;
+    const float *in = x;
+    for (size_t k = 0; k < bq->sections; k++, c += 5, s += 2) {
+        float b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+        float s0 = s[0], s1 = s[1];
+        for (size_t i = 0; i < n; i++) {
+            float xi = in[i];
+            float yi = b0 * xi + s0;
+            s0 = b1 * xi - a1 * yi + s1;
+            s1 = b2 * xi - a2 * yi;
+            y[i] = yi;
+        }
+        s[0] = s0;
+        s[1] = s1;
+        // later sections filter the output in place
+        in = y;
+    }
+    return 0;
+}
+
+int create_mirror_line_mc(mirror_line_mc_t *line, size_t len, size_t channels) {
+    if (!line || len == 0 || channels == 0 || channels > FILTER_MAX_CHANNELS) return -1;
+    line->head = line_alloc(2 * len * channels);
+    if (!line->head) return -1;
+    line->newest = 0;
+    line->len = len;
+    line->mask = wrap_mask(len);
+    line->channels = channels;
+    return 0;
+}
+
+int destroy_mirror_line_mc(mirror_line_mc_t *line) {
+    if (!line) return -1;
+    line_free(line->head, 2 * line->len * line->channels);
+    line->head = NULL;
+    line->newest = 0;
+    line->len = 0;
+    line->mask = 0;
+    line->channels = 0;
+    return 0;
+}
+
+int fir_filter_mc(mirror_line_mc_t *line, const float *b, size_t b_size,
+                  const float *x, float *y) {
+    if (!line || !b || !x || !y) return -1;
+    size_t ch = line->channels;
+    size_t taps = min(line->len, b_size);
+    // step back one frame and write both copies
+    if (line->mask) {
+        line->newest = (line->newest - 1) & line->mask;
+    } else {
+        line->newest = (line->newest == 0) ? line->len - 1 : line->newest - 1;
+    }
+    float *p = line->head + line->newest * ch;
+    float *q = p + line->len * ch;
+    for (size_t c = 0; c < ch; c++) {
+        p[c] = x[c];
+        q[c] = x[c];
+    }
+    if (ch == 3) {
+        // common case of an IMU axis triple, with the channel loop unrolled
+        float s0 = 0, s1 = 0, s2 = 0;
+        for (size_t i = 0; i < taps; i++, p += 3) {
+            s0 += b[i] * p[0];
+            s1 += b[i] * p[1];
+            s2 += b[i] * p[2];
+        }
+        y[0] = s0;
+        y[1] = s1;
+        y[2] = s2;
+        return 0;
+    }
+    float sum[FILTER_MAX_CHANNELS] = {0};
+    for (size_t i = 0; i < taps; i++, p += ch) {
+        for (size_t c = 0; c < ch; c++) {
+            sum[c] += b[i] * p[c];
+        }
+    }
+    for (size_t c = 0; c < ch; c++) {
+        y[c] = sum[c];
+    }
+    return 0;
+}
+
+int create_avg_line_mc(avg_line_mc_t *line, size_t len, size_t channels) {
+    if (!line || len == 0 || channels == 0 || channels > FILTER_MAX_CHANNELS) return -1;
+    line->head = line_alloc(len * channels);
+    if (!line->head) return -1;
+    line->curr = 0;
+    line->len = len;
+    line->mask = wrap_mask(len);
+    line->channels = channels;
+    for (size_t c = 0; c < FILTER_MAX_CHANNELS; c++) {
+        line->sum[c] = 0;
+        line->comp[c] = 0;
+    }
+    line->count = 0;
+    return 0;
+}
+
+int destroy_avg_line_mc(avg_line_mc_t *line) {
+    if (!line) return -1;
+    line_free(line->head, line->len * line->channels);
+    line->head = NULL;
+    line->curr = 0;
+    line->len = 0;
+    line->mask = 0;
+    line->channels = 0;
+    return 0;
+}
+
+int push_avg_mc(avg_line_mc_t *line, const float *x, float *sum) {
+    if (!line || !x || !sum) return -1;
+    size_t ch = line->channels;
+    // advance to the oldest frame, which x replaces
+    if (line->mask) {
+        line->curr = (line->curr + 1) & line->mask;
+    } else if (++line->curr == line->len) {
+        line->curr = 0;
+    }
+    float *frame = line->head + line->curr * ch;
+    if (++line->count >= AVG_LINE_RESYNC * line->len) {
+        // recompute from scratch to discard accumulated rounding error
+        for (size_t c = 0; c < ch; c++) {
+            frame[c] = x[c];
+            line->sum[c] = 0;
+            line->comp[c] = 0;
+        }
+        for (size_t i = 0; i < line->len * ch; i += ch) {
+            for (size_t c = 0; c < ch; c++) {
+                kahan_add(&line->sum[c], &line->comp[c], line->head[i + c]);
+            }
+        }
+        line->count = 0;
+    } else {
+        for (size_t c = 0; c < ch; c++) {
+            kahan_add(&line->sum[c], &line->comp[c], x[c]);
+            kahan_add(&line->sum[c], &line->comp[c], -frame[c]);
+            frame[c] = x[c];
+        }
+    }
+    for (size_t c = 0; c < ch; c++) {
+        sum[c] = line->sum[c];
+    }
+    return 0;
+}
+
+int create_biquad_mc(biquad_mc_t *bq, const float *coeffs, size_t sections, size_t channels) {
+    if (!bq || !coeffs || sections == 0 || channels == 0 || channels > FILTER_MAX_CHANNELS) {
+        return -1;
+    }
+    bq->state = line_alloc(2 * sections * channels);
+    if (!bq->state) return -1;
+    bq->coeffs = coeffs;
+    bq->sections = sections;
+    bq->channels = channels;
+    return 0;
+}
+
+int destroy_biquad_mc(biquad_mc_t *bq) {
+    if (!bq) return -1;
+    line_free(bq->state, 2 * bq->sections * bq->channels);
+    bq->coeffs = NULL;
+    bq->state = NULL;
+    bq->sections = 0;
+    bq->channels = 0;
+    return 0;
+}
+
+int biquad_filter_mc(biquad_mc_t *bq, const float *x, float *y) {
+    if (!bq || !x || !y) return -1;
+    size_t ch = bq->channels;
+    const float *c = bq->coeffs;
+    float *s = bq->state;
+    if (ch == 3) {
+        // common case of an IMU axis triple, kept in registers so the
+        // three independent channels can overlap in the FPU pipeline
+        float v0 = x[0], v1 = x[1], v2 = x[2];
+        for (size_t k = 0; k < bq->sections; k++, c += 5, s += 6) {
+            float b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+            float o0 = b0 * v0 + s[0];
+            float o1 = b0 * v1 + s[2];
+            float o2 = b0 * v2 + s[4];
+            s[0] = b1 * v0 - a1 * o0 + s[1];
+            s[2] = b1 * v1 - a1 * o1 + s[3];
+            s[4] = b1 * v2 - a1 * o2 + s[5];
+            s[1] = b2 * v0 - a2 * o0;
+            s[3] = b2 * v1 - a2 * o1;
+            s[5] = b2 * v2 - a2 * o2;
+            v0 = o0;
+            v1 = o1;
+            v2 = o2;
+        }
+        y[0] = v0;
+        y[1] = v1;
+        y[2] = v2;
+        return 0;
+    }
+    float v[FILTER_MAX_CHANNELS];
+    for (size_t k = 0; k < ch; k++) {
+        v[k] = x[k];
+    }
+    for (size_t k = 0; k < bq->sections; k++, c += 5) {
+        // coefficients are loaded once per section for all channels
+        float b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+        for (size_t j = 0; j < ch; j++, s += 2) {
+            float out = b0 * v[j] + s[0];
+            s[0] = b1 * v[j] - a1 * out + s[1];
+            s[1] = b2 * v[j] - a2 * out;
+            v[j] = out;
+        }
+    }
+    for (size_t k = 0; k < ch; k++) {
+        y[k] = v[k];
+    }
+    return 0;
+}
+
+size_t filter_memory_used(void) {
+    return filter_bytes_in_use;
+}
@@ -11,6 +11,43 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+/** Configuration **/
+
+/**
+ * Define FILTER_STATIC_POOL to have create_line() and friends take their
+ * storage from a static pool of FILTER_POOL_LEN floats instead of the heap.
+ * Pool storage is never reclaimed, so destroy_line() only resets the struct.
+ */
+#ifndef FILTER_POOL_LEN
+#define FILTER_POOL_LEN 512
+#endif
+
+/**
+ * @brief Declare static storage for a delay line of compile-time length `len`,
+ * to be passed to init_line() or init_avg_line().
+ */
+#define DELAY_LINE_STORAGE(name, len) static float name[(len)]
+
+/**
+ * @brief Declare static storage for a mirrored delay line of compile-time
+ * length `len`, to be passed to init_mirror_line().
+ */
+#define MIRROR_LINE_STORAGE(name, len) static float name[2 * (len)]
+
+/**
+ * @brief Declare static state storage for a biquad cascade with a
+ * compile-time number of sections, to be passed to init_biquad().
+ */
+#define BIQUAD_STATE_STORAGE(name, sections) static float name[2 * (sections)]
+
+/**
+ * @brief Maximum number of channels in a multi-channel filter,
+ * enough for the three axes of an IMU measurement plus one.
+ */
+#ifndef FILTER_MAX_CHANNELS
+#define FILTER_MAX_CHANNELS 4
+#endif
+
 /** Data Structures **/
 
 /**
@@ -20,8 +57,98 @@ typedef struct {
     float *head; // Pointer to start of buffer
     float *curr; // Pointer to n=0 sample in buffer
     size_t len; // Max length of buffer
+    size_t mask; // len - 1 if len is a power of two, else 0
 } delay_line_t;
 
+/**
+ * @brief Mirrored delay line implemented as a double-length float buffer.
+ * Every sample is written twice, `len` floats apart, so the `len` most
+ * recent samples are always contiguous in memory starting at
+ * `head + newest`, ordered from newest to oldest.
+ */
+typedef struct {
+    float *head; // Pointer to start of buffer of length 2 * len
+    size_t newest; // Index of n=0 sample in buffer
+    size_t len; // Number of samples held
+    size_t mask; // len - 1 if len is a power of two, else 0
+} mirror_line_t;
+
+/**
+ * @brief Delay line that keeps a running sum of its contents.
+ * The sum is updated on every push using Kahan compensated summation,
+ * and is recomputed from the buffer every `AVG_LINE_RESYNC * len` pushes
+ * so that rounding error cannot accumulate without bound.
+ */
+typedef struct {
+    delay_line_t line; // Underlying circular buffer
+    float sum; // Running sum of the samples in line
+    float comp; // Kahan compensation term for sum
+    size_t count; // Pushes since the sum was last recomputed
+} avg_line_t;
+
+/**
+ * @brief Cascade of second order IIR sections in transposed Direct Form II.
+ * Each section has five coefficients in the order b0, b1, b2, a1, a2,
+ * normalized so that a0 = 1, and computes
+ *
+ *     y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+ *
+ * This is the same layout as a row of a SciPy `sos` array with a0 dropped.
+ */
+typedef struct {
+    const float *coeffs; // 5 coefficients per section
+    float *state; // 2 state variables per section
+    size_t sections; // Number of sections
+} biquad_t;
+
+/**
+ * @brief Multi-channel mirrored delay line.
+ * Like mirror_line_t, but each slot holds a frame of `channels` samples
+ * stored interleaved, so one pass over the taps filters every channel.
+ */
+typedef struct {
+    float *head; // Pointer to start of buffer of 2 * len frames
+    size_t newest; // Index of n=0 frame in buffer
+    size_t len; // Number of frames held
+    size_t mask; // len - 1 if len is a power of two, else 0
+    size_t channels; // Samples per frame
+} mirror_line_mc_t;
+
+/**
+ * @brief Multi-channel delay line with a running sum per channel.
+ * Frames are stored interleaved; see avg_line_t for how the sums are kept.
+ */
+typedef struct {
+    float *head; // Pointer to start of buffer of len frames
+    size_t curr; // Index of n=0 frame in buffer
+    size_t len; // Number of frames held
+    size_t mask; // len - 1 if len is a power of two, else 0
+    size_t channels; // Samples per frame
+    float sum[FILTER_MAX_CHANNELS]; // Running sum of each channel
+    float comp[FILTER_MAX_CHANNELS]; // Kahan compensation terms
+    size_t count; // Pushes since the sums were last recomputed
+} avg_line_mc_t;
+
+/**
+ * @brief Biquad cascade applied to each channel of a multi-channel stream.
+ * All channels share one set of coefficients, laid out as in biquad_t.
+ */
+typedef struct {
+    const float *coeffs; // 5 coefficients per section
+    float *state; // 2 state variables per channel per section
+    size_t sections; // Number of sections
+    size_t channels; // Samples per frame
+} biquad_mc_t;
+
+/**
+ * @brief Number of buffer lengths between resynchronizations of the
+ * running sum in avg_line_t. The amortized cost of resynchronizing is
+ * 1/AVG_LINE_RESYNC additions per push, independent of the line length.
+ */
+#ifndef AVG_LINE_RESYNC
+#define AVG_LINE_RESYNC 64
+#endif
+
 /** Functions **/
 
 // Delay Line
@@ -36,6 +163,19 @@ typedef struct {
  */
 int create_line(delay_line_t *line, size_t len);
 
+/**
+ * @brief Initialize the `line` argument to use caller-provided storage,
+ * such as an array declared with DELAY_LINE_STORAGE, instead of allocating.
+ * The storage is zeroed. A line initialized this way must not be passed
+ * to destroy_line().
+ *
+ * @param line Pointer to a delay line struct to initialize
+ * @param storage Buffer of at least `len` floats
+ * @param len Length of buffer
+ * @return -1 if `line` or `storage` is null or len is 0
+ */
+int init_line(delay_line_t *line, float *storage, size_t len);
+
 /**
  * @brief Deallocate buffer for the delay line specified, 
  * and reset the struct pointers.
@@ -72,6 +212,99 @@ int get(delay_line_t *line, size_t n, float *x);
  */
 float sum_line(delay_line_t *line);
 
+// Mirrored Delay Line
+
+/**
+ * @brief Allocate memory for a mirrored delay line holding `len` samples,
+ * and initialize the `line` argument to refer to it.
+ * The buffer is zeroed, so the line initially holds `len` zero samples.
+ *
+ * @param line Pointer to a mirrored delay line struct to initialize
+ * @param len Number of samples held
+ * @return -1 if `line` is null, len is 0, or allocation fails
+ */
+int create_mirror_line(mirror_line_t *line, size_t len);
+
+/**
+ * @brief Initialize the `line` argument to use caller-provided storage,
+ * such as an array declared with MIRROR_LINE_STORAGE, instead of allocating.
+ * The storage must hold at least `2 * len` floats. A line initialized this
+ * way must not be passed to destroy_mirror_line().
+ *
+ * @param line Pointer to a mirrored delay line struct to initialize
+ * @param storage Buffer of at least `2 * len` floats
+ * @param len Number of samples held
+ * @return -1 if `line` or `storage` is null or len is 0
+ */
+int init_mirror_line(mirror_line_t *line, float *storage, size_t len);
+
+/**
+ * @brief Deallocate buffer for the mirrored delay line specified,
+ * and reset the struct.
+ *
+ * @param line Pointer to mirrored delay line struct
+ * @return -1 if `line` is null
+ */
+int destroy_mirror_line(mirror_line_t *line);
+
+/**
+ * @brief Append `x` to the mirrored delay line, evicting the oldest sample.
+ *
+ * @param line Pointer to mirrored delay line struct
+ * @return -1 if `line` is null
+ */
+int push_mirror(mirror_line_t *line, float x);
+
+// Running Sum Delay Line
+
+/**
+ * @brief Allocate memory for a running sum delay line of the specified length,
+ * and initialize the `line` argument to refer to it.
+ * The line initially holds `len` zero samples.
+ *
+ * @param line Pointer to a running sum delay line struct to initialize
+ * @param len Length of allocated buffer
+ * @return -1 if `line` is null, len is 0, or allocation fails
+ */
+int create_avg_line(avg_line_t *line, size_t len);
+
+/**
+ * @brief Initialize the `line` argument to use caller-provided storage
+ * of at least `len` floats. See init_line().
+ *
+ * @param line Pointer to a running sum delay line struct to initialize
+ * @param storage Buffer of at least `len` floats
+ * @param len Length of buffer
+ * @return -1 if `line` or `storage` is null or len is 0
+ */
+int init_avg_line(avg_line_t *line, float *storage, size_t len);
+
+/**
+ * @brief Deallocate buffer for the running sum delay line specified,
+ * and reset the struct.
+ *
+ * @param line Pointer to running sum delay line struct
+ * @return -1 if `line` is null
+ */
+int destroy_avg_line(avg_line_t *line);
+
+/**
+ * @brief Append `x` to the running sum delay line, evicting the oldest
+ * sample and updating the sum in constant time.
+ *
+ * @param line Pointer to running sum delay line struct
+ * @return -1 if `line` is null
+ */
+int push_avg(avg_line_t *line, float x);
+
+/**
+ * Return the sum of all elements in the running sum delay line.
+ * Unlike sum_line(), this does not traverse the buffer.
+ * @param line Pointer to running sum delay line
+ * @return sum
+ */
+float avg_line_sum(avg_line_t *line);
+
 // Filters
 
 /**
@@ -85,5 +318,196 @@ float sum_line(delay_line_t *line);
  */
 float fir_filter(delay_line_t *line, float *b, size_t b_size);
 
+/**
+ * Apply difference equation y[n] = sum(b[i] * x[n-i]) to the samples
+ * held in a mirrored delay line.
+ * Same semantics as fir_filter(), but the taps are read as one contiguous
+ * array instead of through get().
+ *
+ * @param line Pointer to mirrored delay line
+ * @param b Pointer to b coefficent buffer
+ * @param b_size Size of b buffer
+ */
+float fir_filter_mirror(mirror_line_t *line, const float *b, size_t b_size);
+
+/**
+ * Push each of the `n` samples in `x` onto the mirrored delay line and
+ * write the corresponding filter output to `y`.
+ * Equivalent to calling push_mirror() and fir_filter_mirror() for
+ * each sample, without the per-sample call overhead.
+ * `x` and `y` may be the same buffer.
+ *
+ * @param line Pointer to mirrored delay line
+ * @param b Pointer to b coefficent buffer
+ * @param b_size Size of b buffer
+ * @param x Input samples, oldest first
+ * @param y Output samples, same length as `x`
+ * @param n Number of samples
+ * @return -1 if any pointer is null
+ */
+int fir_filter_block(mirror_line_t *line, const float *b, size_t b_size,
+                     const float *x, float *y, size_t n);
+
+// IIR Filters
+
+/**
+ * @brief Allocate zeroed state for a biquad cascade with the specified
+ * number of sections, and initialize `bq` to use the coefficients in `coeffs`.
+ * The coefficients are not copied and must outlive the filter.
+ *
+ * @param bq Pointer to biquad cascade struct to initialize
+ * @param coeffs Pointer to 5 * sections coefficients
+ * @param sections Number of second order sections
+ * @return -1 if any pointer is null, sections is 0, or allocation fails
+ */
+int create_biquad(biquad_t *bq, const float *coeffs, size_t sections);
+
+/**
+ * @brief Initialize `bq` to use caller-provided state, such as an array
+ * declared with BIQUAD_STATE_STORAGE, instead of allocating.
+ * The state is zeroed. A filter initialized this way must not be passed
+ * to destroy_biquad().
+ *
+ * @param bq Pointer to biquad cascade struct to initialize
+ * @param coeffs Pointer to 5 * sections coefficients
+ * @param state Buffer of at least 2 * sections floats
+ * @param sections Number of second order sections
+ * @return -1 if any pointer is null or sections is 0
+ */
+int init_biquad(biquad_t *bq, const float *coeffs, float *state, size_t sections);
+
+/**
+ * @brief Deallocate state for the biquad cascade specified, and reset the struct.
+ *
+ * @param bq Pointer to biquad cascade struct
+ * @return -1 if `bq` is null
+ */
+int destroy_biquad(biquad_t *bq);
+
+/**
+ * Filter one sample through every section of the cascade.
+ *
+ * @param bq Pointer to biquad cascade
+ * @param x Input sample
+ * @return Output sample
+ */
+float biquad_filter(biquad_t *bq, float x);
+
+/**
+ * Filter `n` samples through the cascade, one section at a time,
+ * which keeps each section's coefficients and state in registers.
+ * Equivalent to calling biquad_filter() for each sample.
+ * `x` and `y` may be the same buffer.
+ *
+ * @param bq Pointer to biquad cascade
+ * @param x Input samples, oldest first
+ * @param y Output samples, same length as `x`
+ * @param n Number of samples
+ * @return -1 if any pointer is null
+ */
+int biquad_filter_block(biquad_t *bq, const float *x, float *y, size_t n);
+
+// Multi-Channel Filters
+// Each takes and produces one frame of `channels` samples per call,
+// so all axes of a sensor are filtered in a single pass.
+
+/**
+ * @brief Allocate a multi-channel mirrored delay line of `len` frames.
+ *
+ * @param line Pointer to the struct to initialize
+ * @param len Number of frames held
+ * @param channels Samples per frame, from 1 to FILTER_MAX_CHANNELS
+ * @return -1 if `line` is null, len or channels is out of range,
+ * or allocation fails
+ */
+int create_mirror_line_mc(mirror_line_mc_t *line, size_t len, size_t channels);
+
+/**
+ * @brief Deallocate a multi-channel mirrored delay line and reset the struct.
+ * @return -1 if `line` is null
+ */
+int destroy_mirror_line_mc(mirror_line_mc_t *line);
+
+/**
+ * Push frame `x` onto the line and write the FIR output for each
+ * channel to `y`, using the same taps `b` for every channel.
+ *
+ * @param line Pointer to multi-channel mirrored delay line
+ * @param b Pointer to b coefficent buffer
+ * @param b_size Size of b buffer
+ * @param x Input frame of `channels` samples
+ * @param y Output frame of `channels` samples
+ * @return -1 if any pointer is null
+ */
+int fir_filter_mc(mirror_line_mc_t *line, const float *b, size_t b_size,
+                  const float *x, float *y);
+
+/**
+ * @brief Allocate a multi-channel running sum delay line of `len` frames.
+ *
+ * @param line Pointer to the struct to initialize
+ * @param len Number of frames held
+ * @param channels Samples per frame, from 1 to FILTER_MAX_CHANNELS
+ * @return -1 if `line` is null, len or channels is out of range,
+ * or allocation fails
+ */
+int create_avg_line_mc(avg_line_mc_t *line, size_t len, size_t channels);
+
+/**
+ * @brief Deallocate a multi-channel running sum delay line and reset the struct.
+ * @return -1 if `line` is null
+ */
+int destroy_avg_line_mc(avg_line_mc_t *line);
+
+/**
+ * Push frame `x` onto the line and write the sum of each channel to `sum`.
+ *
+ * @param line Pointer to multi-channel running sum delay line
+ * @param x Input frame of `channels` samples
+ * @param sum Output frame of `channels` sums
+ * @return -1 if any pointer is null
+ */
+int push_avg_mc(avg_line_mc_t *line, const float *x, float *sum);
+
+/**
+ * @brief Allocate zeroed state for a multi-channel biquad cascade.
+ * The coefficients are not copied and must outlive the filter.
+ *
+ * @param bq Pointer to the struct to initialize
+ * @param coeffs Pointer to 5 * sections coefficients
+ * @param sections Number of second order sections
+ * @param channels Samples per frame, from 1 to FILTER_MAX_CHANNELS
+ * @return -1 if any pointer is null, sections or channels is out of range,
+ * or allocation fails
+ */
+int create_biquad_mc(biquad_mc_t *bq, const float *coeffs, size_t sections, size_t channels);
+
+/**
+ * @brief Deallocate state for a multi-channel biquad cascade and reset the struct.
+ * @return -1 if `bq` is null
+ */
+int destroy_biquad_mc(biquad_mc_t *bq);
+
+/**
+ * Filter frame `x` through the cascade and write the result to `y`.
+ * `x` and `y` may be the same buffer.
+ *
+ * @param bq Pointer to multi-channel biquad cascade
+ * @param x Input frame of `channels` samples
+ * @param y Output frame of `channels` samples
+ * @return -1 if any pointer is null
+ */
+int biquad_filter_mc(biquad_mc_t *bq, const float *x, float *y);
+
+// Memory
+
+/**
+ * Return the number of bytes of sample storage held by delay lines
+ * and biquad state that have been created or initialized and not destroyed.
+ * With FILTER_STATIC_POOL, destroyed lines stay counted because
+ * their pool storage is not reclaimed.
+ */
+size_t filter_memory_used(void);
+
 
 #endif
\ No newline at end of file
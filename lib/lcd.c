@@ -0,0 +1,117 @@
+/**
+ * @file lcd.c
+ * @brief Implementation of the diffing LCD writer.
+ *
+ * The display controller is HD44780 compatible, with row 0 at display
+ * memory address 0x00 and row 1 at 0x40, and the cursor advancing after
+ * each character. On the serial interface, each command or character is
+ * a start byte, which tells them apart, followed by the low and then
+ * the high four bits of the value, each in a byte of its own.
+ */
+
+#include "lcd.h"
+#include <string.h>
+
+#define START_COMMAND 0x1F
+#define START_DATA 0x5F
+#define SET_ADDRESS 0x80
+#define ROW_1_ADDRESS 0x40
+
+static void spim_handler(nrfx_spim_evt_t const *p_event, void *p_context) {
+    lcd_t *lcd = p_context;
+    lcd->busy = false;
+}
+
+static size_t encode(uint8_t *out, uint8_t start, uint8_t value) {
+    out[0] = start;
+    out[1] = value & 0x0F;
+    out[2] = value >> 4;
+    return 3;
+}
+
+ret_code_t lcd_init(lcd_t *lcd, nrfx_spim_t const *spim, nrfx_spim_config_t const *config,
+                    bool nonblocking, int64_t interval) {
+    memset(lcd, 0, sizeof(*lcd));
+    memset(lcd->wanted, ' ', sizeof(lcd->wanted));
+    lcd->spim = spim;
+    lcd->nonblocking = nonblocking;
+    lcd->interval = interval;
+    return nrfx_spim_init(spim, config, nonblocking ? spim_handler : NULL, lcd);
+}
+
+void lcd_write(lcd_t *lcd, int row, const char *text) {
+    char line[LCD_COLUMNS];
+    size_t i = 0;
+    for (; i < LCD_COLUMNS && text[i]; i++) line[i] = text[i];
+    for (; i < LCD_COLUMNS; i++) line[i] = ' ';
+    if (memcmp(lcd->wanted[row], line, LCD_COLUMNS) != 0) {
+        memcpy(lcd->wanted[row], line, LCD_COLUMNS);
+        lcd->stats.writes++;
+    }
+}
+
+int64_t lcd_flush_delay(const lcd_t *lcd, int64_t now) {
+    if (lcd->known && memcmp(lcd->shown, lcd->wanted, sizeof(lcd->shown)) == 0) return -1;
+    if (!lcd->flushed) return 0;
+    int64_t delay = lcd->last_flush + lcd->interval - now;
+    return delay > 0 ? delay : 0;
+}
+
+ret_code_t lcd_flush(lcd_t *lcd, int64_t now) {
+    if (lcd->busy) return NRF_ERROR_BUSY;
+
+    size_t length = 0;
+    uint32_t cells = 0;
+    for (int row = 0; row < LCD_ROWS; row++) {
+        const char *wanted = lcd->wanted[row];
+        const char *shown = lcd->shown[row];
+        int col = 0;
+        while (col < LCD_COLUMNS) {
+            if (lcd->known && wanted[col] == shown[col]) {
+                col++;
+                continue;
+            }
+            // Start of a run. A cursor command costs as much as one cell, so
+            // resend a single unchanged cell rather than move past it.
+            int end = col + 1;
+            while (end < LCD_COLUMNS) {
+                if (!lcd->known || wanted[end] != shown[end]) {
+                    end++;
+                } else if (end + 1 < LCD_COLUMNS && wanted[end + 1] != shown[end + 1]) {
+                    end += 2;
+                } else {
+                    break;
+                }
+            }
+            uint8_t address = (row ? ROW_1_ADDRESS : 0) + col;
+            length += encode(lcd->buffer + length, START_COMMAND, SET_ADDRESS | address);
+            for (; col < end; col++) {
+                length += encode(lcd->buffer + length, START_DATA, (uint8_t)wanted[col]);
+                cells++;
+            }
+        }
+    }
+    memcpy(lcd->shown, lcd->wanted, sizeof(lcd->shown));
+    lcd->known = true;
+    lcd->last_flush = now;
+    lcd->flushed = true;
+    if (length == 0) return NRF_SUCCESS;
+
+    lcd->stats.transfers++;
+    lcd->stats.cells += cells;
+    lcd->stats.bytes += length;
+    nrfx_spim_xfer_desc_t const xfer = NRFX_SPIM_XFER_TX(lcd->buffer, length);
+    // Set busy first, since the transfer can end before nrfx_spim_xfer() returns.
+    lcd->busy = lcd->nonblocking;
+    ret_code_t error_code = nrfx_spim_xfer(lcd->spim, &xfer, 0);
+    if (error_code != NRF_SUCCESS) {
+        // Rewrite everything next time.
+        lcd->busy = false;
+        lcd->known = false;
+    }
+    return error_code;
+}
+
+lcd_stats_t lcd_stats(const lcd_t *lcd) {
+    return lcd->stats;
+}
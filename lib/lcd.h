@@ -0,0 +1,110 @@
+/**
+ * @file lcd.h
+ * @brief Writer for the two-row character LCD on the Buckler board that
+ * sends only what changed.
+ *
+ * A shadow copy of both rows records what the display shows. Text given
+ * to lcd_write() only updates the copy of what it should show, and
+ * lcd_flush() sends the character cells that differ, each run of them
+ * after one cursor command, in a single SPI transfer. Flushes are spaced
+ * at least a refresh interval apart, so several writes in between cost
+ * one update.
+ *
+ * Transfers go through the nrfx SPIM driver, whose EasyDMA reads the
+ * bytes straight from memory. In non-blocking mode lcd_flush() returns
+ * as soon as the transfer starts.
+ */
+
+#ifndef LCD_H
+#define LCD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nrfx_spim.h"
+
+#define LCD_ROWS 2
+#define LCD_COLUMNS 16
+
+// Each command or character takes three bytes on the wire. Runs of
+// changed cells are at least two cells apart, so a row never takes more
+// than its cells and one cursor command.
+#define LCD_BUFFER_SIZE (3 * LCD_ROWS * (LCD_COLUMNS + 1))
+
+/**
+ * @brief Counts of what was sent.
+ */
+typedef struct {
+    uint32_t writes;    // Calls to lcd_write() that changed the text.
+    uint32_t transfers; // SPI transfers, at most one per flush.
+    uint32_t cells;     // Character cells sent.
+    uint32_t bytes;     // Bytes sent.
+} lcd_stats_t;
+
+/**
+ * @brief Writer state. Use the functions below rather than the fields.
+ */
+typedef struct {
+    nrfx_spim_t const *spim;
+    bool nonblocking;
+    volatile bool busy; // A non-blocking transfer is in progress.
+    bool known;         // `shown` matches the display.
+    char shown[LCD_ROWS][LCD_COLUMNS];
+    char wanted[LCD_ROWS][LCD_COLUMNS];
+    int64_t interval;
+    int64_t last_flush;
+    bool flushed;       // last_flush is valid.
+    uint8_t buffer[LCD_BUFFER_SIZE];
+    lcd_stats_t stats;
+} lcd_t;
+
+/**
+ * @brief Initialize the writer and the SPIM instance.
+ * The display controller must already be set up, for instance with
+ * display_init() from the Buckler library, whose SPI driver must then be
+ * uninitialized so that the instance is free. The first flush rewrites
+ * every cell, since what the display shows is not known.
+ * @param lcd The writer.
+ * @param spim The SPIM instance to use.
+ * @param config Its pins and mode.
+ * @param nonblocking Whether lcd_flush() returns before the transfer ends.
+ * @param interval Minimum time between flushes in nanoseconds.
+ * @return An error code that should be checked using the macro APP_ERROR_CHECK.
+ */
+ret_code_t lcd_init(lcd_t *lcd, nrfx_spim_t const *spim, nrfx_spim_config_t const *config,
+                    bool nonblocking, int64_t interval);
+
+/**
+ * @brief Set the text that a row should show. It is cut at the display
+ * width or padded with spaces. Nothing is sent until lcd_flush().
+ * @param lcd The writer.
+ * @param row 0 or 1.
+ * @param text A null-terminated string.
+ */
+void lcd_write(lcd_t *lcd, int row, const char *text);
+
+/**
+ * @brief Get how long to wait before flushing.
+ * @param lcd The writer.
+ * @param now The current time in nanoseconds.
+ * @return Nanoseconds until the next flush is allowed, 0 to flush now,
+ *  or -1 if the display already shows the text.
+ */
+int64_t lcd_flush_delay(const lcd_t *lcd, int64_t now);
+
+/**
+ * @brief Send the cells that differ from what the display shows.
+ * This does not check the refresh interval; see lcd_flush_delay().
+ * @param lcd The writer.
+ * @param now The current time in nanoseconds.
+ * @return NRF_SUCCESS, NRF_ERROR_BUSY if the previous non-blocking
+ *  transfer has not finished, in which case nothing is sent, or an
+ *  error from the SPIM driver.
+ */
+ret_code_t lcd_flush(lcd_t *lcd, int64_t now);
+
+/**
+ * @brief Get the counts of what was sent.
+ */
+lcd_stats_t lcd_stats(const lcd_t *lcd);
+
+#endif // LCD_H
@@ -0,0 +1,167 @@
+/**
+ * @file log_codec.c
+ * @brief Implementation of sensor log blocks.
+ */
+
+#include "log_codec.h"
+#include <string.h>
+#include "nrf_error.h"
+
+static size_t put_varint(uint8_t *p, uint64_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        p[n++] = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+    p[n++] = (uint8_t)value;
+    return n;
+}
+
+/**
+ * Decode a varint from at most `length` bytes, returning the number of
+ * bytes it takes, or 0 if it does not end within them.
+ */
+static size_t get_varint(const uint8_t *p, size_t length, uint64_t *value) {
+    uint64_t v = 0;
+    for (size_t n = 0; n < length && n < 10; n++) {
+        v |= (uint64_t)(p[n] & 0x7F) << (7 * n);
+        if (!(p[n] & 0x80)) {
+            *value = v;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+static uint64_t zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static void put_u16(uint8_t *p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t value) {
+    put_u16(p, (uint16_t)value);
+    put_u16(p + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+// Whether record `index` of a block is a keyframe.
+static bool is_keyframe(log_codec_config_t const *config, uint16_t index) {
+    return config->keyframe <= 1 || index % config->keyframe == 0;
+}
+
+void log_codec_begin(log_codec_writer_t *writer, log_codec_config_t const *config,
+                     uint8_t *block, size_t size, uint32_t sequence) {
+    writer->config = *config;
+    writer->block = block;
+    writer->size = size;
+    writer->count = 0;
+    memset(block, 0, size);
+
+    memcpy(block, "LFSL", 4);
+    block[4] = LOG_CODEC_VERSION;
+    block[5] = config->channels;
+    // Bytes 6 and 7 are the count, written by log_codec_append().
+    put_u32(block + 8, sequence);
+    put_u32(block + 12, config->session);
+    put_u32(block + 16, config->time_unit);
+    block[20] = config->keyframe;
+    for (int i = 0; i < config->channels; i++) {
+        block[21 + i] = (uint8_t)config->exponents[i];
+    }
+    writer->length = LOG_CODEC_HEADER_SIZE(config->channels);
+}
+
+bool log_codec_append(log_codec_writer_t *writer, log_codec_record_t const *record) {
+    uint8_t encoded[LOG_CODEC_RECORD_MAX];
+    size_t n;
+    if (writer->count == UINT16_MAX) return false;
+    if (is_keyframe(&writer->config, writer->count)) {
+        n = put_varint(encoded, record->time);
+        for (int i = 0; i < writer->config.channels; i++) {
+            n += put_varint(encoded + n, zigzag(record->values[i]));
+        }
+    } else {
+        n = put_varint(encoded, record->time - writer->last.time);
+        for (int i = 0; i < writer->config.channels; i++) {
+            n += put_varint(encoded + n, zigzag((int64_t)record->values[i] - writer->last.values[i]));
+        }
+    }
+    if (writer->length + n > writer->size) return false;
+
+    memcpy(writer->block + writer->length, encoded, n);
+    writer->length += n;
+    writer->count++;
+    put_u16(writer->block + 6, writer->count);
+    writer->last = *record;
+    return true;
+}
+
+void log_codec_set_session(log_codec_writer_t *writer, uint32_t session) {
+    writer->config.session = session;
+    put_u32(writer->block + 12, session);
+}
+
+ret_code_t log_codec_open(log_codec_reader_t *reader, const uint8_t *block, size_t size) {
+    if (size < LOG_CODEC_HEADER_SIZE(0) || memcmp(block, "LFSL", 4) != 0
+            || block[4] != LOG_CODEC_VERSION) {
+        return NRF_ERROR_INVALID_DATA;
+    }
+    uint8_t channels = block[5];
+    if (channels == 0 || channels > LOG_CODEC_MAX_CHANNELS
+            || size < LOG_CODEC_HEADER_SIZE(channels)) {
+        return NRF_ERROR_INVALID_DATA;
+    }
+    memset(reader, 0, sizeof(*reader));
+    reader->config.channels = channels;
+    reader->count = get_u16(block + 6);
+    reader->sequence = get_u32(block + 8);
+    reader->config.session = get_u32(block + 12);
+    reader->config.time_unit = get_u32(block + 16);
+    reader->config.keyframe = block[20];
+    for (int i = 0; i < channels; i++) {
+        reader->config.exponents[i] = (int8_t)block[21 + i];
+    }
+    reader->block = block;
+    reader->size = size;
+    reader->position = LOG_CODEC_HEADER_SIZE(channels);
+    return NRF_SUCCESS;
+}
+
+ret_code_t log_codec_read(log_codec_reader_t *reader, log_codec_record_t *record) {
+    if (reader->index == reader->count) return NRF_ERROR_NOT_FOUND;
+    bool keyframe = is_keyframe(&reader->config, reader->index);
+    const uint8_t *p = reader->block + reader->position;
+    size_t left = reader->size - reader->position;
+
+    uint64_t value;
+    size_t n = get_varint(p, left, &value);
+    if (n == 0) return NRF_ERROR_INVALID_LENGTH;
+    log_codec_record_t decoded = {.time = keyframe ? value : reader->last.time + value};
+    for (int i = 0; i < reader->config.channels; i++) {
+        size_t used = get_varint(p + n, left - n, &value);
+        if (used == 0) return NRF_ERROR_INVALID_LENGTH;
+        n += used;
+        int64_t v = unzigzag(value);
+        decoded.values[i] = (int32_t)(keyframe ? v : reader->last.values[i] + v);
+    }
+    reader->position += n;
+    reader->index++;
+    reader->last = decoded;
+    *record = decoded;
+    return NRF_SUCCESS;
+}
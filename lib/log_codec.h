@@ -0,0 +1,142 @@
+/**
+ * @file log_codec.h
+ * @brief Compact encoding of timestamped sensor records into fixed-size
+ * blocks, for logging to an SD card or flash.
+ *
+ * A record is a time and up to LOG_CODEC_MAX_CHANNELS integer values,
+ * such as IMU readings in thousandths of a g. Most records are written
+ * as differences from the record before: the time difference as an
+ * unsigned LEB128 varint, then the difference of each value as a zigzag
+ * varint, so a value that changes by less than 64 takes one byte. Every
+ * `keyframe` records, and at the start of every block, a keyframe holds
+ * the time and values themselves, in the same varints, so the decoder
+ * can start at any block and an error costs at most one block.
+ *
+ * Each block starts with a header, with multi-byte values little endian:
+ *
+ *  - the magic "LFSL", a version byte, and the number of channels,
+ *  - the number of records in the block as a uint16,
+ *  - the sequence number of the block as a uint32, counting from 0,
+ *  - a session number as a uint32, to tell the blocks of one log from
+ *    those left by an earlier one,
+ *  - the time unit in nanoseconds as a uint32,
+ *  - the keyframe interval, and
+ *  - for each channel, the power of ten by which its values were
+ *    multiplied, so that the decoder can scale them back.
+ *
+ * The rest of the block holds the records, and is zero after the last.
+ * Nothing here touches any hardware, so blocks can be written on the
+ * nRF52 and decoded on the host alike, and scripts/sensor_log_decode.py
+ * decodes them into CSV.
+ */
+
+#ifndef LOG_CODEC_H
+#define LOG_CODEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#define LOG_CODEC_VERSION 1
+#define LOG_CODEC_MAX_CHANNELS 8
+// Header size for a number of channels.
+#define LOG_CODEC_HEADER_SIZE(channels) (21 + (channels))
+// Largest encoded record: a 64-bit varint for the time and for each value.
+#define LOG_CODEC_RECORD_MAX (10 * (1 + LOG_CODEC_MAX_CHANNELS))
+
+/**
+ * @brief What is logged. The same for every block of a log.
+ */
+typedef struct {
+    uint8_t channels;                            // Values per record.
+    uint8_t keyframe;                            // Records from one keyframe to the next.
+    uint32_t time_unit;                          // Nanoseconds per unit of record time.
+    uint32_t session;                            // Identifies the log.
+    int8_t exponents[LOG_CODEC_MAX_CHANNELS];    // Value = reading * 10^exponent.
+} log_codec_config_t;
+
+/**
+ * @brief One record.
+ */
+typedef struct {
+    uint64_t time; // In time units, not decreasing from record to record.
+    int32_t values[LOG_CODEC_MAX_CHANNELS];
+} log_codec_record_t;
+
+/**
+ * @brief Writer state, set up by log_codec_begin() for each block.
+ */
+typedef struct {
+    log_codec_config_t config;
+    uint8_t *block;            // The block being filled.
+    size_t size;               // Its size.
+    size_t length;             // Bytes used.
+    uint16_t count;            // Records in it.
+    log_codec_record_t last;   // The last record encoded.
+} log_codec_writer_t;
+
+/**
+ * @brief Reader state, set up by log_codec_open() for each block.
+ */
+typedef struct {
+    log_codec_config_t config;
+    uint32_t sequence;         // Of the block.
+    const uint8_t *block;
+    size_t size;
+    size_t position;           // Of the next record.
+    uint16_t count;            // Records in the block.
+    uint16_t index;            // Of the next record.
+    log_codec_record_t last;   // The last record decoded.
+} log_codec_reader_t;
+
+/**
+ * @brief Start a block, writing its header.
+ * @param writer The writer.
+ * @param config What is logged. The number of channels must be from 1
+ *  to LOG_CODEC_MAX_CHANNELS.
+ * @param block The buffer for the block, which is cleared.
+ * @param size The size of the block.
+ * @param sequence The sequence number of the block.
+ */
+void log_codec_begin(log_codec_writer_t *writer, log_codec_config_t const *config,
+                     uint8_t *block, size_t size, uint32_t sequence);
+
+/**
+ * @brief Encode a record into the block.
+ * @param writer The writer.
+ * @param record The record.
+ * @return false if the block has no room for the record, in which case
+ *  it should be stored and the record encoded into a new block.
+ */
+bool log_codec_append(log_codec_writer_t *writer, log_codec_record_t const *record);
+
+/**
+ * @brief Change the session number, of the block being filled as well as
+ * of the blocks begun after it.
+ * @param writer The writer.
+ * @param session The session number.
+ */
+void log_codec_set_session(log_codec_writer_t *writer, uint32_t session);
+
+/**
+ * @brief Start reading a block.
+ * @param reader The reader.
+ * @param block The block.
+ * @param size The size of the block.
+ * @return NRF_SUCCESS, or NRF_ERROR_INVALID_DATA if the block does not
+ *  start with a header of this version, for example because it was
+ *  never written.
+ */
+ret_code_t log_codec_open(log_codec_reader_t *reader, const uint8_t *block, size_t size);
+
+/**
+ * @brief Decode the next record of the block.
+ * @param reader The reader.
+ * @param record The decoded record.
+ * @return NRF_SUCCESS, NRF_ERROR_NOT_FOUND after the last record, or
+ *  NRF_ERROR_INVALID_LENGTH if a record runs past the end of the block.
+ */
+ret_code_t log_codec_read(log_codec_reader_t *reader, log_codec_record_t *record);
+
+#endif // LOG_CODEC_H
@@ -0,0 +1,101 @@
+/**
+ * @file lsm9ds1_async.c
+ * @brief Implementation of non-blocking LSM9DS1 reads.
+ */
+
+#include "lsm9ds1_async.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ACC_GYRO_ADDRESS 0x6B
+#define MAG_ADDRESS 0x1E
+
+#define OUT_X_L_G 0x18
+#define OUT_X_L_XL 0x28
+// The magnetometer only auto-increments with the top address bit set.
+#define OUT_X_L_M (0x28 | 0x80)
+
+// Sensitivity at +/-2 g, at 245 degrees per second, and at +/-4 gauss
+// (0.14 milligauss per LSB).
+#define ACC_G_PER_LSB 0.000061f
+#define GYRO_DPS_PER_LSB 0.00875f
+#define MAG_UT_PER_LSB 0.014f
+
+static const uint8_t out_x_l_g = OUT_X_L_G;
+static const uint8_t out_x_l_xl = OUT_X_L_XL;
+static const uint8_t out_x_l_m = OUT_X_L_M;
+
+static nrf_twi_mngr_t const *twi_mngr = NULL;
+
+// The read in progress. The TWI manager uses the transaction, transfers,
+// and buffer until it completes.
+static volatile bool busy = false;
+static uint8_t requested;
+static lsm9ds1_async_handler_t read_handler;
+static void *read_context;
+static uint8_t raw[3][6];
+static nrf_twi_mngr_transfer_t transfers[6];
+static nrf_twi_mngr_transaction_t transaction;
+
+static void decode(const uint8_t *raw, float scale, lsm9ds1_measurement_t *m) {
+    m->x_axis = (int16_t)(raw[0] | (raw[1] << 8)) * scale;
+    m->y_axis = (int16_t)(raw[2] | (raw[3] << 8)) * scale;
+    m->z_axis = (int16_t)(raw[4] | (raw[5] << 8)) * scale;
+}
+
+static void read_done(ret_code_t result, void *p_user_data) {
+    lsm9ds1_reading_t reading = {0};
+    if (result == NRF_SUCCESS) {
+        reading.sensors = requested;
+        if (requested & LSM9DS1_ACC) decode(raw[0], ACC_G_PER_LSB, &reading.acc);
+        if (requested & LSM9DS1_GYRO) decode(raw[1], GYRO_DPS_PER_LSB, &reading.gyro);
+        if (requested & LSM9DS1_MAG) decode(raw[2], MAG_UT_PER_LSB, &reading.mag);
+    }
+    // Free the buffers first so that the handler can start another read.
+    lsm9ds1_async_handler_t handler = read_handler;
+    void *context = read_context;
+    busy = false;
+    handler(result, &reading, context);
+}
+
+void lsm9ds1_async_init(nrf_twi_mngr_t const *twi) {
+    twi_mngr = twi;
+    busy = false;
+}
+
+ret_code_t lsm9ds1_async_read(uint8_t sensors, lsm9ds1_async_handler_t handler, void *context) {
+    if (busy) return NRF_ERROR_BUSY;
+
+    // Each sensor is a write of its register address and a 6-byte read.
+    static const struct {
+        uint8_t sensor;
+        uint8_t address;
+        const uint8_t *reg;
+    } sources[3] = {
+        {LSM9DS1_ACC, ACC_GYRO_ADDRESS, &out_x_l_xl},
+        {LSM9DS1_GYRO, ACC_GYRO_ADDRESS, &out_x_l_g},
+        {LSM9DS1_MAG, MAG_ADDRESS, &out_x_l_m},
+    };
+    uint8_t n = 0;
+    for (int i = 0; i < 3; i++) {
+        if (!(sensors & sources[i].sensor)) continue;
+        nrf_twi_mngr_transfer_t const address = NRF_TWI_MNGR_WRITE(sources[i].address, sources[i].reg, 1, NRF_TWI_MNGR_NO_STOP);
+        nrf_twi_mngr_transfer_t const data = NRF_TWI_MNGR_READ(sources[i].address, raw[i], 6, 0);
+        transfers[n++] = address;
+        transfers[n++] = data;
+    }
+    if (n == 0) return NRF_ERROR_INVALID_PARAM;
+
+    requested = sensors & (LSM9DS1_ACC | LSM9DS1_GYRO | LSM9DS1_MAG);
+    read_handler = handler;
+    read_context = context;
+    transaction.callback = read_done;
+    transaction.p_user_data = NULL;
+    transaction.p_transfers = transfers;
+    transaction.number_of_transfers = n;
+    transaction.p_required_twi_cfg = NULL;
+    busy = true;
+    ret_code_t error_code = nrf_twi_mngr_schedule(twi_mngr, &transaction);
+    if (error_code != NRF_SUCCESS) busy = false;
+    return error_code;
+}
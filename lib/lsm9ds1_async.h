@@ -0,0 +1,66 @@
+/**
+ * @file lsm9ds1_async.h
+ * @brief Non-blocking reads of the LSM9DS1 IMU on the Buckler board.
+ *
+ * lsm9ds1_read_accelerometer() and friends wait for their I2C transfer,
+ * which takes almost a millisecond per sensor at 100 kHz. A read started
+ * with lsm9ds1_async_read() is queued with the TWI manager instead and
+ * returns at once. The handler gets the decoded readings when the
+ * transfer completes, from the TWI interrupt, where a reactor would
+ * typically call lf_schedule_copy() on a physical action.
+ *
+ * Readings are decoded for the lowest full-scale ranges, which are the
+ * power-on defaults: +/-2 g, 245 degrees per second, and +/-4 gauss.
+ */
+
+#ifndef LSM9DS1_ASYNC_H
+#define LSM9DS1_ASYNC_H
+
+#include <stdint.h>
+#include "lsm9ds1.h"      // Defines lsm9ds1_measurement_t
+#include "nrf_twi_mngr.h" // Defines nrf_twi_mngr_t
+
+// Sensors to read, for lsm9ds1_async_read() and lsm9ds1_reading_t.
+#define LSM9DS1_ACC 0x01
+#define LSM9DS1_GYRO 0x02
+#define LSM9DS1_MAG 0x04
+
+/**
+ * @brief Readings from one call to lsm9ds1_async_read().
+ */
+typedef struct {
+    uint8_t sensors;            // Which fields below were read, as LSM9DS1_ACC etc.
+    lsm9ds1_measurement_t acc;  // In g's.
+    lsm9ds1_measurement_t gyro; // In degrees per second.
+    lsm9ds1_measurement_t mag;  // In microtesla.
+} lsm9ds1_reading_t;
+
+/**
+ * @brief Function called when a read completes.
+ * @param result NRF_SUCCESS, or the TWI error that ended the transfer.
+ * @param reading The readings, valid only during the call.
+ * @param context The context given to lsm9ds1_async_read().
+ */
+typedef void (*lsm9ds1_async_handler_t)(ret_code_t result,
+                                        lsm9ds1_reading_t const *reading,
+                                        void *context);
+
+/**
+ * @brief Set the TWI manager to use. The sensors must already be running,
+ * for instance after lsm9ds1_init().
+ * @param twi The TWI manager of the sensor bus.
+ */
+void lsm9ds1_async_init(nrf_twi_mngr_t const *twi);
+
+/**
+ * @brief Start reading the given sensors in one queued transaction.
+ * Only one read can be in progress at a time.
+ * @param sensors The sensors to read, as LSM9DS1_ACC | LSM9DS1_GYRO etc.
+ * @param handler The function to call with the readings.
+ * @param context Passed to the handler.
+ * @return NRF_SUCCESS if the read was queued, NRF_ERROR_BUSY if the
+ *  previous read has not completed, or the error from the TWI manager.
+ */
+ret_code_t lsm9ds1_async_read(uint8_t sensors, lsm9ds1_async_handler_t handler, void *context);
+
+#endif // LSM9DS1_ASYNC_H
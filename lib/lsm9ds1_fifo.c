@@ -0,0 +1,170 @@
+/**
+ * @file lsm9ds1_fifo.c
+ * @brief Implementation of batched reads from the LSM9DS1 FIFO.
+ * Register addresses and values are from the LSM9DS1 datasheet
+ * (DocID025715) and ST application note AN4650.
+ */
+
+#include "lsm9ds1_fifo.h"
+#include <stddef.h>
+
+#define ACC_GYRO_ADDRESS 0x6B
+
+#define WHO_AM_I 0x0F
+#define CTRL_REG1_G 0x10
+#define OUT_X_L_G 0x18
+#define CTRL_REG6_XL 0x20
+#define CTRL_REG8 0x22
+#define CTRL_REG9 0x23
+#define FIFO_CTRL 0x2E
+#define FIFO_SRC 0x2F
+
+#define WHO_AM_I_VALUE 0x68
+#define CTRL_REG8_BDU 0x40
+#define CTRL_REG8_IF_ADD_INC 0x04
+#define CTRL_REG9_FIFO_EN 0x02
+#define FIFO_CTRL_BYPASS 0x00
+#define FIFO_CTRL_CONTINUOUS 0xC0
+#define FIFO_SRC_OVRN 0x40
+#define FIFO_SRC_FSS 0x3F
+
+// Each FIFO slot holds the gyro and then the accelerometer output registers.
+#define SLOT_SIZE 12
+// Whole slots that fit in one read, whose length is 8 bits.
+#define SLOTS_PER_READ (255 / SLOT_SIZE)
+#define MAX_READS ((LSM9DS1_FIFO_DEPTH + SLOTS_PER_READ - 1) / SLOTS_PER_READ)
+
+// Sensitivity at +/-2 g and at 245 degrees per second.
+#define ACC_G_PER_LSB 0.000061f
+#define GYRO_DPS_PER_LSB 0.00875f
+
+// Sample periods in nanoseconds, indexed by lsm9ds1_odr_t.
+static const int64_t odr_periods[] = {
+    0, 67114094, 16806723, 8403361, 4201681, 2100840, 1050420,
+};
+
+static nrf_twi_mngr_t const *twi_mngr = NULL;
+
+// Timestamp reconstruction.
+static int64_t nominal_period;
+static int64_t period;
+static int64_t last_now;
+static int64_t last_time;
+static bool have_last;
+
+static ret_code_t write_register(uint8_t reg, uint8_t value) {
+    uint8_t data[2] = {reg, value};
+    nrf_twi_mngr_transfer_t const transfers[] = {
+        NRF_TWI_MNGR_WRITE(ACC_GYRO_ADDRESS, data, 2, 0),
+    };
+    return nrf_twi_mngr_perform(twi_mngr, NULL, transfers, 1, NULL);
+}
+
+static ret_code_t read_register(uint8_t reg, uint8_t *value) {
+    nrf_twi_mngr_transfer_t const transfers[] = {
+        NRF_TWI_MNGR_WRITE(ACC_GYRO_ADDRESS, &reg, 1, NRF_TWI_MNGR_NO_STOP),
+        NRF_TWI_MNGR_READ(ACC_GYRO_ADDRESS, value, 1, 0),
+    };
+    return nrf_twi_mngr_perform(twi_mngr, NULL, transfers, 2, NULL);
+}
+
+static float axis(const uint8_t *raw, float scale) {
+    return (int16_t)(raw[0] | (raw[1] << 8)) * scale;
+}
+
+ret_code_t lsm9ds1_fifo_init(nrf_twi_mngr_t const *twi, lsm9ds1_odr_t odr) {
+    twi_mngr = twi;
+    nominal_period = odr_periods[odr];
+    period = nominal_period;
+    have_last = false;
+
+    uint8_t id = 0;
+    ret_code_t error_code = read_register(WHO_AM_I, &id);
+    if (error_code != NRF_SUCCESS) return error_code;
+    if (id != WHO_AM_I_VALUE) return NRF_ERROR_NOT_FOUND;
+
+    // With both sensors on, the accelerometer runs at the gyro's rate.
+    // Zero full-scale bits select 245 degrees per second and +/-2 g.
+    const uint8_t config[][2] = {
+        {CTRL_REG1_G, odr << 5},
+        {CTRL_REG6_XL, odr << 5},
+        {CTRL_REG8, CTRL_REG8_BDU | CTRL_REG8_IF_ADD_INC},
+        {CTRL_REG9, CTRL_REG9_FIFO_EN},
+        // Bypass mode first, to empty the FIFO.
+        {FIFO_CTRL, FIFO_CTRL_BYPASS},
+        {FIFO_CTRL, FIFO_CTRL_CONTINUOUS},
+    };
+    for (size_t i = 0; i < sizeof(config) / sizeof(config[0]); i++) {
+        error_code = write_register(config[i][0], config[i][1]);
+        if (error_code != NRF_SUCCESS) return error_code;
+    }
+    return NRF_SUCCESS;
+}
+
+ret_code_t lsm9ds1_fifo_read(lsm9ds1_batch_t *batch, int64_t now) {
+    batch->count = 0;
+    batch->overrun = false;
+
+    uint8_t status = 0;
+    ret_code_t error_code = read_register(FIFO_SRC, &status);
+    if (error_code != NRF_SUCCESS) return error_code;
+    int count = status & FIFO_SRC_FSS;
+    if (count > LSM9DS1_FIFO_DEPTH) count = LSM9DS1_FIFO_DEPTH;
+    if (count == 0) return NRF_SUCCESS;
+
+    // One write of the register address and one read per chunk of slots,
+    // all handed to the TWI manager at once.
+    static const uint8_t out_x_l_g = OUT_X_L_G;
+    uint8_t raw[LSM9DS1_FIFO_DEPTH * SLOT_SIZE];
+    nrf_twi_mngr_transfer_t transfers[2 * MAX_READS];
+    uint8_t n = 0;
+    for (int first = 0; first < count; first += SLOTS_PER_READ) {
+        int slots = count - first < SLOTS_PER_READ ? count - first : SLOTS_PER_READ;
+        nrf_twi_mngr_transfer_t const address = NRF_TWI_MNGR_WRITE(ACC_GYRO_ADDRESS, &out_x_l_g, 1, NRF_TWI_MNGR_NO_STOP);
+        nrf_twi_mngr_transfer_t const data = NRF_TWI_MNGR_READ(ACC_GYRO_ADDRESS, raw + first * SLOT_SIZE, slots * SLOT_SIZE, 0);
+        transfers[n++] = address;
+        transfers[n++] = data;
+    }
+    error_code = nrf_twi_mngr_perform(twi_mngr, NULL, transfers, n, NULL);
+    if (error_code != NRF_SUCCESS) return error_code;
+
+    bool overrun = (status & FIFO_SRC_OVRN) != 0;
+    if (have_last && !overrun) {
+        // Exactly `count` samples were taken since the last read, so this
+        // measures the period, give or take one period over the interval.
+        // Average over many reads, and stay within 10% of the nominal
+        // period in case the reads come in a burst.
+        int64_t measured = (now - last_now) / count;
+        period += (measured - period) / 8;
+        if (period < nominal_period - nominal_period / 10) period = nominal_period - nominal_period / 10;
+        if (period > nominal_period + nominal_period / 10) period = nominal_period + nominal_period / 10;
+    }
+
+    // The newest sample was taken within one period before now.
+    int64_t time = now - period / 2 - (count - 1) * period;
+    for (int i = 0; i < count; i++) {
+        const uint8_t *slot = raw + i * SLOT_SIZE;
+        lsm9ds1_sample_t *sample = &batch->samples[i];
+        if (have_last && time <= last_time) {
+            time = last_time + 1;
+        }
+        sample->time = time;
+        sample->gyro.x_axis = axis(slot, GYRO_DPS_PER_LSB);
+        sample->gyro.y_axis = axis(slot + 2, GYRO_DPS_PER_LSB);
+        sample->gyro.z_axis = axis(slot + 4, GYRO_DPS_PER_LSB);
+        sample->acc.x_axis = axis(slot + 6, ACC_G_PER_LSB);
+        sample->acc.y_axis = axis(slot + 8, ACC_G_PER_LSB);
+        sample->acc.z_axis = axis(slot + 10, ACC_G_PER_LSB);
+        last_time = time;
+        time += period;
+    }
+    batch->count = count;
+    batch->overrun = overrun;
+    last_now = now;
+    have_last = true;
+    return NRF_SUCCESS;
+}
+
+int64_t lsm9ds1_fifo_period(void) {
+    return period;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file lsm9ds1_fifo.h
+ * @brief Batched accelerometer and gyro readings from the FIFO of the
+ * LSM9DS1 IMU on the Buckler board.
+ *
+ * The sensor samples at a fixed output data rate (ODR) into its 32-slot
+ * FIFO, and lsm9ds1_fifo_read() drains everything collected since the
+ * previous call with burst reads: one transaction for the FIFO status
+ * and at most two more for up to 32 samples. Reading the registers one
+ * sample at a time, as lsm9ds1_read_accelerometer() and
+ * lsm9ds1_read_gyro() do, takes two transactions per sample.
+ *
+ * The sensor does not timestamp its samples, so times are reconstructed
+ * from the time of each read and an estimate of the sample period that
+ * tracks the sensor's clock, which may be off by a few percent.
+ *
+ * The magnetometer has no FIFO; read it with lsm9ds1_read_magnetometer().
+ */
+
+#ifndef LSM9DS1_FIFO_H
+#define LSM9DS1_FIFO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lsm9ds1.h"      // Defines lsm9ds1_measurement_t
+#include "nrf_twi_mngr.h" // Defines nrf_twi_mngr_t
+
+#define LSM9DS1_FIFO_DEPTH 32
+
+/**
+ * @brief Output data rates, with the register encoding of CTRL_REG1_G.
+ */
+typedef enum {
+    LSM9DS1_ODR_14_9_HZ = 1,
+    LSM9DS1_ODR_59_5_HZ = 2,
+    LSM9DS1_ODR_119_HZ = 3,
+    LSM9DS1_ODR_238_HZ = 4,
+    LSM9DS1_ODR_476_HZ = 5,
+    LSM9DS1_ODR_952_HZ = 6,
+} lsm9ds1_odr_t;
+
+/**
+ * @brief One sample from the FIFO.
+ */
+typedef struct {
+    int64_t time;               // Estimated sampling time, on the clock of `now` in lsm9ds1_fifo_read().
+    lsm9ds1_measurement_t acc;  // In g's.
+    lsm9ds1_measurement_t gyro; // In degrees per second.
+} lsm9ds1_sample_t;
+
+/**
+ * @brief Samples collected between two reads, oldest first.
+ */
+typedef struct {
+    uint8_t count;
+    bool overrun; // The FIFO filled up and samples before the first one were lost.
+    lsm9ds1_sample_t samples[LSM9DS1_FIFO_DEPTH];
+} lsm9ds1_batch_t;
+
+/**
+ * @brief Configure the accelerometer (+/-2 g) and gyro (245 degrees per
+ * second) to sample at the given rate into the FIFO, in continuous mode.
+ * Call this after lsm9ds1_init() if the magnetometer is also used, since
+ * that function sets its own rates.
+ * @param twi The TWI manager of the sensor bus.
+ * @param odr The output data rate.
+ * @return An error code that should be checked using the macro APP_ERROR_CHECK.
+ *  NRF_ERROR_NOT_FOUND if the sensor does not identify itself as an LSM9DS1.
+ */
+ret_code_t lsm9ds1_fifo_init(nrf_twi_mngr_t const *twi, lsm9ds1_odr_t odr);
+
+/**
+ * @brief Take all the samples in the FIFO.
+ * @param batch Where to put the samples. Its count is zero if there were none.
+ * @param now The current time in nanoseconds, on any clock that the caller
+ *  uses consistently, such as lf_time_physical().
+ * @return An error code that should be checked using the macro APP_ERROR_CHECK.
+ */
+ret_code_t lsm9ds1_fifo_read(lsm9ds1_batch_t *batch, int64_t now);
+
+/**
+ * @brief Get the current estimate of the sample period in nanoseconds.
+ */
+int64_t lsm9ds1_fifo_period(void);
+
+#endif // LSM9DS1_FIFO_H
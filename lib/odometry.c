@@ -0,0 +1,86 @@
+/**
+ * @file odometry.c
+ * @brief Implementation of fixed-point wheel odometry.
+ */
+
+#include "odometry.h"
+#include <math.h>
+
+// Fraction bits of the sine table entries.
+#define SIN_BITS 28
+// The sine table covers a quarter turn in 2^SIN_SEGMENT_BITS segments.
+#define SIN_SEGMENT_BITS 6
+#define SIN_SEGMENTS (1 << SIN_SEGMENT_BITS)
+
+// sin() at the segment ends of a quarter turn, plus a copy of the last entry
+// so that interpolation at exactly a quarter turn stays in bounds.
+static int32_t sin_table[SIN_SEGMENTS + 2];
+static bool sin_table_ready = false;
+
+static void sin_table_init(void) {
+    if (sin_table_ready) return;
+    for (int i = 0; i <= SIN_SEGMENTS; i++) {
+        sin_table[i] = (int32_t)lround(sin(M_PI / 2 * i / SIN_SEGMENTS) * (1 << SIN_BITS));
+    }
+    sin_table[SIN_SEGMENTS + 1] = sin_table[SIN_SEGMENTS];
+    sin_table_ready = true;
+}
+
+/**
+ * Return sin(angle) with SIN_BITS fraction bits, where `angle` is a binary
+ * angle, by linear interpolation in the quarter-turn table.
+ * The error is below 1e-4.
+ */
+static int32_t sin_fixed(uint32_t angle) {
+    uint32_t quadrant = angle >> 30;
+    uint32_t a = angle & 0x3FFFFFFF;
+    if (quadrant & 1) a = 0x40000000 - a; // sin(pi - x) = sin(x)
+    uint32_t i = a >> (30 - SIN_SEGMENT_BITS);
+    uint32_t frac = (a >> (30 - SIN_SEGMENT_BITS - 16)) & 0xFFFF;
+    int32_t s = sin_table[i] + (int32_t)(((int64_t)(sin_table[i + 1] - sin_table[i]) * frac) >> 16);
+    return (quadrant & 2) ? -s : s;
+}
+
+void odometry_init(odometry_t *odom, float meters_per_tick, float wheelbase) {
+    sin_table_init();
+    odom->um_per_tick = (int32_t)lround(meters_per_tick * 1e6 * 65536);
+    // Heading changes by the difference in wheel travel over the wheelbase.
+    odom->angle_per_tick = (int64_t)llround(meters_per_tick / wheelbase
+            * (4294967296.0 / (2 * M_PI)) * 65536);
+    odometry_reset(odom);
+}
+
+void odometry_reset(odometry_t *odom) {
+    odom->x = 0;
+    odom->y = 0;
+    odom->theta = 0;
+    odom->first = true;
+}
+
+void odometry_update(odometry_t *odom, romi_encoder_t encoders) {
+    if (odom->first) {
+        odom->previous = encoders;
+        odom->first = false;
+        return;
+    }
+    // Differences of 16-bit counts, taken modulo 2^16, handle rollover both ways.
+    int32_t left = (int16_t)(uint16_t)(encoders.left - odom->previous.left);
+    int32_t right = (int16_t)(uint16_t)(encoders.right - odom->previous.right);
+    odom->previous = encoders;
+
+    // Move along the heading halfway through the turn, which is exact to
+    // second order for an arc.
+    int32_t dtheta = (int32_t)(((int64_t)(right - left) * odom->angle_per_tick) >> 16);
+    uint32_t heading = odom->theta + (uint32_t)(dtheta / 2);
+    // Average of the wheel distances, in 1/256 micrometer.
+    int64_t distance = ((int64_t)(left + right) * odom->um_per_tick) >> 9;
+    odom->x += (distance * sin_fixed(heading + 0x40000000)) >> SIN_BITS;
+    odom->y += (distance * sin_fixed(heading)) >> SIN_BITS;
+    odom->theta += (uint32_t)dtheta;
+}
+
+void odometry_get_pose(const odometry_t *odom, odometry_pose_t *pose) {
+    pose->x = odom->x / (256 * 1e6);
+    pose->y = odom->y / (256 * 1e6);
+    pose->theta = (int32_t)odom->theta * (float)(2 * M_PI / 4294967296.0);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file odometry.h
+ * @brief Wheel odometry for a differential-drive robot such as the Romi.
+ *
+ * The pose is integrated in fixed point from the 16-bit wheel encoder
+ * counts returned by romi_sensors_poll(), so every update takes the same
+ * small number of integer operations and no floating point.
+ * Position is kept in units of 1/256 micrometer and heading as a binary
+ * angle, where 2^32 is one full turn, so heading wraps around for free.
+ */
+
+#ifndef ODOMETRY_H
+#define ODOMETRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lib/romi.h"
+
+/**
+ * @brief Pose in floating point, for output.
+ */
+typedef struct {
+    float x;     // Meters forward of the starting position.
+    float y;     // Meters to the left of the starting position.
+    float theta; // Heading in radians, counterclockwise, in [-pi, pi), up to rounding.
+} odometry_pose_t;
+
+/**
+ * @brief Odometry state. Use the functions below rather than the fields.
+ */
+typedef struct {
+    int64_t x;      // 1/256 micrometer.
+    int64_t y;      // 1/256 micrometer.
+    uint32_t theta; // Binary angle, 2^32 per turn.
+
+    int32_t um_per_tick;    // Distance per encoder tick in micrometers, Q16.
+    int64_t angle_per_tick; // Binary angle per tick of difference between the wheels, Q16.
+
+    romi_encoder_t previous; // Encoder counts at the last update.
+    bool first;              // No update yet.
+} odometry_t;
+
+/**
+ * @brief Initialize odometry at pose (0, 0, 0).
+ * @param odom The odometry state.
+ * @param meters_per_tick Distance a wheel travels per encoder tick.
+ * @param wheelbase Distance between the wheels in meters.
+ */
+void odometry_init(odometry_t *odom, float meters_per_tick, float wheelbase);
+
+/**
+ * @brief Reset the pose to (0, 0, 0). The next update sets the reference
+ * encoder counts, as after odometry_init().
+ */
+void odometry_reset(odometry_t *odom);
+
+/**
+ * @brief Integrate the motion since the last update.
+ * The first update after odometry_init() or odometry_reset() only records
+ * the encoder counts. Counts may roll over, and wheels may turn either
+ * way, as long as neither moves 32768 ticks or more between updates.
+ * @param odom The odometry state.
+ * @param encoders The current encoder counts.
+ */
+void odometry_update(odometry_t *odom, romi_encoder_t encoders);
+
+/**
+ * @brief Get the current pose.
+ */
+void odometry_get_pose(const odometry_t *odom, odometry_pose_t *pose);
+
+#endif // ODOMETRY_H
@@ -0,0 +1,139 @@
+/**
+ * @file reaction_profile.c
+ * @brief Implementation of the reaction profiler.
+ *
+ * The table is open addressing on the address of the reaction, so that
+ * finding a reaction's slot usually takes one comparison.
+ */
+
+#include "reaction_profile.h"
+#include <stdio.h>
+#include <string.h>
+
+bool reaction_profile_started = false;
+
+static reaction_profile_entry_t table[REACTION_PROFILE_SLOTS];
+static uint32_t overflow = 0;
+static uint32_t overhead = 0;
+
+void reaction_profile_start(void) {
+#ifdef PLATFORM_NRF52
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    // The least of a few back-to-back readings.
+    overhead = UINT32_MAX;
+    for (int i = 0; i < 8; i++) {
+        uint32_t start = reaction_profile_now();
+        uint32_t ticks = reaction_profile_now() - start;
+        if (ticks < overhead) overhead = ticks;
+    }
+    reaction_profile_started = true;
+}
+
+// Histogram bucket of a time.
+static int bucket(uint32_t ticks) {
+    int bits = ticks == 0 ? 0 : 32 - __builtin_clz(ticks);
+    int b = bits - REACTION_PROFILE_MIN_BITS;
+    if (b < 0) return 0;
+    if (b >= REACTION_PROFILE_BUCKETS) return REACTION_PROFILE_BUCKETS - 1;
+    return b;
+}
+
+void reaction_profile_record(const void *reaction, const void *function, const void *self,
+                             int number, uint32_t ticks) {
+    uint32_t hash = (uint32_t)((uintptr_t)reaction >> 2) * 2654435761u;
+    uint32_t slot = (hash >> 16) % REACTION_PROFILE_SLOTS;
+    reaction_profile_entry_t *entry;
+    for (int probe = 0;; probe++) {
+        if (probe == REACTION_PROFILE_SLOTS) {
+            overflow++;
+            return;
+        }
+        entry = &table[slot];
+        if (entry->reaction == reaction) break;
+        if (entry->reaction == NULL) {
+            entry->reaction = reaction;
+            entry->function = function;
+            entry->self = self;
+            entry->number = number;
+            entry->min = UINT32_MAX;
+            break;
+        }
+        slot = (slot + 1) % REACTION_PROFILE_SLOTS;
+    }
+
+    entry->count++;
+    entry->total += ticks;
+    if (ticks < entry->min) entry->min = ticks;
+    if (ticks > entry->max) entry->max = ticks;
+    entry->histogram[bucket(ticks)]++;
+}
+
+reaction_profile_entry_t const *reaction_profile_entry(int index) {
+    if (index < 0 || index >= REACTION_PROFILE_SLOTS || table[index].reaction == NULL) {
+        return NULL;
+    }
+    return &table[index];
+}
+
+uint32_t reaction_profile_overflow(void) {
+    return overflow;
+}
+
+uint32_t reaction_profile_ticks_per_second(void) {
+#ifdef PLATFORM_NRF52
+    return SystemCoreClock;
+#else
+    return 1000000000;
+#endif
+}
+
+uint32_t reaction_profile_overhead(void) {
+    return overhead;
+}
+
+void reaction_profile_reset(void) {
+    for (int i = 0; i < REACTION_PROFILE_SLOTS; i++) {
+        reaction_profile_entry_t *entry = &table[i];
+        entry->count = 0;
+        entry->total = 0;
+        entry->min = UINT32_MAX;
+        entry->max = 0;
+        memset(entry->histogram, 0, sizeof(entry->histogram));
+    }
+    overflow = 0;
+}
+
+void reaction_profile_report(uint32_t min_max_us) {
+    if (!reaction_profile_started) {
+        printf("reaction profile: no reactions timed; build with LF_BUCKLER_PROFILE=1\n");
+        return;
+    }
+    double us = 1e6 / reaction_profile_ticks_per_second();
+    printf("reaction profile (us, timing adds %.2f):\n", overhead * us);
+    for (int i = 0; i < REACTION_PROFILE_SLOTS; i++) {
+        reaction_profile_entry_t const *e = &table[i];
+        if (e->reaction == NULL || e->count == 0) continue;
+        printf("%p.%d (%p): n %u min %.1f mean %.1f max %.1f\n", e->function, e->number,
+               e->self, (unsigned)e->count, e->min * us,
+               (double)e->total / e->count * us, e->max * us);
+    }
+    if (overflow > 0) {
+        printf("%u calls of reactions not profiled\n", (unsigned)overflow);
+    }
+
+    // Histograms, as the lower bound of each bucket in microseconds and its count.
+    for (int i = 0; i < REACTION_PROFILE_SLOTS; i++) {
+        reaction_profile_entry_t const *e = &table[i];
+        if (e->reaction == NULL || e->count == 0 || e->max * us < min_max_us) continue;
+        printf("%p.%d:", e->function, e->number);
+        for (int b = 0; b < REACTION_PROFILE_BUCKETS; b++) {
+            if (e->histogram[b] == 0) continue;
+            uint32_t low = b == 0 ? 0 : 1u << (REACTION_PROFILE_MIN_BITS + b - 1);
+            printf(" %.1f:%u", low * us, (unsigned)e->histogram[b]);
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,156 @@
+/**
+ * @file reaction_profile.h
+ * @brief Execution times of every reaction of a program, kept in static
+ * memory with little enough overhead to leave on in the field.
+ *
+ * In a profiling build, the LF runtime calls each reaction through
+ * REACTION_PROFILE_INVOKE(), which reads a clock before and after the
+ * call and adds the difference to the statistics of that reaction: the
+ * number of calls, the shortest, longest, and total time, and a histogram
+ * with a bucket for each power of two. On the nRF52, the clock is the
+ * Cortex-M4 DWT cycle counter, at SystemCoreClock ticks per second, which
+ * takes a single load to read. Elsewhere, it is clock_gettime(), in
+ * nanoseconds. Either way, the times include the few ticks that reading
+ * the clock takes, which reaction_profile_report() prints.
+ *
+ * To build a program with profiling, set LF_BUCKLER_PROFILE=1 when
+ * running lfc. The build scripts then wrap the reaction calls in the
+ * runtime (see scripts/profile_reactions.sh) and build with PROFILE=1,
+ * which defines REACTION_PROFILE. Without it, REACTION_PROFILE_INVOKE()
+ * is a plain call and nothing is recorded. Print the report on demand
+ * with reaction_profile_report(), or with the ReactionProfile reactor.
+ *
+ * The report names a reaction by the address of its function and its
+ * number in its reactor, counting from 0, and by the address of its
+ * reactor instance, which tells apart instances of one reactor class.
+ * To find the reactor from the address, for example:
+ *
+ *     arm-none-eabi-addr2line -f -e _build/TiltLog.elf 0x2f45
+ *
+ * Reactions run one at a time, and never in interrupt handlers, so the
+ * statistics are updated without disabling interrupts.
+ */
+
+#ifndef REACTION_PROFILE_H
+#define REACTION_PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef PLATFORM_NRF52
+#include "nrf.h"
+#else
+#include <time.h>
+#endif
+
+// Number of reactions profiled. The calls of any more are only counted.
+#ifndef REACTION_PROFILE_SLOTS
+#define REACTION_PROFILE_SLOTS 32
+#endif
+
+// Histogram buckets. Bucket 0 counts times below 2^REACTION_PROFILE_MIN_BITS
+// ticks, bucket b times from 2^(REACTION_PROFILE_MIN_BITS + b - 1) up to
+// twice that, and the last bucket all longer times.
+#define REACTION_PROFILE_BUCKETS 16
+#ifdef PLATFORM_NRF52
+#define REACTION_PROFILE_MIN_BITS 6 // 1 us at 64 MHz.
+#else
+#define REACTION_PROFILE_MIN_BITS 10 // 1 us.
+#endif
+
+/**
+ * @brief Statistics of one reaction. Times are in clock ticks.
+ */
+typedef struct {
+    const void *reaction;      // The runtime's reaction_t, or NULL if the slot is free.
+    const void *function;      // The reaction function.
+    const void *self;          // The reactor instance.
+    int number;                // Of the reaction in its reactor.
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t histogram[REACTION_PROFILE_BUCKETS];
+} reaction_profile_entry_t;
+
+/**
+ * @brief Read the clock.
+ */
+static inline uint32_t reaction_profile_now(void) {
+#ifdef PLATFORM_NRF52
+    return DWT->CYCCNT;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+extern bool reaction_profile_started;
+
+/**
+ * @brief Start the clock, if it is not already running. This is done
+ * before the first reaction is timed, so there is no need to call it.
+ */
+void reaction_profile_start(void);
+
+/**
+ * @brief Add a time to the statistics of a reaction.
+ * @param reaction Identifies the reaction; the runtime's reaction_t.
+ * @param function The reaction function.
+ * @param self The reactor instance.
+ * @param number The number of the reaction in its reactor.
+ * @param ticks The time the reaction took.
+ */
+void reaction_profile_record(const void *reaction, const void *function, const void *self,
+                             int number, uint32_t ticks);
+
+#ifdef REACTION_PROFILE
+#define REACTION_PROFILE_INVOKE(reaction) do { \
+    if (!reaction_profile_started) reaction_profile_start(); \
+    uint32_t _profile_start = reaction_profile_now(); \
+    (reaction)->function((reaction)->self); \
+    uint32_t _profile_ticks = reaction_profile_now() - _profile_start; \
+    reaction_profile_record((reaction), (const void *)(reaction)->function, \
+                            (reaction)->self, (reaction)->number, _profile_ticks); \
+} while (0)
+#else
+#define REACTION_PROFILE_INVOKE(reaction) (reaction)->function((reaction)->self)
+#endif
+
+/**
+ * @brief The statistics of a reaction.
+ * @param index From 0 to REACTION_PROFILE_SLOTS - 1.
+ * @return The statistics, or NULL if no reaction has that slot.
+ */
+reaction_profile_entry_t const *reaction_profile_entry(int index);
+
+/**
+ * @brief Number of calls of reactions that did not fit in the table.
+ */
+uint32_t reaction_profile_overflow(void);
+
+/**
+ * @brief Clock ticks per second.
+ */
+uint32_t reaction_profile_ticks_per_second(void);
+
+/**
+ * @brief Ticks that the timing itself adds to each time, measured when
+ * the clock starts.
+ */
+uint32_t reaction_profile_overhead(void);
+
+/**
+ * @brief Clear the statistics, keeping the reactions in their slots.
+ */
+void reaction_profile_reset(void);
+
+/**
+ * @brief Print the statistics with printf, one line per reaction, in
+ * microseconds, followed by the histograms of the reactions whose
+ * longest time is at least min_max_us microseconds.
+ */
+void reaction_profile_report(uint32_t min_max_us);
+
+#endif // REACTION_PROFILE_H
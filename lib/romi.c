@@ -14,6 +14,7 @@
  * Jeff C. Jensen, Joshua Adkins, and Neal Jackson.
  */
 #include "lib/romi.h"
+#include "lib/romi_framer.h"
 #include "buckler.h"
 #include <math.h>
 #include <string.h> // Defines memcpy
@@ -24,6 +25,7 @@
 #include "nrf_drv_clock.h" // Defines nrf_drv_clock_init() and nrf_drv_clock_lfclk_request().
 #include "nrfx_uart.h"
 #include "app_timer.h" // Defines app_timer_init()
+#include "app_util_platform.h" // Defines CRITICAL_REGION_ENTER() and CRITICAL_REGION_EXIT()
 
 // See romi.h for function documentation.
 
@@ -38,6 +40,54 @@
 static nrfx_uart_t nrfx_uart = NRFX_UART_INSTANCE(0);
 static nrfx_uart_config_t nrfx_uart_cfg = NRFX_UART_DEFAULT_CONFIG;
 
+// Receive ring, filled by the UART interrupt and drained by romi_sensors_poll().
+// Must be a power of two. The robot sends about 3.5 kB/s, so 512 bytes holds
+// about 140 ms of data, which covers polling at 100 ms.
+#ifndef ROMI_RX_RING_SIZE
+#define ROMI_RX_RING_SIZE 512
+#endif
+static volatile uint8_t rx_ring[ROMI_RX_RING_SIZE];
+static volatile uint32_t rx_head = 0; // Bytes written. Updated by the interrupt only.
+static volatile uint32_t rx_tail = 0; // Bytes read. Updated by _romi_rx_drain() only.
+static volatile uint32_t rx_tick = 0; // app_timer tick when the last byte arrived.
+static volatile uint32_t rx_gap = 0;  // Value of rx_head when bytes were first dropped.
+static volatile bool rx_overflow = false; // rx_gap is valid and not yet reached by the framer.
+static uint8_t rx_byte;               // Buffer for the byte being received.
+
+// Splits the received bytes into packets.
+static romi_framer_t rx_framer;
+static uint32_t rx_drain_tick = 0; // Value of rx_tick when draining started.
+
+// Most recent valid packet, as received and decoded.
+static uint8_t rx_packet[ROMI_FRAME_MAX];
+static romi_sensors_ext_t rx_sensors;
+static bool rx_have_packet = false; // A valid packet has been received.
+static bool rx_unread = false;      // rx_sensors has not been returned by a poll yet.
+static uint32_t rx_packet_tick = 0; // app_timer tick when it arrived.
+static romi_rx_stats_t rx_stats;
+
+// Transmit queue. Frames are sent in order from a small preallocated pool,
+// with the next frame started by the UART interrupt when the previous one is done.
+// A queue length of 4 leaves room for other commands behind a drive command.
+#ifndef ROMI_TX_QUEUE_LEN
+#define ROMI_TX_QUEUE_LEN 4
+#endif
+// Largest frame: header, length, up to 12 bytes of payload, and checksum.
+#define ROMI_TX_FRAME_MAX 16
+
+typedef struct
+{
+    uint8_t data[ROMI_TX_FRAME_MAX];
+    uint8_t length;
+    bool coalesce; // A newer frame with coalesce set may replace this one while it waits.
+} romi_tx_frame_t;
+
+static romi_tx_frame_t tx_frames[ROMI_TX_QUEUE_LEN];
+static volatile uint8_t tx_head = 0;      // Index of the oldest frame in the queue.
+static volatile uint8_t tx_count = 0;     // Number of frames in the queue, including one being sent.
+static volatile bool tx_sending = false;  // The frame at tx_head is being sent.
+static romi_tx_stats_t tx_stats;
+
 /**
  * @brief Combine bytes into a 16 bit unsigned integer.
  * @param low Low-order byte.
@@ -71,29 +121,98 @@ static uint8_t _romi_checksum(uint8_t *buffer, int length)
 }
 
 /**
- * @brief Send the specified payload over UART to the Romi robot.
+ * @brief Start sending the frame at the head of the transmit queue.
+ * Must be called with interrupts disabled or from the UART interrupt,
+ * and only when no frame is being sent and the queue is not empty.
+ * If the driver refuses the frame, it is discarded.
+ *
+ * @return An error code that should be checked using the macro APP_ERROR_CHECK.
+ */
+static int32_t _romi_tx_start()
+{
+    romi_tx_frame_t *frame = &tx_frames[tx_head];
+    int32_t err_code = nrfx_uart_tx(&nrfx_uart, frame->data, frame->length);
+    if (err_code == NRF_SUCCESS)
+    {
+        tx_sending = true;
+    }
+    else
+    {
+        tx_head = (tx_head + 1) % ROMI_TX_QUEUE_LEN;
+        tx_count--;
+        tx_stats.dropped++;
+    }
+    return err_code;
+}
+
+/**
+ * @brief Queue the specified payload for sending over UART to the Romi robot,
+ * and return without waiting for it to be sent.
  * This function adds a header (0xAA and 0x55) and a length to
  * the front of the byte stream that is sent, plus a checksum at
  * the end.
+ * If `coalesce` is true and the newest frame in the queue was also queued
+ * with `coalesce` true and is still waiting, that frame is replaced, so that
+ * only the latest command of its kind is sent.
  * This is based on kobukiSendPayload from the buckler repo,
  * converted to use lower-level UART functions.
  *
  * @param payload The payload.
  * @param length The size of the payload.
+ * @param coalesce Whether this frame may replace, and be replaced by, a waiting frame.
  * @return An error code that should be checked using the macro APP_ERROR_CHECK.
  */
-static int32_t _romi_send_payload(uint8_t *payload, uint8_t length)
+static int32_t _romi_send_payload(uint8_t *payload, uint8_t length, bool coalesce)
 {
-    uint8_t writeData[256] = {0};
+    if (length > ROMI_TX_FRAME_MAX - 4)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+    int32_t err_code = NRF_SUCCESS;
 
-    // Write move payload
-    writeData[0] = 0xAA;
-    writeData[1] = 0x55;
-    writeData[2] = length;
-    memcpy(writeData + 3, payload, length);
-    writeData[3 + length] = _romi_checksum(writeData, 3 + length);
+    CRITICAL_REGION_ENTER();
+    romi_tx_frame_t *frame = NULL;
+    uint8_t waiting = tx_count - (tx_sending ? 1 : 0);
+    if (coalesce && waiting > 0)
+    {
+        romi_tx_frame_t *newest = &tx_frames[(tx_head + tx_count - 1) % ROMI_TX_QUEUE_LEN];
+        if (newest->coalesce)
+        {
+            frame = newest;
+            tx_stats.coalesced++;
+        }
+    }
+    if (frame == NULL)
+    {
+        if (tx_count == ROMI_TX_QUEUE_LEN)
+        {
+            tx_stats.dropped++;
+            err_code = NRF_ERROR_NO_MEM;
+        }
+        else
+        {
+            frame = &tx_frames[(tx_head + tx_count) % ROMI_TX_QUEUE_LEN];
+            tx_count++;
+            tx_stats.queued++;
+        }
+    }
+    if (frame != NULL)
+    {
+        frame->data[0] = 0xAA;
+        frame->data[1] = 0x55;
+        frame->data[2] = length;
+        memcpy(frame->data + 3, payload, length);
+        frame->data[3 + length] = _romi_checksum(frame->data, 3 + length);
+        frame->length = length + 4;
+        frame->coalesce = coalesce;
+        if (!tx_sending)
+        {
+            err_code = _romi_tx_start();
+        }
+    }
+    CRITICAL_REGION_EXIT();
 
-    return nrfx_uart_tx(&nrfx_uart, writeData, length + 4);
+    return err_code;
 }
 
 /**
@@ -112,11 +231,16 @@ static int32_t _romi_drive_radius(int16_t radius, int16_t speed)
     memcpy(payload + 2, &speed, 2);
     memcpy(payload + 4, &radius, 2);
 
-    return _romi_send_payload(payload, 6);
+    // Only the latest drive command matters.
+    return _romi_send_payload(payload, 6, true);
 }
 
+static void _romi_uart_event_handler(nrfx_uart_event_t const *p_event, void *p_context);
+static void _romi_handle_packet(const uint8_t *packet, size_t length, void *context);
+
 /**
- * @brief Initialize the UART to a baud rate of 115,200.
+ * @brief Initialize the UART to a baud rate of 115,200 in interrupt mode,
+ * and start receiving into the receive ring.
  * @return An error code that should be checked using the macro APP_ERROR_CHECK.
  */
 static int32_t _romi_uart_init()
@@ -127,203 +251,307 @@ static int32_t _romi_uart_init()
     nrfx_uart_cfg.baudrate = NRF_UART_BAUDRATE_115200;
     nrfx_uart_cfg.interrupt_priority = NRFX_UART_DEFAULT_CONFIG_IRQ_PRIORITY;
 
+    // Start with an empty receive ring and no packet.
+    rx_head = 0;
+    rx_tail = 0;
+    rx_overflow = false;
+    romi_framer_init(&rx_framer, _romi_handle_packet, NULL);
+    rx_have_packet = false;
+    rx_unread = false;
+    memset(&rx_sensors, 0, sizeof(rx_sensors));
+    memset(&rx_stats, 0, sizeof(rx_stats));
+
+    // Start with an empty transmit queue.
+    tx_head = 0;
+    tx_count = 0;
+    tx_sending = false;
+    memset(&tx_stats, 0, sizeof(tx_stats));
+
     // Initialize UART.
-    return nrfx_uart_init(&nrfx_uart, &nrfx_uart_cfg, NULL);
+    int32_t err_code = nrfx_uart_init(&nrfx_uart, &nrfx_uart_cfg, _romi_uart_event_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    // Keep the receiver running between bytes, and start receiving.
+    nrfx_uart_rx_enable(&nrfx_uart);
+    return nrfx_uart_rx(&nrfx_uart, &rx_byte, 1);
 }
 
-/**
- * @brief Read a packet from the serial port.
- * Read from the serial port until a header AA55 is encountered.
- * Then read the length of the packet.
- * Then read the packet into the specified buffer.
- *
- * @param packetBuffer The buffer into which to put the result.
- * @param len The length of the buffer.
- * @return int32_t
- */
-static int32_t _romi_read_serial(uint8_t *packetBuffer, uint8_t len)
+// Decoders for sensor sub-payloads. Each is given the data following the
+// identifier and length bytes, whose length has already been checked.
+
+static void _romi_decode_basic(const uint8_t *data, uint8_t length, romi_sensors_ext_t *sensors)
 {
-    // States of the state machine depending on what is read next.
-    // Header should start with AA55.
-    typedef enum
-    {
-        wait_until_header,
-        read_length,
-        read_payload,
-        read_checksum
-    } state_type;
-
-    state_type state = wait_until_header;
-    uint8_t header_buf[2];
-    uint8_t payloadSize = 0;
-    uint8_t calcuatedCS = 0;
-    uint8_t byteBuffer = 0;
-    nrfx_err_t ret;
-    int err_cnt = 0;
-    bool done = false;
-    // Enable reception on UART
-    nrfx_uart_rx_enable(&nrfx_uart);
+    sensors->basic.time_stamp = to_uint16(data[0], data[1]);
 
-    int num_checksum_failures = 0;
+    sensors->basic.bumps.right = data[2] & 0x01;
+    sensors->basic.bumps.center = (data[2] & 0x02);
+    sensors->basic.bumps.left = (data[2] & 0x04);
 
-    if (len <= 4)
-    {
-        ret = NRF_ERROR_NO_MEM;
-        done = true;
-    }
+    sensors->wheel_drops = data[3];
 
-    while (!done)
-    {
-        switch (state)
-        {
-        case wait_until_header:
-            ret = nrfx_uart_rx(&nrfx_uart, header_buf, 2);
-            if (ret != NRF_SUCCESS)
-            {
-                nrfx_uart_errorsrc_get(&nrfx_uart);
-                err_cnt++;
-                break;
-            }
+    sensors->basic.reflectance.right = (data[4] & 0x01);
+    sensors->basic.reflectance.center = (data[4] & 0x02);
+    sensors->basic.reflectance.left = (data[4] & 0x04);
 
-            if (header_buf[0] == 0xAA && header_buf[1] == 0x55)
-            {
-                state = read_length;
-            }
-            else
-            {
-                state = wait_until_header;
-            }
-            break;
+    sensors->basic.encoders.left = to_uint16(data[5], data[6]);
+    sensors->basic.encoders.right = to_uint16(data[7], data[8]);
 
-        case read_length:
-            ret = nrfx_uart_rx(&nrfx_uart, &payloadSize, sizeof(payloadSize));
-            if (ret != NRF_SUCCESS)
-            {
-                nrfx_uart_errorsrc_get(&nrfx_uart);
-                err_cnt++;
-                state = wait_until_header;
-                break;
-            }
-            if (len < payloadSize + 3)
-            {
-                done = true;
-                ret = NRF_ERROR_NO_MEM;
-            }
-            state = read_payload;
-            break;
+    sensors->pwm_left = (int8_t)data[9];
+    sensors->pwm_right = (int8_t)data[10];
 
-        case read_payload:
-            ret = nrfx_uart_rx(&nrfx_uart, packetBuffer + 3, payloadSize + 1);
-            if (ret != NRF_SUCCESS)
-            {
-                err_cnt++;
-                nrfx_uart_errorsrc_get(&nrfx_uart);
-                state = wait_until_header;
-                break;
-            }
-            state = read_checksum;
-            break;
+    sensors->basic.buttons.right = (bool)(data[11] & 0x01);
+    sensors->basic.buttons.left = (bool)(data[11] & 0x02);
 
-        case read_checksum:
-            memcpy(packetBuffer, header_buf, 2);
-            packetBuffer[2] = payloadSize;
+    sensors->charger = data[12];
+    sensors->battery = data[13];
+    sensors->overcurrent = data[14];
+}
 
-            calcuatedCS = _romi_checksum(packetBuffer, payloadSize + 3);
-            byteBuffer = (packetBuffer)[payloadSize + 3];
-            done = true;
-            if (calcuatedCS == byteBuffer)
-            {
-                num_checksum_failures = 0;
-                ret = NRF_SUCCESS;
-            }
-            else
-            {
-                state = wait_until_header;
-                if (num_checksum_failures == 3)
-                {
-                    ret = -1500;
-                }
-                num_checksum_failures++;
-            }
-            break;
+static void _romi_decode_docking_ir(const uint8_t *data, uint8_t length, romi_sensors_ext_t *sensors)
+{
+    memcpy(sensors->docking_ir, data, 3);
+}
 
-        default:
-            break;
-        }
-        // If we get too many errors abort the sensor reading.
-        if (ret != NRF_SUCCESS && err_cnt >= 20)
-        {
-            done = true;
-        }
+static void _romi_decode_inertial(const uint8_t *data, uint8_t length, romi_sensors_ext_t *sensors)
+{
+    sensors->inertial.angle = (int16_t)to_uint16(data[0], data[1]);
+    sensors->inertial.angle_rate = (int16_t)to_uint16(data[2], data[3]);
+}
+
+static void _romi_decode_cliff(const uint8_t *data, uint8_t length, romi_sensors_ext_t *sensors)
+{
+    for (int k = 0; k < 3; k++)
+    {
+        sensors->cliff[k] = to_uint16(data[2 * k], data[2 * k + 1]);
+    }
+}
+
+static void _romi_decode_current(const uint8_t *data, uint8_t length, romi_sensors_ext_t *sensors)
+{
+    sensors->current[0] = data[0];
+    sensors->current[1] = data[1];
+}
+
+static void _romi_decode_gyro(const uint8_t *data, uint8_t length, romi_sensors_ext_t *sensors)
+{
+    // Frame id, number of 16-bit values, then x, y, z for each sample.
+    if (length < 2)
+    {
+        return;
     }
-    nrfx_uart_rx_disable(&nrfx_uart);
+    uint8_t count = data[1] / 3;
+    if (count > (length - 2) / 6)
+    {
+        count = (length - 2) / 6;
+    }
+    if (count > ROMI_GYRO_MAX_SAMPLES)
+    {
+        count = ROMI_GYRO_MAX_SAMPLES;
+    }
+    sensors->gyro.frame_id = data[0];
+    sensors->gyro.count = count;
+    const uint8_t *p = data + 2;
+    for (uint8_t k = 0; k < count; k++, p += 6)
+    {
+        sensors->gyro.samples[k].x = (int16_t)to_uint16(p[0], p[1]);
+        sensors->gyro.samples[k].y = (int16_t)to_uint16(p[2], p[3]);
+        sensors->gyro.samples[k].z = (int16_t)to_uint16(p[4], p[5]);
+    }
+}
 
-    return ret;
+static void _romi_decode_gpio(const uint8_t *data, uint8_t length, romi_sensors_ext_t *sensors)
+{
+    sensors->gpio.digital = to_uint16(data[0], data[1]);
+    for (int k = 0; k < 4; k++)
+    {
+        sensors->gpio.analog[k] = to_uint16(data[2 + 2 * k], data[3 + 2 * k]);
+    }
 }
 
+/**
+ * @brief How to decode a sub-payload. A length of 0 means any length.
+ */
+typedef struct
+{
+    uint8_t length;
+    void (*decode)(const uint8_t *data, uint8_t length, romi_sensors_ext_t *sensors);
+} romi_subpayload_t;
+
+// Indexed by sub-payload identifier. Identifiers without a decoder are skipped.
+static const romi_subpayload_t _romi_subpayloads[ROMI_ID_MAX] = {
+    [ROMI_ID_BASIC] = {15, _romi_decode_basic},
+    [ROMI_ID_DOCKING_IR] = {3, _romi_decode_docking_ir},
+    [ROMI_ID_INERTIAL] = {7, _romi_decode_inertial},
+    [ROMI_ID_CLIFF] = {6, _romi_decode_cliff},
+    [ROMI_ID_CURRENT] = {2, _romi_decode_current},
+    [ROMI_ID_GYRO] = {0, _romi_decode_gyro},
+    [ROMI_ID_GPIO] = {16, _romi_decode_gpio},
+};
+
 /**
  * @brief Parse the sensor data sent over the UART by the robot.
+ * This walks the sub-payloads once, decoding those in _romi_subpayloads
+ * and skipping the rest. A sub-payload whose length does not match the
+ * table is skipped too. For example, the documentation says both basic
+ * sensor data and controller info have ID 0x01, though it says elsewhere
+ * that controller info has ID 0x15. The checksum has already been checked.
  * This is based on kobukiParseSensorPacket in kobukiSensors.c in the buckler repo.
  *
  * @param packet The raw sensor data.
  * @param sensors The struct into which to insert the data.
  */
-static void _romi_parse_sensor_packet(const uint8_t *packet, romi_sensors_t *sensors)
+static void _romi_parse_sensor_packet(const uint8_t *packet, romi_sensors_ext_t *sensors)
 {
-    uint8_t payload_length = packet[2];
-    uint8_t subpayload_length = 0;
+    const uint8_t *p = packet + 3;
+    const uint8_t *end = p + packet[2];
+    sensors->present = 0;
 
-    uint8_t i = 3;
-    while (i < payload_length + 3)
+    // Each sub-payload has an identifier, a length, and the data.
+    while (end - p >= 2)
     {
-
-        uint8_t id = packet[i];
-
-        subpayload_length = packet[i + 1];
-
-        switch (id)
+        uint8_t id = p[0];
+        uint8_t length = p[1];
+        if (length > end - p - 2)
+        {
+            break; // Truncated.
+        }
+        if (id < ROMI_ID_MAX)
         {
-        case 0x01:
-            // There's an ambiguity in the documentation where
-            // it says there are two headers with value 0x01:
-            // basic sensor data and controller info - although it
-            // says elsewhere that controller info has ID 0x15
-            // so we'll just check here to make sure it's the right length
-
-            if (subpayload_length == 0x0F)
+            const romi_subpayload_t *entry = &_romi_subpayloads[id];
+            if (entry->decode != NULL && (entry->length == 0 || entry->length == length))
             {
-                sensors->time_stamp = to_uint16(packet[i + 2], packet[i + 3]);
-
-                sensors->bumps.right = packet[i + 4] & 0x01;
-                sensors->bumps.center = (packet[i + 4] & 0x02);
-                sensors->bumps.left = (packet[i + 4] & 0x04);
-
-                sensors->reflectance.right = (packet[i + 6] & 0x01);
-                sensors->reflectance.center = (packet[i + 6] & 0x02);
-                sensors->reflectance.left = (packet[i + 6] & 0x04);
-
-                sensors->encoders.left = to_uint16(packet[i + 7], packet[i + 8]);
-                sensors->encoders.right = to_uint16(packet[i + 9], packet[i + 10]);
-
-                sensors->buttons.right = (bool)(packet[i + 13] & 0x01);
-                sensors->buttons.left = (bool)(packet[i + 13] & 0x02);
-
-                i += subpayload_length + 2; // + 2 for header and length
+                entry->decode(p + 2, length, sensors);
+                sensors->present |= 1UL << id;
             }
-            else
+        }
+        p += 2 + length;
+    }
+}
+
+/**
+ * @brief Handle events from the UART driver. Runs in interrupt context.
+ * Each received byte is appended to the receive ring and reception of the
+ * next byte is started immediately, so no bytes are lost between polls
+ * unless the ring fills up.
+ *
+ * @param p_event The event.
+ * @param p_context Unused.
+ */
+static void _romi_uart_event_handler(nrfx_uart_event_t const *p_event, void *p_context)
+{
+    switch (p_event->type)
+    {
+    case NRFX_UART_EVT_RX_DONE:
+        if (rx_head - rx_tail < ROMI_RX_RING_SIZE)
+        {
+            rx_ring[rx_head % ROMI_RX_RING_SIZE] = rx_byte;
+            rx_head++;
+        }
+        else
+        {
+            rx_stats.bytes_dropped++;
+            if (!rx_overflow)
             {
-                i += payload_length + 3; // add enough to terminate the outer while loop
+                rx_gap = rx_head;
+                rx_overflow = true;
             }
+        }
+        rx_tick = app_timer_cnt_get();
+        nrfx_uart_rx(&nrfx_uart, &rx_byte, 1);
+        break;
+
+    case NRFX_UART_EVT_ERROR:
+        // Framing, parity, or overrun error. Discard the byte and restart.
+        rx_stats.uart_errors++;
+        nrfx_uart_rx(&nrfx_uart, &rx_byte, 1);
+        break;
+
+    case NRFX_UART_EVT_TX_DONE:
+        // Free the frame that was sent and start the next one, if any.
+        tx_stats.sent++;
+        tx_head = (tx_head + 1) % ROMI_TX_QUEUE_LEN;
+        tx_count--;
+        tx_sending = false;
+        if (tx_count > 0)
+        {
+            _romi_tx_start();
+        }
+        break;
 
-            break;
+    default:
+        break;
+    }
+}
 
-        default:
-            printf("Unexpected message type over UART: %d", id);
-            break;
+/**
+ * @brief Handle a packet with a valid checksum from the framer.
+ * Parse it into rx_sensors, replacing any previous packet.
+ *
+ * @param packet The packet.
+ * @param length The length of the packet.
+ * @param context Unused.
+ */
+static void _romi_handle_packet(const uint8_t *packet, size_t length, void *context)
+{
+    memcpy(rx_packet, packet, length);
+    _romi_parse_sensor_packet(packet, &rx_sensors);
+    rx_stats.packets++;
+    if (rx_unread)
+    {
+        rx_stats.packets_dropped++;
+    }
+    rx_unread = true;
+    rx_have_packet = true;
+    rx_packet_tick = rx_drain_tick;
+}
+
+/**
+ * @brief Pass received bytes from rx_tail up to, but not including, `end`
+ * to the framer. The bytes are passed in at most two chunks, since the
+ * ring wraps around.
+ */
+static void _romi_rx_feed(uint32_t end)
+{
+    while (rx_tail != end)
+    {
+        uint32_t offset = rx_tail % ROMI_RX_RING_SIZE;
+        uint32_t count = end - rx_tail;
+        if (count > ROMI_RX_RING_SIZE - offset)
+        {
+            count = ROMI_RX_RING_SIZE - offset;
         }
+        // The interrupt does not write to bytes between rx_tail and rx_head,
+        // so they can be read as ordinary memory.
+        romi_framer_feed(&rx_framer, (const uint8_t *)&rx_ring[offset], count);
+        rx_tail += count;
     }
-    // Checksum has already been checked.
-    return;
+}
+
+/**
+ * @brief Run all bytes received since the last call through the framer.
+ * The most recent valid packet is parsed into rx_sensors.
+ */
+static void _romi_rx_drain(void)
+{
+    // Bytes up to rx_head have arrived by time rx_tick, so use that
+    // as the arrival time of any packet they complete.
+    // Read rx_overflow before rx_head so that rx_gap is not past head.
+    rx_drain_tick = rx_tick;
+    bool overflow = rx_overflow;
+    uint32_t head = rx_head;
+    if (overflow)
+    {
+        // Bytes after rx_gap were dropped, so any partial packet is lost there.
+        _romi_rx_feed(rx_gap);
+        romi_framer_reset(&rx_framer);
+        rx_overflow = false;
+    }
+    _romi_rx_feed(head);
+    rx_stats.checksum_errors = rx_framer.bad_checksums;
+    rx_stats.resyncs = rx_framer.resyncs;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -437,17 +665,62 @@ uint32_t romi_init()
 
 int32_t romi_sensors_poll(romi_sensors_t *const sensors)
 {
-    // initialize communications buffer
-    // We know that the maximum size of the packet is less than 140 based on documentation
-    uint8_t packet[140] = {0};
-    int status = _romi_read_serial(packet, 140);
-    if (status != NRF_SUCCESS)
+    _romi_rx_drain();
+    *sensors = rx_sensors.basic;
+    rx_unread = false;
+    return NRF_SUCCESS;
+}
+
+int32_t romi_sensors_ext_poll(romi_sensors_ext_t *const sensors)
+{
+    _romi_rx_drain();
+    *sensors = rx_sensors;
+    rx_unread = false;
+    return NRF_SUCCESS;
+}
+
+const uint8_t *romi_sensors_raw(uint8_t id, uint8_t *length)
+{
+    _romi_rx_drain();
+    if (!rx_have_packet)
     {
-        return status;
+        return NULL;
+    }
+    const uint8_t *p = rx_packet + 3;
+    const uint8_t *end = p + rx_packet[2];
+    while (end - p >= 2 && p[1] <= end - p - 2)
+    {
+        if (p[0] == id)
+        {
+            *length = p[1];
+            return p + 2;
+        }
+        p += 2 + p[1];
     }
+    return NULL;
+}
+
+void romi_rx_stats(romi_rx_stats_t *const stats)
+{
+    CRITICAL_REGION_ENTER();
+    *stats = rx_stats;
+    CRITICAL_REGION_EXIT();
+}
 
-    // parse response
-    _romi_parse_sensor_packet(packet, sensors);
+void romi_tx_stats(romi_tx_stats_t *const stats)
+{
+    CRITICAL_REGION_ENTER();
+    *stats = tx_stats;
+    CRITICAL_REGION_EXIT();
+}
 
-    return status;
+uint32_t romi_sensors_age_ms(void)
+{
+    _romi_rx_drain();
+    if (!rx_have_packet)
+    {
+        return UINT32_MAX;
+    }
+    uint32_t ticks = app_timer_cnt_diff_compute(app_timer_cnt_get(), rx_packet_tick);
+    return (uint32_t)(((uint64_t)ticks * 1000) / APP_TIMER_CLOCK_FREQ);
 }
@@ -75,6 +75,115 @@ typedef struct
 
 } romi_sensors_t;
 
+/**
+ * @brief Identifiers of the sub-payloads in a sensor packet.
+ * These follow the Kobuki protocol. Which ones are sent depends on the
+ * firmware on the robot.
+ */
+#define ROMI_ID_BASIC            0x01
+#define ROMI_ID_DOCKING_IR       0x03
+#define ROMI_ID_INERTIAL         0x04
+#define ROMI_ID_CLIFF            0x05
+#define ROMI_ID_CURRENT          0x06
+#define ROMI_ID_HARDWARE_VERSION 0x0A
+#define ROMI_ID_FIRMWARE_VERSION 0x0B
+#define ROMI_ID_GYRO             0x0D
+#define ROMI_ID_GPIO             0x10
+#define ROMI_ID_UNIQUE_ID        0x13
+#define ROMI_ID_CONTROLLER_INFO  0x15
+// One more than the largest identifier that is decoded.
+#define ROMI_ID_MAX              0x20
+
+// Largest number of raw gyro samples kept from one packet.
+#define ROMI_GYRO_MAX_SAMPLES 4
+
+/**
+ * @brief Heading from the on-board gyro, in hundredths of a degree.
+ */
+typedef struct
+{
+    int16_t angle;      // Heading relative to the heading at power on.
+    int16_t angle_rate; // Hundredths of a degree per second.
+} romi_inertial_t;
+
+/**
+ * @brief Raw 3-axis gyro samples, in units of 0.00875 degrees per second.
+ */
+typedef struct
+{
+    uint8_t frame_id; // Increments with each batch of samples.
+    uint8_t count;    // Number of valid entries in samples.
+    struct
+    {
+        int16_t x;
+        int16_t y;
+        int16_t z;
+    } samples[ROMI_GYRO_MAX_SAMPLES];
+} romi_gyro_t;
+
+/**
+ * @brief General purpose inputs.
+ */
+typedef struct
+{
+    uint16_t digital;   // One bit per digital input.
+    uint16_t analog[4]; // 12-bit readings of the analog inputs.
+} romi_gpio_t;
+
+/**
+ * @brief All the sensor data that the Romi can send.
+ * Fields of a sub-payload that was absent from the most recent packet
+ * keep the values from the last packet that had it. Check `present`
+ * to see which sub-payloads the most recent packet had.
+ */
+typedef struct
+{
+    // The data also available from romi_sensors_poll().
+    romi_sensors_t basic;
+
+    // Bit (1 << id) is set for each sub-payload decoded from the most recent packet.
+    uint32_t present;
+
+    // The rest of the basic sensor data.
+    uint8_t wheel_drops;  // Bit 0 right, bit 1 left.
+    int8_t pwm_left;      // Motor PWM, -100 to 100.
+    int8_t pwm_right;
+    uint8_t charger;      // Charging state.
+    uint8_t battery;      // Battery voltage in units of 0.1 V.
+    uint8_t overcurrent;  // Bit 0 left motor, bit 1 right motor.
+
+    uint8_t docking_ir[3]; // Docking signals, right, center, left.
+    romi_inertial_t inertial;
+    uint16_t cliff[3];     // 12-bit readings of the cliff sensors, right, center, left.
+    uint8_t current[2];    // Motor currents, left and right, in units of 10 mA.
+    romi_gyro_t gyro;
+    romi_gpio_t gpio;
+} romi_sensors_ext_t;
+
+/**
+ * @brief Counters for the data received from the Romi.
+ */
+typedef struct
+{
+    uint32_t packets;         // Packets received with a valid checksum.
+    uint32_t packets_dropped; // Valid packets replaced by a newer one before any poll returned them.
+    uint32_t checksum_errors; // Packets discarded because of a bad checksum.
+    uint32_t resyncs;         // Times the packet boundaries were lost and searched for again.
+    uint32_t bytes_dropped;   // Bytes lost because the receive buffer was full.
+    uint32_t uart_errors;     // Framing, parity, or overrun errors reported by the UART.
+} romi_rx_stats_t;
+
+/**
+ * @brief Counters for the commands sent to the Romi.
+ */
+typedef struct
+{
+    uint32_t queued;    // Frames added to the transmit queue.
+    uint32_t coalesced; // Drive commands that replaced a waiting one instead of being queued.
+    uint32_t sent;      // Frames sent completely.
+    uint32_t dropped;   // Frames discarded because the queue was full or the UART refused them.
+} romi_tx_stats_t;
+
 //////////////////////////////////////////////////////////////
 //// Functions
 
@@ -94,6 +203,9 @@ bool romi_button_pressed(romi_sensors_t *const sensors);
  * The speed is in units of mm/s.
  * A good starting point for experimentations is 75 mm/s.
  * This function assumes that romi_init() has been called.
+ * The command is queued and sent in the background, so this function
+ * does not wait for the UART. If an earlier drive command is still
+ * waiting to be sent, it is replaced by this one.
  *
  * @param left_wheel_speed The left wheel speed in mm/s.
  * @param right_wheel_speed The right wheel speed in mm/s.
@@ -109,10 +221,58 @@ uint32_t romi_init();
 
 /**
  * @brief Read the sensors from the Romi robot.
+ * The robot streams sensor packets continuously, and they are received in the
+ * background. This function does not wait for a packet. It writes the most
+ * recent packet with a valid checksum into `sensors`, or all zeros if none has
+ * arrived yet. Use romi_sensors_age_ms() to find out how old that packet is.
  *
  * @param sensors The struct into which to write the sensor values.
  * @return int32_t An error code that should be checked using the macro APP_ERROR_CHECK.
  */
 int32_t romi_sensors_poll(romi_sensors_t *const sensors);
 
+/**
+ * @brief Like romi_sensors_poll(), but write all the decoded sensor data.
+ *
+ * @param sensors The struct into which to write the sensor values.
+ * @return int32_t An error code that should be checked using the macro APP_ERROR_CHECK.
+ */
+int32_t romi_sensors_ext_poll(romi_sensors_ext_t *const sensors);
+
+/**
+ * @brief Return a pointer to the data of a sub-payload in the most recent
+ * valid sensor packet, without copying it. This gives access to
+ * sub-payloads that are not decoded, such as ROMI_ID_UNIQUE_ID.
+ * The data is only valid until the next call to a romi_sensors_ function,
+ * which may replace the packet.
+ *
+ * @param id The identifier of the sub-payload, such as ROMI_ID_CLIFF.
+ * @param length Where to write the length of the data.
+ * @return A pointer to the data, following the identifier and length bytes,
+ *  or NULL if the packet does not have the sub-payload.
+ */
+const uint8_t *romi_sensors_raw(uint8_t id, uint8_t *length);
+
+/**
+ * @brief Return the time in milliseconds since the most recent valid sensor
+ * packet arrived, or UINT32_MAX if none has arrived since romi_init().
+ * A steadily growing age means the robot has stopped sending,
+ * for example because it is switched off.
+ */
+uint32_t romi_sensors_age_ms(void);
+
+/**
+ * @brief Get counters for the data received from the Romi since romi_init().
+ *
+ * @param stats The struct into which to write the counters.
+ */
+void romi_rx_stats(romi_rx_stats_t *const stats);
+
+/**
+ * @brief Get counters for the commands sent to the Romi since romi_init().
+ *
+ * @param stats The struct into which to write the counters.
+ */
+void romi_tx_stats(romi_tx_stats_t *const stats);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,156 @@
+/**
+ * @file romi_framer.c
+ * @brief Implementation of the incremental Kobuki packet framer.
+ */
+#include "lib/romi_framer.h"
+#include <string.h> // Defines memchr, memcpy, memmove
+
+/**
+ * @brief Return the offset of the first possible header in the specified
+ * bytes. That is either 0xAA 0x55 or a 0xAA that is the last byte.
+ * If there is none, return length.
+ */
+static size_t _romi_framer_find_header(const uint8_t *data, size_t length)
+{
+    const uint8_t *p = data;
+    const uint8_t *end = data + length;
+    while ((p = memchr(p, 0xAA, end - p)) != NULL)
+    {
+        if (p + 1 == end || p[1] == 0x55)
+        {
+            return p - data;
+        }
+        p++;
+    }
+    return length;
+}
+
+/**
+ * @brief Count discarded bytes. A run of discarded bytes between two
+ * valid packets counts as one resync, however it was fed in.
+ */
+static void _romi_framer_count_discard(romi_framer_t *framer, size_t count)
+{
+    framer->bytes_discarded += count;
+    if (!framer->lost)
+    {
+        framer->lost = true;
+        framer->resyncs++;
+    }
+}
+
+/**
+ * @brief Frame as many packets as possible from the buffered bytes.
+ */
+static void _romi_framer_run(romi_framer_t *framer)
+{
+    while (1)
+    {
+        uint8_t *data = framer->buffer + framer->start;
+        size_t length = framer->end - framer->start;
+
+        if (length == 0)
+        {
+            return;
+        }
+        // Usually the bytes already start with a header.
+        bool header = data[0] == 0xAA && (length == 1 || data[1] == 0x55);
+        size_t skip = header ? 0 : _romi_framer_find_header(data, length);
+        if (skip > 0)
+        {
+            framer->start += skip;
+            _romi_framer_count_discard(framer, skip);
+            continue;
+        }
+        if (length < 3)
+        {
+            return;
+        }
+        size_t packet_length = data[2] + 4;
+        if (length < packet_length)
+        {
+            return;
+        }
+
+        // XOR of the length, payload, and checksum is zero for a valid packet.
+        uint8_t cs = 0;
+        for (size_t i = 2; i < packet_length; i++)
+        {
+            cs ^= data[i];
+        }
+        if (cs == 0)
+        {
+            framer->start += packet_length;
+            framer->frames++;
+            framer->lost = false;
+            framer->handler(data, packet_length, framer->context);
+        }
+        else
+        {
+            // Rescan from the byte after this header.
+            framer->bad_checksums++;
+            framer->start += 1;
+            _romi_framer_count_discard(framer, 1);
+        }
+    }
+}
+
+void romi_framer_init(romi_framer_t *framer, romi_frame_handler_t handler, void *context)
+{
+    memset(framer, 0, sizeof(*framer));
+    framer->handler = handler;
+    framer->context = context;
+}
+
+void romi_framer_reset(romi_framer_t *framer)
+{
+    framer->bytes_discarded += framer->end - framer->start;
+    framer->start = 0;
+    framer->end = 0;
+}
+
+void romi_framer_feed(romi_framer_t *framer, const uint8_t *data, size_t length)
+{
+    while (length > 0)
+    {
+        // Move the unframed bytes to the front when the buffer is full.
+        // After framing, fewer than ROMI_FRAME_MAX bytes are left, so this
+        // always makes room.
+        if (framer->end == ROMI_FRAME_MAX)
+        {
+            size_t unframed = framer->end - framer->start;
+            memmove(framer->buffer, framer->buffer + framer->start, unframed);
+            framer->start = 0;
+            framer->end = unframed;
+        }
+        // Skip garbage without copying it in.
+        if (framer->start == framer->end)
+        {
+            size_t skip = _romi_framer_find_header(data, length);
+            if (skip > 0)
+            {
+                _romi_framer_count_discard(framer, skip);
+                data += skip;
+                length -= skip;
+                framer->start = 0;
+                framer->end = 0;
+                continue;
+            }
+        }
+        size_t count = ROMI_FRAME_MAX - framer->end;
+        if (count > length)
+        {
+            count = length;
+        }
+        memcpy(framer->buffer + framer->end, data, count);
+        framer->end += count;
+        data += count;
+        length -= count;
+        _romi_framer_run(framer);
+        if (framer->start == framer->end)
+        {
+            framer->start = 0;
+            framer->end = 0;
+        }
+    }
+}
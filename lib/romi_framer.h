@@ -0,0 +1,84 @@
+/**
+ * @file romi_framer.h
+ * @brief Incremental framer for packets in the Kobuki serial protocol
+ * used by the Romi robot.
+ *
+ * A packet is the header bytes 0xAA 0x55, a length byte, that many bytes
+ * of payload, and a checksum byte, which is the XOR of the length and payload.
+ * The framer is fed received bytes in chunks of any size and calls a handler
+ * for each complete packet with a valid checksum. It does no allocation and
+ * does not touch any hardware, so it can be used from a receive path on the
+ * nRF52 and tested on the host alike.
+ *
+ * When a checksum fails, the framer does not throw away the buffered bytes,
+ * because the start of a good packet may be among them (for example, when
+ * the length byte of the bad packet was corrupted). It rescans them for the
+ * next header instead.
+ */
+#ifndef ROMI_FRAMER_H
+#define ROMI_FRAMER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Size of the largest packet: header, length, 255 bytes of payload, and checksum.
+#define ROMI_FRAME_MAX (3 + 255 + 1)
+
+/**
+ * @brief Function called with each complete packet with a valid checksum.
+ *
+ * @param packet The whole packet, starting with the header. This is only
+ *  valid until the handler returns.
+ * @param length The length of the packet, including header and checksum.
+ * @param context The context given to romi_framer_init().
+ */
+typedef void (*romi_frame_handler_t)(const uint8_t *packet, size_t length, void *context);
+
+/**
+ * @brief Framer state. Treat the fields as read only, except for the counters,
+ * which may be reset by the user.
+ */
+typedef struct
+{
+    uint8_t buffer[ROMI_FRAME_MAX];
+    uint16_t start; // Index in buffer of the first byte not yet framed.
+    uint16_t end;   // Index in buffer one past the last byte received.
+    romi_frame_handler_t handler;
+    void *context;
+    bool lost; // Bytes have been discarded since the last valid packet.
+
+    uint32_t frames;          // Packets passed to the handler.
+    uint32_t bad_checksums;   // Packets discarded because of a bad checksum.
+    uint32_t resyncs;         // Times the framer lost track of packet boundaries.
+    uint32_t bytes_discarded; // Bytes that were not part of any valid packet.
+} romi_framer_t;
+
+/**
+ * @brief Initialize a framer with no buffered bytes and zero counters.
+ *
+ * @param framer The framer.
+ * @param handler The function to call with each packet.
+ * @param context Passed to the handler.
+ */
+void romi_framer_init(romi_framer_t *framer, romi_frame_handler_t handler, void *context);
+
+/**
+ * @brief Discard any partial packet, for example because bytes following
+ * it were lost. Counters are kept.
+ *
+ * @param framer The framer.
+ */
+void romi_framer_reset(romi_framer_t *framer);
+
+/**
+ * @brief Feed received bytes to the framer. The handler is called before
+ * this returns for every packet these bytes complete.
+ *
+ * @param framer The framer.
+ * @param data The received bytes.
+ * @param length The number of bytes.
+ */
+void romi_framer_feed(romi_framer_t *framer, const uint8_t *data, size_t length);
+
+#endif // ROMI_FRAMER_H
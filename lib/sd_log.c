@@ -0,0 +1,140 @@
+/**
+ * @file sd_log.c
+ * @brief Implementation of double-buffered logging to the SD card.
+ *
+ * Of the two buffers, buffers[filling] is being encoded into, and the
+ * other is full, and being or waiting to be written, or free. The main
+ * program sets full, and the SD card event handler clears it when the
+ * write is done, so each flag has one writer at a time. While the card
+ * starts, the other buffer holds the first block read from the card.
+ */
+
+#include "sd_log.h"
+#include <string.h>
+#include "app_util_platform.h" // Defines CRITICAL_REGION_ENTER() and CRITICAL_REGION_EXIT()
+#include "buckler.h"           // Defines BUCKLER_SD_ENABLE etc.
+#include "nrf_gpio.h"
+
+// The log, for the event handler.
+static sd_log_t *active = NULL;
+
+// Start writing the full buffer, if there is one and the card is free.
+static void start_write(sd_log_t *log) {
+    bool start = false;
+    CRITICAL_REGION_ENTER();
+    if (log->state == SD_LOG_READY && log->full && !log->writing
+            && log->next_block < log->end_block) {
+        log->writing = true;
+        start = true;
+    }
+    CRITICAL_REGION_EXIT();
+    if (!start) return;
+    if (app_sdc_block_write(log->buffers[!log->filling], log->next_block, 1) != NRF_SUCCESS) {
+        log->errors++;
+        log->writing = false;
+        log->full = false;
+    }
+}
+
+// Hand the buffer being filled over to be written, and begin the next
+// block in the other one, which must be free.
+static void next_buffer(sd_log_t *log) {
+    log_codec_config_t config = log->writer.config;
+    log->full = true;
+    log->filling = !log->filling;
+    log->sequence++;
+    log_codec_begin(&log->writer, &config, log->buffers[log->filling], SD_LOG_BLOCK_SIZE,
+                    log->sequence);
+    start_write(log);
+}
+
+static void sdc_event_handler(sdc_evt_t const *event) {
+    sd_log_t *log = active;
+    switch (event->type) {
+        case APP_SDC_EVT_INIT:
+            if (event->result != SDC_SUCCESS) {
+                log->state = SD_LOG_FAILED;
+                break;
+            }
+            log->end_block = app_sdc_info_get()->num_blocks;
+            if (app_sdc_block_read(log->buffers[!log->filling], log->next_block, 1) != NRF_SUCCESS) {
+                log->state = SD_LOG_FAILED;
+            }
+            break;
+        case APP_SDC_EVT_READ: {
+            // Follow on from the session of the log being overwritten.
+            uint32_t session = 1;
+            log_codec_reader_t reader;
+            if (event->result == SDC_SUCCESS
+                    && log_codec_open(&reader, log->buffers[!log->filling], SD_LOG_BLOCK_SIZE)
+                    == NRF_SUCCESS) {
+                session = reader.config.session + 1;
+            }
+            log_codec_set_session(&log->writer, session);
+            log->state = SD_LOG_READY;
+            break;
+        }
+        case APP_SDC_EVT_WRITE:
+            // A block that failed is lost, and the next takes its place.
+            if (event->result == SDC_SUCCESS) {
+                log->blocks++;
+                log->next_block++;
+            } else {
+                log->errors++;
+            }
+            log->writing = false;
+            log->full = false;
+            break;
+    }
+}
+
+ret_code_t sd_log_init(sd_log_t *log, log_codec_config_t const *config, uint32_t first_block) {
+    memset(log, 0, sizeof(*log));
+    log->state = SD_LOG_STARTING;
+    log->next_block = first_block;
+    log_codec_begin(&log->writer, config, log->buffers[0], SD_LOG_BLOCK_SIZE, 0);
+    active = log;
+
+    // Power up the card.
+    nrf_gpio_cfg_output(BUCKLER_SD_ENABLE);
+    nrf_gpio_pin_set(BUCKLER_SD_ENABLE);
+
+    app_sdc_config_t sdc_config = APP_SDCARD_CONFIG(BUCKLER_SD_MOSI, BUCKLER_SD_MISO,
+                                                    BUCKLER_SD_SCLK, BUCKLER_SD_CS);
+    ret_code_t error_code = app_sdc_init(&sdc_config, sdc_event_handler);
+    if (error_code != NRF_SUCCESS) {
+        log->state = SD_LOG_FAILED;
+    }
+    return error_code;
+}
+
+bool sd_log_append(sd_log_t *log, log_codec_record_t const *record) {
+    if (log->state != SD_LOG_FAILED && log_codec_append(&log->writer, record)) {
+        log->records++;
+        return true;
+    }
+    // Until the card is ready, the other buffer is not free.
+    if (log->state != SD_LOG_READY || log->full) {
+        log->dropped++;
+        return false;
+    }
+    next_buffer(log);
+    // A record always fits in an empty block.
+    log_codec_append(&log->writer, record);
+    log->records++;
+    return true;
+}
+
+ret_code_t sd_log_flush(sd_log_t *log) {
+    if (log->writer.count == 0) return NRF_SUCCESS;
+    if (log->state == SD_LOG_FAILED) return NRF_ERROR_INVALID_STATE;
+    if (log->state != SD_LOG_READY || log->full) return NRF_ERROR_BUSY;
+    next_buffer(log);
+    return NRF_SUCCESS;
+}
+
+bool sd_log_busy(sd_log_t const *log) {
+    // A block cannot wait for a full card.
+    return log->state == SD_LOG_STARTING || log->writing
+            || (log->full && log->next_block < log->end_block);
+}
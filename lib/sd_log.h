@@ -0,0 +1,105 @@
+/**
+ * @file sd_log.h
+ * @brief Double-buffered logging of sensor records to the SD card on the
+ * Buckler, in the blocks of lib/log_codec.h.
+ *
+ * Records are encoded into one block-sized RAM buffer. When it is full,
+ * the log starts writing it to the card and goes on encoding into the
+ * other buffer, so sd_log_append() only ever encodes and never waits for
+ * the card. The write finishes in the background, in the SD card
+ * library's interrupt. If the card falls so far behind that both buffers
+ * are full, records are dropped and counted rather than waited for.
+ *
+ * The card is written as raw blocks, from a first block onward, without
+ * a file system, so use a card set aside for logging. Each log has a
+ * session number one more than that of the log it overwrites, found in
+ * the first block when the card starts, so that a reader can tell where
+ * the new log ends and the blocks of the old one begin. To read a log,
+ * copy the blocks off the card, for example with
+ *
+ *     dd if=/dev/sdX of=log.img bs=512 count=2048
+ *
+ * and decode them with scripts/sensor_log_decode.py.
+ *
+ * There is one card, so there is one log at a time.
+ */
+
+#ifndef SD_LOG_H
+#define SD_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_sdcard.h"
+#include "lib/log_codec.h"
+#include "sdk_errors.h"
+
+#define SD_LOG_BLOCK_SIZE SDC_SECTOR_SIZE
+
+/**
+ * @brief State of the card.
+ */
+typedef enum {
+    SD_LOG_STARTING, // Initializing the card and reading the first block.
+    SD_LOG_READY,
+    SD_LOG_FAILED,   // The card did not start. Records are dropped.
+} sd_log_state_t;
+
+/**
+ * @brief Log state, set up by sd_log_init(). The card's event handler
+ * updates state, full, writing, next_block, blocks, and errors, so read
+ * them once sd_log_busy() returns false.
+ */
+typedef struct {
+    uint8_t buffers[2][SD_LOG_BLOCK_SIZE];
+    log_codec_writer_t writer; // Encoding into buffers[filling].
+    uint8_t filling;
+    volatile sd_log_state_t state;
+    volatile bool full;        // buffers[!filling] holds a block to write.
+    volatile bool writing;     // It is being written.
+    uint32_t sequence;         // Of the block being filled.
+    uint32_t next_block;       // Card block for the next block written.
+    uint32_t end_block;        // One past the last card block to use.
+
+    uint32_t records;          // Records encoded.
+    uint32_t dropped;          // Records dropped because both buffers were full.
+    uint32_t blocks;           // Blocks written.
+    uint32_t errors;           // Blocks that failed to write, and are lost.
+                               // The next block is written in place of each.
+} sd_log_t;
+
+/**
+ * @brief Power up and start the card, and begin a log. The card starts in
+ * the background; records appended meanwhile are kept, up to one block.
+ * @param log The log.
+ * @param config What is logged. The session number is replaced by one
+ *  more than that of a log found at first_block, or 1 if there is none.
+ * @param first_block The card block at which to start.
+ * @return An error code that should be checked using the macro APP_ERROR_CHECK.
+ */
+ret_code_t sd_log_init(sd_log_t *log, log_codec_config_t const *config, uint32_t first_block);
+
+/**
+ * @brief Encode a record, starting to write the block to the card if
+ * the record completes it. This never waits for the card.
+ * @param log The log.
+ * @param record The record.
+ * @return false if the record was dropped.
+ */
+bool sd_log_append(sd_log_t *log, log_codec_record_t const *record);
+
+/**
+ * @brief Start writing the records in the buffer being filled, in a
+ * block of their own, for example before shutting down.
+ * @param log The log.
+ * @return NRF_SUCCESS, or NRF_ERROR_BUSY if the other buffer is still
+ *  waiting to be written, in which case call again later.
+ */
+ret_code_t sd_log_flush(sd_log_t *log);
+
+/**
+ * @brief Whether a block is being or waiting to be written. When the
+ * card is full, blocks no longer wait, and records are dropped.
+ */
+bool sd_log_busy(sd_log_t const *log);
+
+#endif // SD_LOG_H
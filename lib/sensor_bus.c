@@ -0,0 +1,28 @@
+/**
+ * @file sensor_bus.c
+ * @brief Implementation of the shared sensor bus.
+ */
+
+#include "sensor_bus.h"
+#include <stdbool.h>
+#include "buckler.h" // Defines BUCKLER_SENSORS_SCL, BUCKLER_SENSORS_SDA
+#include "lsm9ds1.h" // Defines lsm9ds1_init
+
+// TWI manager with a queue of 5 transactions on TWI instance 0.
+NRF_TWI_MNGR_DEF(twi_mngr_instance, 5, 0);
+
+static bool initialized = false;
+
+nrf_twi_mngr_t const *sensor_bus_init(void) {
+    if (initialized) return &twi_mngr_instance;
+    initialized = true;
+
+    nrf_drv_twi_config_t i2c_config = NRF_DRV_TWI_DEFAULT_CONFIG;
+    i2c_config.scl = BUCKLER_SENSORS_SCL;
+    i2c_config.sda = BUCKLER_SENSORS_SDA;
+    ret_code_t error_code = nrf_twi_mngr_init(&twi_mngr_instance, &i2c_config);
+    APP_ERROR_CHECK(error_code);
+
+    lsm9ds1_init(&twi_mngr_instance);
+    return &twi_mngr_instance;
+}
@@ -0,0 +1,23 @@
+/**
+ * @file sensor_bus.h
+ * @brief The I2C bus of the sensors on the Buckler board, shared by all
+ * the reactors that use it.
+ *
+ * The bus and its TWI manager can only be set up once, so reactors such
+ * as IMU and GyroAngle get them from sensor_bus_init() rather than each
+ * defining their own.
+ */
+
+#ifndef SENSOR_BUS_H
+#define SENSOR_BUS_H
+
+#include "nrf_twi_mngr.h" // Defines nrf_twi_mngr_t
+
+/**
+ * @brief Set up the sensor bus and the LSM9DS1 driver, if that has not
+ * been done yet, and return the TWI manager of the bus.
+ * Errors are reported with APP_ERROR_CHECK.
+ */
+nrf_twi_mngr_t const *sensor_bus_init(void);
+
+#endif // SENSOR_BUS_H
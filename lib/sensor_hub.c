@@ -0,0 +1,71 @@
+/**
+ * @file sensor_hub.c
+ * @brief Implementation of the shared IMU read schedule.
+ */
+
+#include "sensor_hub.h"
+#include <string.h>
+
+static int64_t gcd(int64_t a, int64_t b) {
+    while (b != 0) {
+        int64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+void sensor_hub_init(sensor_hub_t *hub) {
+    memset(hub, 0, sizeof(*hub));
+}
+
+int sensor_hub_subscribe(sensor_hub_t *hub, int index, sensor_hub_subscription_t subscription) {
+    if (index < 0 || index >= SENSOR_HUB_MAX_SUBSCRIBERS) return -1;
+    if (subscription.period <= 0) {
+        subscription.sensors = 0;
+        subscription.period = 0;
+    }
+    hub->subscriptions[index] = subscription;
+
+    hub->tick = 0;
+    for (int i = 0; i < SENSOR_HUB_MAX_SUBSCRIBERS; i++) {
+        const sensor_hub_subscription_t *s = &hub->subscriptions[i];
+        if (s->sensors) hub->tick = gcd(hub->tick, s->period);
+    }
+    hub->count = 0;
+    return 0;
+}
+
+int64_t sensor_hub_tick(const sensor_hub_t *hub) {
+    return hub->tick;
+}
+
+uint32_t sensor_hub_step(sensor_hub_t *hub, uint8_t *sensors) {
+    uint32_t due = 0;
+    *sensors = 0;
+    if (hub->tick == 0) return 0;
+    if (hub->pending) {
+        // Keep to the schedule, without those due now.
+        hub->count++;
+        return 0;
+    }
+    for (int i = 0; i < SENSOR_HUB_MAX_SUBSCRIBERS; i++) {
+        const sensor_hub_subscription_t *s = &hub->subscriptions[i];
+        if (s->sensors && hub->count % (uint64_t)(s->period / hub->tick) == 0) {
+            due |= (uint32_t)1 << i;
+            *sensors |= s->sensors;
+        }
+    }
+    hub->count++;
+    return due;
+}
+
+void sensor_hub_read_started(sensor_hub_t *hub, uint32_t due) {
+    hub->pending = due;
+}
+
+uint32_t sensor_hub_read_done(sensor_hub_t *hub) {
+    uint32_t due = hub->pending;
+    hub->pending = 0;
+    return due;
+}
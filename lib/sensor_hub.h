@@ -0,0 +1,92 @@
+/**
+ * @file sensor_hub.h
+ * @brief Scheduling of shared IMU reads for several consumers, each with
+ * its own rate.
+ *
+ * Each consumer subscribes to a set of sensors (LSM9DS1_ACC etc.) with a
+ * period. The hub ticks at the greatest common divisor of the periods,
+ * and at each tick it reads, once, every sensor that some consumer due
+ * at that tick wants. So bus traffic depends on the distinct sensors and
+ * rates, not on the number of consumers.
+ *
+ * One read is in flight at a time. The hub keeps the consumers that a
+ * read is for from when it starts, with sensor_hub_read_started(), until
+ * its reading is handed out, with sensor_hub_read_done(), and skips the
+ * ticks in between. The end of the bus transfer is not enough: with an
+ * LF reactor, the transfer ends in an interrupt and the reading is handed
+ * out later by a physical action, after which the next tick may already
+ * have come.
+ */
+
+#ifndef SENSOR_HUB_H
+#define SENSOR_HUB_H
+
+#include <stdint.h>
+
+#define SENSOR_HUB_MAX_SUBSCRIBERS 32
+
+/**
+ * @brief What a consumer wants.
+ */
+typedef struct {
+    uint8_t sensors; // LSM9DS1_ACC | LSM9DS1_GYRO | LSM9DS1_MAG, or 0 to unsubscribe.
+    int64_t period;  // Nanoseconds between readings, such as an LF interval_t.
+} sensor_hub_subscription_t;
+
+/**
+ * @brief Hub state. Use the functions below rather than the fields.
+ */
+typedef struct {
+    sensor_hub_subscription_t subscriptions[SENSOR_HUB_MAX_SUBSCRIBERS];
+    int64_t tick;      // GCD of the periods, or 0 with no subscribers.
+    uint64_t count;    // Ticks since the last change of subscriptions.
+    uint32_t pending;  // Consumers the read in flight is for.
+} sensor_hub_t;
+
+/**
+ * @brief Initialize a hub with no subscribers.
+ */
+void sensor_hub_init(sensor_hub_t *hub);
+
+/**
+ * @brief Set the subscription of a consumer, replacing any earlier one.
+ * The next tick is the first of a new schedule, at which every
+ * consumer is due.
+ * @param hub The hub.
+ * @param index The consumer, less than SENSOR_HUB_MAX_SUBSCRIBERS.
+ * @param subscription What it wants. A period of zero or less unsubscribes.
+ * @return 0 on success, or -1 if the index is out of range.
+ */
+int sensor_hub_subscribe(sensor_hub_t *hub, int index, sensor_hub_subscription_t subscription);
+
+/**
+ * @brief Get the time between ticks in nanoseconds, or 0 if there are no
+ * subscribers.
+ */
+int64_t sensor_hub_tick(const sensor_hub_t *hub);
+
+/**
+ * @brief Advance the schedule by one tick.
+ * @param hub The hub.
+ * @param sensors Set to the sensors to read at this tick.
+ * @return The consumers due at this tick, as a bitmask with bit i for
+ *  consumer i. They all get the same reading. 0 if a read is in flight,
+ *  in which case the tick is skipped.
+ */
+uint32_t sensor_hub_step(sensor_hub_t *hub, uint8_t *sensors);
+
+/**
+ * @brief Record that the read for the consumers due at a tick started.
+ * @param hub The hub.
+ * @param due The consumers, from sensor_hub_step().
+ */
+void sensor_hub_read_started(sensor_hub_t *hub, uint32_t due);
+
+/**
+ * @brief End the read in flight, when its reading is handed out.
+ * @param hub The hub.
+ * @return The consumers that get the reading, or 0 if no read was in flight.
+ */
+uint32_t sensor_hub_read_done(sensor_hub_t *hub);
+
+#endif // SENSOR_HUB_H
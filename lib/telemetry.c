@@ -0,0 +1,202 @@
+/**
+ * @file telemetry.c
+ * @brief Implementation of telemetry frames.
+ */
+
+#include "telemetry.h"
+#include <math.h>
+#include <string.h>
+#include "nrf_error.h"
+
+static size_t put_varint(uint8_t *p, uint32_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        p[n++] = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+    p[n++] = (uint8_t)value;
+    return n;
+}
+
+/**
+ * Decode a varint from at most `length` bytes, returning the number of
+ * bytes it takes, or 0 if it does not end within them.
+ */
+static size_t get_varint(const uint8_t *p, size_t length, uint32_t *value) {
+    uint32_t v = 0;
+    for (size_t n = 0; n < length && n < 5; n++) {
+        v |= (uint32_t)(p[n] & 0x7F) << (7 * n);
+        if (!(p[n] & 0x80)) {
+            *value = v;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+static uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static void put_u16(uint8_t *p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static size_t put_full(uint8_t *p, const telemetry_sample_t *s) {
+    put_u16(p, (uint16_t)s->time);
+    put_u16(p + 2, (uint16_t)(s->time >> 16));
+    put_u16(p + 4, s->left_encoder);
+    put_u16(p + 6, s->right_encoder);
+    p[8] = s->bumpers;
+    for (int i = 0; i < 3; i++) {
+        put_u16(p + 9 + 2 * i, (uint16_t)s->accel[i]);
+        put_u16(p + 15 + 2 * i, (uint16_t)s->gyro[i]);
+    }
+    return TELEMETRY_SAMPLE_FULL;
+}
+
+static void get_full(const uint8_t *p, telemetry_sample_t *s) {
+    s->time = get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+    s->left_encoder = get_u16(p + 4);
+    s->right_encoder = get_u16(p + 6);
+    s->bumpers = p[8];
+    for (int i = 0; i < 3; i++) {
+        s->accel[i] = (int16_t)get_u16(p + 9 + 2 * i);
+        s->gyro[i] = (int16_t)get_u16(p + 15 + 2 * i);
+    }
+}
+
+static size_t put_delta(uint8_t *p, const telemetry_sample_t *from, const telemetry_sample_t *to) {
+    size_t n = put_varint(p, to->time - from->time);
+    n += put_varint(p + n, zigzag((int16_t)(to->left_encoder - from->left_encoder)));
+    n += put_varint(p + n, zigzag((int16_t)(to->right_encoder - from->right_encoder)));
+    p[n++] = to->bumpers;
+    for (int i = 0; i < 3; i++) {
+        n += put_varint(p + n, zigzag((int32_t)to->accel[i] - from->accel[i]));
+    }
+    for (int i = 0; i < 3; i++) {
+        n += put_varint(p + n, zigzag((int32_t)to->gyro[i] - from->gyro[i]));
+    }
+    return n;
+}
+
+/**
+ * Decode a difference from at most `length` bytes, returning the number
+ * of bytes it takes, or 0 if it does not end within them.
+ */
+static size_t get_delta(const uint8_t *p, size_t length, const telemetry_sample_t *from,
+                        telemetry_sample_t *to) {
+    // The time, the two encoders, and the six IMU axes, with the bumper byte
+    // after the encoders.
+    uint32_t values[9];
+    size_t n = 0;
+    for (int i = 0; i < 9; i++) {
+        if (i == 3) {
+            if (n == length) return 0;
+            to->bumpers = p[n++];
+        }
+        size_t used = get_varint(p + n, length - n, &values[i]);
+        if (used == 0) return 0;
+        n += used;
+    }
+    to->time = from->time + values[0];
+    to->left_encoder = from->left_encoder + (uint16_t)unzigzag(values[1]);
+    to->right_encoder = from->right_encoder + (uint16_t)unzigzag(values[2]);
+    for (int i = 0; i < 3; i++) {
+        to->accel[i] = (int16_t)(from->accel[i] + unzigzag(values[3 + i]));
+        to->gyro[i] = (int16_t)(from->gyro[i] + unzigzag(values[6 + i]));
+    }
+    return n;
+}
+
+void telemetry_encoder_init(telemetry_encoder_t *encoder, size_t capacity) {
+    memset(encoder, 0, sizeof(*encoder));
+    if (capacity > TELEMETRY_FRAME_MAX) capacity = TELEMETRY_FRAME_MAX;
+    if (capacity < TELEMETRY_HEADER_SIZE + TELEMETRY_SAMPLE_FULL) {
+        capacity = TELEMETRY_HEADER_SIZE + TELEMETRY_SAMPLE_FULL;
+    }
+    encoder->capacity = capacity;
+}
+
+bool telemetry_encoder_add(telemetry_encoder_t *encoder, const telemetry_sample_t *sample) {
+    if (encoder->length == 0) {
+        encoder->frame[0] = TELEMETRY_VERSION;
+        encoder->frame[1] = 0;
+        put_u16(encoder->frame + 2, encoder->sequence);
+        encoder->length = TELEMETRY_HEADER_SIZE
+                + put_full(encoder->frame + TELEMETRY_HEADER_SIZE, sample);
+    } else {
+        if (encoder->frame[1] == UINT8_MAX) return false;
+        uint8_t delta[TELEMETRY_SAMPLE_MAX];
+        size_t n = put_delta(delta, &encoder->last, sample);
+        if (encoder->length + n > encoder->capacity) return false;
+        memcpy(encoder->frame + encoder->length, delta, n);
+        encoder->length += n;
+    }
+    encoder->frame[1]++;
+    encoder->last = *sample;
+    encoder->samples++;
+    return true;
+}
+
+size_t telemetry_encoder_flush(telemetry_encoder_t *encoder, uint8_t *frame) {
+    size_t length = encoder->length;
+    if (length == 0) return 0;
+    memcpy(frame, encoder->frame, length);
+    encoder->length = 0;
+    encoder->sequence++;
+    encoder->frames++;
+    encoder->bytes += length;
+    return length;
+}
+
+ret_code_t telemetry_decode(const uint8_t *frame, size_t length, uint16_t *sequence,
+                            telemetry_sample_t *samples, size_t *count) {
+    if (length < TELEMETRY_HEADER_SIZE) return NRF_ERROR_INVALID_LENGTH;
+    if (frame[0] != TELEMETRY_VERSION) return NRF_ERROR_INVALID_DATA;
+    size_t n = frame[1];
+    if (n > *count) return NRF_ERROR_NO_MEM;
+    *sequence = get_u16(frame + 2);
+
+    size_t position = TELEMETRY_HEADER_SIZE;
+    for (size_t i = 0; i < n; i++) {
+        if (i == 0) {
+            if (position + TELEMETRY_SAMPLE_FULL > length) return NRF_ERROR_INVALID_LENGTH;
+            get_full(frame + position, &samples[0]);
+            position += TELEMETRY_SAMPLE_FULL;
+        } else {
+            size_t used = get_delta(frame + position, length - position, &samples[i - 1], &samples[i]);
+            if (used == 0) return NRF_ERROR_INVALID_LENGTH;
+            position += used;
+        }
+    }
+    if (position != length) return NRF_ERROR_INVALID_LENGTH;
+    *count = n;
+    return NRF_SUCCESS;
+}
+
+static int16_t quantize(float value, float scale) {
+    float scaled = roundf(value * scale);
+    if (scaled > INT16_MAX) return INT16_MAX;
+    if (scaled < INT16_MIN) return INT16_MIN;
+    return (int16_t)scaled;
+}
+
+void telemetry_set_imu(telemetry_sample_t *sample, const lsm9ds1_measurement_t *accel,
+                       const lsm9ds1_measurement_t *gyro) {
+    sample->accel[0] = quantize(accel->x_axis, 1000);
+    sample->accel[1] = quantize(accel->y_axis, 1000);
+    sample->accel[2] = quantize(accel->z_axis, 1000);
+    sample->gyro[0] = quantize(gyro->x_axis, 10);
+    sample->gyro[1] = quantize(gyro->y_axis, 10);
+    sample->gyro[2] = quantize(gyro->z_axis, 10);
+}
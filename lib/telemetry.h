@@ -0,0 +1,145 @@
+/**
+ * @file telemetry.h
+ * @brief Packing of timestamped robot sensor samples into frames that
+ * fit one BLE notification, for streaming telemetry at more than one
+ * sample per connection event.
+ *
+ * A frame is a 4-byte header followed by samples. The header is a version
+ * byte, the number of samples, and a sequence number as a little-endian
+ * uint16, which goes up by one with each frame so that the client can
+ * tell when notifications were lost. The first sample is written in
+ * full, in 21 bytes:
+ *
+ *  - the time in milliseconds as a little-endian uint32,
+ *  - the left and right wheel encoders as little-endian uint16,
+ *  - a byte of bumper bits (TELEMETRY_BUMP_LEFT etc.),
+ *  - the accelerometer x, y, and z in thousandths of a g, and the gyro
+ *    x, y, and z in tenths of a degree per second, as little-endian int16.
+ *
+ * Each following sample is written as its difference from the one before
+ * it: the time difference as an unsigned LEB128 varint, then the encoder
+ * differences (modulo 2^16) as zigzag varints, the bumper byte as is, and
+ * the six IMU differences as zigzag varints. A robot sampled every 10 ms
+ * takes about 10 bytes per sample this way, so a 244-byte frame, the
+ * most that fits the 247-byte ATT MTU in app_config.h, holds more than 20
+ * samples. Since every frame starts with a full sample, a lost frame
+ * loses only its own samples.
+ *
+ * Neither the encoder nor the decoder touches any hardware, and
+ * scripts/ble_scripts/ble_utils.py has a decoder for the client side.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lsm9ds1.h" // Defines lsm9ds1_measurement_t
+#include "sdk_errors.h"
+
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_HEADER_SIZE 4
+// Size of a sample written in full, and the most a difference can take.
+#define TELEMETRY_SAMPLE_FULL 21
+#define TELEMETRY_SAMPLE_MAX (5 + 2 * 3 + 1 + 6 * 3)
+
+// Largest frame: the 247-byte ATT MTU less the 3-byte notification header.
+#define TELEMETRY_FRAME_MAX 244
+
+// Bits of telemetry_sample_t.bumpers.
+#define TELEMETRY_BUMP_LEFT 0x01
+#define TELEMETRY_BUMP_CENTER 0x02
+#define TELEMETRY_BUMP_RIGHT 0x04
+#define TELEMETRY_DROP_LEFT 0x08
+#define TELEMETRY_DROP_RIGHT 0x10
+
+/**
+ * @brief One sample of the robot's sensors.
+ */
+typedef struct {
+    uint32_t time;         // Milliseconds, not decreasing from sample to sample.
+    uint16_t left_encoder;
+    uint16_t right_encoder;
+    uint8_t bumpers;       // TELEMETRY_BUMP_LEFT etc.
+    int16_t accel[3];      // Thousandths of a g.
+    int16_t gyro[3];       // Tenths of a degree per second.
+} telemetry_sample_t;
+
+/**
+ * @brief Encoder state, set up by telemetry_encoder_init(). The encoder
+ * never reads samples, frames, or bytes, so they may be zeroed to start a
+ * new measurement of the compression.
+ */
+typedef struct {
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    size_t capacity;         // Largest frame to build.
+    size_t length;           // Bytes in frame, 0 if it has no samples yet.
+    uint16_t sequence;       // Of the frame being built.
+    telemetry_sample_t last; // The last sample added to frame.
+
+    uint32_t samples; // Samples added.
+    uint32_t frames;  // Frames flushed.
+    uint32_t bytes;   // Bytes in the frames flushed.
+} telemetry_encoder_t;
+
+/**
+ * @brief Initialize an encoder with an empty frame and zero counters.
+ *
+ * @param encoder The encoder.
+ * @param capacity The largest frame to build, which is limited to between
+ *  TELEMETRY_HEADER_SIZE + TELEMETRY_SAMPLE_FULL and TELEMETRY_FRAME_MAX.
+ *  Use the ATT MTU of the connection less 3.
+ */
+void telemetry_encoder_init(telemetry_encoder_t *encoder, size_t capacity);
+
+/**
+ * @brief Add a sample to the frame being built.
+ *
+ * @param encoder The encoder.
+ * @param sample The sample.
+ * @return false if the frame has no room for the sample, in which case
+ *  the frame should be flushed and the sample added again.
+ */
+bool telemetry_encoder_add(telemetry_encoder_t *encoder, const telemetry_sample_t *sample);
+
+/**
+ * @brief Finish the frame being built and start the next one.
+ *
+ * @param encoder The encoder.
+ * @param frame Where to copy the frame, with room for the capacity given
+ *  to telemetry_encoder_init().
+ * @return The length of the frame, or 0 if it had no samples, in which
+ *  case nothing is copied and the sequence number is not used up.
+ */
+size_t telemetry_encoder_flush(telemetry_encoder_t *encoder, uint8_t *frame);
+
+/**
+ * @brief Decode a frame.
+ *
+ * @param frame The frame.
+ * @param length The length of the frame.
+ * @param sequence Set to the sequence number of the frame.
+ * @param samples Where to write the samples.
+ * @param count The room in samples on entry, and the number of samples
+ *  written on return.
+ * @return NRF_SUCCESS, NRF_ERROR_INVALID_DATA if the version is not
+ *  TELEMETRY_VERSION, NRF_ERROR_INVALID_LENGTH if the frame is cut short
+ *  or has bytes left over, or NRF_ERROR_NO_MEM if there is no room for
+ *  all its samples.
+ */
+ret_code_t telemetry_decode(const uint8_t *frame, size_t length, uint16_t *sequence,
+                            telemetry_sample_t *samples, size_t *count);
+
+/**
+ * @brief Fill in the IMU fields of a sample from readings in g's and
+ * degrees per second, rounding and limiting them to the range of int16.
+ *
+ * @param sample The sample.
+ * @param accel The accelerometer reading.
+ * @param gyro The gyro reading.
+ */
+void telemetry_set_imu(telemetry_sample_t *sample, const lsm9ds1_measurement_t *accel,
+                       const lsm9ds1_measurement_t *gyro);
+
+#endif // TELEMETRY_H
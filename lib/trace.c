@@ -0,0 +1,224 @@
+/**
+ * @file trace.c
+ * @brief Implementation of the binary sensor trace format.
+ */
+
+#include "trace.h"
+#include <stdbool.h>
+#include <string.h>
+
+static const uint8_t magic[4] = {'L', 'F', 'T', 'R'};
+
+#define ROMI_PAYLOAD 7
+#define AXES_PAYLOAD 12
+
+// Bits of the flags byte of a TRACE_ROMI payload.
+#define BUMP_LEFT 0x01
+#define BUMP_CENTER 0x02
+#define BUMP_RIGHT 0x04
+#define BUTTON_LEFT 0x08
+#define BUTTON_RIGHT 0x10
+#define REFLECT_LEFT 0x20
+#define REFLECT_CENTER 0x40
+#define REFLECT_RIGHT 0x80
+
+static int payload_size(uint8_t type) {
+    switch (type) {
+        case TRACE_ROMI: return ROMI_PAYLOAD;
+        case TRACE_ACC:
+        case TRACE_GYRO:
+        case TRACE_MAG:
+        case TRACE_ACCEL: return AXES_PAYLOAD;
+        case TRACE_TIME: return 0;
+        default: return -1;
+    }
+}
+
+static size_t put_varint(uint8_t *p, uint64_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        p[n++] = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+    p[n++] = (uint8_t)value;
+    return n;
+}
+
+/**
+ * Decode a varint from at most `length` bytes, returning the number of
+ * bytes it takes, or 0 if it does not end within them.
+ */
+static size_t get_varint(const uint8_t *p, size_t length, uint64_t *value) {
+    uint64_t v = 0;
+    for (size_t n = 0; n < length && n < 10; n++) {
+        v |= (uint64_t)(p[n] & 0x7F) << (7 * n);
+        if (!(p[n] & 0x80)) {
+            *value = v;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+static void put_u16(uint8_t *p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void put_romi(uint8_t *p, romi_sensors_t const *s) {
+    put_u16(p, s->time_stamp);
+    p[2] = (s->bumps.left ? BUMP_LEFT : 0)
+            | (s->bumps.center ? BUMP_CENTER : 0)
+            | (s->bumps.right ? BUMP_RIGHT : 0)
+            | (s->buttons.left ? BUTTON_LEFT : 0)
+            | (s->buttons.right ? BUTTON_RIGHT : 0)
+            | (s->reflectance.left ? REFLECT_LEFT : 0)
+            | (s->reflectance.center ? REFLECT_CENTER : 0)
+            | (s->reflectance.right ? REFLECT_RIGHT : 0);
+    put_u16(p + 3, s->encoders.left);
+    put_u16(p + 5, s->encoders.right);
+}
+
+static void get_romi(const uint8_t *p, romi_sensors_t *s) {
+    memset(s, 0, sizeof(*s));
+    s->time_stamp = get_u16(p);
+    s->bumps.left = p[2] & BUMP_LEFT;
+    s->bumps.center = p[2] & BUMP_CENTER;
+    s->bumps.right = p[2] & BUMP_RIGHT;
+    s->buttons.left = p[2] & BUTTON_LEFT;
+    s->buttons.right = p[2] & BUTTON_RIGHT;
+    s->reflectance.left = p[2] & REFLECT_LEFT;
+    s->reflectance.center = p[2] & REFLECT_CENTER;
+    s->reflectance.right = p[2] & REFLECT_RIGHT;
+    s->encoders.left = get_u16(p + 3);
+    s->encoders.right = get_u16(p + 5);
+}
+
+static void put_axes(uint8_t *p, lsm9ds1_measurement_t const *m) {
+    memcpy(p, &m->x_axis, 4);
+    memcpy(p + 4, &m->y_axis, 4);
+    memcpy(p + 8, &m->z_axis, 4);
+}
+
+static void get_axes(const uint8_t *p, lsm9ds1_measurement_t *m) {
+    memcpy(&m->x_axis, p, 4);
+    memcpy(&m->y_axis, p + 4, 4);
+    memcpy(&m->z_axis, p + 8, 4);
+}
+
+static void put_time(trace_writer_t *writer) {
+    uint8_t *p = writer->buffer + writer->length;
+    p[0] = TRACE_TIME;
+    writer->length += 1 + put_varint(p + 1, (uint64_t)(writer->last_time - writer->start_time));
+}
+
+void trace_writer_init(trace_writer_t *writer, int64_t start_time,
+                       trace_sink_t sink, void *context) {
+    memset(writer, 0, sizeof(*writer));
+    writer->start_time = start_time;
+    writer->last_time = start_time;
+    writer->sink = sink;
+    writer->context = context;
+
+    uint8_t *p = writer->buffer;
+    memcpy(p, magic, 4);
+    p[4] = TRACE_VERSION;
+    p[5] = TRACE_HEADER_SIZE;
+    p[6] = 0;
+    p[7] = 0;
+    uint64_t t = (uint64_t)start_time;
+    for (int i = 0; i < 8; i++) {
+        p[8 + i] = (uint8_t)(t >> (8 * i));
+    }
+    writer->length = TRACE_HEADER_SIZE;
+}
+
+ret_code_t trace_write(trace_writer_t *writer, trace_record_t const *record) {
+    int size = payload_size(record->type);
+    if (size < 0 || record->type == TRACE_TIME) return NRF_ERROR_INVALID_DATA;
+    if (record->time < writer->last_time) return NRF_ERROR_INVALID_PARAM;
+
+    if (writer->length + TRACE_RECORD_MAX > TRACE_BUFFER_SIZE) {
+        trace_writer_flush(writer);
+    }
+    if (writer->length == 0) {
+        put_time(writer);
+    }
+
+    uint8_t *p = writer->buffer + writer->length;
+    size_t n = 0;
+    p[n++] = record->type;
+    n += put_varint(p + n, (uint64_t)(record->time - writer->last_time));
+    if (record->type == TRACE_ROMI) {
+        put_romi(p + n, &record->value.romi);
+    } else {
+        put_axes(p + n, &record->value.axes);
+    }
+    writer->length += n + size;
+    writer->last_time = record->time;
+    writer->records++;
+    return NRF_SUCCESS;
+}
+
+void trace_writer_flush(trace_writer_t *writer) {
+    if (writer->length == 0) return;
+    writer->sink(writer->buffer, writer->length, writer->context);
+    writer->bytes += writer->length;
+    writer->length = 0;
+}
+
+ret_code_t trace_reader_init(trace_reader_t *reader, const uint8_t *data, size_t length) {
+    if (length < TRACE_HEADER_SIZE) return NRF_ERROR_INVALID_LENGTH;
+    if (memcmp(data, magic, 4) != 0 || data[4] != TRACE_VERSION
+            || data[5] != TRACE_HEADER_SIZE) {
+        return NRF_ERROR_INVALID_DATA;
+    }
+    uint64_t t = 0;
+    for (int i = 0; i < 8; i++) {
+        t |= (uint64_t)data[8 + i] << (8 * i);
+    }
+    reader->start_time = (int64_t)t;
+    reader->time = reader->start_time;
+    return NRF_SUCCESS;
+}
+
+ret_code_t trace_read(trace_reader_t *reader, const uint8_t *data, size_t length,
+                      trace_record_t *record, size_t *used) {
+    size_t position = 0;
+    // Time as of the records consumed so far, committed only on success
+    // so that a call that runs out of data can be repeated with more.
+    int64_t time = reader->time;
+    while (true) {
+        if (position == length) {
+            return position == 0 ? NRF_ERROR_NOT_FOUND : NRF_ERROR_INVALID_LENGTH;
+        }
+        uint8_t type = data[position];
+        int size = payload_size(type);
+        if (size < 0) return NRF_ERROR_INVALID_DATA;
+
+        uint64_t delta;
+        size_t n = get_varint(data + position + 1, length - position - 1, &delta);
+        if (n == 0 || position + 1 + n + size > length) return NRF_ERROR_INVALID_LENGTH;
+        const uint8_t *payload = data + position + 1 + n;
+        position += 1 + n + size;
+
+        if (type == TRACE_TIME) {
+            time = reader->start_time + (int64_t)delta;
+            continue;
+        }
+        record->type = type;
+        record->time = time + (int64_t)delta;
+        if (type == TRACE_ROMI) {
+            get_romi(payload, &record->value.romi);
+        } else {
+            get_axes(payload, &record->value.axes);
+        }
+        reader->time = record->time;
+        *used = position;
+        return NRF_SUCCESS;
+    }
+}
@@ -0,0 +1,163 @@
+/**
+ * @file trace.h
+ * @brief Compact binary traces of sensor readings, for recording on the
+ * board and replaying on a host.
+ *
+ * A trace is a 16-byte header followed by records. The header is the
+ * magic "LFTR", a version byte, the header size, two reserved bytes, and
+ * the logical start time as a little-endian int64 in nanoseconds. Each
+ * record is a type byte, the time in nanoseconds since the previous
+ * record as an unsigned LEB128 varint, and a fixed-size payload for its
+ * type:
+ *
+ *  - TRACE_ROMI: romi_sensors_t in 7 bytes: time_stamp, a byte of bump,
+ *    button, and reflectance bits, and the two encoders, each as
+ *    little-endian uint16.
+ *  - TRACE_ACC, TRACE_GYRO, TRACE_MAG, TRACE_ACCEL: x, y, and z as
+ *    little-endian IEEE floats, 12 bytes.
+ *  - TRACE_TIME: no payload. Its varint is the time since the start of
+ *    the trace rather than since the previous record.
+ *
+ * The writer starts each chunk it hands to its sink with a TRACE_TIME
+ * record, so a trace whose transport dropped a chunk still has correct
+ * times after the gap. A trace of Romi packets every 20 ms and IMU
+ * accelerometer and gyro readings every 10 ms takes about 14.5 bytes per
+ * record.
+ *
+ * Records are decoded in order from any window of bytes, so a trace can
+ * be read from a memory-mapped file or in pieces from a stream without
+ * loading it all. Neither the writer nor the reader allocates memory.
+ * Floats are copied in the byte order of the CPU, which is little endian
+ * on both the nRF52 and x86 or ARM hosts.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "lsm9ds1.h" // Defines lsm9ds1_measurement_t
+#include "romi.h"    // Defines romi_sensors_t
+#include "sdk_errors.h"
+
+#define TRACE_VERSION 1
+#define TRACE_HEADER_SIZE 16
+// Largest encoded record: type, 10-byte varint, and payload.
+#define TRACE_RECORD_MAX (1 + 10 + 12)
+
+// Size of the writer's buffer, and so of the chunks given to the sink.
+#ifndef TRACE_BUFFER_SIZE
+#define TRACE_BUFFER_SIZE 256
+#endif
+
+/**
+ * @brief Record types, which are the first byte of each record.
+ */
+typedef enum {
+    TRACE_ROMI = 1,  // Romi sensor packet.
+    TRACE_ACC = 2,   // IMU accelerometer, in g's.
+    TRACE_GYRO = 3,  // IMU gyro, in degrees per second.
+    TRACE_MAG = 4,   // IMU magnetometer.
+    TRACE_ACCEL = 5, // Analog accelerometer, in g's.
+    TRACE_TIME = 0x7F,
+} trace_type_t;
+
+/**
+ * @brief One decoded record. TRACE_TIME records are not returned.
+ */
+typedef struct {
+    trace_type_t type;
+    int64_t time; // Logical time, in nanoseconds.
+    union {
+        romi_sensors_t romi;           // For TRACE_ROMI.
+        lsm9ds1_measurement_t axes;    // For the other types.
+    } value;
+} trace_record_t;
+
+/**
+ * @brief Function that stores or sends encoded bytes.
+ * @param data The bytes, which are only valid during the call.
+ * @param length The number of bytes.
+ * @param context The context given to trace_writer_init().
+ */
+typedef void (*trace_sink_t)(const uint8_t *data, size_t length, void *context);
+
+/**
+ * @brief Writer state, set up by trace_writer_init(). Only the writer
+ * uses records and bytes, which are there to be reported.
+ */
+typedef struct {
+    uint8_t buffer[TRACE_BUFFER_SIZE];
+    size_t length;      // Bytes in buffer.
+    int64_t start_time;
+    int64_t last_time;  // Time of the last record encoded.
+    trace_sink_t sink;
+    void *context;
+
+    uint32_t records;   // Records written, not counting TRACE_TIME.
+    uint32_t bytes;     // Bytes given to the sink.
+} trace_writer_t;
+
+/**
+ * @brief Reader state, set up by trace_reader_init() from the header.
+ */
+typedef struct {
+    int64_t start_time;
+    int64_t time;       // Time of the last record read.
+} trace_reader_t;
+
+/**
+ * @brief Start a trace, putting its header in the buffer.
+ * @param writer The writer.
+ * @param start_time The logical start time, from lf_time_start().
+ * @param sink The function that gets the encoded bytes.
+ * @param context Passed to the sink.
+ */
+void trace_writer_init(trace_writer_t *writer, int64_t start_time,
+                       trace_sink_t sink, void *context);
+
+/**
+ * @brief Encode a record, giving the buffer to the sink first if the
+ * record does not fit.
+ * @param writer The writer.
+ * @param record The record. Its time must not be earlier than that of the
+ *  previous record or the start of the trace.
+ * @return NRF_SUCCESS, NRF_ERROR_INVALID_PARAM for an earlier time, or
+ *  NRF_ERROR_INVALID_DATA for an unknown type.
+ */
+ret_code_t trace_write(trace_writer_t *writer, trace_record_t const *record);
+
+/**
+ * @brief Give the encoded bytes in the buffer to the sink.
+ * @param writer The writer.
+ */
+void trace_writer_flush(trace_writer_t *writer);
+
+/**
+ * @brief Read the header of a trace.
+ * @param reader The reader.
+ * @param data The first bytes of the trace.
+ * @param length The number of bytes available.
+ * @return NRF_SUCCESS, having read TRACE_HEADER_SIZE bytes,
+ *  NRF_ERROR_INVALID_LENGTH if there are fewer than that, or
+ *  NRF_ERROR_INVALID_DATA if they are not a header of this version.
+ */
+ret_code_t trace_reader_init(trace_reader_t *reader, const uint8_t *data, size_t length);
+
+/**
+ * @brief Decode the next record.
+ * @param reader The reader.
+ * @param data The bytes that follow the header or the last record read.
+ * @param length The number of bytes available.
+ * @param record The decoded record.
+ * @param used The number of bytes read, which may include TRACE_TIME
+ *  records before the one returned. Set on success only.
+ * @return NRF_SUCCESS, NRF_ERROR_NOT_FOUND if there are no more records in
+ *  the data, NRF_ERROR_INVALID_LENGTH if the data ends within a record, or
+ *  NRF_ERROR_INVALID_DATA for an unknown record type. When streaming,
+ *  NRF_ERROR_INVALID_LENGTH means to call again with more bytes.
+ */
+ret_code_t trace_read(trace_reader_t *reader, const uint8_t *data, size_t length,
+                      trace_record_t *record, size_t *used);
+
+#endif // TRACE_H
@@ -0,0 +1,28 @@
+/**
+ * @file app_error.h
+ * @brief Host stand-in for the nRF5 SDK error handler.
+ * On the host, a failed APP_ERROR_CHECK prints the error and aborts
+ * instead of flashing the board LEDs.
+ */
+#ifndef APP_ERROR_H__
+#define APP_ERROR_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "sdk_errors.h"
+
+/**
+ * @brief Report an error code and abort. Called by APP_ERROR_CHECK.
+ */
+void app_error_handler_host(ret_code_t error_code, const char *file, int line);
+
+#define APP_ERROR_CHECK(ERR_CODE) \
+    do { \
+        const uint32_t LOCAL_ERR_CODE = (ERR_CODE); \
+        if (LOCAL_ERR_CODE != NRF_SUCCESS) { \
+            app_error_handler_host(LOCAL_ERR_CODE, __FILE__, __LINE__); \
+        } \
+    } while (0)
+
+#endif
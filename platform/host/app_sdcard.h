@@ -0,0 +1,94 @@
+/**
+ * @file app_sdcard.h
+ * @brief Host stand-in for the SD card library (SPI mode).
+ * The types and functions follow app_sdcard.h in nRF5 SDK 15.
+ * The implementation in app_sdcard_host.c keeps the card's blocks in a
+ * file. Operations finish inside the call that starts them, which calls
+ * the event handler before returning, unless a test defers them with the
+ * host-only functions declared at the end of this file.
+ */
+#ifndef APP_SDCARD_H_
+#define APP_SDCARD_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#define SDC_SECTOR_SIZE 512
+
+typedef enum {
+    APP_SDC_EVT_INIT = 0,
+    APP_SDC_EVT_READ,
+    APP_SDC_EVT_WRITE,
+} sdc_evt_type_t;
+
+typedef enum {
+    SDC_SUCCESS = 0,
+    SDC_ERROR_NOT_RESPONDING,
+    SDC_ERROR_CRC,
+    SDC_ERROR_COMMAND,
+    SDC_ERROR_DATA,
+    SDC_ERROR_INTERNAL,
+} sdc_result_t;
+
+typedef struct {
+    sdc_evt_type_t type;
+    sdc_result_t result;
+} sdc_evt_t;
+
+typedef void (*sdc_event_handler_t)(sdc_evt_t const *p_event);
+
+typedef struct {
+    uint8_t version : 2;
+    uint8_t sdhc : 1;
+} sdc_type_t;
+
+typedef struct {
+    uint32_t num_blocks;
+    uint16_t block_len;
+    sdc_type_t type;
+} app_sdc_info_t;
+
+typedef struct {
+    uint8_t mosi_pin;
+    uint8_t miso_pin;
+    uint8_t sck_pin;
+    uint8_t cs_pin;
+} app_sdc_config_t;
+
+#define APP_SDCARD_CONFIG(MOSI_PIN, MISO_PIN, SCK_PIN, CS_PIN) { \
+    .mosi_pin = MOSI_PIN, \
+    .miso_pin = MISO_PIN, \
+    .sck_pin = SCK_PIN, \
+    .cs_pin = CS_PIN, \
+}
+
+ret_code_t app_sdc_init(app_sdc_config_t const *const p_config, sdc_event_handler_t event_handler);
+ret_code_t app_sdc_uninit(void);
+bool app_sdc_busy_check(void);
+ret_code_t app_sdc_block_read(uint8_t *p_buf, uint32_t block_address, uint16_t block_count);
+ret_code_t app_sdc_block_write(uint8_t const *p_buf, uint32_t block_address, uint16_t block_count);
+app_sdc_info_t const *app_sdc_info_get(void);
+
+// Host only. Back the card with the file at `path`, created if it does
+// not exist, holding `num_blocks` blocks. Without this, app_sdc_init()
+// uses "sdcard.img" in the working directory, with 2^21 blocks (1 GB).
+void app_sdc_host_open(const char *path, uint32_t num_blocks);
+
+// Host only. If `defer` is true, operations stay in progress until
+// app_sdc_host_complete() is called, as they would until an interrupt
+// on the board.
+void app_sdc_host_defer(bool defer);
+
+// Host only. Finish the operation in progress, calling the event handler.
+// Returns false if there was none.
+bool app_sdc_host_complete(void);
+
+// Host only. Make the next operations fail with `result`, or succeed
+// again with SDC_SUCCESS.
+void app_sdc_host_fail(sdc_result_t result);
+
+// Host only. Number of blocks written since app_sdc_init().
+uint32_t app_sdc_host_blocks_written(void);
+
+#endif // APP_SDCARD_H_
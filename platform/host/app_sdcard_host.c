@@ -0,0 +1,159 @@
+/**
+ * @file app_sdcard_host.c
+ * @brief Host stand-in for the SD card library.
+ * The card is a file of num_blocks blocks of SDC_SECTOR_SIZE bytes,
+ * opened by app_sdc_init(). Reads and writes go to the file when they
+ * start, and finish, with a call of the event handler, either at once or,
+ * if deferred with app_sdc_host_defer(), when the test calls
+ * app_sdc_host_complete(). Either way, the buffer may not be reused until
+ * the handler has been called, as on the board.
+ */
+#include <stdio.h>
+#include "app_sdcard.h"
+
+#define DEFAULT_PATH "sdcard.img"
+#define DEFAULT_BLOCKS (1u << 21)
+
+static const char *path = DEFAULT_PATH;
+static app_sdc_info_t info = {.num_blocks = DEFAULT_BLOCKS, .block_len = SDC_SECTOR_SIZE,
+                              .type = {.version = 2, .sdhc = 1}};
+static FILE *file = NULL;
+static sdc_event_handler_t handler = NULL;
+static bool deferred = false;
+static sdc_result_t failure = SDC_SUCCESS;
+static uint32_t blocks_written = 0;
+
+// Operation in progress, if busy is true.
+static bool busy = false;
+static sdc_evt_t pending;
+
+// Start an operation, finishing it at once unless deferred.
+static void start(sdc_evt_type_t type, sdc_result_t result) {
+    busy = true;
+    pending.type = type;
+    pending.result = result;
+    if (!deferred) {
+        app_sdc_host_complete();
+    }
+}
+
+ret_code_t app_sdc_init(app_sdc_config_t const *const p_config, sdc_event_handler_t event_handler) {
+    if (event_handler == NULL) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (handler != NULL) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    handler = event_handler;
+    blocks_written = 0;
+    if (file == NULL) {
+        file = fopen(path, "r+b");
+        if (file == NULL) {
+            file = fopen(path, "w+b");
+        }
+    }
+    start(APP_SDC_EVT_INIT, file == NULL ? SDC_ERROR_NOT_RESPONDING : failure);
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_sdc_uninit(void) {
+    if (handler == NULL) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if (busy) {
+        return NRF_ERROR_BUSY;
+    }
+    handler = NULL;
+    if (file != NULL) {
+        fclose(file);
+        file = NULL;
+    }
+    return NRF_SUCCESS;
+}
+
+bool app_sdc_busy_check(void) {
+    return busy;
+}
+
+static ret_code_t check(uint32_t block_address, uint16_t block_count) {
+    if (handler == NULL || file == NULL) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if (busy) {
+        return NRF_ERROR_BUSY;
+    }
+    if (block_count == 0 || block_address + block_count > info.num_blocks) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_sdc_block_read(uint8_t *p_buf, uint32_t block_address, uint16_t block_count) {
+    ret_code_t error_code = check(block_address, block_count);
+    if (error_code != NRF_SUCCESS) {
+        return error_code;
+    }
+    size_t length = (size_t)block_count * SDC_SECTOR_SIZE;
+    fseek(file, (long)block_address * SDC_SECTOR_SIZE, SEEK_SET);
+    size_t got = fread(p_buf, 1, length, file);
+    // Blocks past the end of the file read as erased.
+    for (size_t i = got; i < length; i++) {
+        p_buf[i] = 0xFF;
+    }
+    start(APP_SDC_EVT_READ, failure);
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_sdc_block_write(uint8_t const *p_buf, uint32_t block_address, uint16_t block_count) {
+    ret_code_t error_code = check(block_address, block_count);
+    if (error_code != NRF_SUCCESS) {
+        return error_code;
+    }
+    sdc_result_t result = failure;
+    if (result == SDC_SUCCESS) {
+        fseek(file, (long)block_address * SDC_SECTOR_SIZE, SEEK_SET);
+        size_t length = (size_t)block_count * SDC_SECTOR_SIZE;
+        if (fwrite(p_buf, 1, length, file) == length && fflush(file) == 0) {
+            blocks_written += block_count;
+        } else {
+            result = SDC_ERROR_DATA;
+        }
+    }
+    start(APP_SDC_EVT_WRITE, result);
+    return NRF_SUCCESS;
+}
+
+app_sdc_info_t const *app_sdc_info_get(void) {
+    return handler != NULL && file != NULL ? &info : NULL;
+}
+
+void app_sdc_host_open(const char *p_path, uint32_t num_blocks) {
+    if (file != NULL) {
+        fclose(file);
+        file = NULL;
+    }
+    path = p_path;
+    info.num_blocks = num_blocks;
+}
+
+void app_sdc_host_defer(bool defer) {
+    deferred = defer;
+}
+
+bool app_sdc_host_complete(void) {
+    if (!busy) {
+        return false;
+    }
+    busy = false;
+    sdc_evt_t event = pending;
+    handler(&event);
+    return true;
+}
+
+void app_sdc_host_fail(sdc_result_t result) {
+    failure = result;
+}
+
+uint32_t app_sdc_host_blocks_written(void) {
+    return blocks_written;
+}
@@ -0,0 +1,23 @@
+/**
+ * @file app_timer.h
+ * @brief Host stand-in for the nRF5 SDK application timer.
+ * The counter only moves when a test calls app_timer_host_advance(),
+ * so timing on the host is deterministic.
+ */
+#ifndef APP_TIMER_H__
+#define APP_TIMER_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+// Frequency of the RTC that drives the timer, with no prescaler.
+#define APP_TIMER_CLOCK_FREQ 32768
+
+ret_code_t app_timer_init(void);
+uint32_t app_timer_cnt_get(void);
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from);
+
+// Host only. Advance the counter by the specified number of ticks.
+void app_timer_host_advance(uint32_t ticks);
+
+#endif
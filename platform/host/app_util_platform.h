@@ -0,0 +1,13 @@
+/**
+ * @file app_util_platform.h
+ * @brief Host stand-in for the nRF5 SDK platform utilities.
+ * Host tests call interrupt handlers synchronously, so critical
+ * regions have nothing to protect against.
+ */
+#ifndef APP_UTIL_PLATFORM_H__
+#define APP_UTIL_PLATFORM_H__
+
+#define CRITICAL_REGION_ENTER() {
+#define CRITICAL_REGION_EXIT() }
+
+#endif
@@ -0,0 +1,42 @@
+/**
+ * @file buckler.h
+ * @brief Host stand-in for the Buckler board pin definitions.
+ * The values are those of the board. On the host, the LED and button
+ * pins are pins of the GPIO stand-in, and the analog accelerometer pins
+ * are SAADC inputs AIN5 to AIN7.
+ */
+#ifndef BUCKLER_H
+#define BUCKLER_H
+
+#include "app_error.h"
+#include "nrf_gpio.h"
+
+#define BUCKLER_LED0 NRF_GPIO_PIN_MAP(0,25)
+#define BUCKLER_LED1 NRF_GPIO_PIN_MAP(0,24)
+#define BUCKLER_LED2 NRF_GPIO_PIN_MAP(0,23)
+
+#define BUCKLER_BUTTON0 NRF_GPIO_PIN_MAP(0,28)
+
+#define BUCKLER_UART_RX 8
+#define BUCKLER_UART_TX 6
+
+#define BUCKLER_SENSORS_SCL 19
+#define BUCKLER_SENSORS_SDA 20
+
+#define BUCKLER_LCD_MISO 17
+#define BUCKLER_LCD_MOSI 15
+#define BUCKLER_LCD_SCLK 16
+#define BUCKLER_LCD_CS 18
+
+#define BUCKLER_SD_ENABLE 26
+#define BUCKLER_SD_SCLK 13
+#define BUCKLER_SD_MISO 12
+#define BUCKLER_SD_MOSI 11
+#define BUCKLER_SD_CS 14
+
+// NRF_SAADC_INPUT_AIN5 to NRF_SAADC_INPUT_AIN7.
+#define BUCKLER_ANALOG_ACCEL_X 6
+#define BUCKLER_ANALOG_ACCEL_Y 7
+#define BUCKLER_ANALOG_ACCEL_Z 8
+
+#endif
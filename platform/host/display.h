@@ -0,0 +1,17 @@
+/**
+ * @file display.h
+ * @brief Host stand-in for the Buckler display library header
+ * (buckler/software/libraries/display/display.h).
+ * The functions are implemented by the Linux platform, in
+ * platform/linux/display_linux.c, which prints the display rows.
+ */
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <stdint.h>
+#include "nrf_drv_spi.h"
+
+ret_code_t display_init(const nrf_drv_spi_t *spi_instance);
+ret_code_t display_write(const char *format, uint8_t row);
+
+#endif
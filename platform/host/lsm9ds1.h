@@ -0,0 +1,46 @@
+/**
+ * @file lsm9ds1.h
+ * @brief Host stand-in for the Buckler LSM9DS1 driver header
+ * (buckler/software/libraries/lsm9ds1/lsm9ds1.h).
+ * Only the measurement type, lsm9ds1_init(), and the blocking reads are
+ * provided. lsm9ds1_init() does nothing, since the model starts out
+ * running. The blocking reads, in g, degrees per second, and microtesla,
+ * are implemented only by the Linux platform, from its world model in
+ * platform/linux/sim.h, rather than over the bus. The host-only
+ * functions at the end of this file drive a model of the sensor, in
+ * lsm9ds1_host.c, which sits on the bus of the nrf_twi_mngr stand-in.
+ */
+#ifndef LSM9DS1_H
+#define LSM9DS1_H
+
+#include <stdint.h>
+#include "nrf_twi_mngr.h"
+
+typedef struct {
+    float x_axis;
+    float y_axis;
+    float z_axis;
+} lsm9ds1_measurement_t;
+
+void lsm9ds1_init(const nrf_twi_mngr_t *instance);
+lsm9ds1_measurement_t lsm9ds1_read_accelerometer(void);
+lsm9ds1_measurement_t lsm9ds1_read_gyro(void);
+lsm9ds1_measurement_t lsm9ds1_read_magnetometer(void);
+
+// Host only. Put the model in its power-on state and attach it to the
+// TWI bus, at address 0x6B for the accelerometer and gyro and 0x1E for
+// the magnetometer.
+void lsm9ds1_host_reset(void);
+
+// Host only. Take one sample, as the sensor does once per output data
+// period, with raw accelerometer and gyro readings for x, y, and z.
+// It goes to the output registers and, if enabled, into the FIFO.
+void lsm9ds1_host_sample(int16_t const acc[3], int16_t const gyro[3]);
+
+// Host only. Set the raw magnetometer readings for x, y, and z.
+void lsm9ds1_host_magnetic(int16_t const mag[3]);
+
+// Host only. Read an accelerometer and gyro register without going through the bus.
+uint8_t lsm9ds1_host_register(uint8_t reg);
+
+#endif
@@ -0,0 +1,228 @@
+/**
+ * @file lsm9ds1_host.c
+ * @brief Host model of the LSM9DS1.
+ * Registers are read and written over the nrf_twi_mngr stand-in.
+ * The magnetometer, at its own bus address, is only a set of output
+ * registers that tests fill with lsm9ds1_host_magnetic().
+ * The model covers what lib/ needs: register auto-increment, software
+ * reset, and the 32-slot FIFO with its bypass, FIFO, and continuous
+ * modes. Samples are taken only when a test calls lsm9ds1_host_sample().
+ *
+ * As described in ST application note AN4650, with the FIFO enabled
+ * the output registers read the oldest FIFO slot, and reading the last
+ * accelerometer byte (OUT_Z_H_XL) moves on to the next slot. During a
+ * multi-byte read, the address goes from the last gyro byte to the first
+ * accelerometer byte and back, so a single read returns whole slots.
+ */
+#include <stdbool.h>
+#include <string.h>
+#include "lsm9ds1.h"
+#include "nrf_twi_mngr.h"
+
+#define ADDRESS 0x6B
+#define MAG_ADDRESS 0x1E
+
+#define WHO_AM_I 0x0F
+#define OUT_X_L_G 0x18
+#define OUT_Z_H_G 0x1D
+#define CTRL_REG8 0x22
+#define CTRL_REG9 0x23
+#define OUT_X_L_XL 0x28
+#define OUT_Z_H_XL 0x2D
+#define FIFO_CTRL 0x2E
+#define FIFO_SRC 0x2F
+
+#define CTRL_REG8_SW_RESET 0x01
+#define CTRL_REG8_IF_ADD_INC 0x04
+#define CTRL_REG9_FIFO_EN 0x02
+
+#define FIFO_MODE_BYPASS 0
+#define FIFO_MODE_FIFO 1
+
+#define WHO_AM_I_M 0x0F
+#define OUT_X_L_M 0x28
+// Magnetometer multi-byte accesses only auto-increment with this bit
+// set in the register address.
+#define MAG_AUTO_INCREMENT 0x80
+
+#define FIFO_SLOTS 32
+#define SLOT_SIZE 12
+
+static uint8_t regs[0x80];
+static uint8_t pointer;
+
+static uint8_t mag_regs[0x80];
+static uint8_t mag_pointer;
+
+// Slots hold the gyro and then the accelerometer output registers.
+static uint8_t fifo[FIFO_SLOTS][SLOT_SIZE];
+static int fifo_head;
+static int fifo_count;
+static bool overrun;
+
+static void power_on(void) {
+    memset(regs, 0, sizeof(regs));
+    regs[WHO_AM_I] = 0x68;
+    regs[CTRL_REG8] = CTRL_REG8_IF_ADD_INC;
+    pointer = 0;
+    memset(mag_regs, 0, sizeof(mag_regs));
+    mag_regs[WHO_AM_I_M] = 0x3D;
+    mag_pointer = 0;
+    fifo_head = 0;
+    fifo_count = 0;
+    overrun = false;
+}
+
+static int fifo_mode(void) {
+    return regs[FIFO_CTRL] >> 5;
+}
+
+static bool fifo_active(void) {
+    return (regs[CTRL_REG9] & CTRL_REG9_FIFO_EN) && fifo_mode() != FIFO_MODE_BYPASS;
+}
+
+static bool is_output(uint8_t reg) {
+    return (reg >= OUT_X_L_G && reg <= OUT_Z_H_G) || (reg >= OUT_X_L_XL && reg <= OUT_Z_H_XL);
+}
+
+static uint8_t read_byte(uint8_t reg) {
+    if (reg == FIFO_SRC) {
+        int threshold = regs[FIFO_CTRL] & 0x1F;
+        return (fifo_count >= threshold && threshold > 0 ? 0x80 : 0)
+                | (overrun ? 0x40 : 0) | fifo_count;
+    }
+    if (!is_output(reg) || !fifo_active() || fifo_count == 0) {
+        return regs[reg];
+    }
+    int offset = reg <= OUT_Z_H_G ? reg - OUT_X_L_G : 6 + reg - OUT_X_L_XL;
+    uint8_t value = fifo[fifo_head][offset];
+    if (reg == OUT_Z_H_XL) {
+        fifo_head = (fifo_head + 1) % FIFO_SLOTS;
+        fifo_count--;
+        overrun = false;
+    }
+    return value;
+}
+
+static uint8_t next_address(uint8_t reg) {
+    if (!(regs[CTRL_REG8] & CTRL_REG8_IF_ADD_INC)) {
+        return reg;
+    }
+    if (fifo_active()) {
+        if (reg == OUT_Z_H_G) return OUT_X_L_XL;
+        if (reg == OUT_Z_H_XL) return OUT_X_L_G;
+    }
+    return (reg + 1) & 0x7F;
+}
+
+static void write_byte(uint8_t reg, uint8_t value) {
+    if (reg == CTRL_REG8 && (value & CTRL_REG8_SW_RESET)) {
+        power_on();
+        return;
+    }
+    regs[reg] = value;
+    if (reg == FIFO_CTRL && fifo_mode() == FIFO_MODE_BYPASS) {
+        // Bypass mode empties the FIFO.
+        fifo_count = 0;
+        overrun = false;
+    }
+}
+
+static ret_code_t bus_write(void *context, uint8_t const *p_data, uint8_t length) {
+    if (length == 0) {
+        return NRF_SUCCESS;
+    }
+    pointer = p_data[0] & 0x7F;
+    for (uint8_t i = 1; i < length; i++) {
+        write_byte(pointer, p_data[i]);
+        pointer = next_address(pointer);
+    }
+    return NRF_SUCCESS;
+}
+
+static ret_code_t bus_read(void *context, uint8_t *p_data, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        p_data[i] = read_byte(pointer);
+        pointer = next_address(pointer);
+    }
+    return NRF_SUCCESS;
+}
+
+static ret_code_t mag_write(void *context, uint8_t const *p_data, uint8_t length) {
+    if (length == 0) {
+        return NRF_SUCCESS;
+    }
+    mag_pointer = p_data[0];
+    for (uint8_t i = 1; i < length; i++) {
+        mag_regs[mag_pointer & 0x7F] = p_data[i];
+        if (mag_pointer & MAG_AUTO_INCREMENT) mag_pointer++;
+    }
+    return NRF_SUCCESS;
+}
+
+static ret_code_t mag_read(void *context, uint8_t *p_data, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        p_data[i] = mag_regs[mag_pointer & 0x7F];
+        if (mag_pointer & MAG_AUTO_INCREMENT) mag_pointer++;
+    }
+    return NRF_SUCCESS;
+}
+
+void lsm9ds1_init(const nrf_twi_mngr_t *instance) {
+}
+
+void lsm9ds1_host_reset(void) {
+    nrf_twi_mngr_host_device_t device = {
+        .address = ADDRESS,
+        .write = bus_write,
+        .read = bus_read,
+        .context = NULL,
+    };
+    nrf_twi_mngr_host_device_t mag_device = {
+        .address = MAG_ADDRESS,
+        .write = mag_write,
+        .read = mag_read,
+        .context = NULL,
+    };
+    power_on();
+    nrf_twi_mngr_host_attach(&device);
+    nrf_twi_mngr_host_attach(&mag_device);
+}
+
+void lsm9ds1_host_sample(int16_t const acc[3], int16_t const gyro[3]) {
+    uint8_t slot[SLOT_SIZE];
+    for (int i = 0; i < 3; i++) {
+        slot[2 * i] = (uint8_t)gyro[i];
+        slot[2 * i + 1] = (uint8_t)((uint16_t)gyro[i] >> 8);
+        slot[6 + 2 * i] = (uint8_t)acc[i];
+        slot[6 + 2 * i + 1] = (uint8_t)((uint16_t)acc[i] >> 8);
+    }
+    memcpy(&regs[OUT_X_L_G], slot, 6);
+    memcpy(&regs[OUT_X_L_XL], slot + 6, 6);
+    if (!fifo_active()) {
+        return;
+    }
+    if (fifo_count == FIFO_SLOTS) {
+        overrun = true;
+        if (fifo_mode() == FIFO_MODE_FIFO) {
+            // FIFO mode stops when full.
+            return;
+        }
+        // The other modes overwrite the oldest sample.
+        fifo_head = (fifo_head + 1) % FIFO_SLOTS;
+        fifo_count--;
+    }
+    memcpy(fifo[(fifo_head + fifo_count) % FIFO_SLOTS], slot, SLOT_SIZE);
+    fifo_count++;
+}
+
+void lsm9ds1_host_magnetic(int16_t const mag[3]) {
+    for (int i = 0; i < 3; i++) {
+        mag_regs[OUT_X_L_M + 2 * i] = (uint8_t)mag[i];
+        mag_regs[OUT_X_L_M + 2 * i + 1] = (uint8_t)((uint16_t)mag[i] >> 8);
+    }
+}
+
+uint8_t lsm9ds1_host_register(uint8_t reg) {
+    return regs[reg & 0x7F];
+}
@@ -0,0 +1,13 @@
+/**
+ * @file nrf_drv_clock.h
+ * @brief Host stand-in for the nRF5 SDK clock driver. Does nothing.
+ */
+#ifndef NRF_DRV_CLOCK_H__
+#define NRF_DRV_CLOCK_H__
+
+#include "sdk_errors.h"
+
+ret_code_t nrf_drv_clock_init(void);
+void nrf_drv_clock_lfclk_request(void *p_handler_item);
+
+#endif
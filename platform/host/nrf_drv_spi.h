@@ -0,0 +1,61 @@
+/**
+ * @file nrf_drv_spi.h
+ * @brief Host stand-in for the legacy SPI master driver.
+ * The types and functions follow nrf_drv_spi.h in nRF5 SDK 15, which the
+ * Buckler display library uses. Initializing only checks that an instance
+ * is not initialized twice; the display itself is the business of the
+ * display.h stand-in.
+ */
+#ifndef NRF_DRV_SPI_H__
+#define NRF_DRV_SPI_H__
+
+#include <stdint.h>
+#include "nrfx_spi.h"
+#include "sdk_errors.h"
+
+typedef struct {
+    uint8_t inst_idx;
+} nrf_drv_spi_t;
+
+#define NRF_DRV_SPI_INSTANCE(id) { .inst_idx = (id) }
+
+typedef enum {
+    NRF_DRV_SPI_FREQ_125K = 0x02000000,
+    NRF_DRV_SPI_FREQ_1M = 0x10000000,
+    NRF_DRV_SPI_FREQ_4M = 0x40000000,
+    NRF_DRV_SPI_FREQ_8M = 0x80000000,
+} nrf_drv_spi_frequency_t;
+
+typedef enum {
+    NRF_DRV_SPI_MODE_0,
+    NRF_DRV_SPI_MODE_1,
+    NRF_DRV_SPI_MODE_2,
+    NRF_DRV_SPI_MODE_3,
+} nrf_drv_spi_mode_t;
+
+typedef enum {
+    NRF_DRV_SPI_BIT_ORDER_MSB_FIRST,
+    NRF_DRV_SPI_BIT_ORDER_LSB_FIRST,
+} nrf_drv_spi_bit_order_t;
+
+typedef struct {
+    uint8_t sck_pin;
+    uint8_t mosi_pin;
+    uint8_t miso_pin;
+    uint8_t ss_pin;
+    uint8_t irq_priority;
+    uint8_t orc;
+    nrf_drv_spi_frequency_t frequency;
+    nrf_drv_spi_mode_t mode;
+    nrf_drv_spi_bit_order_t bit_order;
+} nrf_drv_spi_config_t;
+
+typedef void (*nrf_drv_spi_evt_handler_t)(void const *p_event, void *p_context);
+
+ret_code_t nrf_drv_spi_init(nrf_drv_spi_t const *const p_instance,
+                            nrf_drv_spi_config_t const *p_config,
+                            nrf_drv_spi_evt_handler_t handler,
+                            void *p_context);
+void nrf_drv_spi_uninit(nrf_drv_spi_t const *const p_instance);
+
+#endif
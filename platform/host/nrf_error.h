@@ -0,0 +1,25 @@
+/**
+ * @file nrf_error.h
+ * @brief Host stand-in for the nRF5 SDK error codes.
+ * Values match nrf_error.h and sdk_errors.h in the SDK.
+ */
+#ifndef NRF_ERROR_H__
+#define NRF_ERROR_H__
+
+#define NRF_ERROR_BASE_NUM                    (0x0)
+#define NRF_SUCCESS                           (NRF_ERROR_BASE_NUM + 0)
+#define NRF_ERROR_INTERNAL                    (NRF_ERROR_BASE_NUM + 3)
+#define NRF_ERROR_NO_MEM                      (NRF_ERROR_BASE_NUM + 4)
+#define NRF_ERROR_NOT_FOUND                   (NRF_ERROR_BASE_NUM + 5)
+#define NRF_ERROR_INVALID_PARAM               (NRF_ERROR_BASE_NUM + 7)
+#define NRF_ERROR_INVALID_STATE               (NRF_ERROR_BASE_NUM + 8)
+#define NRF_ERROR_INVALID_LENGTH              (NRF_ERROR_BASE_NUM + 9)
+#define NRF_ERROR_INVALID_DATA                (NRF_ERROR_BASE_NUM + 11)
+#define NRF_ERROR_TIMEOUT                     (NRF_ERROR_BASE_NUM + 13)
+#define NRF_ERROR_NULL                        (NRF_ERROR_BASE_NUM + 14)
+#define NRF_ERROR_BUSY                        (NRF_ERROR_BASE_NUM + 17)
+
+#define NRF_ERROR_SDK_COMMON_ERROR_BASE       (0x8000)
+#define NRF_ERROR_MODULE_ALREADY_INITIALIZED  (NRF_ERROR_SDK_COMMON_ERROR_BASE + 0x0005)
+
+#endif
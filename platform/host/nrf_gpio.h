@@ -0,0 +1,35 @@
+/**
+ * @file nrf_gpio.h
+ * @brief Host stand-in for the nRF5 SDK GPIO functions.
+ * The functions follow hal/nrf_gpio.h in nRF5 SDK 15. The implementation
+ * in nrf_gpio_host.c keeps the level of each pin, and inputs are driven
+ * with the host-only function declared at the end of this file.
+ */
+#ifndef NRF_GPIO_H__
+#define NRF_GPIO_H__
+
+#include <stdint.h>
+
+#define NRF_GPIO_PIN_MAP(port, pin) (((port) << 5) | ((pin) & 0x1F))
+#define NRF_GPIO_HOST_PINS 32
+
+typedef enum {
+    NRF_GPIO_PIN_NOPULL = 0,
+    NRF_GPIO_PIN_PULLDOWN = 1,
+    NRF_GPIO_PIN_PULLUP = 3,
+} nrf_gpio_pin_pull_t;
+
+void nrf_gpio_cfg_output(uint32_t pin_number);
+void nrf_gpio_cfg_input(uint32_t pin_number, nrf_gpio_pin_pull_t pull_config);
+void nrf_gpio_pin_set(uint32_t pin_number);
+void nrf_gpio_pin_clear(uint32_t pin_number);
+void nrf_gpio_pin_toggle(uint32_t pin_number);
+void nrf_gpio_pin_write(uint32_t pin_number, uint32_t value);
+uint32_t nrf_gpio_pin_read(uint32_t pin_number);
+uint32_t nrf_gpio_pin_out_read(uint32_t pin_number);
+
+// Host only. Drive an input pin to `value` from outside, calling the
+// GPIOTE event handler of the pin if the change matches its sense.
+void nrf_gpio_host_input(uint32_t pin_number, uint32_t value);
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file nrf_gpio_host.c
+ * @brief Host stand-ins for the GPIO functions and the GPIOTE driver.
+ * Outputs only change the level kept for the pin. An input changed with
+ * nrf_gpio_host_input() calls the event handler of the pin, if its
+ * event is enabled and the change matches its sense, as the interrupt
+ * would.
+ */
+#include <stddef.h>
+#include "nrfx_gpiote.h"
+
+static uint8_t levels[NRF_GPIO_HOST_PINS];
+static bool initialized = false;
+
+static struct {
+    nrfx_gpiote_evt_handler_t handler;
+    nrf_gpiote_polarity_t sense;
+    bool enabled;
+} inputs[NRF_GPIO_HOST_PINS];
+
+void nrf_gpio_cfg_output(uint32_t pin_number) {
+}
+
+void nrf_gpio_cfg_input(uint32_t pin_number, nrf_gpio_pin_pull_t pull_config) {
+    levels[pin_number] = pull_config == NRF_GPIO_PIN_PULLUP;
+}
+
+void nrf_gpio_pin_set(uint32_t pin_number) {
+    levels[pin_number] = 1;
+}
+
+void nrf_gpio_pin_clear(uint32_t pin_number) {
+    levels[pin_number] = 0;
+}
+
+void nrf_gpio_pin_toggle(uint32_t pin_number) {
+    levels[pin_number] ^= 1;
+}
+
+void nrf_gpio_pin_write(uint32_t pin_number, uint32_t value) {
+    levels[pin_number] = value != 0;
+}
+
+uint32_t nrf_gpio_pin_read(uint32_t pin_number) {
+    return levels[pin_number];
+}
+
+uint32_t nrf_gpio_pin_out_read(uint32_t pin_number) {
+    return levels[pin_number];
+}
+
+void nrf_gpio_host_input(uint32_t pin_number, uint32_t value) {
+    uint8_t previous = levels[pin_number];
+    levels[pin_number] = value != 0;
+    if (previous == levels[pin_number] || !inputs[pin_number].enabled) return;
+    nrf_gpiote_polarity_t edge = value ? NRF_GPIOTE_POLARITY_LOTOHI : NRF_GPIOTE_POLARITY_HITOLO;
+    if (inputs[pin_number].sense & edge) {
+        inputs[pin_number].handler(pin_number, inputs[pin_number].sense);
+    }
+}
+
+nrfx_err_t nrfx_gpiote_init(void) {
+    if (initialized) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    initialized = true;
+    return NRF_SUCCESS;
+}
+
+bool nrfx_gpiote_is_init(void) {
+    return initialized;
+}
+
+void nrfx_gpiote_uninit(void) {
+    initialized = false;
+    for (int i = 0; i < NRF_GPIO_HOST_PINS; i++) {
+        inputs[i].handler = NULL;
+        inputs[i].enabled = false;
+    }
+}
+
+nrfx_err_t nrfx_gpiote_out_init(nrfx_gpiote_pin_t pin, nrfx_gpiote_out_config_t const *p_config) {
+    levels[pin] = p_config->init_state == NRF_GPIOTE_INITIAL_VALUE_HIGH;
+    return NRF_SUCCESS;
+}
+
+void nrfx_gpiote_out_uninit(nrfx_gpiote_pin_t pin) {
+}
+
+void nrfx_gpiote_out_set(nrfx_gpiote_pin_t pin) {
+    nrf_gpio_pin_set(pin);
+}
+
+void nrfx_gpiote_out_clear(nrfx_gpiote_pin_t pin) {
+    nrf_gpio_pin_clear(pin);
+}
+
+void nrfx_gpiote_out_toggle(nrfx_gpiote_pin_t pin) {
+    nrf_gpio_pin_toggle(pin);
+}
+
+nrfx_err_t nrfx_gpiote_in_init(nrfx_gpiote_pin_t pin,
+                               nrfx_gpiote_in_config_t const *p_config,
+                               nrfx_gpiote_evt_handler_t evt_handler) {
+    if (inputs[pin].handler) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    inputs[pin].handler = evt_handler;
+    inputs[pin].sense = p_config->sense;
+    inputs[pin].enabled = false;
+    if (!p_config->skip_gpio_setup) {
+        nrf_gpio_cfg_input(pin, p_config->pull);
+    }
+    return NRF_SUCCESS;
+}
+
+void nrfx_gpiote_in_uninit(nrfx_gpiote_pin_t pin) {
+    inputs[pin].handler = NULL;
+    inputs[pin].enabled = false;
+}
+
+void nrfx_gpiote_in_event_enable(nrfx_gpiote_pin_t pin, bool int_enable) {
+    inputs[pin].enabled = int_enable && inputs[pin].handler != NULL;
+}
+
+void nrfx_gpiote_in_event_disable(nrfx_gpiote_pin_t pin) {
+    inputs[pin].enabled = false;
+}
+
+bool nrfx_gpiote_in_is_set(nrfx_gpiote_pin_t pin) {
+    return levels[pin];
+}
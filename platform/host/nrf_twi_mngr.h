@@ -0,0 +1,139 @@
+/**
+ * @file nrf_twi_mngr.h
+ * @brief Host stand-in for the nRF5 SDK TWI (I2C) transaction manager.
+ * The types and functions follow nrf_twi_mngr.h in nRF5 SDK 15.
+ * The implementation in nrf_twi_mngr_host.c performs transfers against
+ * device models that tests attach with the host-only functions declared
+ * at the end of this file, and counts bus transactions. It also keeps
+ * track of how long the transfers would take on the wire, and how much
+ * of that time callers of nrf_twi_mngr_perform() would spend waiting.
+ */
+#ifndef NRF_TWI_MNGR_H__
+#define NRF_TWI_MNGR_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+typedef enum {
+    NRF_TWIM_FREQ_100K = 0x01980000,
+    NRF_TWIM_FREQ_250K = 0x04000000,
+    NRF_TWIM_FREQ_400K = 0x06400000,
+} nrf_twim_frequency_t;
+
+typedef struct {
+    uint32_t scl;
+    uint32_t sda;
+    nrf_twim_frequency_t frequency;
+    uint8_t interrupt_priority;
+    bool clear_bus_init;
+    bool hold_bus_uninit;
+} nrf_drv_twi_config_t;
+
+#define NRF_DRV_TWI_DEFAULT_CONFIG { \
+    .scl = 31, \
+    .sda = 31, \
+    .frequency = NRF_TWIM_FREQ_100K, \
+    .interrupt_priority = 6, \
+    .clear_bus_init = false, \
+    .hold_bus_uninit = false, \
+}
+
+typedef struct {
+    uint8_t drv_inst_idx;
+    uint8_t queue_size;
+} nrf_twi_mngr_t;
+
+#define NRF_TWI_MNGR_DEF(_nrf_twi_mngr_name, _queue_size, _twi_idx) \
+    static nrf_twi_mngr_t const _nrf_twi_mngr_name = { \
+        .drv_inst_idx = (_twi_idx), \
+        .queue_size = (_queue_size), \
+    }
+
+// Flag for a transfer that is followed by a repeated start, not a stop.
+#define NRF_TWI_MNGR_NO_STOP 0x01
+
+#define NRF_TWI_MNGR_WRITE_OP(address) (((address) << 1) | 0)
+#define NRF_TWI_MNGR_READ_OP(address)  (((address) << 1) | 1)
+#define NRF_TWI_MNGR_IS_READ_OP(operation) ((operation) & 1)
+#define NRF_TWI_MNGR_OP_ADDRESS(operation) ((operation) >> 1)
+
+typedef struct {
+    uint8_t *p_data;
+    uint8_t length;
+    uint8_t operation;
+    uint8_t flags;
+} nrf_twi_mngr_transfer_t;
+
+#define NRF_TWI_MNGR_TRANSFER(_operation, _p_data, _length, _flags) { \
+    .p_data = (uint8_t *)(_p_data), \
+    .length = (_length), \
+    .operation = (_operation), \
+    .flags = (_flags), \
+}
+#define NRF_TWI_MNGR_WRITE(_address, _p_data, _length, _flags) \
+    NRF_TWI_MNGR_TRANSFER(NRF_TWI_MNGR_WRITE_OP(_address), _p_data, _length, _flags)
+#define NRF_TWI_MNGR_READ(_address, _p_data, _length, _flags) \
+    NRF_TWI_MNGR_TRANSFER(NRF_TWI_MNGR_READ_OP(_address), _p_data, _length, _flags)
+
+typedef void (*nrf_twi_mngr_callback_t)(ret_code_t result, void *p_user_data);
+
+typedef struct {
+    nrf_twi_mngr_callback_t callback;
+    void *p_user_data;
+    nrf_twi_mngr_transfer_t const *p_transfers;
+    uint8_t number_of_transfers;
+    nrf_drv_twi_config_t const *p_required_twi_cfg;
+} nrf_twi_mngr_transaction_t;
+
+ret_code_t nrf_twi_mngr_init(nrf_twi_mngr_t const *p_nrf_twi_mngr,
+                             nrf_drv_twi_config_t const *p_default_twi_config);
+ret_code_t nrf_twi_mngr_perform(nrf_twi_mngr_t const *p_nrf_twi_mngr,
+                                nrf_drv_twi_config_t const *p_config,
+                                nrf_twi_mngr_transfer_t const *p_transfers,
+                                uint8_t number_of_transfers,
+                                void (*user_function)(void));
+ret_code_t nrf_twi_mngr_schedule(nrf_twi_mngr_t const *p_nrf_twi_mngr,
+                                 nrf_twi_mngr_transaction_t const *p_transaction);
+bool nrf_twi_mngr_is_idle(nrf_twi_mngr_t const *p_nrf_twi_mngr);
+
+// Host only. A device on the bus. Each write transfer is passed to
+// `write` and each read transfer to `read`, which may fail the
+// transfer by returning an error code.
+typedef struct {
+    uint8_t address;
+    ret_code_t (*write)(void *context, uint8_t const *p_data, uint8_t length);
+    ret_code_t (*read)(void *context, uint8_t *p_data, uint8_t length);
+    void *context;
+} nrf_twi_mngr_host_device_t;
+
+// Host only. Put a device on the bus, replacing any at the same address.
+// Transfers to addresses with no device fail with
+// NRF_ERROR_DRV_TWI_ERR_ANACK.
+void nrf_twi_mngr_host_attach(nrf_twi_mngr_host_device_t const *p_device);
+
+// Host only. Remove all devices, drop scheduled transactions, and clear
+// the counters.
+void nrf_twi_mngr_host_reset(void);
+
+// Host only. Carry out the oldest transaction queued by
+// nrf_twi_mngr_schedule() and call its callback, as the interrupt at the
+// end of the transfer does. Returns false if the queue was empty.
+bool nrf_twi_mngr_host_complete(void);
+
+// Host only. Number of transactions performed, each of which starts
+// with a start condition and ends with a stop, and number of bytes
+// transferred, not counting addresses.
+uint32_t nrf_twi_mngr_host_transactions(void);
+uint32_t nrf_twi_mngr_host_bytes(void);
+
+// Host only. Microseconds that all transactions so far would occupy the
+// bus, and the part of that during which a caller of
+// nrf_twi_mngr_perform() would be blocked. Each transfer costs a start
+// bit, nine bits for the address, nine bits per byte, and a stop bit at
+// the end of each transaction, at the bus frequency given to
+// nrf_twi_mngr_init().
+uint32_t nrf_twi_mngr_host_bus_us(void);
+uint32_t nrf_twi_mngr_host_blocked_us(void);
+
+#endif
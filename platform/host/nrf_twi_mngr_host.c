@@ -0,0 +1,177 @@
+/**
+ * @file nrf_twi_mngr_host.c
+ * @brief Host stand-in for the nRF5 SDK TWI transaction manager.
+ * nrf_twi_mngr_perform() carries out its transfers at once against the
+ * device models attached with nrf_twi_mngr_host_attach(), so it returns
+ * with the data in place, as it does on the board. Transactions queued
+ * by nrf_twi_mngr_schedule() wait until the test calls
+ * nrf_twi_mngr_host_complete(), as if the bus were still busy.
+ */
+#include <stddef.h>
+#include "nrf_twi_mngr.h"
+
+#define MAX_DEVICES 4
+#define MAX_QUEUE 16
+
+static nrf_twi_mngr_host_device_t devices[MAX_DEVICES];
+static size_t device_count = 0;
+
+static nrf_twi_mngr_transaction_t const *queue[MAX_QUEUE];
+static size_t queue_head = 0;
+static size_t queue_count = 0;
+
+static nrf_twim_frequency_t frequency = NRF_TWIM_FREQ_100K;
+
+static uint32_t transactions = 0;
+static uint32_t bytes = 0;
+static uint64_t bus_bits = 0;
+static uint64_t blocked_bits = 0;
+
+static nrf_twi_mngr_host_device_t const *find_device(uint8_t address) {
+    for (size_t i = 0; i < device_count; i++) {
+        if (devices[i].address == address) {
+            return &devices[i];
+        }
+    }
+    return NULL;
+}
+
+static uint32_t bits_to_us(uint64_t bits) {
+    uint32_t hz = frequency == NRF_TWIM_FREQ_400K ? 400000
+            : frequency == NRF_TWIM_FREQ_250K ? 250000 : 100000;
+    return (uint32_t)(bits * 1000000 / hz);
+}
+
+/**
+ * Carry out the transfers of one call to perform() or schedule(),
+ * adding the bits they put on the bus to `*bits`.
+ */
+static ret_code_t transfer(nrf_twi_mngr_transfer_t const *p_transfers,
+                           uint8_t number_of_transfers, uint64_t *bits) {
+    // A transfer without NRF_TWI_MNGR_NO_STOP ends a bus transaction, and
+    // so does the last one, whatever its flags.
+    bool open = false;
+    for (uint8_t i = 0; i < number_of_transfers; i++) {
+        nrf_twi_mngr_transfer_t const *t = &p_transfers[i];
+        if (!open) {
+            transactions++;
+            open = true;
+        }
+        *bits += 1 + 9;
+        nrf_twi_mngr_host_device_t const *device = find_device(NRF_TWI_MNGR_OP_ADDRESS(t->operation));
+        if (!device) {
+            *bits += 1;
+            return NRF_ERROR_DRV_TWI_ERR_ANACK;
+        }
+        ret_code_t error_code = NRF_TWI_MNGR_IS_READ_OP(t->operation)
+                ? device->read(device->context, t->p_data, t->length)
+                : device->write(device->context, t->p_data, t->length);
+        if (error_code != NRF_SUCCESS) {
+            *bits += 1;
+            return error_code;
+        }
+        bytes += t->length;
+        *bits += 9 * t->length;
+        if (!(t->flags & NRF_TWI_MNGR_NO_STOP)) {
+            *bits += 1;
+            open = false;
+        }
+    }
+    if (open) {
+        *bits += 1;
+    }
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_twi_mngr_init(nrf_twi_mngr_t const *p_nrf_twi_mngr,
+                             nrf_drv_twi_config_t const *p_default_twi_config) {
+    frequency = p_default_twi_config->frequency;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_twi_mngr_perform(nrf_twi_mngr_t const *p_nrf_twi_mngr,
+                                nrf_drv_twi_config_t const *p_config,
+                                nrf_twi_mngr_transfer_t const *p_transfers,
+                                uint8_t number_of_transfers,
+                                void (*user_function)(void)) {
+    // The caller waits for the transactions queued ahead of it as well.
+    uint64_t before = bus_bits;
+    while (nrf_twi_mngr_host_complete()) {
+    }
+    ret_code_t error_code = transfer(p_transfers, number_of_transfers, &bus_bits);
+    blocked_bits += bus_bits - before;
+    if (error_code != NRF_SUCCESS) {
+        return error_code;
+    }
+    if (user_function) {
+        user_function();
+    }
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_twi_mngr_schedule(nrf_twi_mngr_t const *p_nrf_twi_mngr,
+                                 nrf_twi_mngr_transaction_t const *p_transaction) {
+    size_t limit = p_nrf_twi_mngr->queue_size < MAX_QUEUE ? p_nrf_twi_mngr->queue_size : MAX_QUEUE;
+    if (queue_count >= limit) {
+        return NRF_ERROR_NO_MEM;
+    }
+    queue[(queue_head + queue_count) % MAX_QUEUE] = p_transaction;
+    queue_count++;
+    return NRF_SUCCESS;
+}
+
+bool nrf_twi_mngr_is_idle(nrf_twi_mngr_t const *p_nrf_twi_mngr) {
+    return queue_count == 0;
+}
+
+bool nrf_twi_mngr_host_complete(void) {
+    if (queue_count == 0) {
+        return false;
+    }
+    // Dequeue first so the callback can schedule another.
+    nrf_twi_mngr_transaction_t const *t = queue[queue_head];
+    queue_head = (queue_head + 1) % MAX_QUEUE;
+    queue_count--;
+    ret_code_t result = transfer(t->p_transfers, t->number_of_transfers, &bus_bits);
+    if (t->callback) {
+        t->callback(result, t->p_user_data);
+    }
+    return true;
+}
+
+void nrf_twi_mngr_host_attach(nrf_twi_mngr_host_device_t const *p_device) {
+    for (size_t i = 0; i < device_count; i++) {
+        if (devices[i].address == p_device->address) {
+            devices[i] = *p_device;
+            return;
+        }
+    }
+    if (device_count < MAX_DEVICES) {
+        devices[device_count++] = *p_device;
+    }
+}
+
+void nrf_twi_mngr_host_reset(void) {
+    device_count = 0;
+    queue_count = 0;
+    transactions = 0;
+    bytes = 0;
+    bus_bits = 0;
+    blocked_bits = 0;
+}
+
+uint32_t nrf_twi_mngr_host_transactions(void) {
+    return transactions;
+}
+
+uint32_t nrf_twi_mngr_host_bytes(void) {
+    return bytes;
+}
+
+uint32_t nrf_twi_mngr_host_bus_us(void) {
+    return bits_to_us(bus_bits);
+}
+
+uint32_t nrf_twi_mngr_host_blocked_us(void) {
+    return bits_to_us(blocked_bits);
+}
@@ -0,0 +1,79 @@
+/**
+ * @file nrfx_gpiote.h
+ * @brief Host stand-in for the nrfx GPIOTE driver.
+ * The types and functions follow nrfx_gpiote.h in nRF5 SDK 15. Pins are
+ * those of the GPIO stand-in in nrf_gpio_host.c, and input events come
+ * from nrf_gpio_host_input().
+ */
+#ifndef NRFX_GPIOTE_H__
+#define NRFX_GPIOTE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nrf_gpio.h"
+#include "sdk_errors.h"
+
+typedef ret_code_t nrfx_err_t;
+typedef uint32_t nrfx_gpiote_pin_t;
+
+typedef enum {
+    NRF_GPIOTE_POLARITY_LOTOHI = 1,
+    NRF_GPIOTE_POLARITY_HITOLO = 2,
+    NRF_GPIOTE_POLARITY_TOGGLE = 3,
+} nrf_gpiote_polarity_t;
+
+typedef enum {
+    NRF_GPIOTE_INITIAL_VALUE_LOW = 0,
+    NRF_GPIOTE_INITIAL_VALUE_HIGH = 1,
+} nrf_gpiote_outinit_t;
+
+typedef struct {
+    nrf_gpiote_polarity_t action;
+    nrf_gpiote_outinit_t init_state;
+    bool task_pin;
+} nrfx_gpiote_out_config_t;
+
+#define NRFX_GPIOTE_CONFIG_OUT_SIMPLE(init_high) { \
+    .action = NRF_GPIOTE_POLARITY_LOTOHI, \
+    .init_state = (init_high) ? NRF_GPIOTE_INITIAL_VALUE_HIGH : NRF_GPIOTE_INITIAL_VALUE_LOW, \
+    .task_pin = false, \
+}
+
+typedef struct {
+    nrf_gpiote_polarity_t sense;
+    nrf_gpio_pin_pull_t pull;
+    bool is_watcher;
+    bool hi_accuracy;
+    bool skip_gpio_setup;
+} nrfx_gpiote_in_config_t;
+
+#define NRFX_GPIOTE_CONFIG_IN_SENSE(_sense, hi_accu) { \
+    .sense = (_sense), \
+    .pull = NRF_GPIO_PIN_NOPULL, \
+    .is_watcher = false, \
+    .hi_accuracy = (hi_accu), \
+    .skip_gpio_setup = false, \
+}
+#define NRFX_GPIOTE_CONFIG_IN_SENSE_LOTOHI(hi_accu) NRFX_GPIOTE_CONFIG_IN_SENSE(NRF_GPIOTE_POLARITY_LOTOHI, hi_accu)
+#define NRFX_GPIOTE_CONFIG_IN_SENSE_HITOLO(hi_accu) NRFX_GPIOTE_CONFIG_IN_SENSE(NRF_GPIOTE_POLARITY_HITOLO, hi_accu)
+#define NRFX_GPIOTE_CONFIG_IN_SENSE_TOGGLE(hi_accu) NRFX_GPIOTE_CONFIG_IN_SENSE(NRF_GPIOTE_POLARITY_TOGGLE, hi_accu)
+
+typedef void (*nrfx_gpiote_evt_handler_t)(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action);
+
+nrfx_err_t nrfx_gpiote_init(void);
+bool nrfx_gpiote_is_init(void);
+void nrfx_gpiote_uninit(void);
+nrfx_err_t nrfx_gpiote_out_init(nrfx_gpiote_pin_t pin, nrfx_gpiote_out_config_t const *p_config);
+void nrfx_gpiote_out_uninit(nrfx_gpiote_pin_t pin);
+void nrfx_gpiote_out_set(nrfx_gpiote_pin_t pin);
+void nrfx_gpiote_out_clear(nrfx_gpiote_pin_t pin);
+void nrfx_gpiote_out_toggle(nrfx_gpiote_pin_t pin);
+nrfx_err_t nrfx_gpiote_in_init(nrfx_gpiote_pin_t pin,
+                               nrfx_gpiote_in_config_t const *p_config,
+                               nrfx_gpiote_evt_handler_t evt_handler);
+void nrfx_gpiote_in_uninit(nrfx_gpiote_pin_t pin);
+void nrfx_gpiote_in_event_enable(nrfx_gpiote_pin_t pin, bool int_enable);
+void nrfx_gpiote_in_event_disable(nrfx_gpiote_pin_t pin);
+bool nrfx_gpiote_in_is_set(nrfx_gpiote_pin_t pin);
+
+#endif
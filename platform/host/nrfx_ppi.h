@@ -0,0 +1,43 @@
+/**
+ * @file nrfx_ppi.h
+ * @brief Host stand-in for the nrfx PPI (programmable peripheral
+ * interconnect) driver. The types and functions follow nrfx_ppi.h in
+ * nRF5 SDK 15. Peripheral stand-ins report their events with
+ * nrfx_ppi_host_event(), which triggers the tasks connected to them.
+ */
+#ifndef NRFX_PPI_H__
+#define NRFX_PPI_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+typedef ret_code_t nrfx_err_t;
+
+typedef enum {
+    NRF_PPI_CHANNEL0,
+    NRF_PPI_CHANNEL1,
+    NRF_PPI_CHANNEL2,
+    NRF_PPI_CHANNEL3,
+    NRF_PPI_CHANNEL4,
+    NRF_PPI_CHANNEL5,
+    NRF_PPI_CHANNEL6,
+    NRF_PPI_CHANNEL7,
+    // The remaining programmable channels up to 19 are not named here.
+} nrf_ppi_channel_t;
+
+#define NRFX_PPI_HOST_CHANNELS 20
+
+nrfx_err_t nrfx_ppi_channel_alloc(nrf_ppi_channel_t *p_channel);
+nrfx_err_t nrfx_ppi_channel_free(nrf_ppi_channel_t channel);
+nrfx_err_t nrfx_ppi_channel_assign(nrf_ppi_channel_t channel, uint32_t eep, uint32_t tep);
+nrfx_err_t nrfx_ppi_channel_enable(nrf_ppi_channel_t channel);
+nrfx_err_t nrfx_ppi_channel_disable(nrf_ppi_channel_t channel);
+
+// Host only. Signal the event at address `eep`, triggering the task of
+// each enabled channel that starts at it.
+void nrfx_ppi_host_event(uint32_t eep);
+
+// Host only. Free all channels.
+void nrfx_ppi_host_reset(void);
+
+#endif
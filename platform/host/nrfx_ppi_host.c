@@ -0,0 +1,78 @@
+/**
+ * @file nrfx_ppi_host.c
+ * @brief Host stand-in for the nrfx PPI driver.
+ * Only the tasks of peripherals that have a stand-in can be triggered;
+ * a channel that ends anywhere else does nothing.
+ */
+#include <stdbool.h>
+#include "nrfx_ppi.h"
+#include "nrfx_saadc.h"
+
+typedef struct {
+    bool allocated;
+    bool enabled;
+    uint32_t eep;
+    uint32_t tep;
+} channel_t;
+
+static channel_t channels[NRFX_PPI_HOST_CHANNELS];
+
+nrfx_err_t nrfx_ppi_channel_alloc(nrf_ppi_channel_t *p_channel) {
+    for (int i = 0; i < NRFX_PPI_HOST_CHANNELS; i++) {
+        if (!channels[i].allocated) {
+            channels[i] = (channel_t){.allocated = true};
+            *p_channel = (nrf_ppi_channel_t)i;
+            return NRF_SUCCESS;
+        }
+    }
+    return NRF_ERROR_NO_MEM;
+}
+
+nrfx_err_t nrfx_ppi_channel_free(nrf_ppi_channel_t channel) {
+    if (channel >= NRFX_PPI_HOST_CHANNELS || !channels[channel].allocated) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    channels[channel].allocated = false;
+    channels[channel].enabled = false;
+    return NRF_SUCCESS;
+}
+
+nrfx_err_t nrfx_ppi_channel_assign(nrf_ppi_channel_t channel, uint32_t eep, uint32_t tep) {
+    if (channel >= NRFX_PPI_HOST_CHANNELS || !channels[channel].allocated) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    channels[channel].eep = eep;
+    channels[channel].tep = tep;
+    return NRF_SUCCESS;
+}
+
+nrfx_err_t nrfx_ppi_channel_enable(nrf_ppi_channel_t channel) {
+    if (channel >= NRFX_PPI_HOST_CHANNELS || !channels[channel].allocated) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    channels[channel].enabled = true;
+    return NRF_SUCCESS;
+}
+
+nrfx_err_t nrfx_ppi_channel_disable(nrf_ppi_channel_t channel) {
+    if (channel >= NRFX_PPI_HOST_CHANNELS || !channels[channel].allocated) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    channels[channel].enabled = false;
+    return NRF_SUCCESS;
+}
+
+void nrfx_ppi_host_event(uint32_t eep) {
+    for (int i = 0; i < NRFX_PPI_HOST_CHANNELS; i++) {
+        if (!channels[i].enabled || channels[i].eep != eep) continue;
+        if (channels[i].tep == nrfx_saadc_sample_task_get()) {
+            nrfx_saadc_host_sample_task();
+        }
+    }
+}
+
+void nrfx_ppi_host_reset(void) {
+    for (int i = 0; i < NRFX_PPI_HOST_CHANNELS; i++) {
+        channels[i] = (channel_t){0};
+    }
+}
@@ -0,0 +1,194 @@
+/**
+ * @file nrfx_saadc.h
+ * @brief Host stand-in for the nrfx SAADC (analog to digital converter)
+ * driver. The types and functions follow nrfx_saadc.h in nRF5 SDK 15.
+ * The implementation in nrfx_saadc_host.c converts input values that
+ * tests set with the host-only functions declared at the end of this
+ * file, and scans all enabled channels into the queued buffers when the
+ * SAMPLE task is triggered through PPI (see nrfx_ppi.h).
+ */
+#ifndef NRFX_SAADC_H__
+#define NRFX_SAADC_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+typedef ret_code_t nrfx_err_t;
+
+typedef int16_t nrf_saadc_value_t;
+
+#define NRF_SAADC_CHANNEL_COUNT 8
+
+typedef enum {
+    NRF_SAADC_RESOLUTION_8BIT,
+    NRF_SAADC_RESOLUTION_10BIT,
+    NRF_SAADC_RESOLUTION_12BIT,
+    NRF_SAADC_RESOLUTION_14BIT,
+} nrf_saadc_resolution_t;
+
+typedef enum {
+    NRF_SAADC_OVERSAMPLE_DISABLED,
+    NRF_SAADC_OVERSAMPLE_2X,
+    NRF_SAADC_OVERSAMPLE_4X,
+    NRF_SAADC_OVERSAMPLE_8X,
+    NRF_SAADC_OVERSAMPLE_16X,
+    NRF_SAADC_OVERSAMPLE_32X,
+    NRF_SAADC_OVERSAMPLE_64X,
+    NRF_SAADC_OVERSAMPLE_128X,
+    NRF_SAADC_OVERSAMPLE_256X,
+} nrf_saadc_oversample_t;
+
+typedef enum {
+    NRF_SAADC_INPUT_DISABLED,
+    NRF_SAADC_INPUT_AIN0,
+    NRF_SAADC_INPUT_AIN1,
+    NRF_SAADC_INPUT_AIN2,
+    NRF_SAADC_INPUT_AIN3,
+    NRF_SAADC_INPUT_AIN4,
+    NRF_SAADC_INPUT_AIN5,
+    NRF_SAADC_INPUT_AIN6,
+    NRF_SAADC_INPUT_AIN7,
+    NRF_SAADC_INPUT_VDD,
+} nrf_saadc_input_t;
+
+typedef enum {
+    NRF_SAADC_RESISTOR_DISABLED,
+    NRF_SAADC_RESISTOR_PULLDOWN,
+    NRF_SAADC_RESISTOR_PULLUP,
+    NRF_SAADC_RESISTOR_VDD1_2,
+} nrf_saadc_resistor_t;
+
+typedef enum {
+    NRF_SAADC_GAIN1_6,
+    NRF_SAADC_GAIN1_5,
+    NRF_SAADC_GAIN1_4,
+    NRF_SAADC_GAIN1_3,
+    NRF_SAADC_GAIN1_2,
+    NRF_SAADC_GAIN1,
+    NRF_SAADC_GAIN2,
+    NRF_SAADC_GAIN4,
+} nrf_saadc_gain_t;
+
+typedef enum {
+    NRF_SAADC_REFERENCE_INTERNAL,
+    NRF_SAADC_REFERENCE_VDD4,
+} nrf_saadc_reference_t;
+
+typedef enum {
+    NRF_SAADC_ACQTIME_3US,
+    NRF_SAADC_ACQTIME_5US,
+    NRF_SAADC_ACQTIME_10US,
+    NRF_SAADC_ACQTIME_15US,
+    NRF_SAADC_ACQTIME_20US,
+    NRF_SAADC_ACQTIME_40US,
+} nrf_saadc_acqtime_t;
+
+typedef enum {
+    NRF_SAADC_MODE_SINGLE_ENDED,
+    NRF_SAADC_MODE_DIFFERENTIAL,
+} nrf_saadc_mode_t;
+
+typedef enum {
+    NRF_SAADC_BURST_DISABLED,
+    NRF_SAADC_BURST_ENABLED,
+} nrf_saadc_burst_t;
+
+typedef struct {
+    nrf_saadc_resistor_t resistor_p;
+    nrf_saadc_resistor_t resistor_n;
+    nrf_saadc_gain_t gain;
+    nrf_saadc_reference_t reference;
+    nrf_saadc_acqtime_t acq_time;
+    nrf_saadc_mode_t mode;
+    nrf_saadc_burst_t burst;
+    nrf_saadc_input_t pin_p;
+    nrf_saadc_input_t pin_n;
+} nrf_saadc_channel_config_t;
+
+#define NRFX_SAADC_DEFAULT_CHANNEL_CONFIG_SE(PIN_P) { \
+    .resistor_p = NRF_SAADC_RESISTOR_DISABLED, \
+    .resistor_n = NRF_SAADC_RESISTOR_DISABLED, \
+    .gain = NRF_SAADC_GAIN1_6, \
+    .reference = NRF_SAADC_REFERENCE_INTERNAL, \
+    .acq_time = NRF_SAADC_ACQTIME_10US, \
+    .mode = NRF_SAADC_MODE_SINGLE_ENDED, \
+    .burst = NRF_SAADC_BURST_DISABLED, \
+    .pin_p = (nrf_saadc_input_t)(PIN_P), \
+    .pin_n = NRF_SAADC_INPUT_DISABLED, \
+}
+
+typedef struct {
+    nrf_saadc_resolution_t resolution;
+    nrf_saadc_oversample_t oversample;
+    uint8_t interrupt_priority;
+    bool low_power_mode;
+} nrfx_saadc_config_t;
+
+#define NRFX_SAADC_DEFAULT_CONFIG { \
+    .resolution = NRF_SAADC_RESOLUTION_10BIT, \
+    .oversample = NRF_SAADC_OVERSAMPLE_DISABLED, \
+    .interrupt_priority = 6, \
+    .low_power_mode = false, \
+}
+
+typedef enum {
+    NRFX_SAADC_EVT_DONE,
+    NRFX_SAADC_EVT_LIMIT,
+    NRFX_SAADC_EVT_CALIBRATEDONE,
+} nrfx_saadc_evt_type_t;
+
+typedef struct {
+    nrf_saadc_value_t *p_buffer;
+    uint16_t size;
+} nrfx_saadc_done_evt_t;
+
+typedef struct {
+    nrfx_saadc_evt_type_t type;
+    union {
+        nrfx_saadc_done_evt_t done;
+    } data;
+} nrfx_saadc_evt_t;
+
+typedef void (*nrfx_saadc_event_handler_t)(nrfx_saadc_evt_t const *p_event);
+
+nrfx_err_t nrfx_saadc_init(nrfx_saadc_config_t const *p_config,
+                           nrfx_saadc_event_handler_t event_handler);
+void nrfx_saadc_uninit(void);
+nrfx_err_t nrfx_saadc_channel_init(uint8_t channel,
+                                   nrf_saadc_channel_config_t const *const p_config);
+nrfx_err_t nrfx_saadc_channel_uninit(uint8_t channel);
+uint32_t nrfx_saadc_sample_task_get(void);
+nrfx_err_t nrfx_saadc_sample_convert(uint8_t channel, nrf_saadc_value_t *p_value);
+nrfx_err_t nrfx_saadc_buffer_convert(nrf_saadc_value_t *buffer, uint16_t size);
+nrfx_err_t nrfx_saadc_sample(void);
+bool nrfx_saadc_is_busy(void);
+void nrfx_saadc_abort(void);
+
+// Host only. Set the value that conversions of a channel produce.
+void nrfx_saadc_host_set_input(uint8_t channel, nrf_saadc_value_t value);
+
+// Host only. Function that gives the value converted for an analog input.
+typedef nrf_saadc_value_t (*nrfx_saadc_host_source_t)(nrf_saadc_input_t input);
+
+// Host only. Take the values of all channels from `source`, by the input
+// that each channel samples, instead of from nrfx_saadc_host_set_input().
+// NULL goes back to the values set per channel.
+void nrfx_saadc_host_set_source(nrfx_saadc_host_source_t source);
+
+// Host only. Number of single conversions since nrfx_saadc_init(),
+// counting each one that oversampling averages.
+uint32_t nrfx_saadc_host_conversions(void);
+
+// Host only. Number of events passed to the event handler, which on the
+// board is the number of SAADC interrupts.
+uint32_t nrfx_saadc_host_events(void);
+
+// Host only. Number of SAMPLE tasks that found no buffer to fill.
+uint32_t nrfx_saadc_host_missed(void);
+
+// Host only. Carry out the SAMPLE task. nrfx_ppi_host_event() calls this
+// for a PPI channel that ends at nrfx_saadc_sample_task_get().
+void nrfx_saadc_host_sample_task(void);
+
+#endif
@@ -0,0 +1,192 @@
+/**
+ * @file nrfx_saadc_host.c
+ * @brief Host stand-in for the nrfx SAADC driver.
+ * Conversions produce the values set with nrfx_saadc_host_set_input(),
+ * or given by the source set with nrfx_saadc_host_set_source(),
+ * at once. A SAMPLE task scans the enabled channels, lowest first, into
+ * the buffer queued with nrfx_saadc_buffer_convert(), and when it is full
+ * the driver moves on to the second queued buffer and reports
+ * NRFX_SAADC_EVT_DONE, as the EasyDMA double buffering does on the board.
+ */
+#include <stddef.h>
+#include "nrfx_saadc.h"
+
+// Address of TASKS_SAMPLE of the SAADC on the nRF52832.
+#define SAMPLE_TASK_ADDRESS 0x40007004
+
+static bool initialized = false;
+static nrfx_saadc_config_t config;
+static nrfx_saadc_event_handler_t handler = NULL;
+
+static bool enabled[NRF_SAADC_CHANNEL_COUNT];
+static nrf_saadc_channel_config_t channels[NRF_SAADC_CHANNEL_COUNT];
+static nrf_saadc_value_t inputs[NRF_SAADC_CHANNEL_COUNT];
+static nrfx_saadc_host_source_t source = NULL;
+
+// Buffer being filled and the one queued after it.
+static nrf_saadc_value_t *buffer = NULL;
+static uint16_t buffer_size;
+static uint16_t buffer_fill;
+static nrf_saadc_value_t *next_buffer = NULL;
+static uint16_t next_size;
+
+static uint32_t conversions = 0;
+static uint32_t events = 0;
+static uint32_t missed = 0;
+
+static nrf_saadc_value_t input(uint8_t channel) {
+    return source ? source(channels[channel].pin_p) : inputs[channel];
+}
+
+static uint8_t enabled_count(void) {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < NRF_SAADC_CHANNEL_COUNT; i++) {
+        n += enabled[i];
+    }
+    return n;
+}
+
+nrfx_err_t nrfx_saadc_init(nrfx_saadc_config_t const *p_config,
+                           nrfx_saadc_event_handler_t event_handler) {
+    if (initialized) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    initialized = true;
+    config = *p_config;
+    handler = event_handler;
+    for (uint8_t i = 0; i < NRF_SAADC_CHANNEL_COUNT; i++) {
+        enabled[i] = false;
+    }
+    buffer = NULL;
+    next_buffer = NULL;
+    conversions = 0;
+    events = 0;
+    missed = 0;
+    return NRF_SUCCESS;
+}
+
+void nrfx_saadc_uninit(void) {
+    nrfx_saadc_abort();
+    initialized = false;
+    handler = NULL;
+}
+
+nrfx_err_t nrfx_saadc_channel_init(uint8_t channel,
+                                   nrf_saadc_channel_config_t const *const p_config) {
+    if (channel >= NRF_SAADC_CHANNEL_COUNT) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (enabled[channel]) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    enabled[channel] = true;
+    channels[channel] = *p_config;
+    return NRF_SUCCESS;
+}
+
+nrfx_err_t nrfx_saadc_channel_uninit(uint8_t channel) {
+    if (buffer) {
+        return NRF_ERROR_BUSY;
+    }
+    enabled[channel] = false;
+    return NRF_SUCCESS;
+}
+
+uint32_t nrfx_saadc_sample_task_get(void) {
+    return SAMPLE_TASK_ADDRESS;
+}
+
+nrfx_err_t nrfx_saadc_sample_convert(uint8_t channel, nrf_saadc_value_t *p_value) {
+    if (buffer) {
+        return NRF_ERROR_BUSY;
+    }
+    conversions++;
+    *p_value = input(channel);
+    return NRF_SUCCESS;
+}
+
+nrfx_err_t nrfx_saadc_buffer_convert(nrf_saadc_value_t *p_buffer, uint16_t size) {
+    if (!handler) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    uint8_t count = enabled_count();
+    if (count == 0 || size == 0 || size % count != 0) {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+    if (!buffer) {
+        buffer = p_buffer;
+        buffer_size = size;
+        buffer_fill = 0;
+    } else if (!next_buffer) {
+        next_buffer = p_buffer;
+        next_size = size;
+    } else {
+        return NRF_ERROR_BUSY;
+    }
+    return NRF_SUCCESS;
+}
+
+nrfx_err_t nrfx_saadc_sample(void) {
+    nrfx_saadc_host_sample_task();
+    return NRF_SUCCESS;
+}
+
+bool nrfx_saadc_is_busy(void) {
+    return buffer != NULL;
+}
+
+void nrfx_saadc_abort(void) {
+    buffer = NULL;
+    next_buffer = NULL;
+}
+
+void nrfx_saadc_host_set_input(uint8_t channel, nrf_saadc_value_t value) {
+    inputs[channel] = value;
+}
+
+void nrfx_saadc_host_set_source(nrfx_saadc_host_source_t input_source) {
+    source = input_source;
+}
+
+uint32_t nrfx_saadc_host_conversions(void) {
+    return conversions;
+}
+
+uint32_t nrfx_saadc_host_events(void) {
+    return events;
+}
+
+uint32_t nrfx_saadc_host_missed(void) {
+    return missed;
+}
+
+void nrfx_saadc_host_sample_task(void) {
+    if (!buffer) {
+        missed++;
+        return;
+    }
+    for (uint8_t i = 0; i < NRF_SAADC_CHANNEL_COUNT; i++) {
+        if (!enabled[i]) continue;
+        // With burst enabled, one SAMPLE task takes all the samples that
+        // oversampling averages.
+        conversions += channels[i].burst == NRF_SAADC_BURST_ENABLED
+                ? 1u << config.oversample : 1;
+        buffer[buffer_fill++] = input(i);
+    }
+    if (buffer_fill < buffer_size) {
+        return;
+    }
+    nrfx_saadc_evt_t event = {
+        .type = NRFX_SAADC_EVT_DONE,
+        .data.done = {
+            .p_buffer = buffer,
+            .size = buffer_size,
+        },
+    };
+    buffer = next_buffer;
+    buffer_size = next_size;
+    buffer_fill = 0;
+    next_buffer = NULL;
+    events++;
+    handler(&event);
+}
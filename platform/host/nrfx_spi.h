@@ -0,0 +1,12 @@
+/**
+ * @file nrfx_spi.h
+ * @brief Host stand-in for the nrfx SPI driver header.
+ * Only the default interrupt priority is provided, which the legacy SPI
+ * configuration in nrf_drv_spi.h refers to.
+ */
+#ifndef NRFX_SPI_H__
+#define NRFX_SPI_H__
+
+#define NRFX_SPI_DEFAULT_CONFIG_IRQ_PRIORITY 6
+
+#endif
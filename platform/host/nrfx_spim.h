@@ -0,0 +1,130 @@
+/**
+ * @file nrfx_spim.h
+ * @brief Host stand-in for the nrfx SPIM (SPI master with EasyDMA) driver.
+ * The types and functions follow nrfx_spim.h in nRF5 SDK 15.
+ * The implementation in nrfx_spim_host.c logs transmitted bytes and
+ * counts transfers, which tests read with the host-only functions
+ * declared at the end of this file.
+ */
+#ifndef NRFX_SPIM_H__
+#define NRFX_SPIM_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+typedef ret_code_t nrfx_err_t;
+
+typedef enum {
+    NRF_SPIM_FREQ_125K = 0x02000000,
+    NRF_SPIM_FREQ_1M = 0x10000000,
+    NRF_SPIM_FREQ_4M = 0x40000000,
+    NRF_SPIM_FREQ_8M = 0x80000000,
+} nrf_spim_frequency_t;
+
+typedef enum {
+    NRF_SPIM_MODE_0,
+    NRF_SPIM_MODE_1,
+    NRF_SPIM_MODE_2,
+    NRF_SPIM_MODE_3,
+} nrf_spim_mode_t;
+
+typedef enum {
+    NRF_SPIM_BIT_ORDER_MSB_FIRST = 0,
+    NRF_SPIM_BIT_ORDER_LSB_FIRST = 1,
+} nrf_spim_bit_order_t;
+
+typedef struct {
+    uint8_t drv_inst_idx;
+} nrfx_spim_t;
+
+#define NRFX_SPIM_INSTANCE(id) { .drv_inst_idx = (id) }
+
+#define NRFX_SPIM_PIN_NOT_USED 0xFF
+#define NRFX_SPIM_DEFAULT_CONFIG_IRQ_PRIORITY 6
+
+typedef struct {
+    uint8_t sck_pin;
+    uint8_t mosi_pin;
+    uint8_t miso_pin;
+    uint8_t ss_pin;
+    bool ss_active_high;
+    uint8_t irq_priority;
+    uint8_t orc;
+    nrf_spim_frequency_t frequency;
+    nrf_spim_mode_t mode;
+    nrf_spim_bit_order_t bit_order;
+} nrfx_spim_config_t;
+
+#define NRFX_SPIM_DEFAULT_CONFIG { \
+    .sck_pin = NRFX_SPIM_PIN_NOT_USED, \
+    .mosi_pin = NRFX_SPIM_PIN_NOT_USED, \
+    .miso_pin = NRFX_SPIM_PIN_NOT_USED, \
+    .ss_pin = NRFX_SPIM_PIN_NOT_USED, \
+    .ss_active_high = false, \
+    .irq_priority = NRFX_SPIM_DEFAULT_CONFIG_IRQ_PRIORITY, \
+    .orc = 0xFF, \
+    .frequency = NRF_SPIM_FREQ_4M, \
+    .mode = NRF_SPIM_MODE_0, \
+    .bit_order = NRF_SPIM_BIT_ORDER_MSB_FIRST, \
+}
+
+typedef struct {
+    uint8_t const *p_tx_buffer;
+    size_t tx_length;
+    uint8_t *p_rx_buffer;
+    size_t rx_length;
+} nrfx_spim_xfer_desc_t;
+
+#define NRFX_SPIM_XFER_TRX(_p_tx_buf, _tx_length, _p_rx_buf, _rx_length) { \
+    .p_tx_buffer = (uint8_t const *)(_p_tx_buf), \
+    .tx_length = (_tx_length), \
+    .p_rx_buffer = (_p_rx_buf), \
+    .rx_length = (_rx_length), \
+}
+#define NRFX_SPIM_XFER_TX(_p_buf, _length) NRFX_SPIM_XFER_TRX(_p_buf, _length, NULL, 0)
+
+typedef enum {
+    NRFX_SPIM_EVENT_DONE,
+} nrfx_spim_evt_type_t;
+
+typedef struct {
+    nrfx_spim_evt_type_t type;
+    nrfx_spim_xfer_desc_t xfer_desc;
+} nrfx_spim_evt_t;
+
+typedef void (*nrfx_spim_evt_handler_t)(nrfx_spim_evt_t const *p_event, void *p_context);
+
+nrfx_err_t nrfx_spim_init(nrfx_spim_t const *const p_instance,
+                          nrfx_spim_config_t const *p_config,
+                          nrfx_spim_evt_handler_t handler,
+                          void *p_context);
+void nrfx_spim_uninit(nrfx_spim_t const *const p_instance);
+nrfx_err_t nrfx_spim_xfer(nrfx_spim_t const *const p_instance,
+                          nrfx_spim_xfer_desc_t const *p_xfer_desc,
+                          uint32_t flags);
+
+// Host only. Finish the transfer in progress, calling the event handler
+// with NRFX_SPIM_EVENT_DONE. Without an event handler, transfers finish
+// inside nrfx_spim_xfer(). Returns false if there was none.
+bool nrfx_spim_host_complete(void);
+
+// Host only. Copy up to `length` transmitted bytes into `p_data`, removing
+// them from the stand-in's transmit log. Returns the number copied.
+size_t nrfx_spim_host_take_tx(uint8_t *p_data, size_t length);
+
+// Host only. Number of transfers started since nrfx_spim_init().
+uint32_t nrfx_spim_host_transfers(void);
+
+// Host only. Function that receives the transmitted bytes of a transfer,
+// as a device on the bus would.
+typedef void (*nrfx_spim_host_device_t)(uint8_t const *p_data, size_t length, void *p_context);
+
+// Host only. Attach a device that receives every transfer, or detach it
+// with NULL. While a device is attached, transfers with an event handler
+// also finish inside nrfx_spim_xfer(), which calls the handler before
+// returning, so nothing needs to call nrfx_spim_host_complete().
+void nrfx_spim_host_attach(nrfx_spim_host_device_t device, void *p_context);
+
+#endif
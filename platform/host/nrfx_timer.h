@@ -0,0 +1,121 @@
+/**
+ * @file nrfx_timer.h
+ * @brief Host stand-in for the nrfx TIMER driver.
+ * The types and functions follow nrfx_timer.h in nRF5 SDK 15. Timers in
+ * nrfx_timer_host.c count only when a test calls nrfx_timer_host_advance(),
+ * and a compare event is passed on to any PPI channel that starts at it.
+ */
+#ifndef NRFX_TIMER_H__
+#define NRFX_TIMER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+typedef ret_code_t nrfx_err_t;
+
+#define NRFX_TIMER_HOST_COUNT 5
+
+typedef struct {
+    uint8_t instance_id;
+    uint8_t cc_channel_count;
+} nrfx_timer_t;
+
+#define NRFX_TIMER_INSTANCE(id) { \
+    .instance_id = (id), \
+    .cc_channel_count = (id) < 3 ? 4 : 6, \
+}
+
+typedef enum {
+    NRF_TIMER_FREQ_16MHz,
+    NRF_TIMER_FREQ_8MHz,
+    NRF_TIMER_FREQ_4MHz,
+    NRF_TIMER_FREQ_2MHz,
+    NRF_TIMER_FREQ_1MHz,
+    NRF_TIMER_FREQ_500kHz,
+    NRF_TIMER_FREQ_250kHz,
+    NRF_TIMER_FREQ_125kHz,
+    NRF_TIMER_FREQ_62500Hz,
+    NRF_TIMER_FREQ_31250Hz,
+} nrf_timer_frequency_t;
+
+typedef enum {
+    NRF_TIMER_MODE_TIMER,
+    NRF_TIMER_MODE_COUNTER,
+    NRF_TIMER_MODE_LOW_POWER_COUNTER,
+} nrf_timer_mode_t;
+
+typedef enum {
+    NRF_TIMER_BIT_WIDTH_16,
+    NRF_TIMER_BIT_WIDTH_8,
+    NRF_TIMER_BIT_WIDTH_24,
+    NRF_TIMER_BIT_WIDTH_32,
+} nrf_timer_bit_width_t;
+
+typedef enum {
+    NRF_TIMER_CC_CHANNEL0,
+    NRF_TIMER_CC_CHANNEL1,
+    NRF_TIMER_CC_CHANNEL2,
+    NRF_TIMER_CC_CHANNEL3,
+    NRF_TIMER_CC_CHANNEL4,
+    NRF_TIMER_CC_CHANNEL5,
+} nrf_timer_cc_channel_t;
+
+typedef enum {
+    NRF_TIMER_EVENT_COMPARE0 = 0x140,
+    NRF_TIMER_EVENT_COMPARE1 = 0x144,
+    NRF_TIMER_EVENT_COMPARE2 = 0x148,
+    NRF_TIMER_EVENT_COMPARE3 = 0x14C,
+    NRF_TIMER_EVENT_COMPARE4 = 0x150,
+    NRF_TIMER_EVENT_COMPARE5 = 0x154,
+} nrf_timer_event_t;
+
+typedef enum {
+    NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK = 1 << 0,
+    NRF_TIMER_SHORT_COMPARE1_CLEAR_MASK = 1 << 1,
+    NRF_TIMER_SHORT_COMPARE2_CLEAR_MASK = 1 << 2,
+    NRF_TIMER_SHORT_COMPARE3_CLEAR_MASK = 1 << 3,
+    NRF_TIMER_SHORT_COMPARE4_CLEAR_MASK = 1 << 4,
+    NRF_TIMER_SHORT_COMPARE5_CLEAR_MASK = 1 << 5,
+} nrf_timer_short_mask_t;
+
+typedef struct {
+    nrf_timer_frequency_t frequency;
+    nrf_timer_mode_t mode;
+    nrf_timer_bit_width_t bit_width;
+    uint8_t interrupt_priority;
+    void *p_context;
+} nrfx_timer_config_t;
+
+#define NRFX_TIMER_DEFAULT_CONFIG { \
+    .frequency = NRF_TIMER_FREQ_16MHz, \
+    .mode = NRF_TIMER_MODE_TIMER, \
+    .bit_width = NRF_TIMER_BIT_WIDTH_32, \
+    .interrupt_priority = 6, \
+    .p_context = NULL, \
+}
+
+typedef void (*nrfx_timer_event_handler_t)(nrf_timer_event_t event_type, void *p_context);
+
+nrfx_err_t nrfx_timer_init(nrfx_timer_t const *const p_instance,
+                           nrfx_timer_config_t const *p_config,
+                           nrfx_timer_event_handler_t timer_event_handler);
+void nrfx_timer_uninit(nrfx_timer_t const *const p_instance);
+void nrfx_timer_enable(nrfx_timer_t const *const p_instance);
+void nrfx_timer_disable(nrfx_timer_t const *const p_instance);
+bool nrfx_timer_is_enabled(nrfx_timer_t const *const p_instance);
+void nrfx_timer_clear(nrfx_timer_t const *const p_instance);
+uint32_t nrfx_timer_us_to_ticks(nrfx_timer_t const *const p_instance, uint32_t time_us);
+void nrfx_timer_extended_compare(nrfx_timer_t const *const p_instance,
+                                 nrf_timer_cc_channel_t cc_channel,
+                                 uint32_t cc_value,
+                                 nrf_timer_short_mask_t timer_short_mask,
+                                 bool enable_int);
+uint32_t nrfx_timer_compare_event_address_get(nrfx_timer_t const *const p_instance,
+                                              nrf_timer_cc_channel_t channel);
+
+// Host only. Let every enabled timer count for `time_us` microseconds,
+// generating the compare events that fall in that time.
+void nrfx_timer_host_advance(uint32_t time_us);
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * @file nrfx_timer_host.c
+ * @brief Host stand-in for the nrfx TIMER driver.
+ * Only the first compare channel with a clear short is modelled, which
+ * is how a timer is set up to trigger a task periodically through PPI.
+ */
+#include <stddef.h>
+#include "nrfx_timer.h"
+#include "nrfx_ppi.h"
+
+// Base address of TIMER0 on the nRF52832. The others follow at 0x1000 steps.
+#define TIMER0_ADDRESS 0x40008000
+#define TIMER_ADDRESS(id) ((id) < 3 ? TIMER0_ADDRESS + 0x1000 * (id) \
+        : 0x4001A000 + 0x1000 * ((id) - 3))
+
+typedef struct {
+    bool initialized;
+    bool enabled;
+    nrfx_timer_config_t config;
+    nrfx_timer_event_handler_t handler;
+    nrf_timer_cc_channel_t channel;
+    uint32_t cc;         // Compare value, or 0 if none is set.
+    bool interrupt;
+    uint64_t counter;    // In 1/16 us, to keep the fraction of a tick.
+} timer_state_t;
+
+static timer_state_t timers[NRFX_TIMER_HOST_COUNT];
+
+nrfx_err_t nrfx_timer_init(nrfx_timer_t const *const p_instance,
+                           nrfx_timer_config_t const *p_config,
+                           nrfx_timer_event_handler_t timer_event_handler) {
+    timer_state_t *t = &timers[p_instance->instance_id];
+    if (t->initialized) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    // The SDK asserts that there is a handler, even if it is never called.
+    if (!timer_event_handler) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    *t = (timer_state_t){
+        .initialized = true,
+        .config = *p_config,
+        .handler = timer_event_handler,
+    };
+    return NRF_SUCCESS;
+}
+
+void nrfx_timer_uninit(nrfx_timer_t const *const p_instance) {
+    timers[p_instance->instance_id].initialized = false;
+    timers[p_instance->instance_id].enabled = false;
+}
+
+void nrfx_timer_enable(nrfx_timer_t const *const p_instance) {
+    timers[p_instance->instance_id].enabled = true;
+}
+
+void nrfx_timer_disable(nrfx_timer_t const *const p_instance) {
+    timers[p_instance->instance_id].enabled = false;
+}
+
+bool nrfx_timer_is_enabled(nrfx_timer_t const *const p_instance) {
+    return timers[p_instance->instance_id].enabled;
+}
+
+void nrfx_timer_clear(nrfx_timer_t const *const p_instance) {
+    timers[p_instance->instance_id].counter = 0;
+}
+
+uint32_t nrfx_timer_us_to_ticks(nrfx_timer_t const *const p_instance, uint32_t time_us) {
+    return (uint32_t)(((uint64_t)time_us * 16) >> timers[p_instance->instance_id].config.frequency);
+}
+
+void nrfx_timer_extended_compare(nrfx_timer_t const *const p_instance,
+                                 nrf_timer_cc_channel_t cc_channel,
+                                 uint32_t cc_value,
+                                 nrf_timer_short_mask_t timer_short_mask,
+                                 bool enable_int) {
+    timer_state_t *t = &timers[p_instance->instance_id];
+    t->channel = cc_channel;
+    t->cc = (timer_short_mask & (1 << cc_channel)) ? cc_value : 0;
+    t->interrupt = enable_int;
+}
+
+uint32_t nrfx_timer_compare_event_address_get(nrfx_timer_t const *const p_instance,
+                                              nrf_timer_cc_channel_t channel) {
+    return TIMER_ADDRESS(p_instance->instance_id) + NRF_TIMER_EVENT_COMPARE0 + 4 * channel;
+}
+
+void nrfx_timer_host_advance(uint32_t time_us) {
+    for (uint8_t id = 0; id < NRFX_TIMER_HOST_COUNT; id++) {
+        timer_state_t *t = &timers[id];
+        if (!t->enabled || t->cc == 0) continue;
+        uint64_t period = (uint64_t)t->cc << t->config.frequency;
+        t->counter += (uint64_t)time_us * 16;
+        while (t->counter >= period) {
+            t->counter -= period;
+            nrfx_timer_t instance = NRFX_TIMER_INSTANCE(id);
+            nrfx_ppi_host_event(nrfx_timer_compare_event_address_get(&instance, t->channel));
+            if (t->interrupt) {
+                t->handler(NRF_TIMER_EVENT_COMPARE0 + 4 * t->channel, t->config.p_context);
+            }
+        }
+    }
+}
@@ -0,0 +1,127 @@
+/**
+ * @file nrfx_uart.h
+ * @brief Host stand-in for the nrfx UART driver.
+ * The types and functions follow nrfx_uart.h in nRF5 SDK 15.
+ * The implementation in nrfx_uart_host.c behaves like the driver in
+ * interrupt mode, with the "wire" replaced by the host-only functions
+ * declared at the end of this file: tests push received bytes in and
+ * take transmitted bytes out and complete transmissions.
+ */
+#ifndef NRFX_UART_H__
+#define NRFX_UART_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+typedef ret_code_t nrfx_err_t;
+
+typedef enum {
+    NRF_UART_PARITY_EXCLUDED = 0,
+    NRF_UART_PARITY_INCLUDED = 0x0E,
+} nrf_uart_parity_t;
+
+typedef enum {
+    NRF_UART_HWFC_DISABLED = 0,
+    NRF_UART_HWFC_ENABLED = 1,
+} nrf_uart_hwfc_t;
+
+typedef enum {
+    NRF_UART_BAUDRATE_115200 = 0x01D7E000,
+} nrf_uart_baudrate_t;
+
+#define NRFX_UART_DEFAULT_CONFIG_IRQ_PRIORITY 6
+
+typedef struct {
+    uint8_t drv_inst_idx;
+} nrfx_uart_t;
+
+#define NRFX_UART_INSTANCE(id) { .drv_inst_idx = (id) }
+
+typedef struct {
+    uint32_t pseltxd;
+    uint32_t pselrxd;
+    uint32_t pselcts;
+    uint32_t pselrts;
+    void *p_context;
+    nrf_uart_hwfc_t hwfc;
+    nrf_uart_parity_t parity;
+    nrf_uart_baudrate_t baudrate;
+    uint8_t interrupt_priority;
+} nrfx_uart_config_t;
+
+#define NRFX_UART_DEFAULT_CONFIG { \
+    .pseltxd = 0xFFFFFFFF, \
+    .pselrxd = 0xFFFFFFFF, \
+    .pselcts = 0xFFFFFFFF, \
+    .pselrts = 0xFFFFFFFF, \
+    .p_context = NULL, \
+    .hwfc = NRF_UART_HWFC_DISABLED, \
+    .parity = NRF_UART_PARITY_EXCLUDED, \
+    .baudrate = NRF_UART_BAUDRATE_115200, \
+    .interrupt_priority = NRFX_UART_DEFAULT_CONFIG_IRQ_PRIORITY, \
+}
+
+typedef enum {
+    NRFX_UART_EVT_TX_DONE,
+    NRFX_UART_EVT_RX_DONE,
+    NRFX_UART_EVT_ERROR,
+} nrfx_uart_evt_type_t;
+
+typedef struct {
+    uint8_t *p_data;
+    uint32_t bytes;
+} nrfx_uart_xfer_evt_t;
+
+typedef struct {
+    nrfx_uart_xfer_evt_t rxtx;
+    uint32_t error_mask;
+} nrfx_uart_error_evt_t;
+
+typedef struct {
+    nrfx_uart_evt_type_t type;
+    union {
+        nrfx_uart_xfer_evt_t rxtx;
+        nrfx_uart_error_evt_t error;
+    } data;
+} nrfx_uart_event_t;
+
+typedef void (*nrfx_uart_event_handler_t)(nrfx_uart_event_t const *p_event, void *p_context);
+
+nrfx_err_t nrfx_uart_init(nrfx_uart_t const *p_instance,
+                          nrfx_uart_config_t const *p_config,
+                          nrfx_uart_event_handler_t event_handler);
+void nrfx_uart_uninit(nrfx_uart_t const *p_instance);
+nrfx_err_t nrfx_uart_tx(nrfx_uart_t const *p_instance, uint8_t const *p_data, size_t length);
+bool nrfx_uart_tx_in_progress(nrfx_uart_t const *p_instance);
+nrfx_err_t nrfx_uart_rx(nrfx_uart_t const *p_instance, uint8_t *p_data, size_t length);
+void nrfx_uart_rx_enable(nrfx_uart_t const *p_instance);
+void nrfx_uart_rx_disable(nrfx_uart_t const *p_instance);
+void nrfx_uart_rx_abort(nrfx_uart_t const *p_instance);
+uint32_t nrfx_uart_errorsrc_get(nrfx_uart_t const *p_instance);
+
+// Error sources reported in nrfx_uart_error_evt_t.error_mask.
+#define NRF_UART_ERROR_OVERRUN_MASK 0x01
+#define NRF_UART_ERROR_PARITY_MASK  0x02
+#define NRF_UART_ERROR_FRAMING_MASK 0x04
+#define NRF_UART_ERROR_BREAK_MASK   0x08
+
+// Host only. Deliver bytes as if they arrived on the RX pin, calling the
+// event handler with NRFX_UART_EVT_RX_DONE whenever a receive completes.
+// Bytes that arrive while no receive is pending are lost, as with a full
+// hardware FIFO. Returns the number of bytes delivered.
+size_t nrfx_uart_host_receive(uint8_t const *p_data, size_t length);
+
+// Host only. Abort the pending receive with NRFX_UART_EVT_ERROR.
+void nrfx_uart_host_error(uint32_t error_mask);
+
+// Host only. Finish the transmission in progress, calling the event handler
+// with NRFX_UART_EVT_TX_DONE. Returns false if there was none.
+bool nrfx_uart_host_tx_complete(void);
+
+// Host only. Copy up to `length` transmitted bytes into `p_data`, removing
+// them from the stand-in's transmit log. Returns the number copied.
+size_t nrfx_uart_host_take_tx(uint8_t *p_data, size_t length);
+
+#endif
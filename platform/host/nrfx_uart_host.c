@@ -0,0 +1,155 @@
+/**
+ * @file nrfx_uart_host.c
+ * @brief Host stand-in for the nrfx UART driver.
+ * Transmitted bytes are appended to a log that tests read with
+ * nrfx_uart_host_take_tx(). Without an event handler, transmission
+ * completes at once. With one, it stays in progress until the test calls
+ * nrfx_uart_host_tx_complete(), as if the UART were still shifting it out.
+ * Received bytes come from nrfx_uart_host_receive(). With an event
+ * handler, receives complete through NRFX_UART_EVT_RX_DONE as they do
+ * in interrupt mode. Without one, nrfx_uart_rx() fails with a timeout.
+ */
+#include <string.h>
+#include "nrfx_uart.h"
+
+#define TX_LOG_SIZE 4096
+
+static nrfx_uart_event_handler_t handler = NULL;
+static void *handler_context = NULL;
+
+// Pending receive, if rx_buffer is not NULL.
+static uint8_t *rx_buffer = NULL;
+static size_t rx_length = 0;
+static size_t rx_count = 0;
+static uint32_t error_source = 0;
+
+static uint8_t tx_log[TX_LOG_SIZE];
+static size_t tx_log_length = 0;
+
+// Transmission in progress, if tx_buffer is not NULL.
+static uint8_t const *tx_buffer = NULL;
+static size_t tx_length = 0;
+
+nrfx_err_t nrfx_uart_init(nrfx_uart_t const *p_instance,
+                          nrfx_uart_config_t const *p_config,
+                          nrfx_uart_event_handler_t event_handler) {
+    handler = event_handler;
+    handler_context = p_config->p_context;
+    rx_buffer = NULL;
+    tx_buffer = NULL;
+    tx_log_length = 0;
+    return NRF_SUCCESS;
+}
+
+void nrfx_uart_uninit(nrfx_uart_t const *p_instance) {
+    handler = NULL;
+    rx_buffer = NULL;
+}
+
+nrfx_err_t nrfx_uart_tx(nrfx_uart_t const *p_instance, uint8_t const *p_data, size_t length) {
+    if (tx_buffer) {
+        return NRF_ERROR_BUSY;
+    }
+    if (length > TX_LOG_SIZE - tx_log_length) {
+        // Tests that never take the log only lose the oldest bytes.
+        tx_log_length = 0;
+    }
+    memcpy(tx_log + tx_log_length, p_data, length);
+    tx_log_length += length;
+    if (handler) {
+        tx_buffer = p_data;
+        tx_length = length;
+    }
+    return NRF_SUCCESS;
+}
+
+bool nrfx_uart_tx_in_progress(nrfx_uart_t const *p_instance) {
+    return tx_buffer != NULL;
+}
+
+nrfx_err_t nrfx_uart_rx(nrfx_uart_t const *p_instance, uint8_t *p_data, size_t length) {
+    if (!handler) {
+        return NRF_ERROR_TIMEOUT;
+    }
+    if (rx_buffer) {
+        return NRF_ERROR_BUSY;
+    }
+    rx_buffer = p_data;
+    rx_length = length;
+    rx_count = 0;
+    return NRF_SUCCESS;
+}
+
+void nrfx_uart_rx_enable(nrfx_uart_t const *p_instance) {
+}
+
+void nrfx_uart_rx_disable(nrfx_uart_t const *p_instance) {
+}
+
+void nrfx_uart_rx_abort(nrfx_uart_t const *p_instance) {
+    rx_buffer = NULL;
+}
+
+uint32_t nrfx_uart_errorsrc_get(nrfx_uart_t const *p_instance) {
+    uint32_t result = error_source;
+    error_source = 0;
+    return result;
+}
+
+size_t nrfx_uart_host_receive(uint8_t const *p_data, size_t length) {
+    size_t delivered = 0;
+    for (size_t i = 0; i < length && rx_buffer; i++) {
+        rx_buffer[rx_count++] = p_data[i];
+        delivered++;
+        if (rx_count == rx_length) {
+            // Clear the pending receive first so the handler can start another.
+            nrfx_uart_event_t event = {
+                .type = NRFX_UART_EVT_RX_DONE,
+                .data.rxtx = { .p_data = rx_buffer, .bytes = rx_count },
+            };
+            rx_buffer = NULL;
+            handler(&event, handler_context);
+        }
+    }
+    return delivered;
+}
+
+void nrfx_uart_host_error(uint32_t error_mask) {
+    if (!rx_buffer) {
+        return;
+    }
+    error_source |= error_mask;
+    nrfx_uart_event_t event = {
+        .type = NRFX_UART_EVT_ERROR,
+        .data.error = {
+            .rxtx = { .p_data = rx_buffer, .bytes = rx_count },
+            .error_mask = error_mask,
+        },
+    };
+    rx_buffer = NULL;
+    handler(&event, handler_context);
+}
+
+bool nrfx_uart_host_tx_complete(void) {
+    if (!tx_buffer) {
+        return false;
+    }
+    // Clear the transmission first so the handler can start another.
+    nrfx_uart_event_t event = {
+        .type = NRFX_UART_EVT_TX_DONE,
+        .data.rxtx = { .p_data = (uint8_t *)tx_buffer, .bytes = tx_length },
+    };
+    tx_buffer = NULL;
+    handler(&event, handler_context);
+    return true;
+}
+
+size_t nrfx_uart_host_take_tx(uint8_t *p_data, size_t length) {
+    if (length > tx_log_length) {
+        length = tx_log_length;
+    }
+    memcpy(p_data, tx_log, length);
+    memmove(tx_log, tx_log + length, tx_log_length - length);
+    tx_log_length -= length;
+    return length;
+}
@@ -0,0 +1,18 @@
+/**
+ * @file sdk_errors.h
+ * @brief Host stand-in for the nRF5 SDK error types.
+ */
+#ifndef SDK_ERRORS_H__
+#define SDK_ERRORS_H__
+
+#include <stdint.h>
+#include "nrf_error.h"
+
+typedef uint32_t ret_code_t;
+
+#define NRF_ERROR_PERIPH_DRIVERS_ERR_BASE     (0x8200)
+#define NRF_ERROR_DRV_TWI_ERR_OVERRUN         (NRF_ERROR_PERIPH_DRIVERS_ERR_BASE + 0x0000)
+#define NRF_ERROR_DRV_TWI_ERR_ANACK           (NRF_ERROR_PERIPH_DRIVERS_ERR_BASE + 0x0001)
+#define NRF_ERROR_DRV_TWI_ERR_DNACK           (NRF_ERROR_PERIPH_DRIVERS_ERR_BASE + 0x0002)
+
+#endif
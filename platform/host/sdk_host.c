@@ -0,0 +1,47 @@
+/**
+ * @file sdk_host.c
+ * @brief Host stand-ins for the nRF5 SDK services used by lib/.
+ *
+ * The headers in this directory provide just enough of the SDK API for
+ * the C code in lib/ to compile and run on a Linux or macOS machine, for
+ * host tests and benchmarks. Put this directory on the include path
+ * ahead of the project root, e.g. `cc -Iplatform/host -I. ...`.
+ */
+#include <stdlib.h>
+
+#include "app_error.h"
+#include "app_timer.h"
+#include "nrf_drv_clock.h"
+
+void app_error_handler_host(ret_code_t error_code, const char *file, int line) {
+    fprintf(stderr, "ERROR: error code %u at %s:%d\n", (unsigned)error_code, file, line);
+    abort();
+}
+
+ret_code_t nrf_drv_clock_init(void) {
+    return NRF_SUCCESS;
+}
+
+void nrf_drv_clock_lfclk_request(void *p_handler_item) {
+}
+
+// The RTC counter is 24 bits wide.
+#define APP_TIMER_CNT_MASK 0x00FFFFFF
+
+static uint32_t app_timer_cnt = 0;
+
+ret_code_t app_timer_init(void) {
+    return NRF_SUCCESS;
+}
+
+uint32_t app_timer_cnt_get(void) {
+    return app_timer_cnt;
+}
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from) {
+    return (ticks_to - ticks_from) & APP_TIMER_CNT_MASK;
+}
+
+void app_timer_host_advance(uint32_t ticks) {
+    app_timer_cnt = (app_timer_cnt + ticks) & APP_TIMER_CNT_MASK;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file display_linux.c
+ * @brief Buckler display for the Linux platform.
+ *
+ * A model of the LCD panel takes what display_write() writes and what
+ * goes over the SPIM stand-in, which lib/lcd.c uses, decoding the latter
+ * as the panel's controller does (see lib/lcd.c). Whenever a transfer or
+ * a write changes a row, the row goes to standard output as
+ * "LCD <row>: <text>".
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "display.h"
+#include "nrfx_spim.h"
+
+#define ROWS 2
+#define COLUMNS 16
+// Display memory per row, of which the panel shows the first COLUMNS.
+#define ROW_LENGTH 0x40
+
+#define START_COMMAND 0x1F
+#define START_DATA 0x5F
+#define SET_ADDRESS 0x80
+#define ROW_1_ADDRESS 0x40
+
+static char memory[ROWS][ROW_LENGTH];
+static char printed[ROWS][COLUMNS + 1];
+static uint8_t address = 0;
+
+// A command or character being received, three bytes long.
+static uint8_t group[3];
+static int group_length = 0;
+
+static void print_changes(void) {
+    for (int row = 0; row < ROWS; row++) {
+        if (memcmp(printed[row], memory[row], COLUMNS) != 0) {
+            memcpy(printed[row], memory[row], COLUMNS);
+            printf("LCD %d: %s\n", row, printed[row]);
+        }
+    }
+    fflush(stdout);
+}
+
+static void receive(uint8_t start, uint8_t value) {
+    if (start == START_COMMAND && (value & SET_ADDRESS)) {
+        address = value & 0x7F;
+    } else if (start == START_DATA) {
+        int row = (address & ROW_1_ADDRESS) ? 1 : 0;
+        memory[row][address & (ROW_LENGTH - 1)] = value;
+        address = (address & ROW_1_ADDRESS) | ((address + 1) & (ROW_LENGTH - 1));
+    }
+}
+
+static void panel(uint8_t const *p_data, size_t length, void *p_context) {
+    for (size_t i = 0; i < length; i++) {
+        group[group_length++] = p_data[i];
+        if (group_length == 3) {
+            receive(group[0], group[1] | (group[2] << 4));
+            group_length = 0;
+        }
+    }
+    print_changes();
+}
+
+ret_code_t display_init(const nrf_drv_spi_t *spi_instance) {
+    memset(memory, ' ', sizeof(memory));
+    memset(printed, 0, sizeof(printed));
+    address = 0;
+    group_length = 0;
+    nrfx_spim_host_attach(panel, NULL);
+    return NRF_SUCCESS;
+}
+
+ret_code_t display_write(const char *format, uint8_t row) {
+    if (row >= ROWS) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    size_t i = 0;
+    for (; i < COLUMNS && format[i]; i++) memory[row][i] = format[i];
+    for (; i < COLUMNS; i++) memory[row][i] = ' ';
+    print_changes();
+    return NRF_SUCCESS;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file lsm9ds1_linux.c
+ * @brief Blocking LSM9DS1 reads for the Linux platform, from the world
+ * model in sim.h.
+ *
+ * The axes are those of the robot, x ahead, y to the left, and z up. The
+ * accelerometer reads 1 g on z at rest, the gyro reads the yaw rate on z,
+ * and the magnetometer reads a field of 20 uT horizontal, pointing along
+ * the robot's starting heading, and 45 uT down.
+ */
+
+#include <math.h>
+#include "lsm9ds1.h"
+#include "sim.h"
+
+#define GRAVITY 9.81
+#define PI 3.14159265358979323846
+
+lsm9ds1_measurement_t lsm9ds1_read_accelerometer(void) {
+    sim_state_t const *now = sim_now();
+    lsm9ds1_measurement_t measurement = {
+        .x_axis = now->forward_acceleration / GRAVITY,
+        .y_axis = now->lateral_acceleration / GRAVITY,
+        .z_axis = 1.0f,
+    };
+    return measurement;
+}
+
+lsm9ds1_measurement_t lsm9ds1_read_gyro(void) {
+    sim_state_t const *now = sim_now();
+    lsm9ds1_measurement_t measurement = {
+        .x_axis = 0.0f,
+        .y_axis = 0.0f,
+        .z_axis = now->yaw_rate * 180.0 / PI,
+    };
+    return measurement;
+}
+
+lsm9ds1_measurement_t lsm9ds1_read_magnetometer(void) {
+    sim_state_t const *now = sim_now();
+    lsm9ds1_measurement_t measurement = {
+        .x_axis = 20.0 * cos(now->theta),
+        .y_axis = -20.0 * sin(now->theta),
+        .z_axis = -45.0f,
+    };
+    return measurement;
+}
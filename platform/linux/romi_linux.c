@@ -0,0 +1,106 @@
+/**
+ * @file romi_linux.c
+ * @brief Implementation of romi.h for the Linux platform, on the world
+ * model in sim.h rather than the UART.
+ *
+ * Drive commands go straight to the model, and the sensor data is that of
+ * the most recent packet the Romi would have sent, every 20 ms. The
+ * encoders count the distance each wheel covered at the Romi's 0.6108 mm
+ * per tick, and the inertial sub-payload has the model's heading. The
+ * bumpers, buttons, and reflectance sensors never change. Packets are
+ * neither lost nor corrupted, so those counters stay at zero.
+ */
+
+#include "lib/romi.h"
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+#include "sim.h"
+
+#define METERS_PER_TICK 0.0006108
+#define PI 3.14159265358979323846
+
+static bool initialized = false;
+// Logical time of romi_init(), in nanoseconds.
+static int64_t init_time = 0;
+static romi_buttons_t previous_buttons;
+static romi_rx_stats_t rx_stats;
+static romi_tx_stats_t tx_stats;
+
+static double centidegrees(double radians) {
+    return radians * 18000.0 / PI;
+}
+
+static uint16_t ticks(double distance) {
+    return (uint16_t)(int64_t)floor(distance / METERS_PER_TICK);
+}
+
+bool romi_button_pressed(romi_sensors_t *const sensors) {
+    bool pressed = (sensors->buttons.left && !previous_buttons.left)
+            || (sensors->buttons.right && !previous_buttons.right);
+    previous_buttons = sensors->buttons;
+    return pressed;
+}
+
+int32_t romi_drive_direct(int16_t leftWheelSpeed, int16_t rightWheelSpeed) {
+    sim_drive(leftWheelSpeed / 1000.0, rightWheelSpeed / 1000.0);
+    tx_stats.queued++;
+    tx_stats.sent++;
+    return NRF_SUCCESS;
+}
+
+uint32_t romi_init() {
+    initialized = true;
+    init_time = sim_now()->time;
+    memset(&previous_buttons, 0, sizeof(previous_buttons));
+    memset(&rx_stats, 0, sizeof(rx_stats));
+    memset(&tx_stats, 0, sizeof(tx_stats));
+    return NRF_SUCCESS;
+}
+
+int32_t romi_sensors_ext_poll(romi_sensors_ext_t *const sensors) {
+    memset(sensors, 0, sizeof(*sensors));
+    sim_state_t const *packet = sim_packet();
+    if (!initialized || packet->time <= init_time) {
+        return NRF_SUCCESS;
+    }
+    rx_stats.packets = (packet->time - init_time) / SIM_PACKET_PERIOD;
+
+    sensors->present = (1 << ROMI_ID_BASIC) | (1 << ROMI_ID_INERTIAL);
+    sensors->basic.time_stamp = (uint16_t)(packet->time / 1000000);
+    sensors->basic.encoders.left = ticks(packet->left_distance);
+    sensors->basic.encoders.right = ticks(packet->right_distance);
+    sensors->battery = 74;
+    // Wrapped to -180 to 180 degrees, as the robot reports it.
+    sensors->inertial.angle = (int16_t)lround(remainder(centidegrees(packet->theta), 36000.0));
+    sensors->inertial.angle_rate = (int16_t)lround(centidegrees(packet->yaw_rate));
+    return NRF_SUCCESS;
+}
+
+int32_t romi_sensors_poll(romi_sensors_t *const sensors) {
+    romi_sensors_ext_t ext;
+    int32_t result = romi_sensors_ext_poll(&ext);
+    *sensors = ext.basic;
+    return result;
+}
+
+const uint8_t *romi_sensors_raw(uint8_t id, uint8_t *length) {
+    return NULL;
+}
+
+uint32_t romi_sensors_age_ms(void) {
+    sim_state_t const *now = sim_now();
+    sim_state_t const *packet = sim_packet();
+    if (!initialized || packet->time <= init_time) {
+        return UINT32_MAX;
+    }
+    return (uint32_t)((now->time - packet->time) / 1000000);
+}
+
+void romi_rx_stats(romi_rx_stats_t *const stats) {
+    *stats = rx_stats;
+}
+
+void romi_tx_stats(romi_tx_stats_t *const stats) {
+    *stats = tx_stats;
+}
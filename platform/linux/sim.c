@@ -0,0 +1,102 @@
+/**
+ * @file sim.c
+ * @brief Implementation of the Linux platform's world model.
+ */
+
+#include "sim.h"
+#include <math.h>
+#include <string.h>
+#include "nrfx_saadc.h"
+
+// Provided by the LF runtime.
+int64_t lf_time_logical_elapsed(void);
+
+#define GRAVITY 9.81
+
+// The ADXL327 on the Buckler has its zero at half of the 3 V supply and
+// 0.42 V per g, both ratiometric, here with the board's 2.98 V supply.
+// The SAADC reads 3.6 V full scale at 12 bits.
+#define ADXL327_SUPPLY 2.98
+#define ADXL327_BIAS (1.5 * ADXL327_SUPPLY / 3.0)
+#define ADXL327_SENS (0.42 * ADXL327_SUPPLY / 3.0)
+#define SAADC_LSB (3.6 / 4096)
+
+static sim_state_t state;
+static sim_state_t packet;
+static double left_command = 0;
+static double right_command = 0;
+
+static void step(void) {
+    double dt = SIM_STEP * 1e-9;
+    double k = 1 - exp(-dt / SIM_WHEEL_LAG);
+    double left = state.left_speed + (left_command - state.left_speed) * k;
+    double right = state.right_speed + (right_command - state.right_speed) * k;
+
+    double previous = (state.left_speed + state.right_speed) / 2;
+    double speed = (left + right) / 2;
+    double yaw_rate = (right - left) / SIM_WHEELBASE;
+    double heading = state.theta + yaw_rate * dt / 2;
+
+    state.x += speed * cos(heading) * dt;
+    state.y += speed * sin(heading) * dt;
+    state.theta += yaw_rate * dt;
+    state.left_distance += (state.left_speed + left) / 2 * dt;
+    state.right_distance += (state.right_speed + right) / 2 * dt;
+    state.left_speed = left;
+    state.right_speed = right;
+    state.forward_acceleration = (speed - previous) / dt;
+    state.lateral_acceleration = speed * yaw_rate;
+    state.yaw_rate = yaw_rate;
+    state.time += SIM_STEP;
+
+    if (state.time % SIM_PACKET_PERIOD == 0) {
+        packet = state;
+    }
+}
+
+void sim_reset(void) {
+    memset(&state, 0, sizeof(state));
+    packet = state;
+    left_command = 0;
+    right_command = 0;
+}
+
+void sim_drive(double left_speed, double right_speed) {
+    sim_now();
+    left_command = left_speed;
+    right_command = right_speed;
+}
+
+void sim_advance(int64_t time) {
+    while (state.time + SIM_STEP <= time) {
+        step();
+    }
+}
+
+sim_state_t const *sim_now(void) {
+    sim_advance(lf_time_logical_elapsed());
+    return &state;
+}
+
+sim_state_t const *sim_packet(void) {
+    sim_now();
+    return &packet;
+}
+
+// Analog accelerometer on AIN5 to AIN7, with x ahead, y to the left, and
+// z up, so that it reads 1 g on z at rest.
+static nrf_saadc_value_t accelerometer(nrf_saadc_input_t input) {
+    sim_state_t const *now = sim_now();
+    double g;
+    switch (input) {
+        case NRF_SAADC_INPUT_AIN5: g = now->forward_acceleration / GRAVITY; break;
+        case NRF_SAADC_INPUT_AIN6: g = now->lateral_acceleration / GRAVITY; break;
+        case NRF_SAADC_INPUT_AIN7: g = 1.0; break;
+        default: return 0;
+    }
+    return (nrf_saadc_value_t)lround((ADXL327_BIAS + g * ADXL327_SENS) / SAADC_LSB);
+}
+
+__attribute__((constructor)) static void sim_attach(void) {
+    nrfx_saadc_host_set_source(accelerometer);
+}
@@ -0,0 +1,74 @@
+/**
+ * @file sim.h
+ * @brief World model behind the Linux platform's stand-ins for the Romi,
+ * the IMU, and the analog accelerometer.
+ *
+ * The robot is a differential drive with the Romi's wheelbase. Each wheel
+ * follows its commanded speed with a first-order lag, like the motor
+ * controllers on the robot, and the pose is integrated in steps of
+ * SIM_STEP on the logical time line. Readers ask for the state with
+ * sim_now(), which first advances the model to lf_time_logical_elapsed(),
+ * so a program sees the same world whether it runs in real time or fast.
+ */
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+
+// Distance between the wheels, in meters.
+#define SIM_WHEELBASE 0.141
+// Time constant of the wheel speed response, in seconds.
+#define SIM_WHEEL_LAG 0.05
+// Integration step, in nanoseconds.
+#define SIM_STEP 1000000LL
+// Period of the Romi's sensor packets, in nanoseconds.
+#define SIM_PACKET_PERIOD 20000000LL
+
+/**
+ * @brief State of the simulated robot, in SI units. Positions and heading
+ * are relative to where the robot started, with x ahead of it and y to
+ * its left. Accelerations are in the robot's frame.
+ */
+typedef struct {
+    int64_t time;                // Logical time elapsed, in nanoseconds.
+    double x;                    // Position, in meters.
+    double y;
+    double theta;                // Heading, in radians counterclockwise.
+    double left_speed;           // Wheel speeds, in meters per second.
+    double right_speed;
+    double left_distance;        // Distance covered by each wheel, in meters.
+    double right_distance;
+    double forward_acceleration; // In meters per second squared.
+    double lateral_acceleration; // Positive to the left.
+    double yaw_rate;             // In radians per second, counterclockwise.
+} sim_state_t;
+
+/**
+ * @brief Put the robot at rest at the origin, at time zero.
+ */
+void sim_reset(void);
+
+/**
+ * @brief Command the wheel speeds, in meters per second, from the current
+ * logical time on.
+ */
+void sim_drive(double left_speed, double right_speed);
+
+/**
+ * @brief Advance the model to `time`, in nanoseconds of logical time
+ * elapsed. Times earlier than the model's are ignored.
+ */
+void sim_advance(int64_t time);
+
+/**
+ * @brief Return the state at the current logical time, to within SIM_STEP.
+ */
+sim_state_t const *sim_now(void);
+
+/**
+ * @brief Return the state when the Romi sent its most recent sensor
+ * packet, on a multiple of SIM_PACKET_PERIOD.
+ */
+sim_state_t const *sim_packet(void);
+
+#endif // SIM_H
@@ -0,0 +1,137 @@
+"""Decode a stream from lib/binlog.h into text.
+
+Usage: python3 binlog_decode.py [--follow] LOG.bin
+
+Prints one line per message, with the time in seconds since the first
+message. The stream is what the BinaryLog reactor writes, for example
+saved from RTT channel 2 with JLinkRTTLogger, or the file it writes on
+Linux. With --follow, keeps reading as the file grows.
+"""
+import argparse
+import re
+import struct
+import sys
+import time
+
+FORMAT, MESSAGE, LOST, CLOCK = 1, 2, 3, 4
+
+# A printf conversion, with any flags, width, precision, and length.
+CONVERSION = re.compile(r"%([-+ #0]*\d*(?:\.\d*)?)(hh|h|ll|l|z|j|t)?([diuxXoceEfFgGa%])")
+
+
+class Decoder:
+    def __init__(self):
+        self.formats = {}
+        self.ticks_per_second = None
+        self.clock_bits = None
+        self.clock = None      # Unwrapped time of the last timestamp, in ticks.
+        self.last = None       # Last timestamp, as sent.
+        self.start = None
+
+    def header(self, data):
+        if len(data) < 12 or data[:4] != b"LFBL":
+            raise ValueError("not a binlog stream")
+        version, size, self.clock_bits = data[4], data[5], data[6]
+        if version != 1:
+            raise ValueError(f"unsupported version {version}")
+        self.ticks_per_second = struct.unpack_from("<I", data, 8)[0]
+        return size
+
+    def seconds(self, timestamp):
+        # Follow the counter across wraps, taking the shortest way from the
+        # last timestamp, since interrupts can log slightly out of order.
+        period = 1 << self.clock_bits
+        if self.clock is None:
+            self.clock = timestamp
+            self.start = timestamp
+        else:
+            delta = (timestamp - self.last) % period
+            if delta >= period // 2:
+                delta -= period
+            self.clock += delta
+        self.last = timestamp
+        return (self.clock - self.start) / self.ticks_per_second
+
+    def format(self, text, words):
+        args = iter(words)
+
+        def convert(match):
+            flags, _, kind = match.groups()
+            if kind == "%":
+                return "%"
+            word = next(args, 0)
+            if kind in "eEfFgGa":
+                value = struct.unpack("<f", struct.pack("<I", word))[0]
+                kind = "f" if kind == "a" else kind
+            elif kind in "dic":
+                value = word - (1 << 32) if word & 0x80000000 else word
+            else:
+                value = word
+                kind = "d" if kind == "u" else kind
+            return ("%" + flags + kind) % value
+
+        return CONVERSION.sub(convert, text)
+
+    def records(self, data):
+        """Yield lines for the complete records in data, and finally the
+        number of bytes used."""
+        i = 0
+        while i < len(data):
+            kind = data[i]
+            if kind == FORMAT:
+                if i + 4 > len(data) or i + 4 + data[i + 3] > len(data):
+                    break
+                ident = struct.unpack_from("<H", data, i + 1)[0]
+                length = data[i + 3]
+                self.formats[ident] = data[i + 4:i + 4 + length].decode("utf-8", "replace")
+                i += 4 + length
+            elif kind == MESSAGE:
+                if i + 8 > len(data) or i + 8 + 4 * data[i + 7] > len(data):
+                    break
+                ident, timestamp, count = struct.unpack_from("<HIB", data, i + 1)
+                words = struct.unpack_from(f"<{count}I", data, i + 8)
+                text = self.formats.get(ident, f"<unknown format {ident}>")
+                yield f"[{self.seconds(timestamp):12.6f}] {self.format(text, words)}"
+                i += 8 + 4 * count
+            elif kind in (LOST, CLOCK):
+                if i + 5 > len(data):
+                    break
+                value = struct.unpack_from("<I", data, i + 1)[0]
+                if kind == LOST:
+                    yield f"<{value} messages lost>"
+                else:
+                    self.seconds(value)
+                i += 5
+            else:
+                raise ValueError(f"unknown record type {kind} at byte {i}")
+        yield i
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a binlog stream into text")
+    parser.add_argument("path")
+    parser.add_argument("--follow", "-f", action="store_true",
+                        help="Keep reading as the file grows")
+    args = parser.parse_args()
+
+    decoder = Decoder()
+    data = b""
+    with open(args.path, "rb") as f:
+        while True:
+            data += f.read()
+            if decoder.ticks_per_second is None and len(data) >= 12:
+                data = data[decoder.header(data):]
+            if decoder.ticks_per_second is not None:
+                for line in decoder.records(data):
+                    if isinstance(line, int):
+                        data = data[line:]
+                    else:
+                        print(line)
+                sys.stdout.flush()
+            if not args.follow:
+                break
+            time.sleep(0.1)
+
+
+if __name__ == "__main__":
+    main()
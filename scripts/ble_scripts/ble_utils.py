@@ -2,6 +2,7 @@ import argparse
 import platform
 import sys
 import signal
+import struct
 
 def parse_ble_args(desc="Connects to BLE device",add_arg=None):
     addr_format = 'XX:XX:XX:XX:XX:XX'
@@ -38,3 +39,83 @@ def handle_sigint():
     signal.signal(signal.SIGINT, signal_handler)
 
 LAB11 = 0x02e0
+
+# Telemetry frames from the Kobuki service, as written by lib/telemetry.c.
+# See lib/telemetry.h for the format.
+TELEMETRY_VERSION = 1
+TELEMETRY_BUMPERS = ("bump_left", "bump_center", "bump_right", "drop_left", "drop_right")
+
+def _varint(data, pos):
+    value = shift = 0
+    while True:
+        if pos >= len(data):
+            raise ValueError("Telemetry frame cut short")
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+def _zigzag(data, pos):
+    value, pos = _varint(data, pos)
+    return (value >> 1) ^ -(value & 1), pos
+
+def _wrap(value, bits):
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value >> (bits - 1) else value
+
+def decode_telemetry(frame):
+    """Decode a telemetry frame into its sequence number and a list of samples.
+
+    Each sample is a dict with the time in ms, the left and right wheel
+    encoders, the bumper bits as `bumpers` and by name, the accelerometer
+    in g's as `accel`, and the gyro in degrees per second as `gyro`.
+    """
+    frame = bytes(frame)
+    if len(frame) < 4:
+        raise ValueError("Telemetry frame cut short")
+    if frame[0] != TELEMETRY_VERSION:
+        raise ValueError(f"Unknown telemetry version {frame[0]}")
+    count = frame[1]
+    sequence = int.from_bytes(frame[2:4], "little")
+    samples = []
+    pos = 4
+    for i in range(count):
+        if i == 0:
+            if pos + 21 > len(frame):
+                raise ValueError("Telemetry frame cut short")
+            time, left, right, bumpers = struct.unpack_from("<IHHB", frame, pos)
+            imu = list(struct.unpack_from("<6h", frame, pos + 9))
+            pos += 21
+        else:
+            last = samples[-1]
+            delta, pos = _varint(frame, pos)
+            time = (last["time"] + delta) & 0xFFFFFFFF
+            delta, pos = _zigzag(frame, pos)
+            left = (last["left_encoder"] + delta) & 0xFFFF
+            delta, pos = _zigzag(frame, pos)
+            right = (last["right_encoder"] + delta) & 0xFFFF
+            if pos >= len(frame):
+                raise ValueError("Telemetry frame cut short")
+            bumpers = frame[pos]
+            pos += 1
+            imu = []
+            for previous in last["raw_imu"]:
+                delta, pos = _zigzag(frame, pos)
+                imu.append(_wrap(previous + delta, 16))
+        sample = {
+            "time": time,
+            "left_encoder": left,
+            "right_encoder": right,
+            "bumpers": bumpers,
+            "accel": [v / 1000 for v in imu[:3]],
+            "gyro": [v / 10 for v in imu[3:]],
+            "raw_imu": imu,
+        }
+        for bit, name in enumerate(TELEMETRY_BUMPERS):
+            sample[name] = bool(bumpers & (1 << bit))
+        samples.append(sample)
+    if pos != len(frame):
+        raise ValueError("Telemetry frame has bytes left over")
+    return sequence, samples
@@ -0,0 +1,44 @@
+import asyncio
+
+from bleak import BleakClient, BleakError
+
+from ble_utils import parse_ble_args, handle_sigint, decode_telemetry
+args = parse_ble_args('Prints telemetry samples streamed by the KobukiBLE demo')
+addr = args.addr.lower()
+timeout = args.timeout
+handle_sigint()
+
+TELEMETRY_UUID = "85e4448e-b4a7-4c6f-ba86-2db3c40a2c83"
+
+class TelemetryPrinter():
+    def __init__(self):
+        self.sequence = None
+        self.lost = 0
+
+    def on_frame(self, sender, data):
+        sequence, samples = decode_telemetry(data)
+        if self.sequence is not None and sequence != (self.sequence + 1) & 0xFFFF:
+            self.lost += (sequence - self.sequence - 1) & 0xFFFF
+            print(f"-- {self.lost} frame(s) lost so far")
+        self.sequence = sequence
+        for s in samples:
+            accel = " ".join(f"{v:6.3f}" for v in s["accel"])
+            gyro = " ".join(f"{v:7.1f}" for v in s["gyro"])
+            print(f"[{s['time'] / 1000:9.3f}] enc {s['left_encoder']:5} {s['right_encoder']:5}"
+                  f" bump {s['bumpers']:02x} acc {accel} gyro {gyro}")
+
+async def main(address):
+    print(f"searching for device {address} ({timeout}s timeout)")
+    try:
+        async with BleakClient(address, timeout=timeout) as client:
+            print(f"Connected to device {client.address}: {client.is_connected}")
+            print(f"MTU: {client.mtu_size}")
+            printer = TelemetryPrinter()
+            await client.start_notify(TELEMETRY_UUID, printer.on_frame)
+            while client.is_connected:
+                await asyncio.sleep(1)
+    except BleakError as e:
+        print(f"not found: {e}")
+
+if __name__ == "__main__":
+    asyncio.run(main(addr))
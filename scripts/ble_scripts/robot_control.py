@@ -40,9 +40,13 @@ class RobotController():
         # so we need to use a threadsafe function.
         print("\n" + str(self.pressed.values()))
         future = asyncio.run_coroutine_threadsafe(
-          self.robot.write_gatt_char(DRIVE_UUID, bytes(self.pressed.values())),
+          self.robot.write_gatt_char(DRIVE_UUID, bytes([self.keys()])),
           self.loop)
 
+    def keys(self):
+        # pack the key state into one byte, bit 0 for up through bit 3 for right
+        return sum(1 << i for i, down in enumerate(self.pressed.values()) if down)
+
     def __enter__(self):
         return self
 
@@ -0,0 +1,40 @@
+#!/usr/bin/env bash
+
+# Builds the program to run on Linux, with a simulated robot and Buckler
+# board (see platform/linux), instead of for the nRF52.
+# build_nrf_unix.sh runs this script if LF_BUCKLER_PLATFORM is linux.
+# Experimental: this has not yet been run from lfc. See "Running on Linux"
+# in README.md for what is untested.
+
+# Project root is one up from the bin directory.
+PROJECT_ROOT=$LF_BIN_DIRECTORY/..
+
+
+echo "starting Linux generation script into $LF_SOURCE_GEN_DIRECTORY"
+echo "pwd is $(pwd)"
+
+# Copy the lib directory.
+cp -r $PROJECT_ROOT/lib/* $LF_SOURCE_GEN_DIRECTORY/lib
+
+# Time every reaction, if asked to (see lib/reaction_profile.h).
+if [ "$LF_BUCKLER_PROFILE" = "1" ]; then
+    $PROJECT_ROOT/scripts/profile_reactions.sh $LF_SOURCE_GEN_DIRECTORY || exit 1
+fi
+
+printf '
+# Makefile
+PROJECT_ROOT = %s
+############
+' $PROJECT_ROOT >> $LF_SOURCE_GEN_DIRECTORY/Makefile
+cat $PROJECT_ROOT/platform/linux/Makefile >> $LF_SOURCE_GEN_DIRECTORY/Makefile
+
+echo "Makefile Generated"
+
+cd $LF_SOURCE_GEN_DIRECTORY
+make || exit 1
+
+PROJECT_NAME=$(basename "$(realpath ./)")
+echo ""
+echo "**** To run the program, faster than real time:"
+echo "$LF_BIN_DIRECTORY/$PROJECT_NAME --fast true"
+echo ""
@@ -3,6 +3,11 @@
 # Project root is one up from the bin directory.
 PROJECT_ROOT=$LF_BIN_DIRECTORY/..
 
+# Build for Linux, with a simulated robot, if asked to.
+if [ "$LF_BUCKLER_PLATFORM" = "linux" ]; then
+    exec $PROJECT_ROOT/scripts/build_linux.sh
+fi
+
 
 echo "starting NRF generation script into $LF_SOURCE_GEN_DIRECTORY"
 echo "pwd is $(pwd)"
@@ -10,6 +15,11 @@ echo "pwd is $(pwd)"
 # Copy the lib directory.
 cp -r $PROJECT_ROOT/lib/* $LF_SOURCE_GEN_DIRECTORY/lib
 
+# Time every reaction, if asked to (see lib/reaction_profile.h).
+if [ "$LF_BUCKLER_PROFILE" = "1" ]; then
+    $PROJECT_ROOT/scripts/profile_reactions.sh $LF_SOURCE_GEN_DIRECTORY || exit 1
+fi
+
 printf '
 # Makefile
 PROJECT_ROOT = %s
@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+
+# Instruments the LF runtime in a generated source directory so that every
+# reaction is timed (see lib/reaction_profile.h), and makes its Makefile
+# build with PROFILE=1. The build scripts run this if LF_BUCKLER_PROFILE
+# is 1, before they append the platform Makefile to the generated one.
+#
+# Usage: profile_reactions.sh SOURCE_GEN_DIRECTORY
+
+GEN_DIR=$1
+PATCHED=0
+
+# The runtime calls reactions with reaction->function(reaction->self),
+# in reactor.c or reactor_common.c depending on its version.
+for f in $GEN_DIR/core/reactor.c $GEN_DIR/core/reactor_common.c; do
+    if [ -f "$f" ] && grep -q 'reaction->function(reaction->self);' "$f"; then
+        {
+            echo '#include "lib/reaction_profile.h"'
+            sed 's/reaction->function(reaction->self);/REACTION_PROFILE_INVOKE(reaction);/' "$f"
+        } > "$f.profiled" && mv "$f.profiled" "$f"
+        PATCHED=1
+    fi
+done
+
+if [ $PATCHED = 0 ]; then
+    echo "profile_reactions.sh: found no reaction calls to instrument in $GEN_DIR/core" >&2
+    exit 1
+fi
+
+printf '\nPROFILE = 1\n' >> $GEN_DIR/Makefile
+echo "Reaction profiling enabled"
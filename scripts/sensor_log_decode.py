@@ -0,0 +1,109 @@
+"""Decode a sensor log from lib/sd_log.h into CSV.
+
+Usage: python3 sensor_log_decode.py [--first-block N] LOG.img
+
+The image is the blocks copied off the SD card, for example with
+dd if=/dev/sdX of=LOG.img bs=512 count=2048, or the sdcard.img file that
+the SensorLog reactor writes on Linux. Prints a header line and then one
+line per record, with the time in seconds and each value scaled back by
+its channel's power of ten. The log is the one that starts at the first
+block; it ends at the first block of another session, or whose sequence
+number is not larger than the one before. A gap in the sequence numbers
+is a block that failed to write, and is reported on stderr.
+"""
+import argparse
+import struct
+import sys
+
+BLOCK = 512
+VERSION = 1
+
+
+def varint(data, i):
+    """Return the varint at data[i] and the index after it."""
+    value = shift = 0
+    while True:
+        if i >= len(data) or shift > 63:
+            raise ValueError("truncated varint")
+        b = data[i]
+        value |= (b & 0x7F) << shift
+        i += 1
+        if not b & 0x80:
+            return value, i
+        shift += 7
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def header(block):
+    """Return the header fields of a block, or None if it has no header."""
+    if len(block) < 21 or block[:4] != b"LFSL" or block[4] != VERSION:
+        return None
+    channels = block[5]
+    if not 1 <= channels <= 8 or len(block) < 21 + channels:
+        return None
+    count, sequence, session, time_unit = struct.unpack_from("<HIII", block, 6)
+    keyframe = block[20]
+    exponents = struct.unpack_from(f"<{channels}b", block, 21)
+    return {"channels": channels, "count": count, "sequence": sequence,
+            "session": session, "time_unit": time_unit, "keyframe": keyframe,
+            "exponents": exponents, "start": 21 + channels}
+
+
+def records(block, h):
+    """Yield the (time, values) records of a block."""
+    i = h["start"]
+    time, values = 0, [0] * h["channels"]
+    for index in range(h["count"]):
+        keyframe = h["keyframe"] <= 1 or index % h["keyframe"] == 0
+        t, i = varint(block, i)
+        time = t if keyframe else time + t
+        for c in range(h["channels"]):
+            v, i = varint(block, i)
+            values[c] = unzigzag(v) if keyframe else values[c] + unzigzag(v)
+        yield time, list(values)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a sensor log into CSV")
+    parser.add_argument("path")
+    parser.add_argument("--first-block", type=int, default=0,
+                        help="Card block at which the log starts")
+    args = parser.parse_args()
+
+    session = sequence = None
+    with open(args.path, "rb") as f:
+        f.seek(args.first_block * BLOCK)
+        while True:
+            block = f.read(BLOCK)
+            h = header(block) if len(block) == BLOCK else None
+            if h is None:
+                break
+            if session is None:
+                session = h["session"]
+                print("time," + ",".join(f"v{c}" for c in range(h["channels"])))
+            elif h["session"] != session or h["sequence"] <= sequence:
+                break
+            elif h["sequence"] != sequence + 1:
+                print(f"{h['sequence'] - sequence - 1} blocks lost before block "
+                      f"{h['sequence']}", file=sys.stderr)
+            sequence = h["sequence"]
+            scale = [10.0 ** -e for e in h["exponents"]]
+            try:
+                for time, values in records(block, h):
+                    seconds = time * h["time_unit"] / 1e9
+                    print(f"{seconds:.6f}," + ",".join(
+                        f"{v * s:g}" for v, s in zip(values, scale)))
+            except ValueError:
+                print(f"block {sequence} is truncated", file=sys.stderr)
+    if session is None:
+        print("no log found", file=sys.stderr)
+        return 1
+    print(f"session {session}, {sequence + 1} blocks", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,122 @@
+/**
+ * @file accel_scan_test.c
+ * @brief Host tests for lib/accel_scan.c against the SAADC, TIMER, and
+ * PPI stand-ins in platform/host/.
+ */
+#include "lib/accel_scan.h"
+#include "test.h"
+#include "nrfx_timer.h"
+
+static int batches;
+static accel_scan_batch_t last_batch;
+
+static void handler(accel_scan_batch_t const *batch, void *context) {
+    batches++;
+    last_batch = *batch;
+    CHECK(context == &batches);
+}
+
+static ret_code_t setup(uint32_t period_us, nrf_saadc_oversample_t oversample) {
+    accel_scan_uninit();
+    batches = 0;
+    nrfx_saadc_host_set_input(0, 2000);
+    nrfx_saadc_host_set_input(1, 1500);
+    nrfx_saadc_host_set_input(2, 2500);
+    accel_scan_config_t config = {
+        .x_input = NRF_SAADC_INPUT_AIN5,
+        .y_input = NRF_SAADC_INPUT_AIN6,
+        .z_input = NRF_SAADC_INPUT_AIN7,
+        .period_us = period_us,
+        .oversample = oversample,
+    };
+    return accel_scan_init(&config, handler, &batches);
+}
+
+static void test_stream(void) {
+    CHECK(setup(1000, NRF_SAADC_OVERSAMPLE_DISABLED) == NRF_SUCCESS);
+    CHECK(accel_scan_start() == NRF_SUCCESS);
+    // One second at 1 kHz, in uneven steps.
+    for (int i = 0; i < 1000; i++) {
+        nrfx_timer_host_advance(i % 2 ? 700 : 1300);
+    }
+    CHECK(batches == 1000 / ACCEL_SCAN_BATCH);
+    CHECK(nrfx_saadc_host_conversions() == 3000);
+    CHECK(nrfx_saadc_host_missed() == 0);
+    // One interrupt per batch, where sample_convert() took three
+    // blocking calls per sample.
+    CHECK(nrfx_saadc_host_events() == (uint32_t)batches);
+    printf("  1000 scans: %u interrupts\n", (unsigned)nrfx_saadc_host_events());
+    for (int i = 0; i < ACCEL_SCAN_BATCH; i++) {
+        CHECK(last_batch.samples[i].x == 2000);
+        CHECK(last_batch.samples[i].y == 1500);
+        CHECK(last_batch.samples[i].z == 2500);
+    }
+}
+
+static void test_order(void) {
+    CHECK(setup(500, NRF_SAADC_OVERSAMPLE_DISABLED) == NRF_SUCCESS);
+    CHECK(accel_scan_start() == NRF_SUCCESS);
+    // Change the inputs between scans; the batches keep them in order,
+    // across both buffers.
+    for (int i = 0; i < 3 * ACCEL_SCAN_BATCH; i++) {
+        nrfx_saadc_host_set_input(0, i);
+        nrfx_saadc_host_set_input(1, 1000 + i);
+        nrfx_saadc_host_set_input(2, 2000 + i);
+        nrfx_timer_host_advance(500);
+        if (batches == 1 && i == ACCEL_SCAN_BATCH - 1) {
+            CHECK(last_batch.samples[0].x == 0);
+            CHECK(last_batch.samples[ACCEL_SCAN_BATCH - 1].x == ACCEL_SCAN_BATCH - 1);
+        }
+    }
+    CHECK(batches == 3);
+    for (int i = 0; i < ACCEL_SCAN_BATCH; i++) {
+        CHECK(last_batch.samples[i].x == 2 * ACCEL_SCAN_BATCH + i);
+        CHECK(last_batch.samples[i].y == 1000 + 2 * ACCEL_SCAN_BATCH + i);
+        CHECK(last_batch.samples[i].z == 2000 + 2 * ACCEL_SCAN_BATCH + i);
+    }
+}
+
+static void test_oversample(void) {
+    // Three channels of 16 conversions of 12 us each take 576 us.
+    CHECK(setup(500, NRF_SAADC_OVERSAMPLE_16X) == NRF_ERROR_INVALID_PARAM);
+    CHECK(setup(1000, NRF_SAADC_OVERSAMPLE_16X) == NRF_SUCCESS);
+    CHECK(accel_scan_start() == NRF_SUCCESS);
+    nrfx_timer_host_advance(1000 * ACCEL_SCAN_BATCH);
+    CHECK(batches == 1);
+    CHECK(nrfx_saadc_host_conversions() == 3 * 16 * ACCEL_SCAN_BATCH);
+    CHECK(nrfx_saadc_host_events() == 1);
+    CHECK(last_batch.samples[0].z == 2500);
+}
+
+static void test_stop(void) {
+    CHECK(setup(1000, NRF_SAADC_OVERSAMPLE_DISABLED) == NRF_SUCCESS);
+    CHECK(accel_scan_start() == NRF_SUCCESS);
+    nrfx_timer_host_advance(1000 * (ACCEL_SCAN_BATCH + 3));
+    CHECK(batches == 1);
+    accel_scan_stop();
+    nrfx_timer_host_advance(1000 * 10 * ACCEL_SCAN_BATCH);
+    CHECK(batches == 1);
+    CHECK(nrfx_saadc_host_conversions() == 3 * (ACCEL_SCAN_BATCH + 3));
+
+    // Restarting begins a fresh batch.
+    CHECK(accel_scan_start() == NRF_SUCCESS);
+    nrfx_timer_host_advance(1000 * ACCEL_SCAN_BATCH);
+    CHECK(batches == 2);
+}
+
+static void test_init_twice(void) {
+    CHECK(setup(1000, NRF_SAADC_OVERSAMPLE_DISABLED) == NRF_SUCCESS);
+    accel_scan_config_t config = {.period_us = 1000};
+    CHECK(accel_scan_init(&config, handler, &batches) == NRF_ERROR_INVALID_STATE);
+    accel_scan_uninit();
+    CHECK(accel_scan_start() == NRF_ERROR_INVALID_STATE);
+}
+
+int main(void) {
+    test_stream();
+    test_order();
+    test_oversample();
+    test_stop();
+    test_init_twice();
+    return test_report("accel_scan_test");
+}
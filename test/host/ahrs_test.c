@@ -0,0 +1,171 @@
+/**
+ * @file ahrs_test.c
+ * @brief Host tests for lib/ahrs.c that replay synthetic rotations.
+ *
+ * The true orientation is integrated in double precision, and the
+ * readings an ideal IMU would give are derived from it.
+ */
+#include <math.h>
+
+#include "lib/ahrs.h"
+#include "test.h"
+
+#define DT 0.01 // 100 Hz, a typical IMU rate.
+#define DEG (M_PI / 180)
+
+typedef struct {
+    double w, x, y, z;
+} quat_d;
+
+static quat_d qmul(quat_d a, quat_d b) {
+    quat_d r = {
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+    };
+    return r;
+}
+
+static quat_d qconj(quat_d a) {
+    quat_d r = {a.w, -a.x, -a.y, -a.z};
+    return r;
+}
+
+static quat_d qaxis(double x, double y, double z, double angle) {
+    quat_d r = {cos(angle / 2), x * sin(angle / 2), y * sin(angle / 2), z * sin(angle / 2)};
+    return r;
+}
+
+/**
+ * Rotate an earth-frame vector into the sensor frame of orientation q.
+ */
+static quat_d to_sensor(quat_d q, double x, double y, double z) {
+    quat_d v = {0, x, y, z};
+    return qmul(qmul(qconj(q), v), q);
+}
+
+/**
+ * Angle in radians between the estimated and true orientations.
+ */
+static double angle_error(const ahrs_t *ahrs, quat_d truth) {
+    // Normalize first. The estimate is only normalized to float precision,
+    // which acos() near 1 would turn into a visible angle.
+    const quaternion_t *q = &ahrs->q;
+    double n = sqrt((double)q->w * q->w + (double)q->x * q->x
+                    + (double)q->y * q->y + (double)q->z * q->z);
+    double d = fabs(q->w * truth.w + q->x * truth.x + q->y * truth.y + q->z * truth.z) / n;
+    return 2 * acos(fmin(1.0, d));
+}
+
+// Earth magnetic field, pointing north (x) and down, in microtesla.
+#define MAG_X 20.0
+#define MAG_Z -40.0
+
+/**
+ * Rotate the true orientation at a constant rate (rad/s, sensor frame)
+ * for the given time, feeding ideal readings to the filter.
+ */
+static void replay(ahrs_t *ahrs, quat_d *truth, double gx, double gy, double gz,
+                   double seconds, int use_mag) {
+    int steps = (int)lround(seconds / DT);
+    quat_d dq = qaxis(gx, gy, gz, 0);
+    double rate = sqrt(gx * gx + gy * gy + gz * gz);
+    if (rate > 0) {
+        dq = qaxis(gx / rate, gy / rate, gz / rate, rate * DT);
+    }
+    for (int i = 0; i < steps; i++) {
+        *truth = qmul(*truth, dq);
+        quat_d a = to_sensor(*truth, 0, 0, 1);
+        quat_d m = to_sensor(*truth, MAG_X, 0, MAG_Z);
+        if (!use_mag) m.x = m.y = m.z = 0;
+        ahrs_update(ahrs, gx, gy, gz, a.x, a.y, a.z, m.x, m.y, m.z, DT);
+    }
+}
+
+static void test_at_rest(void) {
+    ahrs_t ahrs;
+    quat_d truth = {1, 0, 0, 0};
+    ahrs_init(&ahrs, 0.1f);
+    replay(&ahrs, &truth, 0, 0, 0, 10, 1);
+    CHECK(angle_error(&ahrs, truth) < 1e-3);
+}
+
+static void test_converges_from_wrong_start(void) {
+    ahrs_t ahrs;
+    // Tilted 20 degrees about x and turned 60 degrees about z.
+    quat_d truth = qmul(qaxis(0, 0, 1, 60 * DEG), qaxis(1, 0, 0, 20 * DEG));
+    ahrs_init(&ahrs, 0.5f);
+    replay(&ahrs, &truth, 0, 0, 0, 20, 1);
+    CHECK(angle_error(&ahrs, truth) < 0.5 * DEG);
+
+    float roll, pitch, yaw;
+    ahrs_euler(&ahrs, &roll, &pitch, &yaw);
+    CHECK_CLOSE(roll, 20 * DEG, 0.5 * DEG);
+    CHECK_CLOSE(pitch, 0, 0.5 * DEG);
+    CHECK_CLOSE(yaw, 60 * DEG, 0.5 * DEG);
+}
+
+static void test_tracks_rotations(void) {
+    ahrs_t ahrs;
+    quat_d truth = {1, 0, 0, 0};
+    ahrs_init(&ahrs, 0.1f);
+    // Yaw 90 degrees, raise the nose 30 degrees (a negative rotation
+    // about y, since z is up), then roll a full turn about the tilted
+    // x axis, which couples all three gyro axes.
+    // While turning, the estimate leads by about one sample, since each
+    // update compares the previous estimate with the new readings.
+    // It catches up as soon as the motion stops.
+    replay(&ahrs, &truth, 0, 0, 45 * DEG, 2, 1);
+    CHECK(angle_error(&ahrs, truth) < (45 * DT + 0.2) * DEG);
+    replay(&ahrs, &truth, 0, 0, 0, 0.5, 1);
+    CHECK(angle_error(&ahrs, truth) < 0.2 * DEG);
+
+    replay(&ahrs, &truth, 0, -30 * DEG, 0, 1, 1);
+    CHECK(angle_error(&ahrs, truth) < (30 * DT + 0.2) * DEG);
+    replay(&ahrs, &truth, 0, 0, 0, 0.5, 1);
+    CHECK(angle_error(&ahrs, truth) < 0.2 * DEG);
+
+    replay(&ahrs, &truth, 180 * DEG, 0, 0, 2, 1);
+    CHECK(angle_error(&ahrs, truth) < (180 * DT + 0.2) * DEG);
+    replay(&ahrs, &truth, 0, 0, 0, 0.5, 1);
+    CHECK(angle_error(&ahrs, truth) < 0.2 * DEG);
+
+    float roll, pitch, yaw;
+    ahrs_euler(&ahrs, &roll, &pitch, &yaw);
+    CHECK_CLOSE(yaw, 90 * DEG, 0.2 * DEG);
+    CHECK_CLOSE(pitch, -30 * DEG, 0.2 * DEG);
+    CHECK_CLOSE(roll, 0, 0.2 * DEG);
+}
+
+static void test_without_magnetometer(void) {
+    ahrs_t ahrs;
+    quat_d truth = {1, 0, 0, 0};
+    ahrs_init(&ahrs, 0.1f);
+    // With ideal gyro readings, heading still follows the gyro.
+    replay(&ahrs, &truth, 10 * DEG, 20 * DEG, 30 * DEG, 3, 0);
+    replay(&ahrs, &truth, 0, 0, 0, 0.5, 0);
+    CHECK(angle_error(&ahrs, truth) < 0.2 * DEG);
+}
+
+static void test_corrects_gyro_bias(void) {
+    ahrs_t ahrs;
+    quat_d truth = {1, 0, 0, 0};
+    ahrs_init(&ahrs, 0.1f);
+    // At rest, with a gyro that reads 1 degree per second on every axis.
+    // Integrating alone would be off by 60 degrees on each axis after a minute.
+    for (int i = 0; i < 6000; i++) {
+        quat_d m = to_sensor(truth, MAG_X, 0, MAG_Z);
+        ahrs_update(&ahrs, 1 * DEG, 1 * DEG, 1 * DEG, 0, 0, 1, m.x, m.y, m.z, DT);
+    }
+    CHECK(angle_error(&ahrs, truth) < 15 * DEG);
+}
+
+int main(void) {
+    test_at_rest();
+    test_converges_from_wrong_start();
+    test_tracks_rotations();
+    test_without_magnetometer();
+    test_corrects_gyro_bias();
+    return test_report("ahrs_test");
+}
@@ -0,0 +1,256 @@
+/**
+ * @file binlog_test.c
+ * @brief Host tests for lib/binlog.c. The drained stream is decoded here
+ * to check it against what was logged.
+ */
+#include <string.h>
+
+#include "app_timer.h"
+#include "lib/binlog.h"
+#include "test.h"
+
+// Everything the sink has taken, and whether it takes more.
+static uint8_t stream[65536];
+static size_t stream_length;
+static bool refuse;
+
+static bool sink(const uint8_t *data, size_t length, void *context) {
+    if (refuse || stream_length + length > sizeof(stream)) return false;
+    memcpy(stream + stream_length, data, length);
+    stream_length += length;
+    return true;
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// A decoded record.
+typedef struct {
+    binlog_type_t type;
+    uint16_t id;
+    uint32_t value;    // Timestamp, or count for BINLOG_LOST.
+    char text[256];    // For BINLOG_FORMAT.
+    uint8_t args;
+    uint32_t arg[BINLOG_MAX_ARGS];
+} record_t;
+
+static size_t position;
+
+static bool next(record_t *r) {
+    if (position >= stream_length) return false;
+    const uint8_t *p = stream + position;
+    memset(r, 0, sizeof(*r));
+    r->type = p[0];
+    switch (r->type) {
+        case BINLOG_FORMAT:
+            r->id = p[1] | (p[2] << 8);
+            memcpy(r->text, p + 4, p[3]);
+            position += 4 + p[3];
+            break;
+        case BINLOG_MESSAGE:
+            r->id = p[1] | (p[2] << 8);
+            r->value = get32(p + 3);
+            r->args = p[7];
+            for (int i = 0; i < r->args; i++) r->arg[i] = get32(p + 8 + 4 * i);
+            position += 8 + 4 * r->args;
+            break;
+        case BINLOG_LOST:
+        case BINLOG_CLOCK:
+            r->value = get32(p + 1);
+            position += 5;
+            break;
+        default:
+            CHECK(false);
+            position = stream_length;
+            return false;
+    }
+    return true;
+}
+
+static void setup(void) {
+    CHECK(binlog_init() == NRF_SUCCESS);
+    binlog_reset();
+    stream_length = 0;
+    position = BINLOG_HEADER_SIZE;
+    refuse = false;
+}
+
+static void log_pair(int i, float x) {
+    BINLOG("i:%d x:%.2f", i, x);
+}
+
+static void test_messages(void) {
+    setup();
+    BINLOG("startup");
+    app_timer_host_advance(5);
+    log_pair(-3, 1.5f);
+    log_pair(4, 2.5);
+    CHECK(binlog_drain(sink, NULL, 1000) == stream_length);
+
+    CHECK(memcmp(stream, "LFBL", 4) == 0);
+    CHECK(stream[4] == BINLOG_VERSION);
+    CHECK(stream[5] == BINLOG_HEADER_SIZE);
+    CHECK(stream[6] == 24);
+    CHECK(get32(stream + 8) == APP_TIMER_CLOCK_FREQ);
+
+    record_t r;
+    uint32_t start = app_timer_cnt_get() - 5;
+    CHECK(next(&r) && r.type == BINLOG_FORMAT && r.id == 1);
+    CHECK(strcmp(r.text, "startup") == 0);
+    CHECK(next(&r) && r.type == BINLOG_MESSAGE && r.id == 1 && r.args == 0);
+    CHECK(r.value == start);
+    CHECK(next(&r) && r.type == BINLOG_FORMAT && r.id == 2);
+    CHECK(strcmp(r.text, "i:%d x:%.2f") == 0);
+    CHECK(next(&r) && r.type == BINLOG_MESSAGE && r.id == 2 && r.args == 2);
+    CHECK(r.value == start + 5);
+    CHECK((int32_t)r.arg[0] == -3);
+    CHECK(r.arg[1] == binlog_float(1.5f));
+    // The second message from the same call site reuses its format.
+    CHECK(next(&r) && r.type == BINLOG_MESSAGE && r.id == 2);
+    CHECK(r.arg[0] == 4);
+    CHECK(r.arg[1] == binlog_float(2.5f));
+    CHECK(!next(&r));
+
+    binlog_stats_t stats;
+    binlog_stats(&stats);
+    CHECK(stats.written == 3 && stats.drained == 3 && stats.dropped == 0);
+    CHECK(stats.formats == 2);
+    CHECK(stats.bytes == stream_length);
+
+    // Nothing more to send.
+    CHECK(binlog_drain(sink, NULL, 1000) == 0);
+}
+
+// A call site logged before a reset is sent with its format again, and
+// does not share an id with the call sites logged first after the reset.
+static void test_reset(void) {
+    setup();
+    log_pair(1, 0.5f);
+    binlog_drain(sink, NULL, 1000);
+    setup();
+    BINLOG("after reset %d", 7);
+    log_pair(2, 1.5f);
+    binlog_drain(sink, NULL, 1000);
+
+    CHECK(memcmp(stream, "LFBL", 4) == 0);
+    record_t r;
+    CHECK(next(&r) && r.type == BINLOG_FORMAT && r.id == 1);
+    CHECK(strcmp(r.text, "after reset %d") == 0);
+    CHECK(next(&r) && r.type == BINLOG_MESSAGE && r.id == 1 && r.arg[0] == 7);
+    CHECK(next(&r) && r.type == BINLOG_FORMAT && r.id == 2);
+    CHECK(strcmp(r.text, "i:%d x:%.2f") == 0);
+    CHECK(next(&r) && r.type == BINLOG_MESSAGE && r.id == 2 && r.arg[0] == 2);
+    CHECK(!next(&r));
+
+    binlog_stats_t stats;
+    binlog_stats(&stats);
+    CHECK(stats.formats == 2);
+}
+
+static void test_full(void) {
+    setup();
+    binlog_stats_t stats;
+    int written = 0;
+    do {
+        BINLOG("n:%d", written);
+        binlog_stats(&stats);
+    } while (stats.dropped == 0 && ++written < BINLOG_RING_WORDS);
+    // Messages with one argument take 4 or 5 words.
+    CHECK(written >= BINLOG_RING_WORDS / 5 && written <= BINLOG_RING_WORDS / 4);
+    BINLOG("n:%d", -1);
+
+    binlog_drain(sink, NULL, sizeof(stream));
+    record_t r;
+    CHECK(next(&r) && r.type == BINLOG_LOST && r.value == 2);
+    int n = 0;
+    while (next(&r)) {
+        if (r.type == BINLOG_MESSAGE) CHECK((int32_t)r.arg[0] == n++);
+    }
+    CHECK(n == written);
+    binlog_stats(&stats);
+    CHECK(stats.peak > BINLOG_RING_WORDS - 5);
+
+    // There is room again.
+    BINLOG("n:%d", n);
+    binlog_stats(&stats);
+    CHECK(stats.written == written + 1);
+    CHECK(stats.dropped == 2);
+}
+
+static void test_refused(void) {
+    setup();
+    refuse = true;
+    BINLOG("a:%d", 1);
+    CHECK(binlog_drain(sink, NULL, 1000) == 0);
+    refuse = false;
+    CHECK(binlog_drain(sink, NULL, 1000) > 0);
+    record_t r;
+    // Nothing was lost, and the format still comes first.
+    CHECK(next(&r) && r.type == BINLOG_FORMAT);
+    CHECK(next(&r) && r.type == BINLOG_MESSAGE && r.arg[0] == 1);
+    CHECK(!next(&r));
+}
+
+static void test_wrap(void) {
+    setup();
+    // Messages of every size, drained a few at a time, so that records
+    // land at every offset and wrap with padding.
+    static const uint8_t args[4] = {1, 2, 4, 6};
+    uint32_t sent = 0, received = 0;
+    for (int round = 0; round < 200; round++) {
+        for (int i = 0; i < 7; i++, sent++) {
+            switch (sent % 4) {
+                case 0: BINLOG("%u", sent); break;
+                case 1: BINLOG("%u %d", sent, 1); break;
+                case 2: BINLOG("%u %d %d %d", sent, 1, 2, 3); break;
+                case 3: BINLOG("%u %d %d %d %d %d", sent, 1, 2, 3, 4, 5); break;
+            }
+        }
+        binlog_drain(sink, NULL, 150);
+        record_t r;
+        while (next(&r)) {
+            if (r.type != BINLOG_MESSAGE) continue;
+            CHECK(r.arg[0] == received);
+            CHECK(r.args == args[received % 4]);
+            received++;
+        }
+        stream_length = position = 0;
+    }
+    binlog_drain(sink, NULL, sizeof(stream));
+    record_t r;
+    while (next(&r)) {
+        if (r.type == BINLOG_MESSAGE) CHECK(r.arg[0] == received++);
+    }
+    CHECK(received == sent);
+    binlog_stats_t stats;
+    binlog_stats(&stats);
+    CHECK(stats.dropped == 0);
+}
+
+static void test_clock(void) {
+    setup();
+    BINLOG("once");
+    binlog_drain(sink, NULL, 1000);
+    size_t length = stream_length;
+    app_timer_host_advance(1000);
+    binlog_drain(sink, NULL, 1000);
+    CHECK(stream_length == length);
+    // Without messages for a quarter of the counter's period, the drain
+    // sends the time.
+    app_timer_host_advance(1 << 22);
+    binlog_drain(sink, NULL, 1000);
+    CHECK(stream_length == length + 5);
+    CHECK(stream[length] == BINLOG_CLOCK);
+    CHECK(get32(stream + length + 1) == app_timer_cnt_get());
+}
+
+int main(void) {
+    test_messages();
+    test_reset();
+    test_full();
+    test_refused();
+    test_wrap();
+    test_clock();
+    return test_report("binlog_test");
+}
@@ -0,0 +1,64 @@
+/**
+ * @file drive_command_test.c
+ * @brief Host tests for lib/drive_command.c.
+ */
+#include "lib/drive_command.h"
+#include "test.h"
+
+static void test_decode(void) {
+    const uint8_t none = 0;
+    const uint8_t up = DRIVE_KEY_UP, down = DRIVE_KEY_DOWN;
+    const uint8_t left = DRIVE_KEY_LEFT, right = DRIVE_KEY_RIGHT;
+    const uint8_t up_left = DRIVE_KEY_UP | DRIVE_KEY_LEFT;
+    const uint8_t down_right = DRIVE_KEY_DOWN | DRIVE_KEY_RIGHT;
+    const uint8_t bad = 0x10;
+    CHECK(drive_command_decode(&none, 1) == DRIVE_STOP);
+    CHECK(drive_command_decode(&up, 1) == DRIVE_FORWARD);
+    CHECK(drive_command_decode(&down, 1) == DRIVE_BACKWARD);
+    CHECK(drive_command_decode(&left, 1) == DRIVE_LEFT);
+    CHECK(drive_command_decode(&right, 1) == DRIVE_RIGHT);
+    CHECK(drive_command_decode(&up_left, 1) == DRIVE_FORWARD);
+    CHECK(drive_command_decode(&down_right, 1) == DRIVE_BACKWARD);
+    CHECK(drive_command_decode(&bad, 1) == -1);
+
+    // The four-byte form.
+    const uint8_t old_stop[4] = {0, 0, 0, 0};
+    const uint8_t old_left[4] = {0, 0, 1, 0};
+    const uint8_t old_left_right[4] = {0, 0, 1, 1};
+    const uint8_t old_bad[4] = {0, 2, 0, 0};
+    CHECK(drive_command_decode(old_stop, 4) == DRIVE_STOP);
+    CHECK(drive_command_decode(old_left, 4) == DRIVE_LEFT);
+    CHECK(drive_command_decode(old_left_right, 4) == DRIVE_LEFT);
+    CHECK(drive_command_decode(old_bad, 4) == -1);
+    CHECK(drive_command_decode(old_left, 0) == -1);
+    CHECK(drive_command_decode(old_left, 3) == -1);
+}
+
+static void test_filter(void) {
+    drive_command_filter_t filter;
+    drive_command_filter_init(&filter);
+    drive_command_t command = DRIVE_STOP;
+    const uint8_t up = DRIVE_KEY_UP, up_left = DRIVE_KEY_UP | DRIVE_KEY_LEFT;
+    const uint8_t left = DRIVE_KEY_LEFT, none = 0, bad = 0xFF;
+
+    CHECK(!drive_command_filter_write(&filter, &none, 1, &command));
+    CHECK(drive_command_filter_write(&filter, &up, 1, &command));
+    CHECK(command == DRIVE_FORWARD);
+    CHECK(!drive_command_filter_write(&filter, &up, 1, &command));
+    CHECK(!drive_command_filter_write(&filter, &up_left, 1, &command));
+    CHECK(!drive_command_filter_write(&filter, &bad, 1, &command));
+    CHECK(command == DRIVE_FORWARD);
+    CHECK(drive_command_filter_write(&filter, &left, 1, &command));
+    CHECK(command == DRIVE_LEFT);
+    CHECK(drive_command_filter_set(&filter, DRIVE_STOP));
+    CHECK(!drive_command_filter_set(&filter, DRIVE_STOP));
+    CHECK(filter.writes == 6);
+    CHECK(filter.changes == 3);
+    CHECK(filter.invalid == 1);
+}
+
+int main(void) {
+    test_decode();
+    test_filter();
+    return test_report("drive_command_test");
+}
@@ -0,0 +1,114 @@
+/**
+ * @file fastmath_test.c
+ * @brief Host accuracy sweep of lib/fastmath.c against libm in double
+ * precision. The bounds checked here are the ones documented in fastmath.h.
+ */
+#include <math.h>
+
+#include "lib/fastmath.h"
+#include "test.h"
+
+#define STEPS 1000000
+
+static void test_atan2f(void) {
+    double worst = 0;
+    // All directions, at several radii, plus the axes.
+    for (int i = -STEPS; i <= STEPS; i++) {
+        double t = M_PI * i / STEPS;
+        for (int r = 0; r < 4; r++) {
+            float y = sin(t) * (0.001 + r * 3.0);
+            float x = cos(t) * (0.001 + r * 3.0);
+            double e = fabs(fast_atan2f(y, x) - atan2((double)y, (double)x));
+            if (e > worst) worst = e;
+        }
+    }
+    printf("  fast_atan2f: max error %.3g rad\n", worst);
+    CHECK(worst <= 2e-6);
+    CHECK(fast_atan2f(0, 0) == 0);
+    CHECK_CLOSE(fast_atan2f(1, 0), M_PI / 2, 2e-6);
+    CHECK_CLOSE(fast_atan2f(-1, 0), -M_PI / 2, 2e-6);
+    CHECK_CLOSE(fast_atan2f(0, -1), M_PI, 2e-6);
+}
+
+static void test_rsqrtf(void) {
+    double worst = 0;
+    for (double x = 1e-30; x < 1e30; x *= 1.00003) {
+        double e = fabs(fast_rsqrtf(x) * sqrt((float)x) - 1);
+        if (e > worst) worst = e;
+    }
+    printf("  fast_rsqrtf: max relative error %.3g\n", worst);
+    CHECK(worst <= 5e-6);
+    CHECK(0 * fast_rsqrtf(0) == 0);
+}
+
+static void test_cosf(void) {
+    double worst = 0;
+    for (int i = -STEPS; i <= STEPS; i++) {
+        float x = 2 * M_PI * i / STEPS;
+        double e = fabs(fast_cosf(x) - cos((double)x));
+        if (e > worst) worst = e;
+    }
+    printf("  fast_cosf:   max error %.3g for |x| <= 2 pi\n", worst);
+    CHECK(worst <= 1e-6);
+    worst = 0;
+    for (int i = -STEPS; i <= STEPS; i++) {
+        float x = 10 * M_PI * i / STEPS;
+        double e = fabs(fast_cosf(x) - cos((double)x));
+        if (e > worst) worst = e;
+    }
+    printf("  fast_cosf:   max error %.3g for |x| <= 10 pi\n", worst);
+    CHECK(worst <= 2e-6);
+}
+
+static void test_acosf(void) {
+    double worst = 0;
+    for (int i = -STEPS; i <= STEPS; i++) {
+        float x = (float)i / STEPS;
+        double e = fabs(fast_acosf(x) - acos((double)x));
+        if (e > worst) worst = e;
+    }
+    printf("  fast_acosf:  max error %.3g rad\n", worst);
+    CHECK(worst <= 7e-5);
+    // Rounding can push a product of cosines slightly past 1.
+    CHECK(fast_acosf(1.0000001f) == 0);
+    CHECK_CLOSE(fast_acosf(-1.5f), M_PI, 1e-6);
+}
+
+/**
+ * The exact and fast computations of the Tilt reactor in src/lib/Tilt.lf,
+ * with zero bias and unit sensitivity, over accelerometer readings in all
+ * directions. Their outputs should differ by less than 0.01 degrees.
+ */
+static void test_tilt(void) {
+    double worst = 0;
+    for (int i = 0; i < 400; i++) {
+        for (int j = 0; j <= 200; j++) {
+            double t = 2 * M_PI * i / 400, u = M_PI * j / 200;
+            float ax = sin(u) * cos(t), ay = sin(u) * sin(t), az = cos(u);
+
+            float pitch = 180 * atanf(-ax / sqrt(ay * ay + az * az)) / M_PI;
+            float roll = 180 * atanf(-ay / sqrt(ax * ax + az * az)) / M_PI;
+            float tilt = 180 * acosf(cosf(pitch * M_PI / 180) * cosf(roll * M_PI / 180)) / M_PI;
+
+            float bx = ay * ay + az * az, by = ax * ax + az * az;
+            float degrees = 180.0f / (float)M_PI;
+            float fpitch = degrees * fast_atan2f(-ax, bx * fast_rsqrtf(bx));
+            float froll = degrees * fast_atan2f(-ay, by * fast_rsqrtf(by));
+            float ftilt = degrees * fast_acosf(fast_cosf(fpitch / degrees) * fast_cosf(froll / degrees));
+
+            double e = fmax(fabs(fpitch - pitch), fmax(fabs(froll - roll), fabs(ftilt - tilt)));
+            if (e > worst) worst = e;
+        }
+    }
+    printf("  Tilt:        max difference %.3g degrees\n", worst);
+    CHECK(worst < 0.01);
+}
+
+int main(void) {
+    test_atan2f();
+    test_rsqrtf();
+    test_cosf();
+    test_acosf();
+    test_tilt();
+    return test_report("fastmath_test");
+}
@@ -0,0 +1,361 @@
+/**
+ * @file filter_test.c
+ * @brief Host unit tests for lib/filter.c.
+ */
+#include <float.h>
+#include <stdlib.h>
+
+#include "lib/filter.h"
+#include "test.h"
+
+static void test_delay_line_order(void) {
+    delay_line_t line;
+    float x;
+    CHECK(create_line(&line, 4) == 0);
+    for (int i = 1; i <= 6; i++) {
+        push(&line, (float)i);
+    }
+    // newest first
+    for (size_t n = 0; n < 4; n++) {
+        CHECK(get(&line, n, &x) == 0);
+        CHECK_CLOSE(x, 6.0 - n, 0);
+    }
+    CHECK(get(&line, 4, &x) == -1);
+    destroy_line(&line);
+}
+
+static void test_fir_paths_agree(void) {
+    float b[5] = {0.5f, 0.25f, 0.125f, 0.0625f, 0.0625f};
+    delay_line_t line;
+    mirror_line_t mline;
+    create_line(&line, 5);
+    create_mirror_line(&mline, 5);
+    for (int i = 0; i < 100; i++) {
+        float x = (float)((i * 37) % 11) - 5.0f;
+        float y;
+        push(&line, x);
+        fir_filter_block(&mline, b, 5, &x, &y, 1);
+        CHECK_CLOSE(y, fir_filter(&line, b, 5), 1e-5);
+    }
+    // impulse response comes out in coefficient order
+    float impulse[6] = {1, 0, 0, 0, 0, 0};
+    float y[6];
+    mirror_line_t fresh;
+    create_mirror_line(&fresh, 5);
+    fir_filter_block(&fresh, b, 5, impulse, y, 6);
+    for (int i = 0; i < 5; i++) {
+        CHECK_CLOSE(y[i], b[i], 0);
+    }
+    CHECK_CLOSE(y[5], 0, 0);
+    destroy_line(&line);
+    destroy_mirror_line(&mline);
+    destroy_mirror_line(&fresh);
+}
+
+static void test_avg_line_matches_sum_line(void) {
+    avg_line_t line;
+    CHECK(create_avg_line(&line, 7) == 0);
+    for (int i = 0; i < 50; i++) {
+        push_avg(&line, (float)(i % 13));
+        CHECK_CLOSE(avg_line_sum(&line), sum_line(&line.line), 1e-4);
+    }
+    destroy_avg_line(&line);
+}
+
+/**
+ * Push millions of samples with a large DC offset, which is the worst
+ * case for cancellation in the running sum, and compare against the
+ * exact sum of the window computed in double precision.
+ */
+static void test_avg_line_drift(size_t len, long samples) {
+    avg_line_t line;
+    double max_err = 0;
+    create_avg_line(&line, len);
+    srand(2);
+    for (long i = 0; i < samples; i++) {
+        float x = 1000.0f + (float)rand() / RAND_MAX - 0.5f;
+        push_avg(&line, x);
+        if (i % 997 == 0) {
+            double exact = 0;
+            for (size_t k = 0; k < len; k++) {
+                exact += line.line.head[k];
+            }
+            double err = fabs(avg_line_sum(&line) - exact) / exact;
+            if (err > max_err) max_err = err;
+        }
+    }
+    printf("  window %4zu: max relative drift %.3g over %ld samples\n",
+           len, max_err, samples);
+    // within a couple of float ulps of the exact sum
+    CHECK(max_err < 2 * FLT_EPSILON);
+    destroy_avg_line(&line);
+}
+
+/**
+ * Power-of-two lengths take the masked path, others the compare-and-branch
+ * path. Both must read back the same samples and filter outputs.
+ */
+static void test_masked_wrap(void) {
+    float b[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    for (size_t len = 1; len <= 9; len++) {
+        delay_line_t line;
+        mirror_line_t mline;
+        create_line(&line, len);
+        create_mirror_line(&mline, len);
+        CHECK(line.mask == ((len == 2 || len == 4 || len == 8) ? len - 1 : 0));
+        for (int i = 1; i <= 20; i++) {
+            push(&line, (float)i);
+            push_mirror(&mline, (float)i);
+            // exact arithmetic on small integers, so compare exactly
+            float expected = 0;
+            for (size_t k = 0; k < len && k < 8; k++) {
+                if (i - (int)k >= 1) expected += b[k] * (i - (int)k);
+            }
+            CHECK_CLOSE(fir_filter(&line, b, 8), expected, 0);
+            CHECK_CLOSE(fir_filter_mirror(&mline, b, 8), expected, 0);
+        }
+        float x;
+        CHECK(get(&line, len - 1, &x) == 0);
+        CHECK_CLOSE(x, 21.0 - len, 0);
+        destroy_line(&line);
+        destroy_mirror_line(&mline);
+    }
+}
+
+static void test_static_storage(void) {
+    DELAY_LINE_STORAGE(avg_storage, 16);
+    MIRROR_LINE_STORAGE(fir_storage, 4);
+    avg_line_t avg;
+    mirror_line_t fir;
+    float b[4] = {0.25f, 0.25f, 0.25f, 0.25f};
+    size_t before = filter_memory_used();
+
+    avg_storage[3] = 42; // init must clear stale contents
+    CHECK(init_avg_line(&avg, avg_storage, 16) == 0);
+    CHECK(init_mirror_line(&fir, fir_storage, 4) == 0);
+    CHECK(filter_memory_used() == before + (16 + 8) * sizeof(float));
+    CHECK(init_line(NULL, avg_storage, 16) == -1);
+    CHECK(init_mirror_line(&fir, NULL, 4) == -1);
+
+    for (int i = 0; i < 32; i++) {
+        float y;
+        push_avg(&avg, 2.0f);
+        fir_filter_block(&fir, b, 4, &(float){4.0f}, &y, 1);
+        if (i >= 15) CHECK_CLOSE(avg_line_sum(&avg), 32.0, 0);
+        if (i >= 3) CHECK_CLOSE(y, 4.0, 0);
+    }
+}
+
+static void test_memory_accounting(void) {
+    size_t before = filter_memory_used();
+    delay_line_t line;
+    mirror_line_t mline;
+    CHECK(create_line(&line, 10) == 0);
+    CHECK(create_mirror_line(&mline, 10) == 0);
+    CHECK(filter_memory_used() == before + 30 * sizeof(float));
+    destroy_line(&line);
+    destroy_mirror_line(&mline);
+#ifdef FILTER_STATIC_POOL
+    // pool storage is never reclaimed
+    CHECK(filter_memory_used() == before + 30 * sizeof(float));
+    // and running out of it fails cleanly
+    CHECK(create_line(&line, FILTER_POOL_LEN + 1) == -1);
+#else
+    CHECK(filter_memory_used() == before);
+#endif
+    CHECK(create_line(&line, 0) == -1);
+}
+
+/**
+ * Fill `c` with the coefficients of a second order low-pass section with
+ * cutoff `fc` (as a fraction of the sample rate) and quality factor `q`,
+ * using the bilinear transform (RBJ audio EQ cookbook).
+ */
+static void lowpass_section(double fc, double q, float *c) {
+    double w0 = 2 * M_PI * fc;
+    double alpha = sin(w0) / (2 * q);
+    double a0 = 1 + alpha;
+    c[0] = (1 - cos(w0)) / 2 / a0;
+    c[1] = (1 - cos(w0)) / a0;
+    c[2] = (1 - cos(w0)) / 2 / a0;
+    c[3] = -2 * cos(w0) / a0;
+    c[4] = (1 - alpha) / a0;
+}
+
+// Fourth order Butterworth low-pass at fc = 0.05 as two sections.
+static void butterworth4(float *c) {
+    lowpass_section(0.05, 0.54119610, c);
+    lowpass_section(0.05, 1.30656296, c + 5);
+}
+
+static void test_biquad_impulse(void) {
+    // y[n] = x[n] + 0.5 y[n-1], so the impulse response is 0.5^n
+    float c[5] = {1, 0, 0, -0.5f, 0};
+    biquad_t bq;
+    CHECK(create_biquad(&bq, c, 1) == 0);
+    CHECK_CLOSE(biquad_filter(&bq, 1), 1, 0);
+    for (int n = 1; n < 20; n++) {
+        CHECK_CLOSE(biquad_filter(&bq, 0), ldexp(1, -n), 0);
+    }
+    destroy_biquad(&bq);
+    CHECK(create_biquad(&bq, c, 0) == -1);
+}
+
+/**
+ * Compare the cascade against each section evaluated in double precision
+ * as a direct form I difference equation.
+ */
+static void test_biquad_reference(void) {
+    float c[10];
+    double xs[2][2] = {{0}}, ys[2][2] = {{0}};
+    biquad_t bq;
+    butterworth4(c);
+    create_biquad(&bq, c, 2);
+    srand(3);
+    for (int n = 0; n < 2000; n++) {
+        double x = (double)rand() / RAND_MAX - 0.5;
+        float y = biquad_filter(&bq, (float)x);
+        for (int k = 0; k < 2; k++) {
+            const float *ck = c + 5 * k;
+            double yk = ck[0] * x + ck[1] * xs[k][0] + ck[2] * xs[k][1]
+                      - ck[3] * ys[k][0] - ck[4] * ys[k][1];
+            xs[k][1] = xs[k][0];
+            xs[k][0] = x;
+            ys[k][1] = ys[k][0];
+            ys[k][0] = yk;
+            x = yk;
+        }
+        CHECK_CLOSE(y, x, 1e-5);
+    }
+    destroy_biquad(&bq);
+}
+
+static void test_biquad_response(void) {
+    float c[10];
+    float dc[400], nyquist[400];
+    biquad_t bq;
+    butterworth4(c);
+    for (int i = 0; i < 400; i++) {
+        dc[i] = 1;
+        nyquist[i] = (i % 2) ? -1 : 1;
+    }
+    create_biquad(&bq, c, 2);
+    biquad_filter_block(&bq, dc, dc, 400);
+    // unity gain in the passband
+    CHECK_CLOSE(dc[399], 1, 1e-4);
+    destroy_biquad(&bq);
+    create_biquad(&bq, c, 2);
+    biquad_filter_block(&bq, nyquist, nyquist, 400);
+    // a bilinear transform low-pass has a zero at the Nyquist frequency
+    for (int i = 300; i < 400; i++) {
+        CHECK(fabsf(nyquist[i]) < 1e-4f);
+    }
+    destroy_biquad(&bq);
+}
+
+static void test_biquad_block_matches_sample(void) {
+    BIQUAD_STATE_STORAGE(block_state, 2);
+    float c[10];
+    float x[256], y[256];
+    biquad_t per_sample, block;
+    size_t before = filter_memory_used();
+    butterworth4(c);
+    create_biquad(&per_sample, c, 2);
+    CHECK(init_biquad(&block, c, block_state, 2) == 0);
+    CHECK(filter_memory_used() == before + 8 * sizeof(float));
+    srand(4);
+    for (int i = 0; i < 256; i++) {
+        x[i] = (float)rand() / RAND_MAX;
+    }
+    // odd split to check state carries across blocks
+    biquad_filter_block(&block, x, y, 100);
+    biquad_filter_block(&block, x + 100, y + 100, 156);
+    for (int i = 0; i < 256; i++) {
+        CHECK_CLOSE(y[i], biquad_filter(&per_sample, x[i]), 1e-6);
+    }
+    destroy_biquad(&per_sample);
+}
+
+/**
+ * Each multi-channel filter must match one single-channel filter per axis.
+ */
+static void test_multichannel_matches_single(void) {
+    float b[6] = {0.3f, 0.2f, 0.2f, 0.1f, 0.1f, 0.1f};
+    float c[10];
+    mirror_line_t fir[3];
+    avg_line_t avg[3];
+    biquad_t iir[3];
+    mirror_line_mc_t fir_mc;
+    avg_line_mc_t avg_mc;
+    biquad_mc_t iir_mc;
+    butterworth4(c);
+    for (int k = 0; k < 3; k++) {
+        create_mirror_line(&fir[k], 6);
+        create_avg_line(&avg[k], 5);
+        create_biquad(&iir[k], c, 2);
+    }
+    CHECK(create_mirror_line_mc(&fir_mc, 6, 3) == 0);
+    CHECK(create_avg_line_mc(&avg_mc, 5, 3) == 0);
+    CHECK(create_biquad_mc(&iir_mc, c, 2, 3) == 0);
+    CHECK(create_mirror_line_mc(&fir_mc, 6, FILTER_MAX_CHANNELS + 1) == -1);
+
+    srand(5);
+    for (int n = 0; n < 1000; n++) {
+        float x[3], y_fir[3], y_avg[3], y_iir[3];
+        for (int k = 0; k < 3; k++) {
+            x[k] = (float)rand() / RAND_MAX - 0.5f;
+        }
+        fir_filter_mc(&fir_mc, b, 6, x, y_fir);
+        push_avg_mc(&avg_mc, x, y_avg);
+        biquad_filter_mc(&iir_mc, x, y_iir);
+        for (int k = 0; k < 3; k++) {
+            float y;
+            fir_filter_block(&fir[k], b, 6, &x[k], &y, 1);
+            CHECK_CLOSE(y_fir[k], y, 1e-6);
+            push_avg(&avg[k], x[k]);
+            CHECK_CLOSE(y_avg[k], avg_line_sum(&avg[k]), 1e-6);
+            CHECK_CLOSE(y_iir[k], biquad_filter(&iir[k], x[k]), 1e-6);
+        }
+    }
+    // a channel count other than three takes the generic path
+    mirror_line_mc_t two;
+    float y2[2];
+    create_mirror_line_mc(&two, 4, 2);
+    fir_filter_mc(&two, b, 4, (float[]){1, 2}, y2);
+    fir_filter_mc(&two, b, 4, (float[]){3, 4}, y2);
+    CHECK_CLOSE(y2[0], 0.3 * 3 + 0.2 * 1, 1e-6);
+    CHECK_CLOSE(y2[1], 0.3 * 4 + 0.2 * 2, 1e-6);
+
+    for (int k = 0; k < 3; k++) {
+        destroy_mirror_line(&fir[k]);
+        destroy_avg_line(&avg[k]);
+        destroy_biquad(&iir[k]);
+    }
+    destroy_mirror_line_mc(&fir_mc);
+    destroy_avg_line_mc(&avg_mc);
+    destroy_biquad_mc(&iir_mc);
+    destroy_mirror_line_mc(&two);
+}
+
+int main(void) {
+    test_delay_line_order();
+    test_fir_paths_agree();
+    test_avg_line_matches_sum_line();
+    test_masked_wrap();
+    test_static_storage();
+    test_memory_accounting();
+    test_biquad_impulse();
+    test_biquad_reference();
+    test_biquad_response();
+    test_biquad_block_matches_sample();
+    test_multichannel_matches_single();
+    test_avg_line_drift(3, 10000000);
+    test_avg_line_drift(64, 10000000);
+    test_avg_line_drift(1000, 10000000);
+    test_avg_line_drift(1024, 10000000);
+#ifdef FILTER_STATIC_POOL
+    return test_report("filter_test (static pool)");
+#else
+    return test_report("filter_test");
+#endif
+}
@@ -0,0 +1,174 @@
+/**
+ * @file lcd_test.c
+ * @brief Host tests for lib/lcd.c. The bytes sent to the SPIM stand-in
+ * are decoded into a model of the display to check what it shows.
+ */
+#include <string.h>
+
+#include "lib/lcd.h"
+#include "test.h"
+
+#define MSEC 1000000LL
+
+static const nrfx_spim_t spim = NRFX_SPIM_INSTANCE(1);
+static lcd_t lcd;
+
+// What the display shows, from the bytes sent so far.
+static char screen[LCD_ROWS][LCD_COLUMNS + 1];
+static int cursor_row, cursor_col;
+
+/**
+ * Take the bytes sent since the last call, apply them to the display
+ * model, and return how many there were.
+ */
+static size_t take(void) {
+    uint8_t bytes[1024];
+    size_t n = nrfx_spim_host_take_tx(bytes, sizeof(bytes));
+    CHECK(n % 3 == 0);
+    for (size_t i = 0; i + 2 < n; i += 3) {
+        uint8_t value = bytes[i + 1] | (bytes[i + 2] << 4);
+        if (bytes[i] == 0x1F) {
+            CHECK(value & 0x80);
+            cursor_row = (value & 0x40) ? 1 : 0;
+            cursor_col = value & 0x3F;
+        } else {
+            CHECK(bytes[i] == 0x5F);
+            CHECK(cursor_col < LCD_COLUMNS);
+            screen[cursor_row][cursor_col++] = value;
+        }
+    }
+    return n;
+}
+
+static void setup(bool nonblocking, int64_t interval) {
+    nrfx_spim_config_t config = NRFX_SPIM_DEFAULT_CONFIG;
+    nrfx_spim_uninit(&spim);
+    CHECK(lcd_init(&lcd, &spim, &config, nonblocking, interval) == NRF_SUCCESS);
+    memset(screen, '?', sizeof(screen));
+    screen[0][LCD_COLUMNS] = screen[1][LCD_COLUMNS] = 0;
+}
+
+static void test_first_flush(void) {
+    setup(false, 0);
+    CHECK(lcd_flush_delay(&lcd, 0) == 0);
+    lcd_write(&lcd, 0, "Hello");
+    lcd_write(&lcd, 1, "a line that is too long");
+    CHECK(lcd_flush(&lcd, 0) == NRF_SUCCESS);
+    // Everything, since what the display showed was unknown.
+    CHECK(take() == 2 * 17 * 3);
+    CHECK(strcmp(screen[0], "Hello           ") == 0);
+    CHECK(strcmp(screen[1], "a line that is t") == 0);
+    CHECK(nrfx_spim_host_transfers() == 1);
+}
+
+static void test_unchanged(void) {
+    setup(false, 0);
+    lcd_write(&lcd, 0, "i:9");
+    lcd_flush(&lcd, 0);
+    take();
+    lcd_write(&lcd, 0, "i:9");
+    CHECK(lcd_flush_delay(&lcd, 0) == -1);
+    CHECK(lcd_flush(&lcd, 0) == NRF_SUCCESS);
+    CHECK(take() == 0);
+    CHECK(nrfx_spim_host_transfers() == 1);
+    CHECK(lcd_stats(&lcd).writes == 1);
+}
+
+static void test_runs(void) {
+    setup(false, 0);
+    lcd_write(&lcd, 0, "i:9");
+    lcd_write(&lcd, 1, "abcdefgh");
+    lcd_flush(&lcd, 0);
+    take();
+
+    // Two cells: one cursor command and two characters.
+    lcd_write(&lcd, 0, "i:10");
+    lcd_flush(&lcd, 0);
+    CHECK(take() == 3 * 3);
+    CHECK(strcmp(screen[0], "i:10            ") == 0);
+
+    // Cells 0 and 2: cheaper to resend cell 1 than to move the cursor.
+    lcd_write(&lcd, 1, "AbCdefgh");
+    lcd_flush(&lcd, 0);
+    CHECK(take() == 4 * 3);
+    // Cells 0 and 3: two runs.
+    lcd_write(&lcd, 1, "abCDefgh");
+    lcd_flush(&lcd, 0);
+    CHECK(take() == 4 * 3);
+    CHECK(strcmp(screen[1], "abCDefgh        ") == 0);
+    // Cells 0 and 6 of one row and 15 of the other.
+    lcd_write(&lcd, 0, "x:10            ");
+    lcd_write(&lcd, 1, "abCDefGh       !");
+    lcd_flush(&lcd, 0);
+    CHECK(take() == 6 * 3);
+    CHECK(strcmp(screen[0], "x:10            ") == 0);
+    CHECK(strcmp(screen[1], "abCDefGh       !") == 0);
+}
+
+static void test_coalesce(void) {
+    setup(false, 100 * MSEC);
+    lcd_write(&lcd, 0, "a");
+    CHECK(lcd_flush_delay(&lcd, 0) == 0);
+    lcd_flush(&lcd, 0);
+    take();
+    lcd_write(&lcd, 0, "b");
+    CHECK(lcd_flush_delay(&lcd, 10 * MSEC) == 90 * MSEC);
+    lcd_write(&lcd, 0, "c");
+    lcd_write(&lcd, 1, "d");
+    CHECK(lcd_flush_delay(&lcd, 50 * MSEC) == 50 * MSEC);
+    CHECK(lcd_flush_delay(&lcd, 150 * MSEC) == 0);
+    lcd_flush(&lcd, 100 * MSEC);
+    // Only the last text, in one transfer.
+    CHECK(take() == 4 * 3);
+    CHECK(screen[0][0] == 'c' && screen[1][0] == 'd');
+    CHECK(nrfx_spim_host_transfers() == 2);
+}
+
+static void test_nonblocking(void) {
+    setup(true, 0);
+    lcd_write(&lcd, 0, "one");
+    CHECK(lcd_flush(&lcd, 0) == NRF_SUCCESS);
+    lcd_write(&lcd, 0, "two");
+    CHECK(lcd_flush(&lcd, 0) == NRF_ERROR_BUSY);
+    CHECK(lcd_flush_delay(&lcd, 0) == 0);
+    CHECK(nrfx_spim_host_complete());
+    CHECK(lcd_flush(&lcd, 0) == NRF_SUCCESS);
+    CHECK(nrfx_spim_host_complete());
+    take();
+    CHECK(strncmp(screen[0], "two ", 4) == 0);
+    CHECK(nrfx_spim_host_transfers() == 2);
+}
+
+static void test_tilt_log(void) {
+    // The pattern of src/TiltLog.lf: a counter on row 0 and two slowly
+    // changing angles on row 1, each written every 250 ms for a minute.
+    setup(false, 100 * MSEC);
+    char text[32];
+    size_t sent = 0;
+    int messages = 0;
+    for (int i = 0; i < 240; i++) {
+        int64_t now = i * 250 * MSEC;
+        snprintf(text, sizeof(text), "i:%d", i);
+        lcd_write(&lcd, 0, text);
+        snprintf(text, sizeof(text), "xz:%.2f yz:%.2f", 10 + 0.01 * (i / 8), -3 + 0.01 * (i / 20));
+        lcd_write(&lcd, 1, text);
+        messages += 2;
+        if (lcd_flush_delay(&lcd, now) == 0) lcd_flush(&lcd, now);
+        sent += take();
+    }
+    // Writing whole rows, each message would cost a cursor command and 16 cells.
+    size_t full = (size_t)messages * 17 * 3;
+    printf("  TiltLog pattern: %zu bytes sent, %zu writing whole rows\n", sent, full);
+    CHECK(sent * 4 < full);
+    CHECK(strcmp(screen[0], "i:239           ") == 0);
+}
+
+int main(void) {
+    test_first_flush();
+    test_unchanged();
+    test_runs();
+    test_coalesce();
+    test_nonblocking();
+    test_tilt_log();
+    return test_report("lcd_test");
+}
@@ -0,0 +1,162 @@
+/**
+ * @file linux_sim_test.c
+ * @brief Host tests for the Linux platform's world model and its
+ * stand-ins for the Romi, the IMU, the analog accelerometer, and the
+ * display. Logical time is whatever the tests set, as the LF runtime
+ * would report it.
+ */
+#include <string.h>
+
+#include "lib/lcd.h"
+#include "lib/odometry.h"
+#include "lib/romi.h"
+#include "display.h"
+#include "lsm9ds1.h"
+#include "nrfx_saadc.h"
+#include "sim.h"
+#include "test.h"
+
+#define MSEC 1000000LL
+#define PI 3.14159265358979323846
+
+static int64_t logical_elapsed = 0;
+
+int64_t lf_time_logical_elapsed(void) {
+    return logical_elapsed;
+}
+
+static void setup(void) {
+    logical_elapsed = 0;
+    sim_reset();
+    CHECK(romi_init() == NRF_SUCCESS);
+}
+
+static void test_straight(void) {
+    setup();
+    romi_sensors_t sensors;
+    CHECK(romi_sensors_age_ms() == UINT32_MAX);
+    CHECK(romi_sensors_poll(&sensors) == NRF_SUCCESS);
+    CHECK(sensors.encoders.left == 0);
+
+    CHECK(romi_drive_direct(200, 200) == NRF_SUCCESS);
+    logical_elapsed = 2005 * MSEC;
+    sim_state_t const *now = sim_now();
+    // 0.2 m/s for 2 s, less the 50 ms lag of the wheels getting up to speed.
+    CHECK_CLOSE(now->x, 0.4 - 0.2 * SIM_WHEEL_LAG, 0.002);
+    CHECK_CLOSE(now->y, 0.0, 1e-9);
+    CHECK_CLOSE(now->theta, 0.0, 1e-9);
+
+    // The latest packet is from 2000 ms.
+    CHECK(romi_sensors_age_ms() == 5);
+    CHECK(romi_sensors_poll(&sensors) == NRF_SUCCESS);
+    CHECK(sensors.time_stamp == 2000);
+    CHECK(sensors.encoders.left == sensors.encoders.right);
+    CHECK_CLOSE(sensors.encoders.left * 0.0006108, sim_packet()->left_distance, 0.0006108);
+
+    romi_rx_stats_t stats;
+    romi_rx_stats(&stats);
+    CHECK(stats.packets == 100);
+
+    lsm9ds1_measurement_t acc = lsm9ds1_read_accelerometer();
+    CHECK_CLOSE(acc.x_axis, 0.0, 1e-3);
+    CHECK_CLOSE(acc.z_axis, 1.0, 1e-6);
+}
+
+static void test_accelerating(void) {
+    setup();
+    romi_drive_direct(300, 300);
+    logical_elapsed = 1 * MSEC;
+    // The wheels start at 0.3 m/s / 50 ms = 6 m/s^2.
+    lsm9ds1_measurement_t acc = lsm9ds1_read_accelerometer();
+    CHECK_CLOSE(acc.x_axis, 6.0 / 9.81, 0.1);
+
+    // The analog accelerometer on AIN5, converted as the Accelerometer
+    // reactor does.
+    nrf_saadc_value_t raw;
+    nrf_saadc_channel_config_t channel = NRFX_SAADC_DEFAULT_CHANNEL_CONFIG_SE(NRF_SAADC_INPUT_AIN5);
+    nrfx_saadc_config_t config = NRFX_SAADC_DEFAULT_CONFIG;
+    CHECK(nrfx_saadc_init(&config, NULL) == NRF_SUCCESS);
+    CHECK(nrfx_saadc_channel_init(0, &channel) == NRF_SUCCESS);
+    CHECK(nrfx_saadc_sample_convert(0, &raw) == NRF_SUCCESS);
+    double g = (raw * 3.6 / 4096 - 1.5 * 2.98 / 3) / (0.42 * 2.98 / 3);
+    CHECK_CLOSE(g, acc.x_axis, 0.01);
+    nrfx_saadc_uninit();
+}
+
+static void test_turn(void) {
+    setup();
+    odometry_t odom;
+    odometry_init(&odom, 0.0006108f, SIM_WHEELBASE);
+    romi_sensors_t sensors;
+    romi_sensors_poll(&sensors);
+    odometry_update(&odom, sensors.encoders);
+
+    // A quarter circle of radius 0.5 m at 0.2 m/s, then stop.
+    double radius = 0.5;
+    double left = 0.2 * (radius - SIM_WHEELBASE / 2) / radius;
+    double right = 0.2 * (radius + SIM_WHEELBASE / 2) / radius;
+    romi_drive_direct(lround(left * 1000), lround(right * 1000));
+    int64_t duration = (int64_t)(PI / 2 * radius / 0.2 * 1000) * MSEC;
+    for (logical_elapsed = 0; logical_elapsed < duration; logical_elapsed += 20 * MSEC) {
+        romi_sensors_poll(&sensors);
+        odometry_update(&odom, sensors.encoders);
+    }
+    lsm9ds1_measurement_t gyro = lsm9ds1_read_gyro();
+    CHECK_CLOSE(gyro.z_axis, 0.2 / radius * 180 / PI, 0.5);
+    lsm9ds1_measurement_t acc = lsm9ds1_read_accelerometer();
+    CHECK_CLOSE(acc.y_axis, 0.2 * 0.2 / radius / 9.81, 0.002);
+
+    romi_drive_direct(0, 0);
+    for (int i = 0; i < 50; i++, logical_elapsed += 20 * MSEC) {
+        romi_sensors_poll(&sensors);
+        odometry_update(&odom, sensors.encoders);
+    }
+    sim_state_t const *now = sim_now();
+    CHECK_CLOSE(now->theta, PI / 2, 0.02);
+    CHECK_CLOSE(now->x, radius, 0.02);
+    CHECK_CLOSE(now->y, radius, 0.02);
+
+    // Odometry on the encoders follows the model.
+    odometry_pose_t pose;
+    odometry_get_pose(&odom, &pose);
+    CHECK_CLOSE(pose.x, now->x, 0.01);
+    CHECK_CLOSE(pose.y, now->y, 0.01);
+    CHECK_CLOSE(pose.theta, now->theta, 0.02);
+
+    romi_sensors_ext_t ext;
+    romi_sensors_ext_poll(&ext);
+    CHECK(ext.present & (1 << ROMI_ID_INERTIAL));
+    CHECK_CLOSE(ext.inertial.angle, now->theta * 18000 / PI, 10);
+
+    lsm9ds1_measurement_t mag = lsm9ds1_read_magnetometer();
+    CHECK_CLOSE(atan2(-mag.y_axis, mag.x_axis), now->theta, 1e-3);
+}
+
+static void test_display(void) {
+    static const nrf_drv_spi_t spi = NRF_DRV_SPI_INSTANCE(1);
+    static const nrfx_spim_t spim = NRFX_SPIM_INSTANCE(1);
+    CHECK(display_init(&spi) == NRF_SUCCESS);
+    CHECK(display_write("Initialized", 0) == NRF_SUCCESS);
+    CHECK(display_write("row", 2) == NRF_ERROR_INVALID_PARAM);
+
+    // A nonblocking writer needs nobody to complete its transfers.
+    lcd_t lcd;
+    nrfx_spim_config_t config = NRFX_SPIM_DEFAULT_CONFIG;
+    CHECK(lcd_init(&lcd, &spim, &config, true, 0) == NRF_SUCCESS);
+    lcd_write(&lcd, 0, "x: 1.00");
+    lcd_write(&lcd, 1, "DRIVING");
+    CHECK(lcd_flush(&lcd, 0) == NRF_SUCCESS);
+    CHECK(!lcd.busy);
+    lcd_write(&lcd, 0, "x: 1.25");
+    CHECK(lcd_flush(&lcd, 0) == NRF_SUCCESS);
+    CHECK(!lcd.busy);
+    nrfx_spim_uninit(&spim);
+}
+
+int main(void) {
+    test_straight();
+    test_accelerating();
+    test_turn();
+    test_display();
+    return test_report("linux_sim_test");
+}
@@ -0,0 +1,231 @@
+/**
+ * @file log_codec_test.c
+ * @brief Host tests for lib/log_codec.c, and its compression of IMU
+ * readings like those SensorLog records.
+ */
+#include <math.h>
+#include <string.h>
+#include "lib/log_codec.h"
+#include "nrf_error.h"
+#include "test.h"
+
+#define BLOCK 512
+#define RECORDS 4000
+
+static log_codec_record_t records[RECORDS];
+static uint32_t seed = 1;
+
+// Noise from a fixed sequence, uniform in [-amplitude, amplitude].
+static float noise(float amplitude) {
+    seed = seed * 1103515245 + 12345;
+    return amplitude * (((seed >> 8) & 0xFFFF) / 32767.5f - 1);
+}
+
+/**
+ * Fill `records` with the accelerometer and gyro of a robot sampled at
+ * 119 Hz, as the IMU's FIFO does: resting, then turning back and forth,
+ * then resting. Readings are quantized as SensorLog does, acceleration
+ * in thousandths of a g and rotation in hundredths of a degree per
+ * second, with the time in milliseconds. The noise is about that of the
+ * LSM9DS1 on the Buckler at rest.
+ */
+static void imu(void) {
+    seed = 1;
+    for (int i = 0; i < RECORDS; i++) {
+        float t = i / 119.0f;
+        float turn = (i > RECORDS / 4 && i < 3 * RECORDS / 4) ? 90 * sinf(t) : 0;
+        float ax = 0.02f + noise(0.01f), ay = -0.01f + 0.002f * turn + noise(0.01f);
+        float az = 1.0f + noise(0.01f);
+        float gx = noise(0.5f), gy = noise(0.5f), gz = turn + noise(0.5f);
+        log_codec_record_t *r = &records[i];
+        r->time = (uint64_t)llroundf(1000 * t) + 5000;
+        r->values[0] = lroundf(ax * 1000);
+        r->values[1] = lroundf(ay * 1000);
+        r->values[2] = lroundf(az * 1000);
+        r->values[3] = lroundf(gx * 100);
+        r->values[4] = lroundf(gy * 100);
+        r->values[5] = lroundf(gz * 100);
+    }
+}
+
+static const log_codec_config_t imu_config = {
+    .channels = 6, .keyframe = 32, .time_unit = 1000000, .session = 7,
+    .exponents = {3, 3, 3, 2, 2, 2},
+};
+
+static bool same(log_codec_record_t const *a, log_codec_record_t const *b, int channels) {
+    return a->time == b->time
+            && memcmp(a->values, b->values, channels * sizeof(a->values[0])) == 0;
+}
+
+/**
+ * Encode the records into as many blocks as they take, decode them
+ * again, and return the number of blocks.
+ */
+static int round_trip(log_codec_config_t const *config, int count) {
+    static uint8_t blocks[RECORDS][BLOCK];
+    log_codec_writer_t writer;
+    int n = 0;
+    log_codec_begin(&writer, config, blocks[n], BLOCK, n);
+    for (int i = 0; i < count; i++) {
+        if (!log_codec_append(&writer, &records[i])) {
+            CHECK(writer.count > 0);
+            n++;
+            log_codec_begin(&writer, config, blocks[n], BLOCK, n);
+            CHECK(log_codec_append(&writer, &records[i]));
+        }
+    }
+    n++;
+
+    int decoded = 0;
+    for (int b = 0; b < n; b++) {
+        log_codec_reader_t reader;
+        log_codec_record_t r;
+        CHECK(log_codec_open(&reader, blocks[b], BLOCK) == NRF_SUCCESS);
+        CHECK(reader.sequence == (uint32_t)b);
+        CHECK(reader.config.session == config->session);
+        CHECK(reader.config.channels == config->channels);
+        CHECK(reader.config.time_unit == config->time_unit);
+        CHECK(memcmp(reader.config.exponents, config->exponents, config->channels) == 0);
+        ret_code_t result;
+        while ((result = log_codec_read(&reader, &r)) == NRF_SUCCESS) {
+            CHECK(decoded < count && same(&r, &records[decoded], config->channels));
+            decoded++;
+        }
+        CHECK(result == NRF_ERROR_NOT_FOUND);
+    }
+    CHECK(decoded == count);
+    return n;
+}
+
+static void test_round_trip(void) {
+    int blocks = round_trip(&imu_config, RECORDS);
+    // The same with a keyframe every record, and with none but the first
+    // of each block.
+    log_codec_config_t config = imu_config;
+    config.keyframe = 1;
+    int all_keyframes = round_trip(&config, RECORDS);
+    config.keyframe = 0;
+    CHECK(round_trip(&config, RECORDS) == all_keyframes);
+    config.keyframe = 255;
+    int few_keyframes = round_trip(&config, RECORDS);
+    CHECK(few_keyframes <= blocks && blocks < all_keyframes);
+
+    // Extreme values, which take the longest varints.
+    log_codec_record_t *r = records;
+    memset(r, 0, 4 * sizeof(*r));
+    r[1].time = UINT64_MAX / 2;
+    r[2].time = UINT64_MAX;
+    r[3].time = UINT64_MAX;
+    for (int c = 0; c < LOG_CODEC_MAX_CHANNELS; c++) {
+        r[1].values[c] = INT32_MIN;
+        r[2].values[c] = INT32_MAX;
+        r[3].values[c] = c % 2 ? INT32_MIN : INT32_MAX;
+    }
+    config = imu_config;
+    config.channels = LOG_CODEC_MAX_CHANNELS;
+    round_trip(&config, 4);
+    imu(); // Restore the records.
+}
+
+static void test_full_block(void) {
+    uint8_t block[64];
+    log_codec_writer_t writer;
+    log_codec_begin(&writer, &imu_config, block, sizeof(block), 0);
+    int appended = 0;
+    while (log_codec_append(&writer, &records[appended])) appended++;
+    CHECK(appended > 0);
+    CHECK(writer.count == appended);
+    CHECK(writer.length <= sizeof(block));
+    // A refused record leaves the block as it was.
+    size_t length = writer.length;
+    CHECK(!log_codec_append(&writer, &records[appended]));
+    CHECK(writer.length == length && writer.count == appended);
+    for (size_t i = length; i < sizeof(block); i++) {
+        CHECK(block[i] == 0);
+    }
+
+    log_codec_set_session(&writer, 0x12345678);
+    log_codec_reader_t reader;
+    CHECK(log_codec_open(&reader, block, sizeof(block)) == NRF_SUCCESS);
+    CHECK(reader.config.session == 0x12345678);
+    CHECK(reader.count == appended);
+}
+
+static void test_errors(void) {
+    uint8_t block[BLOCK];
+    log_codec_reader_t reader;
+    log_codec_record_t r;
+
+    // Blocks never written, erased, or of another format.
+    memset(block, 0, sizeof(block));
+    CHECK(log_codec_open(&reader, block, sizeof(block)) == NRF_ERROR_INVALID_DATA);
+    memset(block, 0xFF, sizeof(block));
+    CHECK(log_codec_open(&reader, block, sizeof(block)) == NRF_ERROR_INVALID_DATA);
+
+    log_codec_writer_t writer;
+    log_codec_begin(&writer, &imu_config, block, sizeof(block), 3);
+    CHECK(log_codec_open(&reader, block, 10) == NRF_ERROR_INVALID_DATA);
+    block[4] = LOG_CODEC_VERSION + 1;
+    CHECK(log_codec_open(&reader, block, sizeof(block)) == NRF_ERROR_INVALID_DATA);
+    block[4] = LOG_CODEC_VERSION;
+    block[5] = LOG_CODEC_MAX_CHANNELS + 1;
+    CHECK(log_codec_open(&reader, block, sizeof(block)) == NRF_ERROR_INVALID_DATA);
+    block[5] = 0;
+    CHECK(log_codec_open(&reader, block, sizeof(block)) == NRF_ERROR_INVALID_DATA);
+
+    // An empty block.
+    log_codec_begin(&writer, &imu_config, block, sizeof(block), 3);
+    CHECK(log_codec_open(&reader, block, sizeof(block)) == NRF_SUCCESS);
+    CHECK(reader.count == 0);
+    CHECK(log_codec_read(&reader, &r) == NRF_ERROR_NOT_FOUND);
+
+    // A count larger than the records in the block, and a record cut off
+    // at the end of the buffer.
+    for (int i = 0; i < 10; i++) {
+        CHECK(log_codec_append(&writer, &records[i]));
+    }
+    size_t length = writer.length;
+    block[6] = 200;
+    CHECK(log_codec_open(&reader, block, length - 1) == NRF_SUCCESS);
+    int read = 0;
+    ret_code_t result;
+    while ((result = log_codec_read(&reader, &r)) == NRF_SUCCESS) read++;
+    CHECK(read == 9);
+    CHECK(result == NRF_ERROR_INVALID_LENGTH);
+}
+
+/*
+ * Bytes per record and blocks for the IMU readings, against two ways of
+ * storing them without the codec: the floats as lsm9ds1_measurement_t
+ * holds them with a 64-bit time, and the quantized values as int16 with
+ * a 32-bit time.
+ */
+static void test_compression(void) {
+    const int raw_floats = 8 + 6 * 4, raw_ints = 4 + 6 * 2;
+    int blocks = round_trip(&imu_config, RECORDS);
+    double bytes = (double)blocks * BLOCK / RECORDS;
+    printf("  %d IMU records at 119 Hz in %d blocks: %.2f bytes per record, %.1f records per block\n",
+           RECORDS, blocks, bytes, (double)RECORDS / blocks);
+    printf("  %.1fx smaller than %d-byte float records, %.1fx than %d-byte int16 records\n",
+           raw_floats / bytes, raw_floats, raw_ints / bytes, raw_ints);
+    printf("  %.0f bytes/s, one 512-byte block every %.2f s\n", 119 * bytes,
+           BLOCK / (119 * bytes));
+
+    log_codec_config_t config = imu_config;
+    config.keyframe = 1;
+    int all_keyframes = round_trip(&config, RECORDS);
+    printf("  with every record a keyframe: %.2f bytes per record\n",
+           (double)all_keyframes * BLOCK / RECORDS);
+    CHECK(bytes * 3 < raw_floats);
+    CHECK(bytes < raw_ints);
+}
+
+int main(void) {
+    imu();
+    test_round_trip();
+    test_full_block();
+    test_errors();
+    test_compression();
+    return test_report("log_codec_test");
+}
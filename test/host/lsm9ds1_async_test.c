@@ -0,0 +1,143 @@
+/**
+ * @file lsm9ds1_async_test.c
+ * @brief Host tests for lib/lsm9ds1_async.c against the LSM9DS1 model
+ * in platform/host/lsm9ds1_host.c.
+ */
+#include "lib/lsm9ds1_async.h"
+#include "test.h"
+
+NRF_TWI_MNGR_DEF(twi, 5, 0);
+
+static int calls;
+static ret_code_t last_result;
+static lsm9ds1_reading_t last_reading;
+
+static void handler(ret_code_t result, lsm9ds1_reading_t const *reading, void *context) {
+    calls++;
+    last_result = result;
+    last_reading = *reading;
+    CHECK(context == &calls);
+}
+
+static void setup(void) {
+    nrf_drv_twi_config_t config = NRF_DRV_TWI_DEFAULT_CONFIG;
+    nrf_twi_mngr_host_reset();
+    nrf_twi_mngr_init(&twi, &config);
+    lsm9ds1_host_reset();
+    lsm9ds1_async_init(&twi);
+    calls = 0;
+
+    int16_t acc[3] = {16384, -8192, 100};
+    int16_t gyro[3] = {1000, -2000, 3000};
+    int16_t mag[3] = {1500, -3000, 42};
+    lsm9ds1_host_sample(acc, gyro);
+    lsm9ds1_host_magnetic(mag);
+}
+
+/**
+ * Read one sensor the way the blocking driver functions do.
+ */
+static void read_blocking(uint8_t address, uint8_t reg, uint8_t *data) {
+    nrf_twi_mngr_transfer_t const transfers[] = {
+        NRF_TWI_MNGR_WRITE(address, &reg, 1, NRF_TWI_MNGR_NO_STOP),
+        NRF_TWI_MNGR_READ(address, data, 6, 0),
+    };
+    CHECK(nrf_twi_mngr_perform(&twi, NULL, transfers, 2, NULL) == NRF_SUCCESS);
+}
+
+static void test_blocking_time(void) {
+    setup();
+    // What the IMU reactor waited for on each trigger: three reads of
+    // about 0.84 ms each at 100 kHz.
+    uint8_t data[6];
+    read_blocking(0x6B, 0x28, data);
+    read_blocking(0x6B, 0x18, data);
+    read_blocking(0x1E, 0x28 | 0x80, data);
+    uint32_t blocked = nrf_twi_mngr_host_blocked_us();
+    printf("  blocking reads: %u us blocked per trigger\n", (unsigned)blocked);
+    CHECK(blocked > 2400);
+
+    // The same reads, queued.
+    uint32_t before = nrf_twi_mngr_host_bus_us();
+    CHECK(lsm9ds1_async_read(LSM9DS1_ACC | LSM9DS1_GYRO | LSM9DS1_MAG, handler, &calls) == NRF_SUCCESS);
+    CHECK(nrf_twi_mngr_host_blocked_us() == blocked);
+    CHECK(calls == 0);
+    CHECK(nrf_twi_mngr_host_complete());
+    CHECK(calls == 1);
+    CHECK(nrf_twi_mngr_host_blocked_us() == blocked);
+    printf("  queued reads: 0 us blocked, %u us on the bus\n",
+           (unsigned)(nrf_twi_mngr_host_bus_us() - before));
+}
+
+static void test_values(void) {
+    setup();
+    CHECK(lsm9ds1_async_read(LSM9DS1_ACC | LSM9DS1_GYRO | LSM9DS1_MAG, handler, &calls) == NRF_SUCCESS);
+    nrf_twi_mngr_host_complete();
+    CHECK(last_result == NRF_SUCCESS);
+    CHECK(last_reading.sensors == (LSM9DS1_ACC | LSM9DS1_GYRO | LSM9DS1_MAG));
+    CHECK_CLOSE(last_reading.acc.x_axis, 16384 * 0.000061, 1e-5);
+    CHECK_CLOSE(last_reading.acc.y_axis, -8192 * 0.000061, 1e-5);
+    CHECK_CLOSE(last_reading.acc.z_axis, 100 * 0.000061, 1e-6);
+    CHECK_CLOSE(last_reading.gyro.x_axis, 1000 * 0.00875, 1e-4);
+    CHECK_CLOSE(last_reading.gyro.y_axis, -2000 * 0.00875, 1e-4);
+    CHECK_CLOSE(last_reading.gyro.z_axis, 3000 * 0.00875, 1e-4);
+    CHECK_CLOSE(last_reading.mag.x_axis, 1500 * 0.014, 1e-4);
+    CHECK_CLOSE(last_reading.mag.y_axis, -3000 * 0.014, 1e-4);
+    CHECK_CLOSE(last_reading.mag.z_axis, 42 * 0.014, 1e-5);
+}
+
+static void test_one_sensor(void) {
+    setup();
+    uint32_t before = nrf_twi_mngr_host_transactions();
+    CHECK(lsm9ds1_async_read(LSM9DS1_GYRO, handler, &calls) == NRF_SUCCESS);
+    nrf_twi_mngr_host_complete();
+    CHECK(nrf_twi_mngr_host_transactions() - before == 1);
+    CHECK(last_reading.sensors == LSM9DS1_GYRO);
+    CHECK_CLOSE(last_reading.gyro.x_axis, 1000 * 0.00875, 1e-4);
+
+    CHECK(lsm9ds1_async_read(0, handler, &calls) == NRF_ERROR_INVALID_PARAM);
+}
+
+static void chain(ret_code_t result, lsm9ds1_reading_t const *reading, void *context) {
+    handler(result, reading, context);
+    if (calls < 3) {
+        CHECK(lsm9ds1_async_read(LSM9DS1_ACC, chain, context) == NRF_SUCCESS);
+    }
+}
+
+static void test_busy(void) {
+    setup();
+    CHECK(lsm9ds1_async_read(LSM9DS1_ACC, handler, &calls) == NRF_SUCCESS);
+    CHECK(lsm9ds1_async_read(LSM9DS1_ACC, handler, &calls) == NRF_ERROR_BUSY);
+    CHECK(nrf_twi_mngr_host_complete());
+    CHECK(!nrf_twi_mngr_host_complete());
+    CHECK(calls == 1);
+
+    // A handler can start the next read.
+    calls = 0;
+    CHECK(lsm9ds1_async_read(LSM9DS1_ACC, chain, &calls) == NRF_SUCCESS);
+    while (nrf_twi_mngr_host_complete()) {
+    }
+    CHECK(calls == 3);
+}
+
+static void test_error(void) {
+    setup();
+    nrf_twi_mngr_host_reset();
+    CHECK(lsm9ds1_async_read(LSM9DS1_MAG, handler, &calls) == NRF_SUCCESS);
+    nrf_twi_mngr_host_complete();
+    CHECK(calls == 1);
+    CHECK(last_result == NRF_ERROR_DRV_TWI_ERR_ANACK);
+    CHECK(last_reading.sensors == 0);
+    // The failed read does not leave the driver busy.
+    CHECK(lsm9ds1_async_read(LSM9DS1_MAG, handler, &calls) == NRF_SUCCESS);
+}
+
+int main(void) {
+    test_blocking_time();
+    test_values();
+    test_one_sensor();
+    test_busy();
+    test_error();
+    return test_report("lsm9ds1_async_test");
+}
@@ -0,0 +1,147 @@
+/**
+ * @file lsm9ds1_fifo_test.c
+ * @brief Host tests for lib/lsm9ds1_fifo.c against the LSM9DS1 model
+ * in platform/host/lsm9ds1_host.c.
+ */
+#include <stdlib.h>
+
+#include "lib/lsm9ds1_fifo.h"
+#include "test.h"
+
+NRF_TWI_MNGR_DEF(twi, 5, 0);
+
+static lsm9ds1_batch_t batch;
+
+static void setup(void) {
+    nrf_twi_mngr_host_reset();
+    lsm9ds1_host_reset();
+    CHECK(lsm9ds1_fifo_init(&twi, LSM9DS1_ODR_119_HZ) == NRF_SUCCESS);
+}
+
+/**
+ * Take one sample whose readings encode `k`, for checking which
+ * samples come back.
+ */
+static void sample(int k) {
+    int16_t acc[3] = {(int16_t)k, (int16_t)-k, 16384};
+    int16_t gyro[3] = {(int16_t)(2 * k), 100, (int16_t)-3000};
+    lsm9ds1_host_sample(acc, gyro);
+}
+
+static int sample_index(const lsm9ds1_sample_t *s) {
+    return (int)lroundf(s->acc.x_axis / 0.000061f);
+}
+
+static void test_init(void) {
+    setup();
+    CHECK(lsm9ds1_host_register(0x10) == 0x60); // CTRL_REG1_G: 119 Hz, 245 dps.
+    CHECK(lsm9ds1_host_register(0x23) == 0x02); // CTRL_REG9: FIFO enabled.
+    CHECK(lsm9ds1_host_register(0x2E) == 0xC0); // FIFO_CTRL: continuous mode.
+    CHECK(lsm9ds1_fifo_period() == 8403361);
+
+    nrf_twi_mngr_host_reset();
+    CHECK(lsm9ds1_fifo_init(&twi, LSM9DS1_ODR_119_HZ) == NRF_ERROR_DRV_TWI_ERR_ANACK);
+}
+
+static void test_empty(void) {
+    setup();
+    CHECK(lsm9ds1_fifo_read(&batch, 0) == NRF_SUCCESS);
+    CHECK(batch.count == 0);
+    CHECK(!batch.overrun);
+}
+
+static void test_values(void) {
+    setup();
+    for (int k = 1; k <= 5; k++) sample(k);
+    CHECK(lsm9ds1_fifo_read(&batch, 1000000000) == NRF_SUCCESS);
+    CHECK(batch.count == 5);
+    for (int i = 0; i < batch.count; i++) {
+        lsm9ds1_sample_t *s = &batch.samples[i];
+        CHECK(sample_index(s) == i + 1);
+        CHECK_CLOSE(s->acc.y_axis, -(i + 1) * 0.000061, 1e-7);
+        CHECK_CLOSE(s->acc.z_axis, 16384 * 0.000061, 1e-5);
+        CHECK_CLOSE(s->gyro.x_axis, 2 * (i + 1) * 0.00875, 1e-6);
+        CHECK_CLOSE(s->gyro.y_axis, 100 * 0.00875, 1e-6);
+        CHECK_CLOSE(s->gyro.z_axis, -3000 * 0.00875, 1e-4);
+    }
+    // Evenly spaced, with the newest within one period of the read.
+    CHECK(batch.samples[4].time - batch.samples[0].time == 4 * 8403361);
+    CHECK(batch.samples[4].time <= 1000000000 && batch.samples[4].time > 1000000000 - 8403361);
+
+    // The FIFO is now empty.
+    CHECK(lsm9ds1_fifo_read(&batch, 1010000000) == NRF_SUCCESS);
+    CHECK(batch.count == 0);
+}
+
+static void test_transactions(void) {
+    setup();
+    // About 100 ms of samples: one transaction for the status, one for the data.
+    for (int k = 0; k < 12; k++) sample(k);
+    uint32_t before = nrf_twi_mngr_host_transactions();
+    lsm9ds1_fifo_read(&batch, 0);
+    CHECK(batch.count == 12);
+    CHECK(nrf_twi_mngr_host_transactions() - before == 2);
+
+    // A full FIFO takes two data reads, since a read is at most 255 bytes.
+    for (int k = 0; k < 32; k++) sample(k);
+    before = nrf_twi_mngr_host_transactions();
+    lsm9ds1_fifo_read(&batch, 0);
+    CHECK(batch.count == 32);
+    CHECK(nrf_twi_mngr_host_transactions() - before == 3);
+    CHECK(sample_index(&batch.samples[31]) == 31);
+}
+
+static void test_overrun(void) {
+    setup();
+    for (int k = 0; k < 40; k++) sample(k);
+    lsm9ds1_fifo_read(&batch, 0);
+    CHECK(batch.count == 32);
+    CHECK(batch.overrun);
+    // The oldest were overwritten.
+    CHECK(sample_index(&batch.samples[0]) == 8);
+    CHECK(sample_index(&batch.samples[31]) == 39);
+
+    sample(40);
+    lsm9ds1_fifo_read(&batch, 0);
+    CHECK(batch.count == 1);
+    CHECK(!batch.overrun);
+}
+
+static void test_timestamps(void) {
+    setup();
+    // The sensor clock runs 3% fast, and reads come every 40 to 120 ms.
+    const double true_period = 8403361 * 0.97;
+    const double phase = 1234567;
+    srand(1);
+    int k = 0;
+    int64_t now = 0;
+    int64_t previous = 0;
+    bool first = true;
+    double worst = 0;
+    while (now < 20000000000LL) {
+        now += 40000000 + rand() % 80000000;
+        while (phase + k * true_period <= now) sample(k++);
+        CHECK(lsm9ds1_fifo_read(&batch, now) == NRF_SUCCESS);
+        for (int i = 0; i < batch.count; i++) {
+            lsm9ds1_sample_t *s = &batch.samples[i];
+            CHECK(first || s->time > previous);
+            first = false;
+            previous = s->time;
+            double error = fabs(s->time - (phase + sample_index(s) * true_period));
+            // Ignore the first two seconds, while the period estimate settles.
+            if (now > 2000000000 && error > worst) worst = error;
+        }
+    }
+    CHECK(worst < true_period);
+    CHECK_CLOSE(lsm9ds1_fifo_period(), true_period, 0.01 * true_period);
+}
+
+int main(void) {
+    test_init();
+    test_empty();
+    test_values();
+    test_transactions();
+    test_overrun();
+    test_timestamps();
+    return test_report("lsm9ds1_fifo_test");
+}
@@ -0,0 +1,115 @@
+/**
+ * @file odometry_test.c
+ * @brief Host unit tests for lib/odometry.c, using synthetic wheel traces.
+ */
+#include <math.h>
+
+#include "lib/odometry.h"
+#include "test.h"
+
+#define METERS_PER_TICK 0.0006108f
+#define WHEELBASE 0.141f
+
+/**
+ * Run `steps` updates that move the wheels by `left` and `right` ticks
+ * each, starting from the current counts in `enc`.
+ */
+static void drive(odometry_t *odom, romi_encoder_t *enc, int left, int right, int steps) {
+    for (int i = 0; i < steps; i++) {
+        enc->left += left;
+        enc->right += right;
+        odometry_update(odom, *enc);
+    }
+}
+
+static void test_first_update(void) {
+    odometry_t odom;
+    odometry_pose_t pose;
+    romi_encoder_t enc = {1234, 60000};
+    odometry_init(&odom, METERS_PER_TICK, WHEELBASE);
+    odometry_update(&odom, enc);
+    odometry_get_pose(&odom, &pose);
+    CHECK(pose.x == 0 && pose.y == 0 && pose.theta == 0);
+}
+
+static void test_straight_with_rollover(void) {
+    odometry_t odom;
+    odometry_pose_t pose;
+    romi_encoder_t enc = {65000, 64000};
+    odometry_init(&odom, METERS_PER_TICK, WHEELBASE);
+    odometry_update(&odom, enc);
+    // 200,000 ticks forward, rolling over both counters several times.
+    drive(&odom, &enc, 100, 100, 2000);
+    odometry_get_pose(&odom, &pose);
+    CHECK_CLOSE(pose.x, 200000 * METERS_PER_TICK, 1e-5);
+    CHECK_CLOSE(pose.y, 0, 1e-9);
+    CHECK_CLOSE(pose.theta, 0, 1e-9);
+
+    // Reverse back past the rollover to the start.
+    drive(&odom, &enc, -250, -250, 800);
+    odometry_get_pose(&odom, &pose);
+    CHECK_CLOSE(pose.x, 0, 1e-5);
+}
+
+static void test_spin_in_place(void) {
+    odometry_t odom;
+    odometry_pose_t pose;
+    romi_encoder_t enc = {10, 10};
+    odometry_init(&odom, METERS_PER_TICK, WHEELBASE);
+    odometry_update(&odom, enc);
+    // A quarter turn left: each wheel travels pi / 4 * wheelbase.
+    int ticks = (int)lround(M_PI / 4 * WHEELBASE / METERS_PER_TICK);
+    drive(&odom, &enc, -1, 1, ticks);
+    odometry_get_pose(&odom, &pose);
+    double theta = 2 * ticks * METERS_PER_TICK / WHEELBASE;
+    CHECK_CLOSE(pose.theta, theta, 1e-6);
+    CHECK_CLOSE(theta, M_PI / 2, 5e-3); // within a tick
+    CHECK_CLOSE(pose.x, 0, 1e-6);
+    CHECK_CLOSE(pose.y, 0, 1e-6);
+    // Keep turning through pi, where the heading wraps to negative.
+    drive(&odom, &enc, -1, 1, 2 * ticks);
+    odometry_get_pose(&odom, &pose);
+    CHECK_CLOSE(pose.theta, 3 * theta - 2 * M_PI, 1e-6);
+}
+
+static void test_arc(void) {
+    odometry_t odom;
+    odometry_pose_t pose;
+    romi_encoder_t enc = {0, 0};
+    odometry_init(&odom, METERS_PER_TICK, WHEELBASE);
+    odometry_update(&odom, enc);
+    // Constant wheel speeds trace a circle of radius R.
+    int left = 20, right = 30, steps = 300;
+    double dl = left * METERS_PER_TICK, dr = right * METERS_PER_TICK;
+    double radius = WHEELBASE / 2 * (dr + dl) / (dr - dl);
+    drive(&odom, &enc, left, right, steps);
+    double theta = steps * (dr - dl) / WHEELBASE;
+    odometry_get_pose(&odom, &pose);
+    CHECK_CLOSE(pose.theta, remainder(theta, 2 * M_PI), 1e-5);
+    CHECK_CLOSE(pose.x, radius * sin(theta), 1e-3);
+    CHECK_CLOSE(pose.y, radius * (1 - cos(theta)), 1e-3);
+}
+
+static void test_reversal(void) {
+    odometry_t odom;
+    odometry_pose_t pose;
+    romi_encoder_t enc = {30000, 100};
+    odometry_init(&odom, METERS_PER_TICK, WHEELBASE);
+    odometry_update(&odom, enc);
+    // An arc followed by the same arc backwards returns to the start.
+    drive(&odom, &enc, 37, 52, 500);
+    drive(&odom, &enc, -37, -52, 500);
+    odometry_get_pose(&odom, &pose);
+    CHECK_CLOSE(pose.x, 0, 1e-4);
+    CHECK_CLOSE(pose.y, 0, 1e-4);
+    CHECK_CLOSE(pose.theta, 0, 1e-6);
+}
+
+int main(void) {
+    test_first_update();
+    test_straight_with_rollover();
+    test_spin_in_place();
+    test_arc();
+    test_reversal();
+    return test_report("odometry_test");
+}
@@ -0,0 +1,131 @@
+/**
+ * @file reaction_profile_test.c
+ * @brief Host tests for lib/reaction_profile.c, through
+ * REACTION_PROFILE_INVOKE() as the instrumented runtime calls it, and
+ * the time that the profiling adds to each reaction.
+ */
+#include <string.h>
+#include "lib/reaction_profile.h"
+#include "test.h"
+
+// The fields of the runtime's reaction_t that REACTION_PROFILE_INVOKE() uses.
+typedef struct {
+    void (*function)(void *self);
+    void *self;
+    int number;
+} reaction_t;
+
+static volatile uint32_t sink;
+
+// A reaction that spins for about self microseconds.
+static void spin(void *self) {
+    uint32_t us = *(uint32_t *)self;
+    uint32_t start = reaction_profile_now();
+    while (reaction_profile_now() - start < us * 1000) {
+        sink++;
+    }
+}
+
+static void empty(void *self) {
+    sink++;
+}
+
+static reaction_profile_entry_t const *find(reaction_t const *reaction) {
+    for (int i = 0; i < REACTION_PROFILE_SLOTS; i++) {
+        reaction_profile_entry_t const *e = reaction_profile_entry(i);
+        if (e != NULL && e->reaction == reaction) return e;
+    }
+    return NULL;
+}
+
+static void test_statistics(void) {
+    uint32_t short_us = 5, long_us = 200;
+    reaction_t a = {spin, &short_us, 0};
+    reaction_t b = {spin, &long_us, 1};
+    reaction_t c = {empty, NULL, 2};
+    for (int i = 0; i < 20; i++) {
+        REACTION_PROFILE_INVOKE(&a);
+        REACTION_PROFILE_INVOKE(&c);
+        if (i % 4 == 0) REACTION_PROFILE_INVOKE(&b);
+    }
+    CHECK(reaction_profile_started);
+    CHECK(reaction_profile_ticks_per_second() == 1000000000);
+    CHECK(reaction_profile_overhead() < 10000);
+
+    reaction_profile_entry_t const *ea = find(&a), *eb = find(&b), *ec = find(&c);
+    CHECK(ea != NULL && eb != NULL && ec != NULL);
+    if (ea == NULL || eb == NULL || ec == NULL) return;
+    CHECK(ea->count == 20 && eb->count == 5 && ec->count == 20);
+    CHECK(ea->function == (const void *)spin && ea->self == &short_us && ea->number == 0);
+    CHECK(eb->number == 1 && ec->number == 2);
+    CHECK(ea->min >= 5000 && eb->min >= 200000);
+    CHECK(ea->min <= ea->max && ea->total >= (uint64_t)ea->min * ea->count);
+    CHECK(ea->total <= (uint64_t)ea->max * ea->count);
+    CHECK(ec->max < eb->min);
+
+    // Each call in exactly one bucket, and 200 us in the bucket from
+    // 2^17 ns (131 us) to 2^18 ns, unless the host was busy.
+    uint32_t calls = 0;
+    for (int i = 0; i < REACTION_PROFILE_BUCKETS; i++) {
+        calls += eb->histogram[i];
+    }
+    CHECK(calls == 5);
+    CHECK(eb->histogram[18 - REACTION_PROFILE_MIN_BITS] >= 3);
+
+    reaction_profile_report(100);
+
+    // Clearing keeps the slots.
+    reaction_profile_reset();
+    CHECK(find(&a) == ea && ea->count == 0 && ea->max == 0 && ea->total == 0);
+    REACTION_PROFILE_INVOKE(&a);
+    CHECK(ea->count == 1 && ea->min == ea->max);
+    reaction_profile_reset();
+}
+
+static void test_overflow(void) {
+    static reaction_t reactions[REACTION_PROFILE_SLOTS + 3];
+    for (int i = 0; i < REACTION_PROFILE_SLOTS + 3; i++) {
+        reactions[i] = (reaction_t){empty, NULL, i};
+        REACTION_PROFILE_INVOKE(&reactions[i]);
+        REACTION_PROFILE_INVOKE(&reactions[i]);
+    }
+    // Three slots were taken by test_statistics.
+    CHECK(reaction_profile_overflow() == 2 * 6);
+    int profiled = 0;
+    for (int i = 0; i < REACTION_PROFILE_SLOTS + 3; i++) {
+        reaction_profile_entry_t const *e = find(&reactions[i]);
+        if (e != NULL) {
+            CHECK(e->count == 2 && e->number == i);
+            profiled++;
+        }
+    }
+    CHECK(profiled == REACTION_PROFILE_SLOTS - 3);
+}
+
+// Time per call of an empty reaction, with and without profiling.
+static void test_overhead(void) {
+    const int calls = 1000000;
+    reaction_t r = {empty, NULL, 0};
+    uint32_t start = reaction_profile_now();
+    for (int i = 0; i < calls; i++) {
+        r.function(r.self);
+    }
+    uint32_t plain = reaction_profile_now() - start;
+    start = reaction_profile_now();
+    for (int i = 0; i < calls; i++) {
+        REACTION_PROFILE_INVOKE(&r);
+    }
+    uint32_t profiled = reaction_profile_now() - start;
+    printf("  %.1f ns per reaction added by profiling, %.1f ns of it reading the clock\n",
+           (double)(profiled - plain) / calls, 2.0 * reaction_profile_overhead());
+    printf("  %u bytes of statistics for %d reactions\n",
+           (unsigned)(REACTION_PROFILE_SLOTS * sizeof(reaction_profile_entry_t)),
+           REACTION_PROFILE_SLOTS);
+}
+
+int main(void) {
+    test_statistics();
+    test_overflow();
+    test_overhead();
+    return test_report("reaction_profile_test");
+}
@@ -0,0 +1,232 @@
+/**
+ * @file romi_framer_test.c
+ * @brief Host unit and fuzz tests for lib/romi_framer.c.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/romi_framer.h"
+#include "test.h"
+
+#define MAX_FRAMES 4096
+
+// Packets reported by the framer, stored back to back.
+static uint8_t out[1 << 20];
+static size_t out_length;
+static size_t out_frames;
+
+static void record(const uint8_t *packet, size_t length, void *context) {
+    CHECK(context == (void *)out);
+    memcpy(out + out_length, packet, length);
+    out_length += length;
+    out_frames++;
+}
+
+static void framer_start(romi_framer_t *framer) {
+    romi_framer_init(framer, record, out);
+    out_length = 0;
+    out_frames = 0;
+}
+
+/**
+ * @brief Write a packet with the specified payload into buf.
+ * @return The length of the packet.
+ */
+static size_t make_packet(uint8_t *buf, const uint8_t *payload, uint8_t length) {
+    buf[0] = 0xAA;
+    buf[1] = 0x55;
+    buf[2] = length;
+    memcpy(buf + 3, payload, length);
+    uint8_t cs = length;
+    for (int i = 0; i < length; i++) {
+        cs ^= payload[i];
+    }
+    buf[3 + length] = cs;
+    return length + 4;
+}
+
+/**
+ * @brief Frame a whole stream at once the slow way: at each possible header,
+ * take the packet if it is complete and valid, and otherwise move on a byte.
+ * @return The total length of the packets, which are written to `packets`.
+ */
+static size_t reference_frame(const uint8_t *data, size_t length, uint8_t *packets, size_t *count) {
+    size_t n = 0;
+    size_t p = 0;
+    *count = 0;
+    while (p + 2 < length) {
+        if (data[p] == 0xAA && data[p + 1] == 0x55) {
+            size_t packet_length = data[p + 2] + 4;
+            if (p + packet_length > length) {
+                break;
+            }
+            uint8_t cs = 0;
+            for (size_t i = 2; i < packet_length; i++) {
+                cs ^= data[p + i];
+            }
+            if (cs == 0) {
+                memcpy(packets + n, data + p, packet_length);
+                n += packet_length;
+                (*count)++;
+                p += packet_length;
+                continue;
+            }
+        }
+        p++;
+    }
+    return n;
+}
+
+static void test_single_packet(void) {
+    uint8_t payload[] = {0x01, 0x02, 0xAA, 0x55};
+    uint8_t buf[16];
+    romi_framer_t framer;
+    framer_start(&framer);
+    size_t n = make_packet(buf, payload, sizeof(payload));
+    // One byte at a time, twice.
+    for (int r = 0; r < 2; r++) {
+        for (size_t i = 0; i < n; i++) {
+            romi_framer_feed(&framer, buf + i, 1);
+        }
+    }
+    CHECK(out_frames == 2);
+    CHECK(framer.frames == 2);
+    CHECK(memcmp(out, buf, n) == 0);
+    CHECK(framer.bad_checksums == 0);
+    CHECK(framer.resyncs == 0);
+    CHECK(framer.bytes_discarded == 0);
+}
+
+static void test_rescan_after_bad_checksum(void) {
+    uint8_t payload[] = {0x01, 0x0F, 0x03, 0x04};
+    uint8_t good[16];
+    uint8_t buf[32];
+    romi_framer_t framer;
+    framer_start(&framer);
+    size_t n = make_packet(good, payload, sizeof(payload));
+    // A header with a corrupted length that claims the good packet as payload.
+    buf[0] = 0xAA;
+    buf[1] = 0x55;
+    buf[2] = 10;
+    memcpy(buf + 3, good, n);
+    romi_framer_feed(&framer, buf, 3 + n);
+    CHECK(out_frames == 0);
+    // The bad packet ends after some more bytes, and its checksum fails.
+    memset(buf, 0, 8);
+    romi_framer_feed(&framer, buf, 8);
+    CHECK(framer.bad_checksums == 1);
+    CHECK(out_frames == 1);
+    CHECK(memcmp(out, good, n) == 0);
+    // Once at the bad checksum, and again at the zeros after the good packet.
+    CHECK(framer.resyncs == 2);
+    // 3 bytes before the good packet, and the zeros after it.
+    CHECK(framer.bytes_discarded == 3 + 8);
+}
+
+static void test_garbage_between_packets(void) {
+    uint8_t payload[20];
+    uint8_t buf[64];
+    uint8_t garbage[] = {0x00, 0xAA, 0xAA, 0x13, 0x55, 0xAA};
+    romi_framer_t framer;
+    framer_start(&framer);
+    memset(payload, 0x42, sizeof(payload));
+    size_t n = make_packet(buf, payload, sizeof(payload));
+    for (int i = 0; i < 3; i++) {
+        romi_framer_feed(&framer, garbage, sizeof(garbage));
+        romi_framer_feed(&framer, buf, n);
+    }
+    CHECK(out_frames == 3);
+    CHECK(framer.resyncs == 3);
+    CHECK(framer.bytes_discarded == 3 * sizeof(garbage));
+}
+
+static void test_reset(void) {
+    uint8_t payload[8] = {0};
+    uint8_t buf[16];
+    romi_framer_t framer;
+    framer_start(&framer);
+    size_t n = make_packet(buf, payload, sizeof(payload));
+    romi_framer_feed(&framer, buf, n - 2);
+    romi_framer_reset(&framer);
+    // The end of the packet alone is not a packet.
+    romi_framer_feed(&framer, buf + n - 2, 2);
+    romi_framer_feed(&framer, buf, n);
+    CHECK(out_frames == 1);
+    CHECK(framer.bytes_discarded == n);
+}
+
+/**
+ * @brief Random streams of valid packets, corrupted packets, and garbage,
+ * fed in random chunks. The framer must find exactly the packets the
+ * reference finds, and account for every byte.
+ */
+static void test_fuzz(void) {
+    static uint8_t stream[1 << 16];
+    static uint8_t expected[1 << 20];
+    uint8_t payload[255];
+    int failures = test_failures;
+    srand(7);
+    for (int trial = 0; trial < 200; trial++) {
+        size_t n = 0;
+        size_t valid = 0;
+        while (n < sizeof(stream) - 2 * ROMI_FRAME_MAX) {
+            int kind = rand() % 4;
+            if (kind < 2) {
+                uint8_t length = rand() % (kind == 0 ? 256 : 20);
+                for (int i = 0; i < length; i++) {
+                    payload[i] = (rand() % 4 == 0) ? 0xAA : (uint8_t)rand();
+                }
+                size_t m = make_packet(stream + n, payload, length);
+                if (rand() % 4 == 0) {
+                    // Corrupt one byte after the header.
+                    stream[n + 2 + rand() % (m - 2)] ^= 1 << (rand() % 8);
+                } else {
+                    valid++;
+                }
+                n += m;
+            } else {
+                size_t m = rand() % 40;
+                for (size_t i = 0; i < m; i++) {
+                    int r = rand() % 8;
+                    stream[n++] = (r == 0) ? 0xAA : (r == 1) ? 0x55 : (uint8_t)rand();
+                }
+            }
+        }
+
+        size_t expected_frames;
+        size_t expected_length = reference_frame(stream, n, expected, &expected_frames);
+
+        romi_framer_t framer;
+        framer_start(&framer);
+        size_t fed = 0;
+        while (fed < n) {
+            size_t chunk = (rand() % 2) ? rand() % 8 : rand() % 600;
+            if (chunk > n - fed) {
+                chunk = n - fed;
+            }
+            romi_framer_feed(&framer, stream + fed, chunk);
+            fed += chunk;
+        }
+        CHECK(out_frames == expected_frames);
+        CHECK(out_length == expected_length);
+        CHECK(memcmp(out, expected, expected_length) == 0);
+        // Corruption can hide a following packet, but only rarely.
+        CHECK(out_frames + out_frames / 10 >= valid);
+        size_t buffered = framer.end - framer.start;
+        CHECK(out_length + framer.bytes_discarded + buffered == n);
+        CHECK(buffered < ROMI_FRAME_MAX);
+        if (test_failures > failures) {
+            printf("ERROR: fuzz trial %d failed\n", trial);
+            return;
+        }
+    }
+}
+
+int main(void) {
+    test_single_packet();
+    test_rescan_after_bad_checksum();
+    test_garbage_between_packets();
+    test_reset();
+    test_fuzz();
+    return test_report("romi_framer_test");
+}
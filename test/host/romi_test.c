@@ -0,0 +1,364 @@
+/**
+ * @file romi_test.c
+ * @brief Host unit tests for receiving sensor packets in lib/romi.c.
+ * Bytes from the robot are fed in through the UART stand-in in platform/host.
+ */
+#include <stdint.h>
+#include <string.h>
+
+#include "nrfx_uart.h"
+#include "app_timer.h"
+#include "lib/romi.h"
+#include "test.h"
+
+/**
+ * @brief Write a sensor packet with a basic sensor sub-payload into buf.
+ * @return The length of the packet.
+ */
+static size_t make_packet(uint8_t *buf, uint16_t left_encoder, uint16_t right_encoder) {
+    uint8_t *p = buf + 3;
+    buf[0] = 0xAA;
+    buf[1] = 0x55;
+    *p++ = 0x01;
+    *p++ = 0x0F;
+    memset(p, 0, 0x0F);
+    p[5] = left_encoder & 0xFF;
+    p[6] = left_encoder >> 8;
+    p[7] = right_encoder & 0xFF;
+    p[8] = right_encoder >> 8;
+    p += 0x0F;
+    buf[2] = (uint8_t)(p - buf - 3);
+    uint8_t cs = 0;
+    for (uint8_t *q = buf + 2; q < p; q++) {
+        cs ^= *q;
+    }
+    *p++ = cs;
+    return p - buf;
+}
+
+/**
+ * @brief Append a sub-payload to a packet being built in buf,
+ * and return the new length of the packet so far.
+ */
+static size_t add_subpayload(uint8_t *buf, size_t n, uint8_t id, const uint8_t *data, uint8_t length) {
+    buf[n++] = id;
+    buf[n++] = length;
+    memcpy(buf + n, data, length);
+    return n + length;
+}
+
+/**
+ * @brief Fill in the header, length, and checksum of a packet whose
+ * sub-payloads end at n, and return its length.
+ */
+static size_t finish_packet(uint8_t *buf, size_t n) {
+    buf[0] = 0xAA;
+    buf[1] = 0x55;
+    buf[2] = (uint8_t)(n - 3);
+    uint8_t cs = 0;
+    for (size_t i = 2; i < n; i++) {
+        cs ^= buf[i];
+    }
+    buf[n] = cs;
+    return n + 1;
+}
+
+static void reset(void) {
+    uint8_t tx[64];
+    CHECK(romi_init() == NRF_SUCCESS);
+    // Finish and discard the stop command sent by romi_init().
+    CHECK(nrfx_uart_host_tx_complete());
+    while (nrfx_uart_host_take_tx(tx, sizeof(tx)) > 0) {
+    }
+}
+
+static void test_no_packet(void) {
+    romi_sensors_t sensors;
+    romi_rx_stats_t stats;
+    reset();
+    memset(&sensors, 0xFF, sizeof(sensors));
+    CHECK(romi_sensors_poll(&sensors) == NRF_SUCCESS);
+    CHECK(sensors.encoders.left == 0);
+    CHECK(sensors.time_stamp == 0);
+    CHECK(romi_sensors_age_ms() == UINT32_MAX);
+    romi_rx_stats(&stats);
+    CHECK(stats.packets == 0);
+}
+
+static void test_split_packet(void) {
+    uint8_t buf[64];
+    romi_sensors_t sensors;
+    reset();
+    size_t n = make_packet(buf, 1234, 4321);
+    // First half arrives, then a poll, then the rest.
+    nrfx_uart_host_receive(buf, n / 2);
+    romi_sensors_poll(&sensors);
+    CHECK(sensors.encoders.left == 0);
+    nrfx_uart_host_receive(buf + n / 2, n - n / 2);
+    romi_sensors_poll(&sensors);
+    CHECK(sensors.encoders.left == 1234);
+    CHECK(sensors.encoders.right == 4321);
+}
+
+static void test_garbage_and_checksum(void) {
+    uint8_t buf[64];
+    uint8_t noise[] = {0x00, 0xAA, 0x13, 0xAA, 0xAA, 0x55, 0x02, 0x01};
+    romi_sensors_t sensors;
+    romi_rx_stats_t stats;
+    reset();
+    size_t n = make_packet(buf, 10, 20);
+    nrfx_uart_host_receive(buf, n);
+    // A corrupted packet must not replace the good one.
+    n = make_packet(buf, 30, 40);
+    buf[8] ^= 0x10;
+    nrfx_uart_host_receive(buf, n);
+    romi_sensors_poll(&sensors);
+    CHECK(sensors.encoders.left == 10);
+    // Noise, including repeated and partial headers, before a good packet.
+    nrfx_uart_host_receive(noise, sizeof(noise));
+    n = make_packet(buf, 50, 60);
+    nrfx_uart_host_receive(buf, n);
+    romi_sensors_poll(&sensors);
+    romi_rx_stats(&stats);
+    CHECK(stats.checksum_errors >= 1);
+    // The noise ends in a short packet that swallows the start of the next one,
+    // so that one may be lost. Send another.
+    nrfx_uart_host_receive(buf, n);
+    romi_sensors_poll(&sensors);
+    CHECK(sensors.encoders.left == 50);
+    CHECK(sensors.encoders.right == 60);
+}
+
+static void test_drop_counts(void) {
+    uint8_t buf[64];
+    romi_sensors_t sensors;
+    romi_rx_stats_t stats;
+    reset();
+    for (int i = 0; i < 5; i++) {
+        size_t n = make_packet(buf, i, 0);
+        nrfx_uart_host_receive(buf, n);
+    }
+    romi_sensors_poll(&sensors);
+    romi_rx_stats(&stats);
+    // Only the newest is returned. The others were overwritten unread.
+    CHECK(sensors.encoders.left == 4);
+    CHECK(stats.packets == 5);
+    CHECK(stats.packets_dropped == 4);
+    CHECK(stats.bytes_dropped == 0);
+
+    // Fill the ring past capacity without polling.
+    size_t n = make_packet(buf, 7, 0);
+    size_t sent = 0;
+    while (sent < 2 * ROMI_RX_RING_SIZE) {
+        nrfx_uart_host_receive(buf, n);
+        sent += n;
+    }
+    romi_rx_stats(&stats);
+    CHECK(stats.bytes_dropped == sent - ROMI_RX_RING_SIZE);
+
+    // Reception recovers once the ring has been drained.
+    romi_sensors_poll(&sensors);
+    n = make_packet(buf, 8, 0);
+    nrfx_uart_host_receive(buf, n);
+    romi_sensors_poll(&sensors);
+    CHECK(sensors.encoders.left == 8);
+}
+
+static void test_uart_error(void) {
+    uint8_t buf[64];
+    romi_sensors_t sensors;
+    romi_rx_stats_t stats;
+    reset();
+    nrfx_uart_host_error(NRF_UART_ERROR_FRAMING_MASK);
+    size_t n = make_packet(buf, 99, 0);
+    CHECK(nrfx_uart_host_receive(buf, n) == n);
+    romi_sensors_poll(&sensors);
+    romi_rx_stats(&stats);
+    CHECK(stats.uart_errors == 1);
+    CHECK(sensors.encoders.left == 99);
+}
+
+static void test_age(void) {
+    uint8_t buf[64];
+    romi_sensors_t sensors;
+    reset();
+    size_t n = make_packet(buf, 1, 0);
+    nrfx_uart_host_receive(buf, n);
+    CHECK(romi_sensors_age_ms() == 0);
+    app_timer_host_advance(APP_TIMER_CLOCK_FREQ / 4);
+    CHECK(romi_sensors_age_ms() == 250);
+    // Polling does not make the packet any younger.
+    romi_sensors_poll(&sensors);
+    CHECK(romi_sensors_age_ms() == 250);
+    nrfx_uart_host_receive(buf, n);
+    CHECK(romi_sensors_age_ms() == 0);
+}
+
+static void test_drive_command(void) {
+    uint8_t tx[16];
+    reset();
+    CHECK(romi_drive_direct(100, 100) == NRF_SUCCESS);
+    size_t n = nrfx_uart_host_take_tx(tx, sizeof(tx));
+    // AA 55, length 6, drive command 01 04, speed 100, radius 0, checksum.
+    uint8_t expected[] = {0xAA, 0x55, 0x06, 0x01, 0x04, 0x64, 0x00, 0x00, 0x00, 0x67};
+    CHECK(n == sizeof(expected));
+    CHECK(memcmp(tx, expected, sizeof(expected)) == 0);
+}
+
+/**
+ * @brief Check that the next frame sent is a drive command with the
+ * specified speed and zero radius.
+ */
+static void check_drive_sent(int16_t speed) {
+    uint8_t tx[16];
+    size_t n = nrfx_uart_host_take_tx(tx, sizeof(tx));
+    CHECK(n == 10);
+    CHECK(tx[3] == 0x01 && tx[4] == 0x04);
+    CHECK(tx[5] == (speed & 0xFF) && tx[6] == (speed >> 8));
+}
+
+static void test_drive_coalescing(void) {
+    romi_tx_stats_t stats;
+    reset();
+    // The first command starts sending at once. Those issued while it
+    // is in progress replace each other, so only the last one follows.
+    for (int16_t speed = 10; speed <= 50; speed += 10) {
+        CHECK(romi_drive_direct(speed, speed) == NRF_SUCCESS);
+    }
+    CHECK(nrfx_uart_tx_in_progress(NULL));
+    check_drive_sent(10);
+    CHECK(nrfx_uart_host_tx_complete());
+    check_drive_sent(50);
+    CHECK(nrfx_uart_host_tx_complete());
+    CHECK(!nrfx_uart_host_tx_complete());
+
+    // Counts include the stop command sent by romi_init().
+    romi_tx_stats(&stats);
+    CHECK(stats.queued == 3);
+    CHECK(stats.coalesced == 3);
+    CHECK(stats.sent == 3);
+    CHECK(stats.dropped == 0);
+
+    // Once the queue is idle, the next command goes out at once.
+    CHECK(romi_drive_direct(60, 60) == NRF_SUCCESS);
+    check_drive_sent(60);
+    CHECK(nrfx_uart_host_tx_complete());
+}
+
+static void test_all_subpayloads(void) {
+    uint8_t buf[256];
+    uint8_t basic[15] = {0x34, 0x12, 0x05, 0x02, 0x04, 0x10, 0x00, 0x20, 0x00,
+                         0x9C, 0x64, 0x02, 0x06, 0xA0, 0x01};
+    uint8_t docking[3] = {1, 2, 3};
+    uint8_t inertial[7] = {0x18, 0xFC, 0x64, 0x00, 0, 0, 0};
+    uint8_t cliff[6] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+    uint8_t current[2] = {7, 8};
+    uint8_t gyro[2 + 18] = {42, 9};
+    uint8_t unique_id[12] = {0xDE, 0xAD, 0xBE, 0xEF};
+    uint8_t unknown[5] = {0xAA, 0x55, 0xAA, 0x55, 0xAA};
+    uint8_t gpio[16] = {0x0F, 0x00, 0xFF, 0x0F};
+    for (int k = 0; k < 9; k++) {
+        // x, y, z of 3 samples: 1, -2, 3, 4, -5, 6, ...
+        int16_t v = (k % 3 == 1) ? -(k + 1) : (k + 1);
+        gyro[2 + 2 * k] = v & 0xFF;
+        gyro[3 + 2 * k] = (uint16_t)v >> 8;
+    }
+
+    size_t n = 3;
+    n = add_subpayload(buf, n, ROMI_ID_BASIC, basic, sizeof(basic));
+    n = add_subpayload(buf, n, ROMI_ID_DOCKING_IR, docking, sizeof(docking));
+    n = add_subpayload(buf, n, ROMI_ID_INERTIAL, inertial, sizeof(inertial));
+    n = add_subpayload(buf, n, ROMI_ID_CLIFF, cliff, sizeof(cliff));
+    n = add_subpayload(buf, n, ROMI_ID_CURRENT, current, sizeof(current));
+    n = add_subpayload(buf, n, ROMI_ID_UNIQUE_ID, unique_id, sizeof(unique_id));
+    n = add_subpayload(buf, n, 0x7F, unknown, sizeof(unknown));
+    n = add_subpayload(buf, n, ROMI_ID_GYRO, gyro, sizeof(gyro));
+    n = add_subpayload(buf, n, ROMI_ID_GPIO, gpio, sizeof(gpio));
+    // A cliff sub-payload with the wrong length is skipped.
+    n = add_subpayload(buf, n, ROMI_ID_CLIFF, cliff, 4);
+    n = finish_packet(buf, n);
+
+    romi_sensors_ext_t sensors;
+    reset();
+    nrfx_uart_host_receive(buf, n);
+    CHECK(romi_sensors_ext_poll(&sensors) == NRF_SUCCESS);
+
+    CHECK(sensors.present == ((1UL << ROMI_ID_BASIC) | (1UL << ROMI_ID_DOCKING_IR)
+                              | (1UL << ROMI_ID_INERTIAL) | (1UL << ROMI_ID_CLIFF)
+                              | (1UL << ROMI_ID_CURRENT) | (1UL << ROMI_ID_GYRO)
+                              | (1UL << ROMI_ID_GPIO)));
+    CHECK(sensors.basic.time_stamp == 0x1234);
+    CHECK(sensors.basic.bumps.right && !sensors.basic.bumps.center && sensors.basic.bumps.left);
+    CHECK(sensors.wheel_drops == 0x02);
+    CHECK(sensors.basic.reflectance.left && !sensors.basic.reflectance.right);
+    CHECK(sensors.basic.encoders.left == 0x10);
+    CHECK(sensors.basic.encoders.right == 0x20);
+    CHECK(sensors.pwm_left == -100);
+    CHECK(sensors.pwm_right == 100);
+    CHECK(sensors.basic.buttons.left && !sensors.basic.buttons.right);
+    CHECK(sensors.charger == 6);
+    CHECK(sensors.battery == 0xA0);
+    CHECK(sensors.overcurrent == 1);
+    CHECK(sensors.docking_ir[0] == 1 && sensors.docking_ir[2] == 3);
+    CHECK(sensors.inertial.angle == -1000);
+    CHECK(sensors.inertial.angle_rate == 100);
+    CHECK(sensors.cliff[0] == 0x0201 && sensors.cliff[1] == 0x0403 && sensors.cliff[2] == 0x0605);
+    CHECK(sensors.current[0] == 7 && sensors.current[1] == 8);
+    CHECK(sensors.gyro.frame_id == 42);
+    CHECK(sensors.gyro.count == 3);
+    CHECK(sensors.gyro.samples[0].x == 1 && sensors.gyro.samples[0].y == -2);
+    CHECK(sensors.gyro.samples[2].z == 9);
+    CHECK(sensors.gpio.digital == 0x000F);
+    CHECK(sensors.gpio.analog[0] == 0x0FFF);
+
+    // The basic data is the same through romi_sensors_poll().
+    romi_sensors_t basic_only;
+    romi_sensors_poll(&basic_only);
+    CHECK(memcmp(&basic_only, &sensors.basic, sizeof(basic_only)) == 0);
+
+    // Sub-payloads without a decoder can be read raw.
+    uint8_t length = 0;
+    const uint8_t *raw = romi_sensors_raw(ROMI_ID_UNIQUE_ID, &length);
+    CHECK(raw != NULL && length == 12 && raw[0] == 0xDE && raw[3] == 0xEF);
+    raw = romi_sensors_raw(0x7F, &length);
+    CHECK(raw != NULL && length == 5 && raw[0] == 0xAA);
+    CHECK(romi_sensors_raw(ROMI_ID_CONTROLLER_INFO, &length) == NULL);
+
+    // A packet with only basic data keeps the other values.
+    n = finish_packet(buf, add_subpayload(buf, 3, ROMI_ID_BASIC, basic, sizeof(basic)));
+    nrfx_uart_host_receive(buf, n);
+    romi_sensors_ext_poll(&sensors);
+    CHECK(sensors.present == (1UL << ROMI_ID_BASIC));
+    CHECK(sensors.inertial.angle == -1000);
+}
+
+static void test_truncated_subpayload(void) {
+    uint8_t buf[64];
+    uint8_t basic[15] = {0};
+    romi_sensors_t sensors;
+    reset();
+    basic[5] = 77;
+    size_t n = add_subpayload(buf, 3, ROMI_ID_BASIC, basic, sizeof(basic));
+    // A sub-payload that claims more bytes than the packet has.
+    buf[n++] = ROMI_ID_CLIFF;
+    buf[n++] = 200;
+    buf[n++] = 0;
+    n = finish_packet(buf, n);
+    nrfx_uart_host_receive(buf, n);
+    romi_sensors_poll(&sensors);
+    CHECK(sensors.encoders.left == 77);
+}
+
+int main(void) {
+    test_no_packet();
+    test_split_packet();
+    test_garbage_and_checksum();
+    test_drop_counts();
+    test_uart_error();
+    test_age();
+    test_drive_command();
+    test_drive_coalescing();
+    test_all_subpayloads();
+    test_truncated_subpayload();
+    return test_report("romi_test");
+}
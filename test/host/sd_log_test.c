@@ -0,0 +1,212 @@
+/**
+ * @file sd_log_test.c
+ * @brief Host tests for lib/sd_log.c, on the file-backed SD card of
+ * platform/host/app_sdcard_host.c.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "lib/sd_log.h"
+#include "nrf_error.h"
+#include "test.h"
+
+#define IMAGE "_build/sd_log_test.img"
+#define CARD_BLOCKS 64
+#define FIRST_BLOCK 4
+
+static const log_codec_config_t config = {
+    .channels = 3, .keyframe = 16, .time_unit = 1000000, .exponents = {3, 3, 3},
+};
+
+static sd_log_t sd_log;
+
+// Record `i` of a slowly changing signal.
+static log_codec_record_t record(uint32_t i) {
+    log_codec_record_t r = {.time = 10 * i};
+    r.values[0] = (int32_t)i;
+    r.values[1] = 1000 - (int32_t)(i % 50);
+    r.values[2] = (int32_t)(i * i % 997);
+    return r;
+}
+
+static bool append(uint32_t i) {
+    log_codec_record_t r = record(i);
+    return sd_log_append(&sd_log, &r);
+}
+
+static void start(uint32_t card_blocks) {
+    app_sdc_host_open(IMAGE, card_blocks);
+    CHECK(sd_log_init(&sd_log, &config, FIRST_BLOCK) == NRF_SUCCESS);
+}
+
+static void stop(void) {
+    while (app_sdc_host_complete()) {}
+    CHECK(app_sdc_uninit() == NRF_SUCCESS);
+    app_sdc_host_defer(false);
+    app_sdc_host_fail(SDC_SUCCESS);
+}
+
+/**
+ * Decode the log of `session` from the image and return the number of
+ * records, checking that they are records of record() in increasing
+ * order. The log ends at the first block that is not of the session, or
+ * whose sequence number is not larger than the one before, which skips
+ * over a block that failed to write.
+ */
+static uint32_t decode(uint32_t session) {
+    FILE *file = fopen(IMAGE, "rb");
+    CHECK(file != NULL);
+    if (file == NULL) return 0;
+    uint8_t block[SD_LOG_BLOCK_SIZE];
+    uint32_t n = 0;
+    uint64_t last = 0;
+    fseek(file, FIRST_BLOCK * SD_LOG_BLOCK_SIZE, SEEK_SET);
+    for (int64_t sequence = -1; fread(block, 1, sizeof(block), file) == sizeof(block);) {
+        log_codec_reader_t reader;
+        if (log_codec_open(&reader, block, sizeof(block)) != NRF_SUCCESS
+                || reader.config.session != session || reader.sequence <= sequence) {
+            break;
+        }
+        sequence = reader.sequence;
+        log_codec_record_t r;
+        while (log_codec_read(&reader, &r) == NRF_SUCCESS) {
+            log_codec_record_t e = record((uint32_t)(r.time / 10));
+            CHECK(memcmp(&r, &e, sizeof(r)) == 0);
+            CHECK(n == 0 || r.time > last);
+            last = r.time;
+            n++;
+        }
+    }
+    fclose(file);
+    return n;
+}
+
+static void test_log(void) {
+    remove(IMAGE);
+    start(CARD_BLOCKS);
+    // The card starts within init, and the image has no log yet.
+    CHECK(sd_log.state == SD_LOG_READY);
+    CHECK(sd_log.writer.config.session == 1);
+    CHECK(sd_log.end_block == CARD_BLOCKS);
+    for (uint32_t i = 0; i < 1000; i++) {
+        CHECK(append(i));
+    }
+    CHECK(sd_log_flush(&sd_log) == NRF_SUCCESS);
+    CHECK(!sd_log_busy(&sd_log));
+    CHECK(sd_log_flush(&sd_log) == NRF_SUCCESS);
+    stop();
+    CHECK(sd_log.records == 1000);
+    CHECK(sd_log.dropped == 0 && sd_log.errors == 0);
+    CHECK(sd_log.blocks == sd_log.sequence);
+    CHECK(app_sdc_host_blocks_written() == sd_log.blocks);
+    printf("  1000 records in %u blocks\n", (unsigned)sd_log.blocks);
+    CHECK(decode(1) == 1000);
+
+    // A shorter log over the first one has the next session, so the
+    // blocks of the first after it are not taken for its own.
+    start(CARD_BLOCKS);
+    CHECK(sd_log.writer.config.session == 2);
+    for (uint32_t i = 0; i < 100; i++) {
+        CHECK(append(2000 + i));
+    }
+    CHECK(sd_log_flush(&sd_log) == NRF_SUCCESS);
+    stop();
+    CHECK(decode(2) == 100);
+}
+
+/*
+ * With the card's operations held until the test completes them, as
+ * they are until the SPI interrupts on the board: appending goes on into
+ * the second buffer while the first is written, and drops records rather
+ * than waiting when both are full.
+ */
+static void test_double_buffer(void) {
+    remove(IMAGE);
+    app_sdc_host_defer(true);
+    start(CARD_BLOCKS);
+    CHECK(sd_log.state == SD_LOG_STARTING);
+    CHECK(sd_log_busy(&sd_log));
+
+    // While the card starts, one block of records is kept.
+    uint32_t i = 0;
+    while (append(i)) i++;
+    uint32_t per_block = i++;
+    CHECK(sd_log.dropped == 1);
+    CHECK(sd_log_flush(&sd_log) == NRF_ERROR_BUSY);
+    CHECK(app_sdc_host_complete()); // Initialized, and reading the first block.
+    CHECK(sd_log.state == SD_LOG_STARTING);
+    CHECK(app_sdc_host_complete());
+    CHECK(sd_log.state == SD_LOG_READY);
+    CHECK(!sd_log_busy(&sd_log));
+
+    // The next record starts writing the first block, and goes into the
+    // second buffer, which fills while the write is in progress.
+    CHECK(append(i++));
+    CHECK(sd_log.full && sd_log.writing && app_sdc_busy_check());
+    while (append(i)) i++;
+    i++;
+    CHECK(sd_log.dropped == 2);
+    CHECK(sd_log.records > per_block);
+    CHECK(sd_log_flush(&sd_log) == NRF_ERROR_BUSY);
+
+    // When the write finishes, the second block is written in turn.
+    CHECK(app_sdc_host_complete());
+    CHECK(sd_log.blocks == 1);
+    CHECK(!sd_log_busy(&sd_log));
+    CHECK(append(i++));
+    CHECK(sd_log.full && sd_log.writing);
+    CHECK(app_sdc_host_complete());
+    CHECK(sd_log_flush(&sd_log) == NRF_SUCCESS);
+    CHECK(sd_log_busy(&sd_log));
+    CHECK(app_sdc_host_complete());
+    CHECK(!sd_log_busy(&sd_log));
+    stop();
+    CHECK(sd_log.blocks == 3 && sd_log.errors == 0);
+    CHECK(decode(1) == sd_log.records);
+}
+
+static void test_card_errors(void) {
+    // A card that does not start.
+    remove(IMAGE);
+    app_sdc_host_fail(SDC_ERROR_NOT_RESPONDING);
+    start(CARD_BLOCKS);
+    CHECK(sd_log.state == SD_LOG_FAILED);
+    CHECK(!append(0));
+    CHECK(sd_log.dropped == 1);
+    CHECK(!sd_log_busy(&sd_log));
+    stop();
+
+    // A block that fails to write is lost, and the next one takes its
+    // place on the card.
+    start(CARD_BLOCKS);
+    app_sdc_host_fail(SDC_ERROR_DATA);
+    uint32_t i = 0;
+    while (sd_log.errors == 0) CHECK(append(i++));
+    uint32_t lost = i - 1;
+    app_sdc_host_fail(SDC_SUCCESS);
+    while (sd_log.blocks == 0) CHECK(append(i++));
+    stop();
+    CHECK(sd_log.errors == 1 && sd_log.next_block == FIRST_BLOCK + 1);
+    CHECK(decode(1) == sd_log.records - sd_log.writer.count - lost);
+
+    // A full card.
+    remove(IMAGE);
+    start(FIRST_BLOCK + 2);
+    i = 0;
+    while (append(i)) i++;
+    CHECK(sd_log.blocks == 2 && sd_log.dropped == 1);
+    CHECK(sd_log.full && !sd_log.writing);
+    CHECK(!sd_log_busy(&sd_log));
+    stop();
+    log_codec_reader_t unwritten;
+    CHECK(log_codec_open(&unwritten, sd_log.buffers[!sd_log.filling], SD_LOG_BLOCK_SIZE)
+          == NRF_SUCCESS);
+    CHECK(decode(1) == sd_log.records - sd_log.writer.count - unwritten.count);
+}
+
+int main(void) {
+    test_log();
+    test_double_buffer();
+    test_card_errors();
+    remove(IMAGE);
+    return test_report("sd_log_test");
+}
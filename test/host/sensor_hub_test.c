@@ -0,0 +1,156 @@
+/**
+ * @file sensor_hub_test.c
+ * @brief Host tests for lib/sensor_hub.c, including shared reads through
+ * lib/lsm9ds1_async.c on the LSM9DS1 model.
+ */
+#include "lib/lsm9ds1_async.h"
+#include "lib/sensor_bus.h"
+#include "lib/sensor_hub.h"
+#include "test.h"
+
+#define MSEC 1000000LL
+
+static sensor_hub_subscription_t sub(uint8_t sensors, int64_t period) {
+    sensor_hub_subscription_t s = {sensors, period};
+    return s;
+}
+
+static void test_empty(void) {
+    sensor_hub_t hub;
+    uint8_t sensors = 0xFF;
+    sensor_hub_init(&hub);
+    CHECK(sensor_hub_tick(&hub) == 0);
+    CHECK(sensor_hub_step(&hub, &sensors) == 0);
+    CHECK(sensors == 0);
+    CHECK(sensor_hub_subscribe(&hub, SENSOR_HUB_MAX_SUBSCRIBERS, sub(LSM9DS1_GYRO, 10 * MSEC)) == -1);
+}
+
+static void test_rates(void) {
+    sensor_hub_t hub;
+    uint8_t sensors;
+    sensor_hub_init(&hub);
+    // Two gyro consumers at 20 and 30 ms and an accelerometer one at 50 ms.
+    sensor_hub_subscribe(&hub, 0, sub(LSM9DS1_GYRO, 20 * MSEC));
+    sensor_hub_subscribe(&hub, 1, sub(LSM9DS1_GYRO, 30 * MSEC));
+    sensor_hub_subscribe(&hub, 2, sub(LSM9DS1_ACC, 50 * MSEC));
+    CHECK(sensor_hub_tick(&hub) == 10 * MSEC);
+
+    int deliveries[3] = {0, 0, 0};
+    int gyro_reads = 0, acc_reads = 0;
+    for (int k = 0; k < 30; k++) { // 300 ms.
+        uint32_t due = sensor_hub_step(&hub, &sensors);
+        for (int i = 0; i < 3; i++) {
+            if (due & (1u << i)) deliveries[i]++;
+        }
+        if (sensors & LSM9DS1_GYRO) gyro_reads++;
+        if (sensors & LSM9DS1_ACC) acc_reads++;
+        CHECK(!(sensors & LSM9DS1_MAG));
+        if (k == 0) CHECK(due == 7);
+        if (k == 6) CHECK(due == 3 && sensors == LSM9DS1_GYRO);
+        if (k == 10) CHECK(due == 5 && sensors == (LSM9DS1_GYRO | LSM9DS1_ACC));
+    }
+    CHECK(deliveries[0] == 15);
+    CHECK(deliveries[1] == 10);
+    CHECK(deliveries[2] == 6);
+    // Ticks 0, 6, 12, ... are shared by both gyro consumers.
+    CHECK(gyro_reads == 15 + 10 - 5);
+    CHECK(acc_reads == 6);
+}
+
+static void test_resubscribe(void) {
+    sensor_hub_t hub;
+    uint8_t sensors;
+    sensor_hub_init(&hub);
+    sensor_hub_subscribe(&hub, 3, sub(LSM9DS1_MAG, 100 * MSEC));
+    CHECK(sensor_hub_tick(&hub) == 100 * MSEC);
+    CHECK(sensor_hub_step(&hub, &sensors) == 1u << 3);
+    sensor_hub_subscribe(&hub, 5, sub(LSM9DS1_ACC, 40 * MSEC));
+    CHECK(sensor_hub_tick(&hub) == 20 * MSEC);
+    // A new schedule starts with everyone due.
+    CHECK(sensor_hub_step(&hub, &sensors) == ((1u << 3) | (1u << 5)));
+    sensor_hub_subscribe(&hub, 3, sub(0, 0));
+    CHECK(sensor_hub_tick(&hub) == 40 * MSEC);
+    sensor_hub_subscribe(&hub, 5, sub(LSM9DS1_ACC, 0));
+    CHECK(sensor_hub_tick(&hub) == 0);
+}
+
+static int readings;
+
+static void read_done(ret_code_t result, lsm9ds1_reading_t const *reading, void *context) {
+    CHECK(result == NRF_SUCCESS);
+    readings++;
+}
+
+static void test_bus_traffic(void) {
+    // Eight consumers of gyro and accelerometer data at 10 ms cost one
+    // read of each of the two sensors per tick, as a single consumer would.
+    nrf_twi_mngr_host_reset();
+    lsm9ds1_host_reset();
+    lsm9ds1_async_init(sensor_bus_init());
+    CHECK(sensor_bus_init() == sensor_bus_init());
+
+    sensor_hub_t hub;
+    uint8_t sensors;
+    sensor_hub_init(&hub);
+    for (int i = 0; i < 8; i++) {
+        sensor_hub_subscribe(&hub, i, sub(i % 2 ? LSM9DS1_GYRO : LSM9DS1_ACC | LSM9DS1_GYRO, 10 * MSEC));
+    }
+    for (int k = 0; k < 100; k++) {
+        CHECK(sensor_hub_step(&hub, &sensors) == 0xFF);
+        CHECK(lsm9ds1_async_read(sensors, read_done, NULL) == NRF_SUCCESS);
+        nrf_twi_mngr_host_complete();
+    }
+    CHECK(readings == 100);
+    CHECK(nrf_twi_mngr_host_transactions() == 100 * 2);
+    // Two sensors of 6 bytes, each after a register address.
+    CHECK(nrf_twi_mngr_host_bytes() == 100 * 2 * 7);
+}
+
+static void test_slow_read(void) {
+    // A read that ends after the next tick, as a 5 ms hub's might when
+    // the reading comes out by a physical action. The hub skips that tick
+    // rather than starting a read for other consumers, and the reading
+    // goes to those it was read for.
+    nrf_twi_mngr_host_reset();
+    lsm9ds1_host_reset();
+    lsm9ds1_async_init(sensor_bus_init());
+    readings = 0;
+
+    sensor_hub_t hub;
+    uint8_t sensors;
+    sensor_hub_init(&hub);
+    sensor_hub_subscribe(&hub, 0, sub(LSM9DS1_GYRO, 5 * MSEC));
+    sensor_hub_subscribe(&hub, 1, sub(LSM9DS1_ACC, 10 * MSEC));
+
+    uint32_t due = sensor_hub_step(&hub, &sensors);
+    CHECK(due == 3);
+    CHECK(lsm9ds1_async_read(sensors, read_done, NULL) == NRF_SUCCESS);
+    sensor_hub_read_started(&hub, due);
+    // The transfer ends, which frees the bus, but the next tick comes
+    // before the reading is handed out.
+    nrf_twi_mngr_host_complete();
+    CHECK(readings == 1);
+    CHECK(sensor_hub_step(&hub, &sensors) == 0);
+    CHECK(sensors == 0);
+    CHECK(sensor_hub_read_done(&hub) == 3);
+    CHECK(sensor_hub_read_done(&hub) == 0);
+
+    // Then the schedule goes on where it would have been.
+    due = sensor_hub_step(&hub, &sensors);
+    CHECK(due == 3 && sensors == (LSM9DS1_GYRO | LSM9DS1_ACC));
+    CHECK(lsm9ds1_async_read(sensors, read_done, NULL) == NRF_SUCCESS);
+    sensor_hub_read_started(&hub, due);
+    nrf_twi_mngr_host_complete();
+    CHECK(sensor_hub_read_done(&hub) == 3);
+    CHECK(sensor_hub_step(&hub, &sensors) == 1 && sensors == LSM9DS1_GYRO);
+    CHECK(readings == 2);
+}
+
+int main(void) {
+    test_empty();
+    test_rates();
+    test_resubscribe();
+    test_bus_traffic();
+    test_slow_read();
+    return test_report("sensor_hub_test");
+}
@@ -0,0 +1,196 @@
+/**
+ * @file telemetry_test.c
+ * @brief Host tests for lib/telemetry.c.
+ */
+#include <string.h>
+#include "lib/telemetry.h"
+#include "nrf_error.h"
+#include "test.h"
+
+#define SAMPLES 1000
+
+static telemetry_sample_t samples[SAMPLES];
+static telemetry_sample_t decoded[SAMPLES];
+static uint32_t seed = 1;
+
+// Small noise, like that of a resting IMU, from a fixed sequence.
+static int noise(int amplitude) {
+    seed = seed * 1103515245 + 12345;
+    return (int)((seed >> 16) % (2 * amplitude + 1)) - amplitude;
+}
+
+/**
+ * Fill `samples` with a robot driving a slow curve: a sample every 10 ms,
+ * wheels turning about 15 ticks a sample, with the left encoder wrapping,
+ * an occasional bump, and IMU readings with a few counts of noise.
+ */
+static void drive(void) {
+    for (int i = 0; i < SAMPLES; i++) {
+        telemetry_sample_t *s = &samples[i];
+        s->time = 1000 + 10 * i + (i % 7 == 0);
+        s->left_encoder = (uint16_t)(65000 + 16 * i);
+        s->right_encoder = (uint16_t)(14 * i);
+        s->bumpers = (i / 100) % 5 == 4 ? TELEMETRY_BUMP_CENTER : 0;
+        s->accel[0] = 20 + noise(8);
+        s->accel[1] = -5 + noise(8);
+        s->accel[2] = 1000 + noise(8);
+        s->gyro[0] = noise(3);
+        s->gyro[1] = noise(3);
+        s->gyro[2] = 120 + noise(3);
+    }
+}
+
+static bool same(const telemetry_sample_t *a, const telemetry_sample_t *b) {
+    return a->time == b->time && a->left_encoder == b->left_encoder
+            && a->right_encoder == b->right_encoder && a->bumpers == b->bumpers
+            && memcmp(a->accel, b->accel, sizeof(a->accel)) == 0
+            && memcmp(a->gyro, b->gyro, sizeof(a->gyro)) == 0;
+}
+
+/**
+ * Encode the samples into frames of at most `capacity` bytes, flushing
+ * only when a frame is full, and decode them again, skipping frame
+ * `lose` if it is not negative. Returns the number of frames.
+ */
+static int round_trip(size_t capacity, int lose, size_t *decoded_count) {
+    telemetry_encoder_t encoder;
+    telemetry_encoder_init(&encoder, capacity);
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    int frames = 0;
+    *decoded_count = 0;
+    for (int i = 0; i <= SAMPLES; i++) {
+        if (i < SAMPLES && telemetry_encoder_add(&encoder, &samples[i])) continue;
+        size_t length = telemetry_encoder_flush(&encoder, frame);
+        CHECK(length > 0 && length <= encoder.capacity);
+        if (frames++ != lose) {
+            uint16_t sequence;
+            size_t count = SAMPLES - *decoded_count;
+            CHECK(telemetry_decode(frame, length, &sequence, decoded + *decoded_count, &count)
+                  == NRF_SUCCESS);
+            CHECK(sequence == frames - 1);
+            *decoded_count += count;
+        }
+        if (i < SAMPLES) CHECK(telemetry_encoder_add(&encoder, &samples[i]));
+    }
+    CHECK(encoder.samples == SAMPLES);
+    CHECK(encoder.frames == (uint32_t)frames);
+    return frames;
+}
+
+static void test_round_trip(void) {
+    drive();
+    size_t count;
+    int frames = round_trip(TELEMETRY_FRAME_MAX, -1, &count);
+    CHECK(count == SAMPLES);
+    for (int i = 0; i < SAMPLES; i++) {
+        CHECK(same(&samples[i], &decoded[i]));
+    }
+
+    // With the default 23-byte ATT MTU, frames are made as small as they
+    // can be, holding a single sample.
+    size_t small;
+    CHECK(round_trip(20, -1, &small) == SAMPLES);
+    CHECK(small == SAMPLES);
+
+    // Losing a frame loses only the samples in it.
+    size_t lost;
+    round_trip(TELEMETRY_FRAME_MAX, 3, &lost);
+    int per_frame = SAMPLES / frames;
+    CHECK(lost >= SAMPLES - per_frame - 2 && lost < SAMPLES);
+    CHECK(same(&decoded[lost - 1], &samples[SAMPLES - 1]));
+}
+
+static void test_extremes(void) {
+    telemetry_sample_t a = {0};
+    telemetry_sample_t b = {.time = UINT32_MAX, .left_encoder = 0xFFFF, .bumpers = 0xFF,
+                            .accel = {INT16_MAX, INT16_MIN, 0}, .gyro = {INT16_MIN, INT16_MAX, -1}};
+    telemetry_encoder_t encoder;
+    telemetry_encoder_init(&encoder, TELEMETRY_FRAME_MAX);
+    for (int i = 0; i < 8; i++) {
+        CHECK(telemetry_encoder_add(&encoder, i % 2 ? &b : &a));
+    }
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    size_t length = telemetry_encoder_flush(&encoder, frame);
+    CHECK(length <= TELEMETRY_HEADER_SIZE + TELEMETRY_SAMPLE_FULL + 7 * TELEMETRY_SAMPLE_MAX);
+
+    telemetry_sample_t out[8];
+    uint16_t sequence;
+    size_t count = 8;
+    CHECK(telemetry_decode(frame, length, &sequence, out, &count) == NRF_SUCCESS);
+    CHECK(count == 8);
+    for (int i = 0; i < 8; i++) {
+        CHECK(same(&out[i], i % 2 ? &b : &a));
+    }
+
+    // Nothing to flush.
+    CHECK(telemetry_encoder_flush(&encoder, frame) == 0);
+    CHECK(encoder.sequence == 1);
+}
+
+static void test_bad_frames(void) {
+    drive();
+    telemetry_encoder_t encoder;
+    telemetry_encoder_init(&encoder, TELEMETRY_FRAME_MAX);
+    for (int i = 0; i < 5; i++) {
+        CHECK(telemetry_encoder_add(&encoder, &samples[i]));
+    }
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    size_t length = telemetry_encoder_flush(&encoder, frame);
+    telemetry_sample_t out[5];
+    uint16_t sequence;
+    size_t count;
+
+    for (size_t cut = 0; cut < length; cut++) {
+        count = 5;
+        CHECK(telemetry_decode(frame, cut, &sequence, out, &count) == NRF_ERROR_INVALID_LENGTH);
+    }
+    count = 5;
+    CHECK(telemetry_decode(frame, length + 1, &sequence, out, &count) == NRF_ERROR_INVALID_LENGTH);
+    count = 4;
+    CHECK(telemetry_decode(frame, length, &sequence, out, &count) == NRF_ERROR_NO_MEM);
+    frame[0] = TELEMETRY_VERSION + 1;
+    count = 5;
+    CHECK(telemetry_decode(frame, length, &sequence, out, &count) == NRF_ERROR_INVALID_DATA);
+}
+
+/**
+ * Report how the frames compare with polling the sensor struct. A read
+ * takes a request and a response, so a client polling gets at most one
+ * sample per connection interval, while the peripheral can send a frame
+ * of samples in each connection event without being asked.
+ */
+static void report(void) {
+    drive();
+    telemetry_encoder_t encoder;
+    telemetry_encoder_init(&encoder, TELEMETRY_FRAME_MAX);
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    int full_frames = 0;
+    uint32_t full_samples = 0, full_bytes = 0;
+    for (int i = 0; i < SAMPLES; i++) {
+        if (telemetry_encoder_add(&encoder, &samples[i])) continue;
+        full_samples += encoder.frame[1];
+        full_bytes += telemetry_encoder_flush(&encoder, frame);
+        full_frames++;
+        CHECK(telemetry_encoder_add(&encoder, &samples[i]));
+    }
+    double bytes_per_sample = (double)(full_bytes - full_frames * TELEMETRY_HEADER_SIZE) / full_samples;
+    double per_frame = (double)full_samples / full_frames;
+    printf("  %.1f bytes per sample, %.1f samples per %d-byte frame\n",
+           bytes_per_sample, per_frame, TELEMETRY_FRAME_MAX);
+    CHECK(bytes_per_sample < 11);
+    CHECK(per_frame >= 20);
+
+    const double intervals[] = {7.5, 30, 100};
+    for (int i = 0; i < 3; i++) {
+        printf("  %5.1f ms connection interval: %6.0f samples/s with one frame per event,"
+               " %4.0f polling\n", intervals[i], per_frame * 1000 / intervals[i], 1000 / intervals[i]);
+    }
+}
+
+int main(void) {
+    test_round_trip();
+    test_extremes();
+    test_bad_frames();
+    report();
+    return test_report("telemetry_test");
+}
@@ -0,0 +1,44 @@
+/**
+ * @file test.h
+ * @brief Minimal assertion helpers for host unit tests of the lib/ modules.
+ *
+ * Failures print a line containing "ERROR", matching what
+ * test/scripts/test_parse.sh looks for in on-target test output.
+ */
+#ifndef TEST_H
+#define TEST_H
+
+#include <math.h>
+#include <stdio.h>
+
+static int test_failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        printf("ERROR: %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        test_failures++; \
+    } \
+} while (0)
+
+#define CHECK_CLOSE(a, b, tol) do { \
+    double _a = (a), _b = (b); \
+    if (fabs(_a - _b) > (tol)) { \
+        printf("ERROR: %s:%d: %s = %g, expected %g (tol %g)\n", \
+               __FILE__, __LINE__, #a, _a, _b, (double)(tol)); \
+        test_failures++; \
+    } \
+} while (0)
+
+/**
+ * @brief Print a summary and return the process exit status.
+ */
+static inline int test_report(const char *name) {
+    if (test_failures) {
+        printf("%s: %d check(s) failed\n", name, test_failures);
+        return 1;
+    }
+    printf("%s: passed\n", name);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,229 @@
+/**
+ * @file trace_test.c
+ * @brief Host tests for lib/trace.c.
+ */
+#include <string.h>
+#include "lib/trace.h"
+#include "test.h"
+
+#define MSEC(t) ((int64_t)(t) * 1000000)
+#define START ((int64_t)1700000000 * 1000000000)
+
+// Sink that collects a whole trace, optionally dropping one chunk.
+static uint8_t trace[16384];
+static size_t trace_length;
+static int chunks;
+static int drop_chunk;
+
+static void sink(const uint8_t *data, size_t length, void *context) {
+    CHECK(context == &trace_length);
+    chunks++;
+    if (chunks == drop_chunk) return;
+    CHECK(trace_length + length <= sizeof(trace));
+    memcpy(trace + trace_length, data, length);
+    trace_length += length;
+}
+
+static trace_record_t romi_record(int64_t time, uint16_t n) {
+    trace_record_t r = {.type = TRACE_ROMI, .time = time};
+    r.value.romi.time_stamp = n;
+    r.value.romi.bumps.center = n & 1;
+    r.value.romi.buttons.right = n & 2;
+    r.value.romi.reflectance.left = n & 4;
+    r.value.romi.encoders.left = 65000 + n;
+    r.value.romi.encoders.right = 3 * n;
+    return r;
+}
+
+static trace_record_t axes_record(trace_type_t type, int64_t time, float v) {
+    trace_record_t r = {.type = type, .time = time};
+    r.value.axes.x_axis = v;
+    r.value.axes.y_axis = -v / 3;
+    r.value.axes.z_axis = 1.0f + v;
+    return r;
+}
+
+/**
+ * Record a robot-like trace: Romi packets every 20 ms and IMU readings
+ * every 10 ms, for `n` IMU periods.
+ */
+static void record(trace_writer_t *writer, int n) {
+    trace_length = 0;
+    chunks = 0;
+    trace_writer_init(writer, START, sink, &trace_length);
+    for (int i = 0; i < n; i++) {
+        int64_t t = START + MSEC(10) * i;
+        if (i % 2 == 0) {
+            trace_record_t r = romi_record(t, i);
+            CHECK(trace_write(writer, &r) == NRF_SUCCESS);
+        }
+        trace_record_t acc = axes_record(TRACE_ACC, t, 0.01f * i);
+        trace_record_t gyro = axes_record(TRACE_GYRO, t, -2.5f * i);
+        CHECK(trace_write(writer, &acc) == NRF_SUCCESS);
+        CHECK(trace_write(writer, &gyro) == NRF_SUCCESS);
+    }
+    trace_writer_flush(writer);
+}
+
+static void check_record(trace_record_t const *r, int i, int k) {
+    // k is 0 for the Romi record, 1 for acc, and 2 for gyro.
+    int64_t t = START + MSEC(10) * i;
+    CHECK(r->time == t);
+    if (k == 0) {
+        trace_record_t e = romi_record(t, i);
+        CHECK(r->type == TRACE_ROMI);
+        CHECK(memcmp(&r->value.romi, &e.value.romi, sizeof(e.value.romi)) == 0);
+    } else {
+        trace_record_t e = axes_record(k == 1 ? TRACE_ACC : TRACE_GYRO, t,
+                                       k == 1 ? 0.01f * i : -2.5f * i);
+        CHECK(r->type == e.type);
+        CHECK(r->value.axes.x_axis == e.value.axes.x_axis);
+        CHECK(r->value.axes.y_axis == e.value.axes.y_axis);
+        CHECK(r->value.axes.z_axis == e.value.axes.z_axis);
+    }
+}
+
+static void test_round_trip(void) {
+    trace_writer_t writer;
+    record(&writer, 100);
+    CHECK(writer.records == 250);
+    CHECK(writer.bytes == trace_length);
+    printf("  250 records in %u bytes (%.1f per record)\n",
+           (unsigned)trace_length, (double)(trace_length - TRACE_HEADER_SIZE) / 250);
+
+    // Read it as from a memory-mapped file.
+    trace_reader_t reader;
+    CHECK(trace_reader_init(&reader, trace, trace_length) == NRF_SUCCESS);
+    CHECK(reader.start_time == START);
+    size_t position = TRACE_HEADER_SIZE;
+    for (int i = 0; i < 100; i++) {
+        for (int k = i % 2 ? 1 : 0; k < 3; k++) {
+            trace_record_t r;
+            size_t used = 0;
+            CHECK(trace_read(&reader, trace + position, trace_length - position, &r, &used) == NRF_SUCCESS);
+            position += used;
+            check_record(&r, i, k);
+        }
+    }
+    trace_record_t r;
+    size_t used;
+    CHECK(position == trace_length);
+    CHECK(trace_read(&reader, trace + position, 0, &r, &used) == NRF_ERROR_NOT_FOUND);
+}
+
+static void test_streaming(void) {
+    trace_writer_t writer;
+    record(&writer, 100);
+
+    // Feed the reader a few bytes at a time through a small window.
+    trace_reader_t reader;
+    uint8_t window[64];
+    size_t window_length = 0;
+    size_t fed = 0;
+    int records = 0;
+    bool have_header = false;
+    while (true) {
+        size_t n = 5;
+        if (n > trace_length - fed) n = trace_length - fed;
+        if (n > sizeof(window) - window_length) n = sizeof(window) - window_length;
+        memcpy(window + window_length, trace + fed, n);
+        window_length += n;
+        fed += n;
+
+        size_t position = 0;
+        if (!have_header) {
+            ret_code_t result = trace_reader_init(&reader, window, window_length);
+            if (result == NRF_ERROR_INVALID_LENGTH) continue;
+            CHECK(result == NRF_SUCCESS);
+            have_header = true;
+            position = TRACE_HEADER_SIZE;
+        }
+        ret_code_t result;
+        trace_record_t r;
+        size_t used;
+        while ((result = trace_read(&reader, window + position, window_length - position, &r, &used)) == NRF_SUCCESS) {
+            position += used;
+            int i = records / 5 * 2;
+            int k = records % 5;
+            check_record(&r, k < 3 ? i : i + 1, k < 3 ? k : k - 2);
+            records++;
+        }
+        CHECK(result == NRF_ERROR_INVALID_LENGTH || result == NRF_ERROR_NOT_FOUND);
+        memmove(window, window + position, window_length - position);
+        window_length -= position;
+        if (fed == trace_length) {
+            CHECK(result == NRF_ERROR_NOT_FOUND);
+            break;
+        }
+    }
+    CHECK(records == 250);
+}
+
+static void test_dropped_chunk(void) {
+    trace_writer_t writer;
+    drop_chunk = 2;
+    record(&writer, 100);
+    drop_chunk = 0;
+    CHECK(chunks > 3);
+
+    // The records after the gap still have the right times.
+    trace_reader_t reader;
+    CHECK(trace_reader_init(&reader, trace, trace_length) == NRF_SUCCESS);
+    size_t position = TRACE_HEADER_SIZE;
+    trace_record_t r;
+    size_t used;
+    int64_t last = 0;
+    int records = 0;
+    while (trace_read(&reader, trace + position, trace_length - position, &r, &used) == NRF_SUCCESS) {
+        position += used;
+        CHECK(r.time >= last);
+        last = r.time;
+        records++;
+        if (r.type == TRACE_GYRO) {
+            int i = (int)((r.time - START) / MSEC(10));
+            CHECK(r.time == START + MSEC(10) * i);
+            CHECK(r.value.axes.x_axis == -2.5f * i);
+        }
+    }
+    CHECK(position == trace_length);
+    CHECK(records < 250);
+    CHECK(last == START + MSEC(10) * 99);
+}
+
+static void test_errors(void) {
+    trace_writer_t writer;
+    trace_length = 0;
+    trace_writer_init(&writer, START, sink, &trace_length);
+    trace_record_t r = axes_record(TRACE_MAG, START + MSEC(5), 1.0f);
+    CHECK(trace_write(&writer, &r) == NRF_SUCCESS);
+    r.time = START;
+    CHECK(trace_write(&writer, &r) == NRF_ERROR_INVALID_PARAM);
+    r.type = TRACE_TIME;
+    CHECK(trace_write(&writer, &r) == NRF_ERROR_INVALID_DATA);
+    trace_writer_flush(&writer);
+
+    trace_reader_t reader;
+    CHECK(trace_reader_init(&reader, trace, TRACE_HEADER_SIZE - 1) == NRF_ERROR_INVALID_LENGTH);
+    trace[0] = 'X';
+    CHECK(trace_reader_init(&reader, trace, trace_length) == NRF_ERROR_INVALID_DATA);
+    trace[0] = 'L';
+    CHECK(trace_reader_init(&reader, trace, trace_length) == NRF_SUCCESS);
+
+    // A record cut short, and an unknown type.
+    size_t used;
+    const uint8_t *records = trace + TRACE_HEADER_SIZE;
+    size_t length = trace_length - TRACE_HEADER_SIZE;
+    CHECK(trace_read(&reader, records, length - 1, &r, &used) == NRF_ERROR_INVALID_LENGTH);
+    CHECK(trace_read(&reader, records, length, &r, &used) == NRF_SUCCESS);
+    CHECK(r.type == TRACE_MAG && r.time == START + MSEC(5));
+    uint8_t bad[] = {0x42, 0x00};
+    CHECK(trace_read(&reader, bad, sizeof(bad), &r, &used) == NRF_ERROR_INVALID_DATA);
+}
+
+int main(void) {
+    test_round_trip();
+    test_streaming();
+    test_dropped_chunk();
+    test_errors();
+    return test_report("trace_test");
+}